@@ -81,6 +81,19 @@ static const struct acl_alg acl_alg[] = {
 		.name = "altivec",
 		.alg = RTE_ACL_CLASSIFY_ALTIVEC,
 	},
+	{
+		.name = "avx512x16",
+		.alg = RTE_ACL_CLASSIFY_AVX512X16,
+	},
+	{
+		.name = "avx512x32",
+		.alg = RTE_ACL_CLASSIFY_AVX512X32,
+	},
+	/* run with all the methods available on the given CPU in turn. */
+	{
+		.name = "all",
+		.alg = RTE_ACL_CLASSIFY_NUM,
+	},
 };
 
 static struct {
@@ -98,6 +111,7 @@ static struct {
 	uint32_t            verbose;
 	uint32_t            ipv6;
 	struct acl_alg      alg;
+	uint32_t            alg_mask;
 	uint32_t            used_traces;
 	void               *traces;
 	struct rte_acl_ctx *acx;
@@ -757,6 +771,7 @@ static void
 acx_init(void)
 {
 	int ret;
+	uint32_t i;
 	FILE *f;
 	struct rte_acl_config cfg;
 
@@ -781,8 +796,18 @@ acx_init(void)
 	if (config.acx == NULL)
 		rte_exit(rte_errno, "failed to create ACL context\n");
 
+	/* find out which classify methods can be used for this context. */
+	if (config.alg.alg == RTE_ACL_CLASSIFY_NUM) {
+		for (i = 0; i != RTE_DIM(acl_alg); i++) {
+			if (rte_acl_set_ctx_classify(config.acx,
+					acl_alg[i].alg) == 0)
+				config.alg_mask |= 1 << i;
+		}
+		rte_acl_set_ctx_classify(config.acx,
+			RTE_ACL_CLASSIFY_DEFAULT);
+
 	/* set default classify method for this context. */
-	if (config.alg.alg != RTE_ACL_CLASSIFY_DEFAULT) {
+	} else if (config.alg.alg != RTE_ACL_CLASSIFY_DEFAULT) {
 		ret = rte_acl_set_ctx_classify(config.acx, config.alg.alg);
 		if (ret != 0)
 			rte_exit(ret, "failed to setup %s method "
@@ -815,7 +840,8 @@ acx_init(void)
 }
 
 static uint32_t
-search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
+search_ip5tuples_once(uint32_t categories, uint32_t step,
+	const struct acl_alg *alg)
 {
 	int ret;
 	uint32_t i, j, k, n, r;
@@ -832,8 +858,12 @@ search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
 			v += config.trace_sz;
 		}
 
-		ret = rte_acl_classify(config.acx, data, results,
-			n, categories);
+		if (alg->alg == RTE_ACL_CLASSIFY_DEFAULT)
+			ret = rte_acl_classify(config.acx, data, results,
+				n, categories);
+		else
+			ret = rte_acl_classify_alg(config.acx, data, results,
+				n, categories, alg->alg);
 
 		if (ret != 0)
 			rte_exit(ret, "classify for ipv%c_5tuples returns %d\n",
@@ -853,12 +883,12 @@ search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
 
 	dump_verbose(DUMP_SEARCH, stdout,
 		"%s(%u, %u, %s) returns %u\n", __func__,
-		categories, step, alg, i);
+		categories, step, alg->name, i);
 	return i;
 }
 
-static int
-search_ip5tuples(__attribute__((unused)) void *arg)
+static void
+search_ip5tuples_alg(const struct acl_alg *alg)
 {
 	uint64_t pkt, start, tm;
 	uint32_t i, lcore;
@@ -869,15 +899,33 @@ search_ip5tuples(__attribute__((unused)) void *arg)
 
 	for (i = 0; i != config.iter_num; i++) {
 		pkt += search_ip5tuples_once(config.run_categories,
-			config.trace_step, config.alg.name);
+			config.trace_step, alg);
 	}
 
 	tm = rte_rdtsc() - start;
 	dump_verbose(DUMP_NONE, stdout,
-		"%s  @lcore %u: %" PRIu32 " iterations, %" PRIu64 " pkts, %"
-		PRIu32 " categories, %" PRIu64 " cycles, %#Lf cycles/pkt\n",
-		__func__, lcore, i, pkt, config.run_categories,
+		"%s(%s)  @lcore %u: %" PRIu32 " iterations, %" PRIu64
+		" pkts, %" PRIu32 " categories, %" PRIu64
+		" cycles, %#Lf cycles/pkt\n",
+		__func__, alg->name, lcore, i, pkt, config.run_categories,
 		tm, (pkt == 0) ? 0 : (long double)tm / pkt);
+}
+
+static int
+search_ip5tuples(__attribute__((unused)) void *arg)
+{
+	uint32_t i;
+
+	if (config.alg.alg != RTE_ACL_CLASSIFY_NUM) {
+		search_ip5tuples_alg(&config.alg);
+		return 0;
+	}
+
+	/* measure each of the available classify methods in turn. */
+	for (i = 0; i != RTE_DIM(acl_alg); i++) {
+		if ((config.alg_mask & (1 << i)) != 0)
+			search_ip5tuples_alg(&acl_alg[i]);
+	}
 
 	return 0;
 }
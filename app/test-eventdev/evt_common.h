@@ -69,6 +69,9 @@ struct evt_options {
 	enum evt_prod_type prod_type;
 	uint8_t timdev_use_burst;
 	uint8_t timdev_cnt;
+	uint8_t ena_vector;
+	uint16_t vector_size;
+	uint64_t vector_tmo_nsec;
 };
 
 static inline bool
@@ -190,6 +190,12 @@ pipeline_ethdev_setup(struct evt_test *test, struct evt_options *opt)
 		rte_event_eth_tx_adapter_caps_get(opt->dev_id, i, &caps);
 		if (!(caps & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT))
 			t->internal_port = 0;
+		else if (opt->ena_vector &&
+			 !(caps & RTE_EVENT_ETH_TX_ADAPTER_CAP_EVENT_VECTOR)) {
+			evt_err("Tx adapter of eth port [%d] does not support"
+				" event vectors", i);
+			return -ENOTSUP;
+		}
 
 		rte_eth_dev_info_get(i, &dev_info);
 		rx_conf = dev_info.default_rxconf;
@@ -270,16 +276,25 @@ pipeline_event_port_setup(struct evt_test *test, struct evt_options *opt,
 }
 
 int
-pipeline_event_rx_adapter_setup(struct evt_options *opt, uint8_t stride,
+pipeline_event_rx_adapter_setup(struct evt_test *test,
+		struct evt_options *opt, uint8_t stride,
 		struct rte_event_port_conf prod_conf)
 {
 	int ret = 0;
 	uint16_t prod;
+	struct test_pipeline *t = evt_test_priv(test);
 	struct rte_event_eth_rx_adapter_queue_conf queue_conf;
 
 	memset(&queue_conf, 0,
 			sizeof(struct rte_event_eth_rx_adapter_queue_conf));
 	queue_conf.ev.sched_type = opt->sched_type_list[0];
+	if (opt->ena_vector) {
+		queue_conf.rx_queue_flags |=
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+		queue_conf.vector_sz = opt->vector_size;
+		queue_conf.vector_timeout_ns = opt->vector_tmo_nsec;
+		queue_conf.vector_mp = t->vector_pool;
+	}
 	RTE_ETH_FOREACH_DEV(prod) {
 		uint32_t cap;
 
@@ -417,6 +432,21 @@ pipeline_mempool_setup(struct evt_test *test, struct evt_options *opt)
 		return -ENOMEM;
 	}
 
+	if (opt->ena_vector) {
+		char name[RTE_MEMPOOL_NAMESIZE];
+
+		snprintf(name, sizeof(name), "%s_vector", test->name);
+		/* Each vector holds at least one mbuf */
+		t->vector_pool = rte_event_vector_pool_create(name,
+				opt->pool_sz, 0, opt->vector_size,
+				opt->socket_id);
+		if (t->vector_pool == NULL) {
+			evt_err("failed to create event vector pool");
+			rte_mempool_free(t->pool);
+			return -ENOMEM;
+		}
+	}
+
 	return 0;
 }
 
@@ -427,6 +457,7 @@ pipeline_mempool_destroy(struct evt_test *test, struct evt_options *opt)
 	struct test_pipeline *t = evt_test_priv(test);
 
 	rte_mempool_free(t->pool);
+	rte_mempool_free(t->vector_pool);
 }
 
 int
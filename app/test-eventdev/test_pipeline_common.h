@@ -48,6 +48,7 @@ struct test_pipeline {
 	uint32_t nb_flows;
 	uint64_t outstand_pkts;
 	struct rte_mempool *pool;
+	struct rte_mempool *vector_pool;
 	struct worker_data worker[EVT_MAX_PORTS];
 	struct evt_options *opt;
 	uint8_t sched_type_list[EVT_MAX_STAGES] __rte_cache_aligned;
@@ -101,6 +102,14 @@ pipeline_fwd_event(struct rte_event *ev, uint8_t sched)
 	ev->sched_type = sched;
 }
 
+static __rte_always_inline void
+pipeline_fwd_event_vector(struct rte_event *ev, uint8_t sched)
+{
+	ev->event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+	ev->op = RTE_EVENT_OP_FORWARD;
+	ev->sched_type = sched;
+}
+
 static __rte_always_inline void
 pipeline_event_tx(const uint8_t dev, const uint8_t port,
 		struct rte_event * const ev)
@@ -110,6 +119,15 @@ pipeline_event_tx(const uint8_t dev, const uint8_t port,
 		rte_pause();
 }
 
+static __rte_always_inline void
+pipeline_event_tx_vector(const uint8_t dev, const uint8_t port,
+		struct rte_event * const ev)
+{
+	ev->vec->queue = 0;
+	while (!rte_event_eth_tx_adapter_enqueue(dev, port, ev, 1))
+		rte_pause();
+}
+
 static __rte_always_inline void
 pipeline_event_tx_burst(const uint8_t dev, const uint8_t port,
 		struct rte_event *ev, const uint16_t nb_rx)
@@ -154,7 +172,8 @@ int pipeline_test_result(struct evt_test *test, struct evt_options *opt);
 int pipeline_opt_check(struct evt_options *opt, uint64_t nb_queues);
 int pipeline_test_setup(struct evt_test *test, struct evt_options *opt);
 int pipeline_ethdev_setup(struct evt_test *test, struct evt_options *opt);
-int pipeline_event_rx_adapter_setup(struct evt_options *opt, uint8_t stride,
+int pipeline_event_rx_adapter_setup(struct evt_test *test,
+		struct evt_options *opt, uint8_t stride,
 		struct rte_event_port_conf prod_conf);
 int pipeline_event_tx_adapter_setup(struct evt_options *opt,
 		struct rte_event_port_conf prod_conf);
@@ -110,6 +110,30 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "RIB autotest",
+        "Command": "rib_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
+    {
+        "Name":    "RIB6 autotest",
+        "Command": "rib6_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
+    {
+        "Name":    "FIB autotest",
+        "Command": "fib_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
+    {
+        "Name":    "FIB6 autotest",
+        "Command": "fib6_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Memcpy autotest",
         "Command": "memcpy_autotest",
@@ -140,6 +164,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Malloc lcore cache autotest",
+        "Command": "malloc_lcore_cache_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Multi-process autotest",
         "Command": "multiprocess_autotest",
@@ -326,6 +356,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Checksum autotest",
+        "Command": "cksum_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Crc autotest",
         "Command": "crc_autotest",
@@ -374,6 +410,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Timer wheel autotest",
+        "Command": "timer_wheel_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Member autotest",
         "Command": "member_autotest",
@@ -500,6 +542,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Telemetry autotest",
+        "Command": "telemetry_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Bitratestats autotest",
         "Command": "bitratestats_autotest",
@@ -603,6 +651,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Checksum performance autotest",
+        "Command": "cksum_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Hash performance autotest",
         "Command": "hash_perf_autotest",
@@ -682,6 +736,18 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "FIB perf autotest",
+        "Command": "fib_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
+    {
+        "Name":    "FIB6 perf autotest",
+        "Command": "fib6_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
          "Name":    "Efd perf autotest",
          "Command": "efd_perf_autotest",
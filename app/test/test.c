@@ -52,6 +52,7 @@ do_recursive_call(void)
 		int (*action_fn)(void);
 	} actions[] =  {
 			{ "run_secondary_instances", test_mp_secondary },
+			{ "malloc_lcore_cache_spawn", test_malloc_lcore_cache },
 #ifdef RTE_LIBRTE_PDUMP
 			{ "run_pdump_server_tests", test_pdump },
 #endif
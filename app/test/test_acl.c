@@ -12,7 +12,10 @@
 #include <rte_byteorder.h>
 #include <rte_ip.h>
 #include <rte_acl.h>
+#include <rte_acl_incr.h>
 #include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test_acl.h"
 
@@ -266,22 +269,15 @@ rte_acl_ipv4vlan_build(struct rte_acl_ctx *ctx,
 }
 
 /*
- * Test scalar and SSE ACL lookup.
+ * Run ACL lookup with the context default classify method
+ * for all possible numbers of packets.
  */
 static int
-test_classify_run(struct rte_acl_ctx *acx)
+test_classify_alg(struct rte_acl_ctx *acx, const uint8_t *data[],
+	uint32_t results[], int alg)
 {
 	int ret, i;
 	uint32_t result, count;
-	uint32_t results[RTE_DIM(acl_test_data) * RTE_ACL_MAX_CATEGORIES];
-	const uint8_t *data[RTE_DIM(acl_test_data)];
-
-	/* swap all bytes in the data to network order */
-	bswap_test_data(acl_test_data, RTE_DIM(acl_test_data), 1);
-
-	/* store pointers to test data */
-	for (i = 0; i < (int) RTE_DIM(acl_test_data); i++)
-		data[i] = (uint8_t *)&acl_test_data[i];
 
 	/**
 	 * these will run quite a few times, it's necessary to test code paths
@@ -291,8 +287,9 @@ test_classify_run(struct rte_acl_ctx *acx)
 		ret = rte_acl_classify(acx, data, results,
 				count, RTE_ACL_MAX_CATEGORIES);
 		if (ret != 0) {
-			printf("Line %i: SSE classify failed!\n", __LINE__);
-			goto err;
+			printf("Line %i: classify with alg %d failed!\n",
+				__LINE__, alg);
+			return ret;
 		}
 
 		/* check if we allow everything we should allow */
@@ -304,8 +301,7 @@ test_classify_run(struct rte_acl_ctx *acx)
 					"(expected %"PRIu32" got %"PRIu32")!\n",
 					__LINE__, i, acl_test_data[i].allow,
 					result);
-				ret = -EINVAL;
-				goto err;
+				return -EINVAL;
 			}
 		}
 
@@ -317,12 +313,67 @@ test_classify_run(struct rte_acl_ctx *acx)
 					"(expected %"PRIu32" got %"PRIu32")!\n",
 					__LINE__, i, acl_test_data[i].deny,
 					result);
-				ret = -EINVAL;
-				goto err;
+				return -EINVAL;
 			}
 		}
 	}
 
+	return 0;
+}
+
+/*
+ * Test all available ACL lookup methods.
+ */
+static int
+test_classify_run(struct rte_acl_ctx *acx)
+{
+	static const enum rte_acl_classify_alg classify_algs[] = {
+		RTE_ACL_CLASSIFY_DEFAULT,
+		RTE_ACL_CLASSIFY_SCALAR,
+		RTE_ACL_CLASSIFY_SSE,
+		RTE_ACL_CLASSIFY_AVX2,
+		RTE_ACL_CLASSIFY_NEON,
+		RTE_ACL_CLASSIFY_ALTIVEC,
+		RTE_ACL_CLASSIFY_AVX512X16,
+		RTE_ACL_CLASSIFY_AVX512X32,
+	};
+	int ret, i;
+	uint32_t alg, result;
+	uint32_t results[RTE_DIM(acl_test_data) * RTE_ACL_MAX_CATEGORIES];
+	const uint8_t *data[RTE_DIM(acl_test_data)];
+
+	/* swap all bytes in the data to network order */
+	bswap_test_data(acl_test_data, RTE_DIM(acl_test_data), 1);
+
+	/* store pointers to test data */
+	for (i = 0; i < (int) RTE_DIM(acl_test_data); i++)
+		data[i] = (uint8_t *)&acl_test_data[i];
+
+	/* check all the classify methods available on this machine */
+	for (alg = 0; alg != RTE_DIM(classify_algs); alg++) {
+		ret = rte_acl_set_ctx_classify(acx, classify_algs[alg]);
+		if (ret == -ENOTSUP)
+			continue;
+		if (ret != 0) {
+			printf("Line %i: setting classify alg %d failed!\n",
+				__LINE__, classify_algs[alg]);
+			goto err;
+		}
+
+		ret = test_classify_alg(acx, data, results,
+			classify_algs[alg]);
+		if (ret != 0)
+			goto err;
+	}
+
+	/* restore the default classify method */
+	ret = rte_acl_set_ctx_classify(acx, RTE_ACL_CLASSIFY_DEFAULT);
+	if (ret != 0) {
+		printf("Line %i: restoring default classify alg failed!\n",
+			__LINE__);
+		goto err;
+	}
+
 	/* make a quick check for scalar */
 	ret = rte_acl_classify_alg(acx, data, results,
 			RTE_DIM(acl_test_data), RTE_ACL_MAX_CATEGORIES,
@@ -1569,6 +1620,253 @@ test_invalid_parameters(void)
 	return 0;
 }
 
+/*
+ * Compare the results of the incremental ACL with the ones of
+ * an ACL context built over the same live rules.
+ */
+static int
+test_incr_check(const struct rte_acl_incr *ai,
+	const struct acl_ipv4vlan_rule *rules, const uint8_t *live,
+	uint32_t num, const uint8_t *data[])
+{
+	int ret;
+	uint32_t i, n;
+	struct rte_acl_ctx *acx;
+	uint32_t exp[RTE_DIM(acl_test_data) * RTE_ACL_MAX_CATEGORIES];
+	uint32_t res[RTE_DIM(acl_test_data) * RTE_ACL_MAX_CATEGORIES];
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	ret = 0;
+	for (i = 0, n = 0; i != num && ret == 0; i++) {
+		if (live[i] != 0) {
+			ret = rte_acl_add_rules(acx,
+				(const struct rte_acl_rule *)(rules + i), 1);
+			n++;
+		}
+	}
+
+	/* empty context can't be built, nothing matches then. */
+	if (n == 0)
+		memset(exp, 0, sizeof(exp));
+	else if (ret == 0)
+		ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+			RTE_ACL_MAX_CATEGORIES);
+	if (n != 0 && ret == 0)
+		ret = rte_acl_classify(acx, data, exp, RTE_DIM(acl_test_data),
+			RTE_ACL_MAX_CATEGORIES);
+	rte_acl_free(acx);
+
+	if (ret != 0) {
+		printf("Line %i: reference ACL context failed: %d!\n",
+			__LINE__, ret);
+		return -1;
+	}
+
+	ret = rte_acl_incr_classify(ai, data, res, RTE_DIM(acl_test_data),
+		RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: incremental classify failed: %d!\n",
+			__LINE__, ret);
+		return -1;
+	}
+
+	for (i = 0; i != RTE_DIM(res); i++) {
+		if (res[i] != exp[i]) {
+			printf("Line %i: Error in results at %u/%u "
+				"(expected %u got %u)!\n",
+				__LINE__, i / RTE_ACL_MAX_CATEGORIES,
+				i % RTE_ACL_MAX_CATEGORIES, exp[i], res[i]);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Test incremental ACL: rules added to the main and delta tries,
+ * rules deleted from both of them, and merges.
+ */
+static int
+test_incr(void)
+{
+	static struct acl_ipv4vlan_rule rules[RTE_DIM(acl_test_rules)];
+	const uint32_t num = RTE_DIM(rules);
+	const uint32_t half = num / 2;
+	struct rte_acl_config cfg;
+	struct rte_acl_incr_param prm;
+	struct rte_acl_incr *ai;
+	struct rte_rcu_qsbr *v;
+	uint8_t live[RTE_DIM(rules)];
+	const uint8_t *data[RTE_DIM(acl_test_data)];
+	uint32_t i;
+	int ret;
+
+	/* unique priorities, so results don't depend on the tie breaks. */
+	for (i = 0; i != num; i++) {
+		acl_ipv4vlan_convert_rule(acl_test_rules + i, rules + i);
+		rules[i].data.priority = i + 1;
+	}
+	memset(live, 0, sizeof(live));
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+
+	v = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+		RTE_CACHE_LINE_SIZE);
+	if (v == NULL || rte_rcu_qsbr_init(v, RTE_MAX_LCORE) != 0) {
+		printf("Line %i: Error creating RCU QSBR variable!\n",
+			__LINE__);
+		rte_free(v);
+		return -1;
+	}
+
+	memset(&prm, 0, sizeof(prm));
+	prm.name = "acl_incr";
+	prm.socket_id = SOCKET_ID_ANY;
+	prm.rule_size = RTE_ACL_IPV4VLAN_RULE_SZ;
+	prm.max_rule_num = num;
+	prm.max_delta_num = num - half;
+	prm.cfg = &cfg;
+	prm.v = v;
+
+	/* invalid parameters */
+	prm.max_delta_num = num + 1;
+	ai = rte_acl_incr_create(&prm);
+	if (ai != NULL) {
+		printf("Line %i: created with too large delta!\n", __LINE__);
+		rte_acl_incr_free(ai);
+		rte_free(v);
+		return -1;
+	}
+	prm.max_delta_num = num - half;
+
+	ai = rte_acl_incr_create(&prm);
+	if (ai == NULL) {
+		printf("Line %i: Error creating incremental ACL!\n", __LINE__);
+		rte_free(v);
+		return -1;
+	}
+
+	/* swap all bytes in the data to network order */
+	bswap_test_data(acl_test_data, RTE_DIM(acl_test_data), 1);
+
+	for (i = 0; i != RTE_DIM(acl_test_data); i++)
+		data[i] = (uint8_t *)&acl_test_data[i];
+
+	/* no rules yet, nothing should match */
+	ret = test_incr_check(ai, rules, live, 0, data);
+	if (ret != 0)
+		goto err;
+
+	/* first half of the rules goes into the main trie */
+	ret = rte_acl_incr_add_rules(ai, (struct rte_acl_rule *)rules, half);
+	if (ret == 0)
+		ret = rte_acl_incr_merge(ai);
+	if (ret != 0) {
+		printf("Line %i: Error adding rules: %d!\n", __LINE__, ret);
+		goto err;
+	}
+	memset(live, 1, half);
+
+	ret = test_incr_check(ai, rules, live, num, data);
+	if (ret != 0)
+		goto err;
+
+	/* second half goes into the delta trie, one by one */
+	for (i = half; i != num; i++) {
+		ret = rte_acl_incr_add_rules(ai,
+			(struct rte_acl_rule *)(rules + i), 1);
+		if (ret != 0) {
+			printf("Line %i: Error adding rule %u: %d!\n",
+				__LINE__, i, ret);
+			goto err;
+		}
+		live[i] = 1;
+	}
+
+	ret = test_incr_check(ai, rules, live, num, data);
+	if (ret != 0)
+		goto err;
+
+	/* delta trie is full */
+	ret = rte_acl_incr_add_rules(ai, (struct rte_acl_rule *)rules, 1);
+	if (ret != -ENOSPC) {
+		printf("Line %i: add to a full delta returned %d!\n",
+			__LINE__, ret);
+		ret = -1;
+		goto err;
+	}
+
+	/* delete every third rule, from both tries */
+	for (i = 0; i < num; i += 3) {
+		ret = rte_acl_incr_del_rules(ai,
+			(struct rte_acl_rule *)(rules + i), 1);
+		if (ret != 0) {
+			printf("Line %i: Error deleting rule %u: %d!\n",
+				__LINE__, i, ret);
+			goto err;
+		}
+		live[i] = 0;
+	}
+
+	ret = test_incr_check(ai, rules, live, num, data);
+	if (ret != 0)
+		goto err;
+
+	/* deleted rule can't be deleted again */
+	ret = rte_acl_incr_del_rules(ai, (struct rte_acl_rule *)rules, 1);
+	if (ret != -ENOENT) {
+		printf("Line %i: delete of a missing rule returned %d!\n",
+			__LINE__, ret);
+		ret = -1;
+		goto err;
+	}
+
+	/* merge everything into the main trie */
+	ret = rte_acl_incr_merge(ai);
+	if (ret != 0 || rte_acl_incr_pending(ai) != 0) {
+		printf("Line %i: Error merging rules: %d, %u pending!\n",
+			__LINE__, ret, rte_acl_incr_pending(ai));
+		ret = -1;
+		goto err;
+	}
+
+	ret = test_incr_check(ai, rules, live, num, data);
+	if (ret != 0)
+		goto err;
+
+	/* add back the deleted rules */
+	for (i = 0; i < num; i += 3) {
+		ret = rte_acl_incr_add_rules(ai,
+			(struct rte_acl_rule *)(rules + i), 1);
+		if (ret != 0) {
+			printf("Line %i: Error adding rule %u: %d!\n",
+				__LINE__, i, ret);
+			goto err;
+		}
+		live[i] = 1;
+	}
+
+	ret = test_incr_check(ai, rules, live, num, data);
+	if (ret == 0)
+		ret = rte_acl_incr_merge(ai);
+	if (ret == 0)
+		ret = test_incr_check(ai, rules, live, num, data);
+
+err:
+	/* swap data back to cpu order so that next time tests don't fail */
+	bswap_test_data(acl_test_data, RTE_DIM(acl_test_data), 0);
+	rte_acl_incr_free(ai);
+	rte_free(v);
+	return ret;
+}
+
 /**
  * Various tests that don't test much but improve coverage
  */
@@ -1616,6 +1914,8 @@ test_acl(void)
 		return -1;
 	if (test_convert() < 0)
 		return -1;
+	if (test_incr() < 0)
+		return -1;
 
 	return 0;
 }
@@ -0,0 +1,348 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_random.h>
+#include <rte_udp.h>
+
+#include "test.h"
+
+#define CKSUM_BUF_SIZE		9216
+#define CKSUM_MAX_OFFSET	8
+/* larger than the size summed by the vector code before folding */
+#define CKSUM_LARGE_BUF_SIZE	(1536 * 1024)
+
+#define CKSUM_NB_MBUF		128
+#define CKSUM_MBUF_DATA_SIZE	2048
+#define CKSUM_ADJUST_LOOPS	1024
+
+static const size_t cksum_sizes[] = {
+	1024, 1025, 1499, 1500, 1514, 2047, 2048, 4095, 4096, 4097,
+	8191, 8192, 9000, 9001, 9215, 9216,
+};
+
+/* IPv4 header with a valid checksum */
+static const uint8_t cksum_ipv4_hdr[] = {
+	0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00,
+	0x40, 0x11, 0xb8, 0x61, 0xc0, 0xa8, 0x00, 0x01,
+	0xc0, 0xa8, 0x00, 0xc7,
+};
+
+/* Reference implementation, summing the buffer one word at a time */
+static uint16_t
+cksum_ref(const uint8_t *buf, size_t len)
+{
+	uint64_t sum = 0;
+	uint16_t w;
+	size_t i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		memcpy(&w, buf + i, sizeof(w));
+		sum += w;
+	}
+	if (len & 1)
+		sum += buf[len - 1];
+
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)sum;
+}
+
+static void
+cksum_fill(uint8_t *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (uint8_t)rte_rand();
+}
+
+static int
+cksum_check(const uint8_t *buf, size_t len)
+{
+	uint16_t ref, res;
+
+	ref = cksum_ref(buf, len);
+	res = rte_raw_cksum(buf, len);
+	if (res != ref) {
+		printf("Error: checksum of %zu bytes at %p is 0x%04x, "
+			"expected 0x%04x\n", len, buf, res, ref);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_cksum_raw(void)
+{
+	uint8_t *buf;
+	size_t len, off, i;
+	int ret = TEST_FAILED;
+
+	buf = rte_malloc(NULL, CKSUM_BUF_SIZE + CKSUM_MAX_OFFSET,
+			RTE_CACHE_LINE_SIZE);
+	TEST_ASSERT_NOT_NULL(buf, "Cannot allocate buffer");
+
+	/* random data, at all lengths and offsets in the small range */
+	cksum_fill(buf, CKSUM_BUF_SIZE + CKSUM_MAX_OFFSET);
+	for (off = 0; off < CKSUM_MAX_OFFSET; off++) {
+		for (len = 0; len < 1024; len++)
+			if (cksum_check(buf + off, len) < 0)
+				goto out;
+		for (i = 0; i < RTE_DIM(cksum_sizes); i++)
+			if (cksum_check(buf + off, cksum_sizes[i]) < 0)
+				goto out;
+	}
+
+	/* data generating a carry on every addition */
+	memset(buf, 0xff, CKSUM_BUF_SIZE + CKSUM_MAX_OFFSET);
+	for (off = 0; off < CKSUM_MAX_OFFSET; off++)
+		for (i = 0; i < RTE_DIM(cksum_sizes); i++)
+			if (cksum_check(buf + off, cksum_sizes[i]) < 0)
+				goto out;
+
+	/* data summing to zero and to a multiple of 0xffff */
+	memset(buf, 0, CKSUM_BUF_SIZE + CKSUM_MAX_OFFSET);
+	if (cksum_check(buf, CKSUM_BUF_SIZE) < 0)
+		goto out;
+	buf[CKSUM_BUF_SIZE / 2] = 0xff;
+	buf[CKSUM_BUF_SIZE / 2 + 1] = 0xff;
+	if (cksum_check(buf, CKSUM_BUF_SIZE) < 0)
+		goto out;
+
+	ret = TEST_SUCCESS;
+out:
+	rte_free(buf);
+	return ret;
+}
+
+static int
+test_cksum_raw_large(void)
+{
+	uint8_t *buf;
+	int ret = TEST_FAILED;
+
+	buf = rte_malloc(NULL, CKSUM_LARGE_BUF_SIZE + 1, RTE_CACHE_LINE_SIZE);
+	TEST_ASSERT_NOT_NULL(buf, "Cannot allocate buffer");
+
+	memset(buf, 0xff, CKSUM_LARGE_BUF_SIZE + 1);
+	if (cksum_check(buf, CKSUM_LARGE_BUF_SIZE) < 0 ||
+			cksum_check(buf + 1, CKSUM_LARGE_BUF_SIZE) < 0)
+		goto out;
+
+	cksum_fill(buf, CKSUM_LARGE_BUF_SIZE + 1);
+	if (cksum_check(buf, CKSUM_LARGE_BUF_SIZE) < 0 ||
+			cksum_check(buf + 1, CKSUM_LARGE_BUF_SIZE) < 0)
+		goto out;
+
+	ret = TEST_SUCCESS;
+out:
+	rte_free(buf);
+	return ret;
+}
+
+/* Build a chain of segments of random lengths holding the given data */
+static struct rte_mbuf *
+cksum_build_mbuf(struct rte_mempool *mp, const uint8_t *data, uint32_t len)
+{
+	struct rte_mbuf *m = NULL, *seg;
+	uint32_t seglen, done = 0;
+	char *p;
+
+	while (done < len) {
+		seg = rte_pktmbuf_alloc(mp);
+		if (seg == NULL)
+			goto fail;
+		seglen = rte_rand() % CKSUM_MBUF_DATA_SIZE + 1;
+		seglen = RTE_MIN(seglen, len - done);
+		p = rte_pktmbuf_append(seg, seglen);
+		if (p == NULL) {
+			rte_pktmbuf_free(seg);
+			goto fail;
+		}
+		memcpy(p, data + done, seglen);
+		done += seglen;
+		if (m == NULL)
+			m = seg;
+		else if (rte_pktmbuf_chain(m, seg) < 0) {
+			rte_pktmbuf_free(seg);
+			goto fail;
+		}
+	}
+
+	return m;
+fail:
+	rte_pktmbuf_free(m);
+	return NULL;
+}
+
+static int
+test_cksum_mbuf(void)
+{
+	static const uint32_t pkt_sizes[] = { 64, 1500, 4097, 9000 };
+	struct rte_mempool *mp;
+	struct rte_mbuf *m;
+	uint8_t *buf;
+	uint32_t len, off;
+	uint16_t ref, res = 0;
+	unsigned int i, j;
+	int ret = TEST_FAILED;
+
+	mp = rte_pktmbuf_pool_create("test_cksum_pool", CKSUM_NB_MBUF, 0, 0,
+			CKSUM_MBUF_DATA_SIZE + RTE_PKTMBUF_HEADROOM,
+			SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(mp, "Cannot create mbuf pool");
+
+	buf = rte_malloc(NULL, CKSUM_BUF_SIZE, 0);
+	if (buf == NULL) {
+		printf("Error: cannot allocate buffer\n");
+		goto out_pool;
+	}
+	cksum_fill(buf, CKSUM_BUF_SIZE);
+
+	for (i = 0; i < RTE_DIM(pkt_sizes); i++) {
+		for (j = 0; j < 16; j++) {
+			len = pkt_sizes[i];
+			m = cksum_build_mbuf(mp, buf, len);
+			if (m == NULL) {
+				printf("Error: cannot build mbuf\n");
+				goto out;
+			}
+
+			/* odd and even offsets and lengths */
+			off = rte_rand() % (len / 2);
+			len = len - off - rte_rand() % (len / 4);
+
+			ref = cksum_ref(buf + off, len);
+			if (rte_raw_cksum_mbuf(m, off, len, &res) < 0 ||
+					res != ref) {
+				printf("Error: checksum of %u bytes at offset "
+					"%u in %u segments is 0x%04x, "
+					"expected 0x%04x\n", len, off,
+					m->nb_segs, res, ref);
+				rte_pktmbuf_free(m);
+				goto out;
+			}
+
+			/* out of the packet */
+			if (rte_raw_cksum_mbuf(m, off, m->pkt_len - off + 1,
+					&res) == 0) {
+				printf("Error: checksum beyond the packet\n");
+				rte_pktmbuf_free(m);
+				goto out;
+			}
+			rte_pktmbuf_free(m);
+		}
+	}
+
+	ret = TEST_SUCCESS;
+out:
+	rte_free(buf);
+out_pool:
+	rte_mempool_free(mp);
+	return ret;
+}
+
+static int
+test_cksum_ipv4(void)
+{
+	struct rte_ipv4_hdr hdr;
+	uint16_t cksum;
+
+	memcpy(&hdr, cksum_ipv4_hdr, sizeof(hdr));
+	TEST_ASSERT_EQUAL(rte_raw_cksum(&hdr, sizeof(hdr)), 0xffff,
+		"Invalid checksum of a valid header");
+
+	cksum = hdr.hdr_checksum;
+	hdr.hdr_checksum = 0;
+	TEST_ASSERT_EQUAL(rte_ipv4_cksum(&hdr), cksum,
+		"Invalid IPv4 header checksum");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_cksum_adjust(void)
+{
+	struct {
+		struct rte_ipv4_hdr ip;
+		struct rte_udp_hdr udp;
+		uint8_t payload[64];
+	} pkt;
+	uint32_t old_addr, new_addr;
+	uint16_t old_port, new_port, cksum;
+	unsigned int i;
+
+	memcpy(&pkt.ip, cksum_ipv4_hdr, sizeof(pkt.ip));
+	pkt.ip.total_length = rte_cpu_to_be_16(sizeof(pkt));
+	pkt.udp.src_port = rte_cpu_to_be_16(1024);
+	pkt.udp.dst_port = rte_cpu_to_be_16(53);
+	pkt.udp.dgram_len = rte_cpu_to_be_16(sizeof(pkt) - sizeof(pkt.ip));
+	cksum_fill(pkt.payload, sizeof(pkt.payload));
+
+	pkt.ip.hdr_checksum = 0;
+	pkt.ip.hdr_checksum = rte_ipv4_cksum(&pkt.ip);
+	pkt.udp.dgram_cksum = 0;
+	pkt.udp.dgram_cksum = rte_ipv4_udptcp_cksum(&pkt.ip, &pkt.udp);
+
+	for (i = 0; i < CKSUM_ADJUST_LOOPS; i++) {
+		/* rewrite the source address and port, as done by a NAT */
+		old_addr = pkt.ip.src_addr;
+		new_addr = (uint32_t)rte_rand();
+		old_port = pkt.udp.src_port;
+		new_port = (uint16_t)rte_rand();
+
+		pkt.ip.src_addr = new_addr;
+		pkt.ip.hdr_checksum = rte_cksum_adjust32(pkt.ip.hdr_checksum,
+			old_addr, new_addr);
+
+		pkt.udp.src_port = new_port;
+		cksum = rte_cksum_adjust32(pkt.udp.dgram_cksum,
+			old_addr, new_addr);
+		cksum = rte_cksum_adjust16(cksum, old_port, new_port);
+		if (cksum == 0)
+			cksum = 0xffff;
+		pkt.udp.dgram_cksum = cksum;
+
+		TEST_ASSERT_EQUAL(rte_raw_cksum(&pkt.ip, sizeof(pkt.ip)),
+			0xffff, "Invalid IPv4 checksum after update");
+
+		pkt.udp.dgram_cksum = 0;
+		TEST_ASSERT_EQUAL(rte_ipv4_udptcp_cksum(&pkt.ip, &pkt.udp),
+			cksum, "Invalid UDP checksum after update");
+		pkt.udp.dgram_cksum = cksum;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite cksum_tests = {
+	.suite_name = "checksum autotest",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_cksum_raw),
+		TEST_CASE(test_cksum_raw_large),
+		TEST_CASE(test_cksum_mbuf),
+		TEST_CASE(test_cksum_ipv4),
+		TEST_CASE(test_cksum_adjust),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_cksum(void)
+{
+	return unit_test_suite_runner(&cksum_tests);
+}
+
+REGISTER_TEST_COMMAND(cksum_autotest, test_cksum);
@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+#define CKSUM_PERF_BUF_SIZE	9216
+#define CKSUM_PERF_ITERATIONS	100000
+
+static const size_t cksum_perf_sizes[] = {
+	20, 64, 128, 256, 512, 1024, 1500, 2048, 4096, 9000,
+};
+
+static volatile uint16_t cksum_perf_sink;
+
+/* Sum of the buffer one word at a time, as done without vector support */
+static inline uint16_t
+cksum_perf_scalar(const void *buf, size_t len)
+{
+	typedef uint16_t __attribute__((__may_alias__)) u16_p;
+	const u16_p *u16_buf = (const u16_p *)buf;
+	uint32_t sum = 0;
+
+	while (len >= (sizeof(*u16_buf) * 4)) {
+		sum += u16_buf[0];
+		sum += u16_buf[1];
+		sum += u16_buf[2];
+		sum += u16_buf[3];
+		len -= sizeof(*u16_buf) * 4;
+		u16_buf += 4;
+	}
+	while (len >= sizeof(*u16_buf)) {
+		sum += *u16_buf;
+		len -= sizeof(*u16_buf);
+		u16_buf += 1;
+	}
+	if (len == 1)
+		sum += *((const uint8_t *)u16_buf);
+
+	return __rte_raw_cksum_reduce(sum);
+}
+
+static void
+cksum_perf_size(const uint8_t *buf, size_t len)
+{
+	uint64_t start, scalar, vec;
+	unsigned int i;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < CKSUM_PERF_ITERATIONS; i++)
+		cksum_perf_sink = cksum_perf_scalar(buf, len);
+	scalar = rte_rdtsc_precise() - start;
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < CKSUM_PERF_ITERATIONS; i++)
+		cksum_perf_sink = rte_raw_cksum(buf, len);
+	vec = rte_rdtsc_precise() - start;
+
+	printf("%5zu %9s %10.1f %10.1f %8.2f\n", len,
+		((uintptr_t)buf & 1) ? "unaligned" : "aligned",
+		(double)scalar / CKSUM_PERF_ITERATIONS,
+		(double)vec / CKSUM_PERF_ITERATIONS,
+		vec ? (double)scalar / vec : 0);
+}
+
+static int
+test_cksum_perf(void)
+{
+	uint8_t *buf;
+	unsigned int i;
+
+	buf = rte_malloc(NULL, CKSUM_PERF_BUF_SIZE + 1, RTE_CACHE_LINE_SIZE);
+	TEST_ASSERT_NOT_NULL(buf, "Cannot allocate buffer");
+
+	for (i = 0; i < CKSUM_PERF_BUF_SIZE + 1; i++)
+		buf[i] = (uint8_t)rte_rand();
+
+	printf("\n%5s %9s %10s %10s %8s\n", "size", "alignment",
+		"scalar", "raw_cksum", "speedup");
+	printf("(cycles per checksum, data in cache)\n");
+	for (i = 0; i < RTE_DIM(cksum_perf_sizes); i++) {
+		cksum_perf_size(buf, cksum_perf_sizes[i]);
+		cksum_perf_size(buf + 1, cksum_perf_sizes[i]);
+	}
+
+	rte_free(buf);
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(cksum_perf_autotest, test_cksum_perf);
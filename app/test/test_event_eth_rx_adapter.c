@@ -452,6 +452,79 @@ adapter_queue_add_del(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_queue_event_vector_add_del(void)
+{
+	int err;
+	struct rte_event ev;
+	struct rte_mempool *vector_mp;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+
+	if ((default_params.caps &
+		RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) &&
+	    !(default_params.caps &
+		RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR))
+		return TEST_SKIPPED;
+
+	vector_mp = rte_event_vector_pool_create("test_vector_pool", 1024, 0,
+						 32, rte_socket_id());
+	TEST_ASSERT(vector_mp != NULL, "Failed to create vector pool");
+	TEST_ASSERT(rte_event_vector_pool_elem_max(vector_mp) == 32,
+		    "Expected 32 got %u",
+		    rte_event_vector_pool_elem_max(vector_mp));
+	TEST_ASSERT(rte_event_vector_pool_elem_max(default_params.mp) == 0,
+		    "mbuf pool reported as a vector pool");
+
+	memset(&ev, 0, sizeof(ev));
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+
+	memset(&queue_config, 0, sizeof(queue_config));
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+	queue_config.vector_sz = 32;
+	queue_config.vector_timeout_ns = 100000;
+
+	/* missing vector pool */
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	/* vector larger than the pool elements */
+	queue_config.vector_mp = vector_mp;
+	queue_config.vector_sz = 64;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	queue_config.vector_sz = 32;
+	queue_config.vector_timeout_ns = 0;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	queue_config.vector_timeout_ns = 100000;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_stop(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(vector_mp);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_multi_eth_add_del(void)
 {
@@ -678,6 +751,8 @@ static struct unit_test_suite event_eth_rx_tests = {
 		TEST_CASE_ST(NULL, NULL, adapter_create_free),
 		TEST_CASE_ST(adapter_create, adapter_free,
 					adapter_queue_add_del),
+		TEST_CASE_ST(adapter_create, adapter_free,
+					adapter_queue_event_vector_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free,
 					adapter_multi_eth_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_start_stop),
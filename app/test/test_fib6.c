@@ -0,0 +1,650 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_memory.h>
+#include <rte_random.h>
+#include <rte_fib6.h>
+
+#include "test.h"
+
+static int32_t test_create_invalid(void);
+static int32_t test_multiple_create(void);
+static int32_t test_free_null(void);
+static int32_t test_add_del_invalid(void);
+static int32_t test_get_invalid(void);
+static int32_t test_lookup(void);
+static int32_t test_lookup_random(void);
+
+#define MAX_ROUTES	(1 << 16)
+/** Maximum number of tbl8 for 2-byte entries */
+#define MAX_TBL8	(1 << 15)
+
+#define NB_RND_ROUTES	512
+#define NB_RND_IPS	4096
+#define NB_IPS		(NB_RND_IPS + NB_RND_ROUTES * 4)
+
+/* Part of the prefix mask of a given depth falling into a given byte */
+static inline uint8_t
+get_msk_part(uint8_t depth, int byte)
+{
+	uint8_t part;
+
+	part = RTE_MAX((int16_t)depth - (byte * 8), 0);
+	part = (part > 8) ? 8 : part;
+	return (uint16_t)(~UINT8_MAX) >> part;
+}
+
+/*
+ * Check that rte_fib6_create fails gracefully for incorrect user input
+ * arguments
+ */
+int32_t
+test_create_invalid(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_DUMMY;
+
+	/* rte_fib6_create: fib name == NULL */
+	fib = rte_fib6_create(NULL, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	/* rte_fib6_create: config == NULL */
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, NULL);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	/* socket_id < -1 is invalid */
+	fib = rte_fib6_create(__func__, -2, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	/* rte_fib6_create: max_routes = 0 */
+	config.max_routes = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+	config.max_routes = MAX_ROUTES;
+
+	config.type = RTE_FIB6_TYPE_MAX;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	config.type = RTE_FIB6_TRIE;
+	config.trie.num_tbl8 = MAX_TBL8;
+
+	config.trie.nh_sz = RTE_FIB6_TRIE_8B + 1;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+	config.trie.nh_sz = RTE_FIB6_TRIE_8B;
+
+	config.trie.num_tbl8 = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	/* 2 byte entries can not index more than 32767 tbl8 groups */
+	config.trie.nh_sz = RTE_FIB6_TRIE_2B;
+	config.trie.num_tbl8 = MAX_TBL8;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	/* default next hop does not fit into the entry */
+	config.trie.num_tbl8 = 1;
+	config.default_nh = UINT16_MAX;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Create fib table then delete fib table 10 times
+ * Use a slightly different rules size each time
+ */
+int32_t
+test_multiple_create(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	int32_t i;
+
+	config.default_nh = 0;
+	config.type = RTE_FIB6_DUMMY;
+
+	for (i = 0; i < 10; i++) {
+		config.max_routes = MAX_ROUTES - i;
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+		rte_fib6_free(fib);
+	}
+	/* Can not test free so return success */
+	return TEST_SUCCESS;
+}
+
+/*
+ * Call rte_fib6_free for NULL pointer user input. Note: free has no return and
+ * therefore it is impossible to check for failure but this test is added to
+ * increase function coverage metrics and to validate that freeing null does
+ * not crash.
+ */
+int32_t
+test_free_null(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_DUMMY;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	rte_fib6_free(fib);
+	rte_fib6_free(NULL);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that rte_fib6_add and rte_fib6_delete fails gracefully
+ * for incorrect user input arguments
+ */
+int32_t
+test_add_del_invalid(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	uint64_t nh = 100;
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	int ret;
+	uint8_t depth = 24;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_DUMMY;
+
+	/* rte_fib6_add: fib == NULL */
+	ret = rte_fib6_add(NULL, ip, depth, nh);
+	RTE_TEST_ASSERT(ret < 0,
+		"Call succeeded with invalid parameters\n");
+
+	/* rte_fib6_delete: fib == NULL */
+	ret = rte_fib6_delete(NULL, ip, depth);
+	RTE_TEST_ASSERT(ret < 0,
+		"Call succeeded with invalid parameters\n");
+
+	/*Create valid fib to use in rest of test. */
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* rte_fib6_add: depth > RTE_FIB6_MAXDEPTH */
+	ret = rte_fib6_add(fib, ip, RTE_FIB6_MAXDEPTH + 1, nh);
+	RTE_TEST_ASSERT(ret < 0,
+		"Call succeeded with invalid parameters\n");
+
+	/* rte_fib6_delete: depth > RTE_FIB6_MAXDEPTH */
+	ret = rte_fib6_delete(fib, ip, RTE_FIB6_MAXDEPTH + 1);
+	RTE_TEST_ASSERT(ret < 0,
+		"Call succeeded with invalid parameters\n");
+
+	/* rte_fib6_delete: non existent route */
+	ret = rte_fib6_delete(fib, ip, depth);
+	RTE_TEST_ASSERT(ret == -ENOENT,
+		"Call succeeded with invalid parameters\n");
+
+	rte_fib6_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that rte_fib6_get_dp and rte_fib6_get_rib fails gracefully
+ * for incorrect user input arguments
+ */
+int32_t
+test_get_invalid(void)
+{
+	void *p;
+	int ret;
+
+	p = rte_fib6_get_dp(NULL);
+	RTE_TEST_ASSERT(p == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	p = rte_fib6_get_rib(NULL);
+	RTE_TEST_ASSERT(p == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	ret = rte_fib6_select_lookup(NULL, RTE_FIB6_LOOKUP_DEFAULT);
+	RTE_TEST_ASSERT(ret < 0,
+		"Call succeeded with invalid parameters\n");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Add routes for one supernet with all possible depths and do lookup
+ * on each step
+ * After delete routes with doing lookup on each step
+ */
+static int
+lookup_and_check_asc(struct rte_fib6 *fib,
+	uint8_t ip_arr[RTE_FIB6_MAXDEPTH][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t ip_missing[][RTE_FIB6_IPV6_ADDR_SIZE], uint64_t def_nh,
+	uint32_t n)
+{
+	uint64_t nh_arr[RTE_FIB6_MAXDEPTH];
+	int ret;
+	uint32_t i = 0;
+
+	ret = rte_fib6_lookup_bulk(fib, ip_arr, nh_arr, RTE_FIB6_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+
+	for (; i <= RTE_FIB6_MAXDEPTH - n; i++)
+		RTE_TEST_ASSERT(nh_arr[i] == n,
+			"Failed to get proper nexthop\n");
+
+	for (; i < RTE_FIB6_MAXDEPTH; i++)
+		RTE_TEST_ASSERT(nh_arr[i] == --n,
+			"Failed to get proper nexthop\n");
+
+	ret = rte_fib6_lookup_bulk(fib, ip_missing, nh_arr, 1);
+	RTE_TEST_ASSERT((ret == 0) && (nh_arr[0] == def_nh),
+		"Failed to get proper nexthop\n");
+
+	return TEST_SUCCESS;
+}
+
+static int
+lookup_and_check_desc(struct rte_fib6 *fib,
+	uint8_t ip_arr[RTE_FIB6_MAXDEPTH][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t ip_missing[][RTE_FIB6_IPV6_ADDR_SIZE], uint64_t def_nh,
+	uint32_t n)
+{
+	uint64_t nh_arr[RTE_FIB6_MAXDEPTH];
+	int ret;
+	uint32_t i = 0;
+
+	ret = rte_fib6_lookup_bulk(fib, ip_arr, nh_arr, RTE_FIB6_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+
+	for (; i < n; i++)
+		RTE_TEST_ASSERT(nh_arr[i] == RTE_FIB6_MAXDEPTH - i,
+			"Failed to get proper nexthop\n");
+
+	for (; i < RTE_FIB6_MAXDEPTH; i++)
+		RTE_TEST_ASSERT(nh_arr[i] == def_nh,
+			"Failed to get proper nexthop\n");
+
+	ret = rte_fib6_lookup_bulk(fib, ip_missing, nh_arr, 1);
+	RTE_TEST_ASSERT((ret == 0) && (nh_arr[0] == def_nh),
+		"Failed to get proper nexthop\n");
+
+	return TEST_SUCCESS;
+}
+
+static int
+check_fib(struct rte_fib6 *fib)
+{
+	uint64_t def_nh = 100;
+	uint8_t ip_arr[RTE_FIB6_MAXDEPTH][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t ip_add[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	uint8_t ip_missing[1][RTE_FIB6_IPV6_ADDR_SIZE] = { {255} };
+	uint32_t i, j;
+	int ret;
+
+	ip_add[0] = 128;
+	ip_missing[0][0] = 127;
+	for (i = 0; i < RTE_FIB6_MAXDEPTH; i++) {
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++) {
+			ip_arr[i][j] = ip_add[j] |
+				~get_msk_part(RTE_FIB6_MAXDEPTH - i, j);
+		}
+	}
+
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh, 0);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	for (i = 1; i <= RTE_FIB6_MAXDEPTH; i++) {
+		ret = rte_fib6_add(fib, ip_add, i, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = lookup_and_check_asc(fib, ip_arr, ip_missing, def_nh, i);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Lookup and check fails\n");
+	}
+
+	for (i = RTE_FIB6_MAXDEPTH; i > 1; i--) {
+		ret = rte_fib6_delete(fib, ip_add, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+		ret = lookup_and_check_asc(fib, ip_arr, ip_missing,
+			def_nh, i - 1);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Lookup and check fails\n");
+	}
+	ret = rte_fib6_delete(fib, ip_add, i);
+	RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh, 0);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	for (i = 0; i < RTE_FIB6_MAXDEPTH; i++) {
+		ret = rte_fib6_add(fib, ip_add, RTE_FIB6_MAXDEPTH - i,
+			RTE_FIB6_MAXDEPTH - i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = lookup_and_check_desc(fib, ip_arr, ip_missing,
+			def_nh, i + 1);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Lookup and check fails\n");
+	}
+
+	for (i = 1; i <= RTE_FIB6_MAXDEPTH; i++) {
+		ret = rte_fib6_delete(fib, ip_add, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+		ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh,
+			RTE_FIB6_MAXDEPTH - i);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Lookup and check fails\n");
+	}
+
+	return TEST_SUCCESS;
+}
+
+int32_t
+test_lookup(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	uint64_t def_nh = 100;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB6_DUMMY;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for DUMMY type\n");
+	rte_fib6_free(fib);
+
+	config.type = RTE_FIB6_TRIE;
+
+	config.trie.nh_sz = RTE_FIB6_TRIE_2B;
+	config.trie.num_tbl8 = MAX_TBL8 - 1;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for TRIE_2B type\n");
+	rte_fib6_free(fib);
+
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = MAX_TBL8;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for TRIE_4B type\n");
+	rte_fib6_free(fib);
+
+	config.trie.nh_sz = RTE_FIB6_TRIE_8B;
+	config.trie.num_tbl8 = MAX_TBL8;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for TRIE_8B type\n");
+	rte_fib6_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/* Add (or subtract if negative) a small value to an address */
+static void
+addr_add(uint8_t *ip, int val)
+{
+	int i, carry = val;
+
+	for (i = RTE_FIB6_IPV6_ADDR_SIZE - 1; (i >= 0) && (carry != 0); i--) {
+		carry += ip[i];
+		ip[i] = (uint8_t)carry;
+		carry >>= 8;
+	}
+}
+
+/* Build a set of addresses around the edges of the random routes */
+static void
+gen_lookup_ips(uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t route_ip[][RTE_FIB6_IPV6_ADDR_SIZE],
+	const uint8_t *route_depth)
+{
+	uint8_t *ip;
+	uint32_t i, j;
+
+	for (i = 0; i < NB_RND_IPS; i++) {
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			ips[i][j] = route_ip[i % NB_RND_ROUTES][j];
+		/* randomize the address beyond the 4 first bytes */
+		j = 4 + rte_rand() % (RTE_FIB6_IPV6_ADDR_SIZE - 4);
+		for (; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			ips[i][j] = (uint8_t)rte_rand();
+	}
+	for (i = 0; i < NB_RND_ROUTES; i++) {
+		ip = ips[NB_RND_IPS + i * 4];
+		memcpy(ip, route_ip[i], RTE_FIB6_IPV6_ADDR_SIZE);
+		ip = ips[NB_RND_IPS + i * 4 + 1];
+		memcpy(ip, route_ip[i], RTE_FIB6_IPV6_ADDR_SIZE);
+		addr_add(ip, -1);
+		ip = ips[NB_RND_IPS + i * 4 + 2];
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			ip[j] = route_ip[i][j] |
+				~get_msk_part(route_depth[i], j);
+		ip = ips[NB_RND_IPS + i * 4 + 3];
+		memcpy(ip, ips[NB_RND_IPS + i * 4 + 2],
+			RTE_FIB6_IPV6_ADDR_SIZE);
+		addr_add(ip, 1);
+	}
+}
+
+/*
+ * Compare the lookup results of all the available lookup functions
+ * of a TRIE FIB against a RIB based one.
+ */
+static int
+compare_fib(struct rte_fib6 *ref, struct rte_fib6 *fib,
+	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE])
+{
+	static uint64_t ref_nh[NB_IPS];
+	static uint64_t nh[NB_IPS];
+	static const enum rte_fib6_lookup_type types[] = {
+		RTE_FIB6_LOOKUP_TRIE_SCALAR,
+		RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512,
+	};
+	uint32_t i, j;
+	int ret;
+
+	ret = rte_fib6_lookup_bulk(ref, ips, ref_nh, NB_IPS);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+
+	for (j = 0; j < RTE_DIM(types); j++) {
+		/* vector lookup may be unsupported */
+		if (rte_fib6_select_lookup(fib, types[j]) != 0)
+			continue;
+		/* odd size to go through the scalar tail of vector lookups */
+		ret = rte_fib6_lookup_bulk(fib, ips, nh, NB_IPS - 3);
+		RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+		for (i = 0; i < NB_IPS - 3; i++)
+			RTE_TEST_ASSERT(nh[i] == ref_nh[i],
+				"Wrong nexthop for address %u with lookup "
+				"type %d: %" PRIu64 " instead of %" PRIu64 "\n",
+				i, types[j], nh[i], ref_nh[i]);
+	}
+	rte_fib6_select_lookup(fib, RTE_FIB6_LOOKUP_DEFAULT);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Add, modify and delete random overlapping routes to TRIE FIBs
+ * of all next hop sizes and check every lookup implementation gives
+ * the same results as a RIB based FIB.
+ */
+int32_t
+test_lookup_random(void)
+{
+	static uint8_t ips[NB_IPS][RTE_FIB6_IPV6_ADDR_SIZE];
+	static uint8_t route_ip[NB_RND_ROUTES][RTE_FIB6_IPV6_ADDR_SIZE];
+	static uint8_t route_depth[NB_RND_ROUTES];
+	static uint8_t route_added[NB_RND_ROUTES];
+	static const uint8_t base[][4] = {
+		{32, 1, 13, 184}, {254, 128, 0, 0}, {255, 255, 255, 255},
+		{0, 0, 0, 0},
+	};
+	struct rte_fib6 *ref, *fib;
+	struct rte_fib6_conf config;
+	uint64_t nh, max_nh;
+	uint32_t i, j;
+	int nh_sz, ret;
+
+	rte_srand(1);
+
+	/* mostly nested and overlapping routes around a few prefixes */
+	for (i = 0; i < NB_RND_ROUTES; i++) {
+		route_depth[i] = rte_rand() % (RTE_FIB6_MAXDEPTH + 1);
+		memcpy(route_ip[i], base[rte_rand() % RTE_DIM(base)], 4);
+		for (j = 4; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			route_ip[i][j] = (rte_rand() % 4 == 0) ?
+				(uint8_t)rte_rand() : 0;
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			route_ip[i][j] &= get_msk_part(route_depth[i], j);
+	}
+	gen_lookup_ips(ips, route_ip, route_depth);
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 7;
+
+	for (nh_sz = RTE_FIB6_TRIE_2B; nh_sz <= RTE_FIB6_TRIE_8B; nh_sz++) {
+		config.type = RTE_FIB6_DUMMY;
+		ref = rte_fib6_create("ref", SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+
+		config.type = RTE_FIB6_TRIE;
+		config.trie.nh_sz = nh_sz;
+		config.trie.num_tbl8 = MAX_TBL8 - 1;
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+		max_nh = (1ULL << ((8 << nh_sz) - 1)) - 1;
+		memset(route_added, 0, sizeof(route_added));
+
+		/* add, duplicates and routes that do not fit are skipped */
+		for (i = 0; i < NB_RND_ROUTES; i++) {
+			for (j = 0; j < i; j++)
+				if (route_added[j] &&
+						route_depth[j] == route_depth[i] &&
+						memcmp(route_ip[j], route_ip[i],
+						RTE_FIB6_IPV6_ADDR_SIZE) == 0)
+					break;
+			if (j != i)
+				continue;
+			nh = rte_rand() % (max_nh + 1);
+			ret = rte_fib6_add(fib, route_ip[i], route_depth[i],
+				nh);
+			if (ret == -ENOSPC)
+				continue;
+			RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+			ret = rte_fib6_add(ref, route_ip[i], route_depth[i],
+				nh);
+			RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+			route_added[i] = 1;
+		}
+		ret = compare_fib(ref, fib, ips);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookups differ\n");
+
+		/* modify next hop of half of them and delete a quarter */
+		for (i = 0; i < NB_RND_ROUTES; i++) {
+			if (!route_added[i])
+				continue;
+			if ((i & 1) == 0) {
+				nh = rte_rand() % (max_nh + 1);
+				ret = rte_fib6_add(fib, route_ip[i],
+					route_depth[i], nh);
+				RTE_TEST_ASSERT(ret == 0,
+					"Failed to modify a route\n");
+				rte_fib6_add(ref, route_ip[i], route_depth[i],
+					nh);
+			} else if ((i & 3) == 1) {
+				ret = rte_fib6_delete(fib, route_ip[i],
+					route_depth[i]);
+				RTE_TEST_ASSERT(ret == 0,
+					"Failed to delete a route\n");
+				rte_fib6_delete(ref, route_ip[i],
+					route_depth[i]);
+				route_added[i] = 0;
+			}
+		}
+		ret = compare_fib(ref, fib, ips);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookups differ\n");
+
+		/* delete everything left, only default next hop remains */
+		for (i = 0; i < NB_RND_ROUTES; i++) {
+			if (!route_added[i])
+				continue;
+			ret = rte_fib6_delete(fib, route_ip[i],
+				route_depth[i]);
+			RTE_TEST_ASSERT(ret == 0,
+				"Failed to delete a route\n");
+			rte_fib6_delete(ref, route_ip[i], route_depth[i]);
+		}
+		ret = compare_fib(ref, fib, ips);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookups differ\n");
+
+		rte_fib6_free(fib);
+		rte_fib6_free(ref);
+	}
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite fib6_tests = {
+	.suite_name = "fib6 autotest",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_create_invalid),
+		TEST_CASE(test_multiple_create),
+		TEST_CASE(test_free_null),
+		TEST_CASE(test_add_del_invalid),
+		TEST_CASE(test_get_invalid),
+		TEST_CASE(test_lookup),
+		TEST_CASE(test_lookup_random),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_fib6(void)
+{
+	return unit_test_suite_runner(&fib6_tests);
+}
+
+REGISTER_TEST_COMMAND(fib6_autotest, test_fib6);
@@ -18,6 +18,7 @@
 #include <rte_eal.h>
 #include <rte_ip.h>
 #include <rte_string_fns.h>
+#include <rte_errno.h>
 
 #include "test.h"
 
@@ -994,6 +995,816 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * rte_hash_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to a lock free hash table
+ *  - Add another RCU QSBR variable to the same table
+ *  - Check returns
+ */
+static int
+test_hash_rcu_qsbr_add(void)
+{
+	struct rte_hash_parameters params = ut_params;
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_hash *handle = NULL;
+	struct rte_rcu_qsbr *qsv = NULL, *qsv2 = NULL;
+	size_t sz;
+	int status;
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	qsv2 = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (qsv == NULL || qsv2 == NULL) {
+		printf("RCU QSBR variable allocation failed\n");
+		goto error;
+	}
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	rte_rcu_qsbr_init(qsv2, RTE_MAX_LCORE);
+
+	/* Lock free mode is required */
+	params.name = "test_rcu_add";
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	rcu_cfg.v = qsv;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg, NULL);
+	RETURN_IF_ERROR(status == 0 || rte_errno != EINVAL,
+			"RCU QSBR added to a table without lock free support");
+	rte_hash_free(handle);
+
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* Invalid arguments */
+	status = rte_hash_rcu_qsbr_add(NULL, &rcu_cfg, NULL);
+	RETURN_IF_ERROR(status == 0 || rte_errno != EINVAL,
+			"RCU QSBR added to a NULL table");
+	status = rte_hash_rcu_qsbr_add(handle, NULL, NULL);
+	RETURN_IF_ERROR(status == 0 || rte_errno != EINVAL,
+			"NULL RCU QSBR configuration accepted");
+	rcu_cfg.v = NULL;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg, NULL);
+	RETURN_IF_ERROR(status == 0 || rte_errno != EINVAL,
+			"NULL RCU QSBR variable accepted");
+
+	/* Invalid mode */
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC + 1;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg, NULL);
+	RETURN_IF_ERROR(status == 0 || rte_errno != EINVAL,
+			"invalid RCU QSBR mode accepted");
+
+	/* Attach RCU QSBR to the hash table */
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg, NULL);
+	RETURN_IF_ERROR(status != 0, "failed to add RCU QSBR");
+
+	/* Attach another RCU QSBR to the hash table */
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg, NULL);
+	RETURN_IF_ERROR(status == 0 || rte_errno != EEXIST,
+			"RCU QSBR added twice");
+
+	rte_hash_free(handle);
+	rte_free(qsv);
+	rte_free(qsv2);
+	return 0;
+
+error:
+	rte_free(qsv);
+	rte_free(qsv2);
+	return -1;
+}
+
+static unsigned int rcu_free_cnt;
+
+static void
+test_hash_rcu_free_key_data(void *p, void *key_data)
+{
+	RTE_SET_USED(key_data);
+	(*(unsigned int *)p)++;
+}
+
+/*
+ * rte_hash_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Register the reader and keep it online
+ *  - Add and delete a key, check its data is not freed until the reader
+ *    reports a quiescent state and the defer queue is reclaimed
+ *  - Fill the table, then delete all the keys, all of them pending
+ *  - Fill the table again, the keys and the extendable buckets pending
+ *    are reclaimed automatically on add
+ */
+static int
+test_hash_rcu_qsbr_dq_mode(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_rcu_dq",
+		.entries = 64,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = pseudo_hash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+				RTE_HASH_EXTRA_FLAGS_EXT_TABLE
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr_dq *dq = NULL;
+	struct rte_hash *handle = NULL;
+	struct rte_rcu_qsbr *qsv;
+	struct flow_key rand_keys[64];
+	unsigned int i, freed, pending;
+	int pos, status;
+
+	for (i = 0; i < 64; i++) {
+		memset(&rand_keys[i], 0, sizeof(rand_keys[i]));
+		rand_keys[i].port_dst = i;
+		rand_keys[i].port_src = i + 1;
+	}
+
+	qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+			RTE_CACHE_LINE_SIZE);
+	if (qsv == NULL) {
+		printf("RCU QSBR variable allocation failed\n");
+		return -1;
+	}
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	handle = rte_hash_create(&params);
+	if (handle == NULL) {
+		printf("hash creation failed\n");
+		rte_free(qsv);
+		return -1;
+	}
+
+	rcu_free_cnt = 0;
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	/* Do not reclaim automatically on delete */
+	rcu_cfg.reclaim_thd = params.entries;
+	rcu_cfg.key_data_ptr = &rcu_free_cnt;
+	rcu_cfg.free_key_data_func = test_hash_rcu_free_key_data;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg, &dq);
+	RETURN_IF_ERROR(status != 0 || dq == NULL, "failed to add RCU QSBR");
+
+	rte_rcu_qsbr_thread_register(qsv, 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	pos = rte_hash_add_key(handle, &rand_keys[0]);
+	RETURN_IF_ERROR(pos < 0, "failed to add key (pos=%d)", pos);
+	pos = rte_hash_del_key(handle, &rand_keys[0]);
+	RETURN_IF_ERROR(pos < 0, "failed to delete key (pos=%d)", pos);
+
+	/* The reader did not report a quiescent state, key is pending */
+	status = rte_rcu_qsbr_dq_reclaim(dq, 1, &freed, &pending, NULL);
+	RETURN_IF_ERROR(status != 0 || freed != 0 || pending != 1 ||
+			rcu_free_cnt != 0, "deleted key freed too early");
+
+	/* Report quiescent state, key can be freed now */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	status = rte_rcu_qsbr_dq_reclaim(dq, 1, &freed, &pending, NULL);
+	RETURN_IF_ERROR(status != 0 || freed != 1 || pending != 0 ||
+			rcu_free_cnt != 1, "deleted key not freed");
+
+	/* Fill the table, keys overflow to the extendable buckets */
+	for (i = 0; i < 64; i++) {
+		pos = rte_hash_add_key(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(pos < 0,
+			"failed to add key (pos[%u]=%d)", i, pos);
+	}
+	for (i = 0; i < 64; i++) {
+		pos = rte_hash_del_key(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(pos < 0,
+			"failed to delete key (pos[%u]=%d)", i, pos);
+	}
+	status = rte_rcu_qsbr_dq_reclaim(dq, 1, &freed, &pending, NULL);
+	RETURN_IF_ERROR(status != 0 || freed != 0 || pending != 64 ||
+			rcu_free_cnt != 1, "deleted keys freed too early");
+
+	/* Add waits for the reader when nothing can be reclaimed */
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	for (i = 0; i < 64; i++) {
+		pos = rte_hash_add_key(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(pos < 0,
+			"failed to add key again (pos[%u]=%d)", i, pos);
+	}
+	RETURN_IF_ERROR(rcu_free_cnt != 65, "deleted keys not reclaimed");
+	for (i = 0; i < 64; i++) {
+		pos = rte_hash_lookup(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(pos < 0,
+			"failed to find key (pos[%u]=%d)", i, pos);
+	}
+
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+}
+
+/*
+ * rte_hash_rcu_qsbr_add sync mode functional test.
+ *  - Add and delete a key, its data is freed before delete returns
+ *  - Repeat more times than the number of key slots, without calling
+ *    rte_hash_free_key_with_position
+ */
+static int
+test_hash_rcu_qsbr_sync_mode(void)
+{
+	struct rte_hash_parameters params = ut_params;
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_hash *handle = NULL;
+	struct rte_rcu_qsbr *qsv;
+	struct flow_key key;
+	unsigned int i;
+	int pos, status;
+
+	qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+			RTE_CACHE_LINE_SIZE);
+	if (qsv == NULL) {
+		printf("RCU QSBR variable allocation failed\n");
+		return -1;
+	}
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	params.name = "test_rcu_sync";
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	handle = rte_hash_create(&params);
+	if (handle == NULL) {
+		printf("hash creation failed\n");
+		rte_free(qsv);
+		return -1;
+	}
+
+	rcu_free_cnt = 0;
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC;
+	rcu_cfg.key_data_ptr = &rcu_free_cnt;
+	rcu_cfg.free_key_data_func = test_hash_rcu_free_key_data;
+	status = rte_hash_rcu_qsbr_add(handle, &rcu_cfg, NULL);
+	RETURN_IF_ERROR(status != 0, "failed to add RCU QSBR");
+
+	/* Registered reader, offline while the writer synchronizes */
+	rte_rcu_qsbr_thread_register(qsv, 0);
+
+	key = keys[0];
+	for (i = 0; i < params.entries + 1; i++) {
+		key.ip_src++;
+		pos = rte_hash_add_key(handle, &key);
+		RETURN_IF_ERROR(pos < 0, "failed to add key (pos=%d)", pos);
+		pos = rte_hash_del_key(handle, &key);
+		RETURN_IF_ERROR(pos < 0, "failed to delete key (pos=%d)", pos);
+		RETURN_IF_ERROR(rcu_free_cnt != i + 1,
+				"deleted key not freed");
+	}
+
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+	rte_hash_free(handle);
+	rte_free(qsv);
+	return 0;
+}
+
+/*
+ * Aging test.
+ *  - Add keys overflowing to the extendable buckets
+ *  - Look up half of them in the next epoch, with single and bulk lookups
+ *  - Check only the other half expires, whether the table is aged in one
+ *    call or incrementally bucket by bucket
+ */
+static int
+test_hash_aging(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_aging",
+		.entries = 64,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = pseudo_hash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_AGING |
+				RTE_HASH_EXTRA_FLAGS_EXT_TABLE
+	};
+	struct rte_hash *handle;
+	struct flow_key rand_keys[64];
+	const void *lookup_keys[16];
+	const void *expired[64];
+	void *data[64];
+	const struct flow_key *key;
+	uint64_t hit_mask;
+	unsigned int i, n, total;
+	int pos, ret;
+
+	for (i = 0; i < 64; i++) {
+		memset(&rand_keys[i], 0, sizeof(rand_keys[i]));
+		rand_keys[i].port_dst = i;
+		rand_keys[i].port_src = i + 1;
+	}
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < 64; i++) {
+		ret = rte_hash_add_key_data(handle, &rand_keys[i],
+				(void *)((uintptr_t)i));
+		RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+	}
+
+	/* Nothing expired yet */
+	ret = rte_hash_age(handle, 1, UINT32_MAX, expired, data, 64);
+	RETURN_IF_ERROR(ret != 0, "keys expired too early (%d)", ret);
+
+	/* Refresh the first half of the keys in the next epoch */
+	rte_hash_age_tick(handle);
+	for (i = 0; i < 16; i++) {
+		pos = rte_hash_lookup(handle, &rand_keys[i]);
+		RETURN_IF_ERROR(pos < 0, "failed to find key %u", i);
+	}
+	for (i = 16; i < 32; i++)
+		lookup_keys[i - 16] = &rand_keys[i];
+	ret = rte_hash_lookup_bulk_data(handle, lookup_keys, 16, &hit_mask,
+			data);
+	RETURN_IF_ERROR(ret != 16, "failed to find keys in bulk (%d)", ret);
+	rte_hash_age_tick(handle);
+
+	/* Age the whole table in one call */
+	ret = rte_hash_age(handle, 2, UINT32_MAX, expired, data, 64);
+	RETURN_IF_ERROR(ret != 32, "unexpected number of expired keys (%d)",
+			ret);
+	for (n = 0; n < 32; n++) {
+		key = expired[n];
+		i = key->port_dst;
+		RETURN_IF_ERROR(i < 32 || (uintptr_t)data[n] != i ||
+				memcmp(key, &rand_keys[i], sizeof(*key)) != 0,
+				"wrong expired key %u", i);
+	}
+
+	/* Age the table incrementally, a bucket at a time: 8 main buckets
+	 * and 8 extendable buckets of 8 entries.
+	 */
+	total = 0;
+	for (i = 0; i < 16; i++) {
+		ret = rte_hash_age(handle, 2, 1, &expired[total], NULL,
+				64 - total);
+		RETURN_IF_ERROR(ret < 0 || ret > 8,
+				"unexpected number of expired keys (%d)", ret);
+		total += ret;
+	}
+	RETURN_IF_ERROR(total != 32, "unexpected number of expired keys (%u)",
+			total);
+
+	/* Batches are bounded by the output array size */
+	ret = rte_hash_age(handle, 1, UINT32_MAX, expired, NULL, 5);
+	RETURN_IF_ERROR(ret != 5, "unexpected number of expired keys (%d)",
+			ret);
+
+	/* Delete the expired keys */
+	ret = rte_hash_age(handle, 2, UINT32_MAX, expired, NULL, 64);
+	RETURN_IF_ERROR(ret != 32, "unexpected number of expired keys (%d)",
+			ret);
+	for (n = 0; n < 32; n++) {
+		pos = rte_hash_del_key(handle, expired[n]);
+		RETURN_IF_ERROR(pos < 0, "failed to delete expired key");
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != 32,
+			"unexpected number of keys after aging");
+	ret = rte_hash_age(handle, 1, UINT32_MAX, expired, NULL, 64);
+	RETURN_IF_ERROR(ret != 32, "unexpected number of expired keys (%d)",
+			ret);
+
+	/* Invalid parameters */
+	ret = rte_hash_age(handle, 0, UINT32_MAX, expired, NULL, 64);
+	RETURN_IF_ERROR(ret != -EINVAL, "zero timeout accepted");
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+/*
+ * Check that a burst lookup, larger than RTE_HASH_LOOKUP_BULK_MAX, finds
+ * the same keys as single lookups, for lock based and lock-free tables,
+ * with keys spread over the table or all colliding in extendable buckets.
+ */
+#define BURST_TEST_KEYS 300
+#define BURST_TEST_MISSES 100
+static int
+test_hash_lookup_burst(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_burst",
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+	};
+	static const uint32_t extra_flags[] = {
+		RTE_HASH_EXTRA_FLAGS_EXT_TABLE,
+		RTE_HASH_EXTRA_FLAGS_EXT_TABLE |
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	};
+	struct rte_hash *handle;
+	struct flow_key rand_keys[BURST_TEST_KEYS + BURST_TEST_MISSES];
+	const void *lookup_keys[BURST_TEST_KEYS + BURST_TEST_MISSES];
+	int32_t positions[BURST_TEST_KEYS + BURST_TEST_MISSES];
+	void *data[BURST_TEST_KEYS + BURST_TEST_MISSES];
+	unsigned int i, f, collide, num_keys, num_lookups;
+	int pos, ret;
+
+	for (i = 0; i < RTE_DIM(rand_keys); i++) {
+		memset(&rand_keys[i], 0, sizeof(rand_keys[i]));
+		rand_keys[i].ip_src = i;
+		rand_keys[i].port_dst = i;
+	}
+
+	for (f = 0; f < RTE_DIM(extra_flags); f++) {
+		for (collide = 0; collide <= 1; collide++) {
+			params.extra_flag = extra_flags[f];
+			/* All keys in the same buckets end up in ext buckets */
+			if (collide) {
+				params.entries = 64;
+				params.hash_func = pseudo_hash;
+				num_keys = 48;
+			} else {
+				params.entries = 1024;
+				params.hash_func = rte_jhash;
+				num_keys = BURST_TEST_KEYS;
+			}
+			num_lookups = num_keys + BURST_TEST_MISSES;
+
+			handle = rte_hash_create(&params);
+			RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+			for (i = 0; i < num_keys; i++) {
+				ret = rte_hash_add_key_data(handle,
+						&rand_keys[i],
+						(void *)((uintptr_t)i));
+				RETURN_IF_ERROR(ret != 0,
+					"failed to add key %u", i);
+			}
+
+			/* Look up in reverse order, misses at the end */
+			for (i = 0; i < num_keys; i++)
+				lookup_keys[i] = &rand_keys[num_keys - 1 - i];
+			for (; i < num_lookups; i++)
+				lookup_keys[i] = &rand_keys[
+					BURST_TEST_KEYS + i - num_keys];
+
+			ret = rte_hash_lookup_burst(handle, lookup_keys,
+					num_lookups, positions, data);
+			RETURN_IF_ERROR(ret != (int)num_keys,
+				"found %d keys, expected %u", ret, num_keys);
+
+			for (i = 0; i < num_lookups; i++) {
+				pos = rte_hash_lookup(handle, lookup_keys[i]);
+				RETURN_IF_ERROR(positions[i] != pos,
+					"key %u at position %d, expected %d",
+					i, positions[i], pos);
+				if (pos < 0)
+					continue;
+				RETURN_IF_ERROR(data[i] !=
+					(void *)((uintptr_t)(num_keys - 1 - i)),
+					"wrong data returned for key %u", i);
+			}
+
+			/* Data output is optional */
+			ret = rte_hash_lookup_burst(handle, lookup_keys,
+					num_lookups, positions, NULL);
+			RETURN_IF_ERROR(ret != (int)num_keys,
+				"found %d keys without data, expected %u",
+				ret, num_keys);
+
+			rte_hash_free(handle);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Look up the keys of a resizable table with all the lookup functions,
+ * the data of key i being i. Only the keys at index i % step == 0 are in
+ * the table.
+ */
+#define RESIZE_TEST_KEYS 2000
+static struct flow_key resize_keys[RESIZE_TEST_KEYS];
+static const void *resize_lookup_keys[RESIZE_TEST_KEYS];
+static int32_t resize_positions[RESIZE_TEST_KEYS];
+static void *resize_data[RESIZE_TEST_KEYS];
+
+static int
+test_hash_resize_check(const struct rte_hash *h, unsigned int num_keys,
+		unsigned int step)
+{
+	struct rte_hash *handle = NULL;
+	unsigned int i, num, num_found = 0;
+	const void *next_key;
+	void *next_data;
+	uint64_t hit_mask;
+	uint32_t iter = 0;
+	void *key;
+	int ret;
+
+	for (i = 0; i < num_keys; i++) {
+		resize_lookup_keys[i] = &resize_keys[i];
+		ret = rte_hash_lookup_data(h, &resize_keys[i], &resize_data[i]);
+		if (i % step != 0) {
+			RETURN_IF_ERROR(ret != -ENOENT,
+				"deleted key %u found", i);
+			continue;
+		}
+		num_found++;
+		RETURN_IF_ERROR(ret < 0, "key %u not found", i);
+		RETURN_IF_ERROR(resize_data[i] != (void *)((uintptr_t)i),
+			"wrong data for key %u", i);
+		RETURN_IF_ERROR(rte_hash_get_key_with_position(h, ret,
+			&key) != 0 || memcmp(key, &resize_keys[i],
+			sizeof(resize_keys[i])) != 0,
+			"wrong key at position of key %u", i);
+	}
+
+	for (i = 0; i < num_keys; i += num) {
+		num = RTE_MIN(num_keys - i,
+				(unsigned int)RTE_HASH_LOOKUP_BULK_MAX);
+		ret = rte_hash_lookup_bulk_data(h, &resize_lookup_keys[i], num,
+				&hit_mask, &resize_data[i]);
+		RETURN_IF_ERROR(ret < 0, "bulk lookup failed");
+		RETURN_IF_ERROR(hit_mask != RTE_LEN2MASK(num, uint64_t) &&
+			step == 1, "bulk lookup missed keys");
+	}
+
+	ret = rte_hash_lookup_burst(h, resize_lookup_keys, num_keys,
+			resize_positions, resize_data);
+	RETURN_IF_ERROR(ret != (int)num_found,
+		"burst lookup found %d keys, expected %u", ret, num_found);
+	for (i = 0; i < num_keys; i += step)
+		RETURN_IF_ERROR(resize_data[i] != (void *)((uintptr_t)i),
+			"burst lookup returned wrong data for key %u", i);
+
+	RETURN_IF_ERROR(rte_hash_count(h) != (int32_t)num_found,
+		"wrong number of keys %d, expected %u",
+		rte_hash_count(h), num_found);
+
+	/* While resizing, both tables are iterated */
+	num = 0;
+	while (rte_hash_iterate(h, &next_key, &next_data, &iter) >= 0)
+		num++;
+	RETURN_IF_ERROR(num != num_found,
+		"iterated over %u keys, expected %u", num, num_found);
+
+	return 0;
+}
+
+/*
+ * Fill a resizable table way over its initial size, checking the lookups
+ * while its buckets are migrated, once the migration is completed, and
+ * after deleting keys. The key indexes of the added key store segments
+ * are freed and reused.
+ */
+static int
+test_hash_resize(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resize",
+		.entries = 64,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+	};
+	static const uint32_t extra_flags[] = {
+		0,
+		RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD,
+		RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY,
+		RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	};
+	struct rte_hash *handle;
+	unsigned int i, f, resizing;
+	int ret;
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		memset(&resize_keys[i], 0, sizeof(resize_keys[i]));
+		resize_keys[i].ip_src = i;
+		resize_keys[i].port_src = i;
+	}
+
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZE |
+		RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle != NULL,
+		"resize with extendable buckets should fail");
+
+	params.extra_flag = 0;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	RETURN_IF_ERROR(rte_hash_resize_step(handle, 1) != -EINVAL,
+		"resize step of a fixed size table should fail");
+	rte_hash_free(handle);
+	handle = NULL;
+	RETURN_IF_ERROR(rte_hash_resize_step(NULL, 1) != -EINVAL,
+		"resize step of a NULL table should fail");
+
+	for (f = 0; f < RTE_DIM(extra_flags); f++) {
+		params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZE |
+					extra_flags[f];
+		handle = rte_hash_create(&params);
+		RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+		resizing = 0;
+		for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+			ret = rte_hash_add_key_data(handle, &resize_keys[i],
+					(void *)((uintptr_t)i));
+			RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+
+			/* Check the lookups in the middle of a resize */
+			if (rte_hash_resize_step(handle, 0) == 0)
+				continue;
+			resizing++;
+			RETURN_IF_ERROR(test_hash_resize_check(handle, i + 1,
+				1) < 0, "lookups failed while resizing");
+		}
+		RETURN_IF_ERROR(resizing == 0, "table was never resizing");
+
+		ret = rte_hash_resize_step(handle, UINT32_MAX);
+		RETURN_IF_ERROR(ret != 0, "resize not completed: %d", ret);
+		RETURN_IF_ERROR(test_hash_resize_check(handle,
+			RESIZE_TEST_KEYS, 1) < 0, "lookups failed after resize");
+
+		/* Delete every other key, freeing the key indexes */
+		for (i = 1; i < RESIZE_TEST_KEYS; i += 2) {
+			ret = rte_hash_del_key(handle, &resize_keys[i]);
+			RETURN_IF_ERROR(ret < 0, "failed to delete key %u", i);
+			if (params.extra_flag &
+					RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				RETURN_IF_ERROR(rte_hash_free_key_with_position(
+					handle, ret) != 0,
+					"failed to free key %u", i);
+		}
+		RETURN_IF_ERROR(test_hash_resize_check(handle,
+			RESIZE_TEST_KEYS, 2) < 0, "lookups failed after delete");
+
+		/* Add them back, and again after a reset */
+		for (i = 1; i < RESIZE_TEST_KEYS; i += 2) {
+			ret = rte_hash_add_key_data(handle, &resize_keys[i],
+					(void *)((uintptr_t)i));
+			RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+		}
+		RETURN_IF_ERROR(test_hash_resize_check(handle,
+			RESIZE_TEST_KEYS, 1) < 0, "lookups failed after add");
+
+		rte_hash_reset(handle);
+		RETURN_IF_ERROR(rte_hash_count(handle) != 0,
+			"table not empty after reset");
+		for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+			ret = rte_hash_add_key_data(handle, &resize_keys[i],
+					(void *)((uintptr_t)i));
+			RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+		}
+		rte_hash_resize_step(handle, UINT32_MAX);
+		RETURN_IF_ERROR(test_hash_resize_check(handle,
+			RESIZE_TEST_KEYS, 1) < 0, "lookups failed after reset");
+
+		rte_hash_free(handle);
+	}
+
+	return 0;
+}
+
+/* Number of keys the two buckets of a signature hold */
+#define RESIZE_COLLIDE_KEYS 16
+
+/*
+ * The keys with ip_dst set all have the same signature, their buckets are
+ * odd. The other keys only use the even buckets: their signature and
+ * short signature are even.
+ */
+static uint32_t
+resize_collide_hash(const void *key, uint32_t key_len, uint32_t init_val)
+{
+	const struct flow_key *k = key;
+
+	if (k->ip_dst != 0)
+		return 0x12340005;
+	return rte_jhash(key, key_len, init_val) & ~0x10001;
+}
+
+/*
+ * Resize a table holding as many colliding keys as their two buckets can
+ * hold, trying to add more of them while resizing. The migration must
+ * complete, keeping all the keys, and preserve the age of the entries.
+ */
+static int
+test_hash_resize_collide(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resize_collide",
+		.entries = 64,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = resize_collide_hash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+	};
+	static const uint32_t extra_flags[] = {
+		0,
+		RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD,
+		RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY,
+		RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	};
+	struct flow_key collide_keys[RESIZE_COLLIDE_KEYS + 4];
+	const void *aged_keys[RESIZE_TEST_KEYS];
+	struct rte_hash *handle;
+	unsigned int i, j, f, resizing;
+	void *data;
+	int ret;
+
+	for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+		memset(&resize_keys[i], 0, sizeof(resize_keys[i]));
+		resize_keys[i].ip_src = i;
+		resize_keys[i].port_src = i;
+	}
+	for (i = 0; i < RTE_DIM(collide_keys); i++) {
+		memset(&collide_keys[i], 0, sizeof(collide_keys[i]));
+		collide_keys[i].ip_src = i;
+		collide_keys[i].ip_dst = 1;
+	}
+
+	for (f = 0; f < RTE_DIM(extra_flags); f++) {
+		params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZE |
+			RTE_HASH_EXTRA_FLAGS_AGING | extra_flags[f];
+		handle = rte_hash_create(&params);
+		RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+		/* Fill the two buckets of the colliding keys */
+		for (i = 0; i < RESIZE_COLLIDE_KEYS; i++) {
+			ret = rte_hash_add_key_data(handle, &collide_keys[i],
+					(void *)((uintptr_t)i));
+			RETURN_IF_ERROR(ret != 0,
+				"failed to add colliding key %u", i);
+		}
+		ret = rte_hash_add_key(handle, &collide_keys[i]);
+		RETURN_IF_ERROR(ret != -ENOSPC,
+			"colliding key %u added to full buckets", i);
+
+		/* Age the colliding keys, which are migrated later */
+		rte_hash_age_tick(handle);
+		rte_hash_age_tick(handle);
+
+		/* Add keys until resizing, then more colliding keys */
+		resizing = 0;
+		for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+			ret = rte_hash_add_key_data(handle, &resize_keys[i],
+					(void *)((uintptr_t)i));
+			RETURN_IF_ERROR(ret != 0, "failed to add key %u", i);
+			if (resizing || rte_hash_resize_step(handle, 0) == 0)
+				continue;
+
+			resizing = 1;
+			for (j = RESIZE_COLLIDE_KEYS;
+					j < RTE_DIM(collide_keys); j++) {
+				ret = rte_hash_add_key(handle,
+						&collide_keys[j]);
+				RETURN_IF_ERROR(ret != -ENOSPC,
+					"colliding key %u added while resizing",
+					j);
+			}
+		}
+		RETURN_IF_ERROR(!resizing, "table was never resizing");
+
+		ret = rte_hash_resize_step(handle, UINT32_MAX);
+		RETURN_IF_ERROR(ret != 0, "resize not completed: %d", ret);
+		RETURN_IF_ERROR(rte_hash_count(handle) !=
+			RESIZE_TEST_KEYS + RESIZE_COLLIDE_KEYS,
+			"wrong number of keys %d", rte_hash_count(handle));
+
+		/* The migration kept the age of the colliding keys */
+		ret = rte_hash_age(handle, 2, UINT32_MAX, aged_keys, NULL,
+				RTE_DIM(aged_keys));
+		RETURN_IF_ERROR(ret != RESIZE_COLLIDE_KEYS,
+			"%d entries aged, expected %u", ret,
+			RESIZE_COLLIDE_KEYS);
+		for (j = 0; j < (unsigned int)ret; j++)
+			RETURN_IF_ERROR(((const struct flow_key *)
+				aged_keys[j])->ip_dst == 0,
+				"aged key is not a colliding key");
+
+		for (i = 0; i < RESIZE_COLLIDE_KEYS; i++) {
+			ret = rte_hash_lookup_data(handle, &collide_keys[i],
+					&data);
+			RETURN_IF_ERROR(ret < 0 ||
+				data != (void *)((uintptr_t)i),
+				"colliding key %u not found", i);
+		}
+		for (i = 0; i < RESIZE_TEST_KEYS; i++) {
+			ret = rte_hash_lookup_data(handle, &resize_keys[i],
+					&data);
+			RETURN_IF_ERROR(ret < 0 ||
+				data != (void *)((uintptr_t)i),
+				"key %u not found", i);
+		}
+
+		rte_hash_free(handle);
+	}
+
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -1843,6 +2654,20 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_hash_rcu_qsbr_add() < 0)
+		return -1;
+	if (test_hash_rcu_qsbr_dq_mode() < 0)
+		return -1;
+	if (test_hash_rcu_qsbr_sync_mode() < 0)
+		return -1;
+	if (test_hash_aging() < 0)
+		return -1;
+	if (test_hash_lookup_burst() < 0)
+		return -1;
+	if (test_hash_resize() < 0)
+		return -1;
+	if (test_hash_resize_collide() < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
@@ -3,6 +3,8 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 
 #include <rte_lcore.h>
@@ -585,6 +587,132 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 	return 0;
 }
 
+/*
+ * Control operation of the burst lookup performance test, comparing
+ * bulk lookups with the pipelined burst lookup, on tables up to
+ * several times the size of a typical last level cache.
+ */
+#define BURST_PERF_KEY_LEN 16
+#define BURST_PERF_LOOKUPS (1 << 22)
+#define BURST_PERF_BURST 256
+
+static const uint32_t burst_perf_entries[] = {
+	1 << 14, 1 << 18, 1 << 20, 1 << 22
+};
+
+static int
+timed_lookups_burst(struct rte_hash *hash, const void **lookup_keys,
+		unsigned int burst, uint64_t *cycles_per_lookup)
+{
+	int32_t positions_burst[BURST_PERF_BURST];
+	void *ret_data[BURST_PERF_BURST];
+	uint64_t hit_mask;
+	uint64_t start_tsc;
+	unsigned int i;
+	int ret;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BURST_PERF_LOOKUPS; i += burst) {
+		if (burst == RTE_HASH_LOOKUP_BULK_MAX)
+			ret = rte_hash_lookup_bulk_data(hash, &lookup_keys[i],
+					burst, &hit_mask, ret_data);
+		else
+			ret = rte_hash_lookup_burst(hash, &lookup_keys[i],
+					burst, positions_burst, ret_data);
+		if (ret != (int)burst) {
+			printf("Expect to find %u keys, but found %d\n",
+				burst, ret);
+			return -1;
+		}
+	}
+	*cycles_per_lookup = (rte_rdtsc() - start_tsc) / BURST_PERF_LOOKUPS;
+
+	return 0;
+}
+
+static int
+run_burst_perf_tests(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_burst",
+		.key_len = BURST_PERF_KEY_LEN,
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	uint64_t bulk_cycles, burst_cycles;
+	uint8_t (*burst_keys)[BURST_PERF_KEY_LEN];
+	const void **lookup_keys;
+	struct rte_hash *hash;
+	unsigned int i, j, num_keys;
+	int ret = -1;
+
+	burst_keys = malloc(burst_perf_entries[RTE_DIM(burst_perf_entries) - 1]
+			* sizeof(*burst_keys));
+	lookup_keys = malloc(BURST_PERF_LOOKUPS * sizeof(*lookup_keys));
+	if (burst_keys == NULL || lookup_keys == NULL) {
+		printf("Memory allocation for burst perf test failed\n");
+		goto exit;
+	}
+
+	printf("\n BURST LOOKUP PERFORMANCE (in CPU cycles/lookup)\n");
+	printf("\n%-18s%-18s%-18s%-18s\n",
+		"Entries", "Key store (MB)", "Lookup_bulk", "Lookup_burst");
+
+	for (i = 0; i < RTE_DIM(burst_perf_entries); i++) {
+		params.entries = burst_perf_entries[i];
+		num_keys = params.entries * ADD_PERCENT;
+
+		hash = rte_hash_create(&params);
+		if (hash == NULL) {
+			printf("Error creating table\n");
+			goto exit;
+		}
+
+		/* Unique keys: a counter followed by random bytes */
+		for (j = 0; j < num_keys; j++) {
+			uint64_t rand = rte_rand();
+
+			memcpy(&burst_keys[j][0], &j, sizeof(j));
+			memcpy(&burst_keys[j][sizeof(j)], &rand, sizeof(rand));
+			if (rte_hash_add_key_data(hash, burst_keys[j],
+					(void *)((uintptr_t)j)) != 0) {
+				printf("Failed to add key number %u\n", j);
+				rte_hash_free(hash);
+				goto exit;
+			}
+		}
+
+		/* Look up random keys, so most accesses miss the cache */
+		for (j = 0; j < BURST_PERF_LOOKUPS; j++)
+			lookup_keys[j] = burst_keys[rte_rand() % num_keys];
+
+		if (timed_lookups_burst(hash, lookup_keys,
+				RTE_HASH_LOOKUP_BULK_MAX, &bulk_cycles) < 0 ||
+				timed_lookups_burst(hash, lookup_keys,
+				BURST_PERF_BURST, &burst_cycles) < 0) {
+			rte_hash_free(hash);
+			goto exit;
+		}
+
+		/* Key slots hold the data pointer and are 16-byte aligned */
+		printf("%-18u%-18u%-18"PRIu64"%-18"PRIu64"\n",
+			params.entries,
+			(unsigned int)((uint64_t)params.entries *
+				RTE_ALIGN(sizeof(void *) + BURST_PERF_KEY_LEN,
+					16) >> 20),
+			bulk_cycles, burst_cycles);
+
+		rte_hash_free(hash);
+	}
+	ret = 0;
+
+exit:
+	free(lookup_keys);
+	free(burst_keys);
+	return ret;
+}
+
 /* Control operation of performance testing of fbk hash. */
 #define LOAD_FACTOR 0.667	/* How full to make the hash table. */
 #define TEST_SIZE 1000000	/* How many operations to time. */
@@ -692,6 +820,9 @@ test_hash_perf(void)
 	if (run_all_tbl_perf_tests(1, 0, 1) < 0)
 		return -1;
 
+	if (run_burst_perf_tests() < 0)
+		return -1;
+
 	if (fbk_hash_perf_test() < 0)
 		return -1;
 
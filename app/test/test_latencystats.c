@@ -4,6 +4,8 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
 #include <string.h>
 
 #include <rte_latencystats.h>
@@ -13,7 +15,7 @@
 #include "sample_packet_forward.h"
 #include "test.h"
 
-#define NUM_STATS 4
+#define NUM_STATS 8
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
 
@@ -25,6 +27,10 @@ struct rte_metric_name lat_stats_strings[] = {
 	{"avg_latency_ns"},
 	{"max_latency_ns"},
 	{"jitter_ns"},
+	{"p50_latency_ns"},
+	{"p90_latency_ns"},
+	{"p99_latency_ns"},
+	{"p99_9_latency_ns"},
 };
 
 /* Test case for latency init with metrics init */
@@ -77,7 +83,7 @@ static int test_latencystats_get_names(void)
 	/* Success Test: Valid names and size */
 	size = NUM_STATS;
 	ret = rte_latencystats_get_names(names, size);
-	for (i = 0; i <= NUM_STATS; i++) {
+	for (i = 0; i < NUM_STATS; i++) {
 		if (strcmp(lat_stats_strings[i].name, names[i].name) == 0)
 			printf(" %s\n", names[i].name);
 		else
@@ -130,6 +136,35 @@ static int test_latencystats_get(void)
 	return TEST_SUCCESS;
 }
 
+/* Test case to get latency percentiles of a queue */
+static int test_latencystats_percentile_get(void)
+{
+	uint64_t p50, p99;
+	int ret;
+
+	ret = rte_latencystats_percentile_get(portid, QUEUE_ID, 50, &p50);
+	TEST_ASSERT(ret == 0, "Test Failed to get the median latency");
+
+	ret = rte_latencystats_percentile_get(portid, QUEUE_ID, 99, &p99);
+	TEST_ASSERT(ret == 0, "Test Failed to get the p99 latency");
+	TEST_ASSERT(p50 <= p99, "Test Failed: p50 %"PRIu64" > p99 %"PRIu64,
+		    p50, p99);
+
+	/* Failure Test: Invalid percentile */
+	ret = rte_latencystats_percentile_get(portid, QUEUE_ID, 101, &p50);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: invalid percentile");
+
+	/* Failure Test: Invalid queue */
+	ret = rte_latencystats_percentile_get(portid, UINT16_MAX, 50, &p50);
+	TEST_ASSERT(ret == -ENODEV, "Test Failed: invalid queue");
+
+	/* Failure Test: Invalid result pointer */
+	ret = rte_latencystats_percentile_get(portid, QUEUE_ID, 50, NULL);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: invalid pointer");
+
+	return TEST_SUCCESS;
+}
+
 static int test_latency_ring_setup(void)
 {
 	test_ring_setup(&ring, &portid);
@@ -191,7 +226,13 @@ unit_test_suite latencystats_testsuite = {
 		 */
 		TEST_CASE_ST(NULL, NULL, test_latencystats_get),
 
-		/* Test Case 5: To check uninit of latency test */
+		/* Test Case 5: To check whether latency percentiles
+		 * of a queue are retrieved
+		 */
+		TEST_CASE_ST(test_latency_packet_forward, NULL,
+				test_latencystats_percentile_get),
+
+		/* Test Case 6: To check uninit of latency test */
 		TEST_CASE_ST(NULL, NULL, test_latency_uninit),
 
 		TEST_CASES_END()
@@ -8,6 +8,9 @@
 
 #include <rte_ip.h>
 #include <rte_lpm.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test.h"
 #include "test_xmmt_ops.h"
@@ -40,6 +43,8 @@ static int32_t test15(void);
 static int32_t test16(void);
 static int32_t test17(void);
 static int32_t test18(void);
+static int32_t test19(void);
+static int32_t test20(void);
 
 rte_lpm_test tests[] = {
 /* Test Cases */
@@ -61,7 +66,9 @@ rte_lpm_test tests[] = {
 	test15,
 	test16,
 	test17,
-	test18
+	test18,
+	test19,
+	test20
 };
 
 #define NUM_LPM_TESTS (sizeof(tests)/sizeof(tests[0]))
@@ -1266,6 +1273,158 @@ test18(void)
 	return PASS;
 }
 
+/*
+ * rte_lpm_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to LPM
+ *  - Add another RCU QSBR variable to LPM
+ *  - Check returns
+ */
+int32_t
+test19(void)
+{
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_lpm_rcu_config rcu_cfg = {0};
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Invalid arguments */
+	status = rte_lpm_rcu_qsbr_add(NULL, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EINVAL);
+	status = rte_lpm_rcu_qsbr_add(lpm, NULL, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EINVAL);
+	status = rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EINVAL);
+
+	/* Invalid mode */
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_SYNC + 1;
+	status = rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EINVAL);
+
+	/* Attach RCU QSBR to LPM table */
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_DQ;
+	status = rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Create and attach another RCU QSBR to LPM table */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv2 != NULL);
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_SYNC;
+	status = rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EEXIST);
+
+	rte_lpm_free(lpm);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return PASS;
+}
+
+/*
+ * rte_lpm_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Register the reader and keep it online
+ *  - Add and delete a rule with depth > 24
+ *  - Check the tbl8 group is not freed until the reader reports
+ *    a quiescent state and the defer queue is reclaimed
+ */
+int32_t
+test20(void)
+{
+#define group_idx next_hop
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr_dq *dq = NULL;
+	struct rte_lpm_rcu_config rcu_cfg = {0};
+	uint32_t ip, next_hop, tbl8_group_index;
+	unsigned int freed, pending;
+	uint8_t depth;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	TEST_LPM_ASSERT(status == 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_DQ;
+	/* Do not reclaim automatically on enqueue */
+	rcu_cfg.reclaim_thd = NUMBER_TBL8S;
+	status = rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg, &dq);
+	TEST_LPM_ASSERT(status == 0 && dq != NULL);
+
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	TEST_LPM_ASSERT(status == 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	ip = RTE_IPV4(192, 168, 100, 100);
+	depth = 28;
+	next_hop = 1;
+	status = rte_lpm_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(lpm->tbl24[ip>>8].valid_group);
+	tbl8_group_index = lpm->tbl24[ip>>8].group_idx;
+
+	status = rte_lpm_delete(lpm, ip, depth);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(!lpm->tbl24[ip>>8].valid);
+
+	/* The reader did not report a quiescent state, group is pending */
+	status = rte_rcu_qsbr_dq_reclaim(dq, 1, &freed, &pending, NULL);
+	TEST_LPM_ASSERT(status == 0 && freed == 0 && pending == 1);
+	TEST_LPM_ASSERT(lpm->tbl8[tbl8_group_index *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES].valid_group);
+
+	/* Report quiescent state, group can be freed now */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	status = rte_rcu_qsbr_dq_reclaim(dq, 1, &freed, &pending, NULL);
+	TEST_LPM_ASSERT(status == 0 && freed == 1 && pending == 0);
+	TEST_LPM_ASSERT(!lpm->tbl8[tbl8_group_index *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES].valid_group);
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+
+	rte_lpm_free(lpm);
+	rte_free(qsv);
+#undef group_idx
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
@@ -8,7 +8,10 @@
 #include <string.h>
 
 #include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
 #include <rte_lpm6.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test.h"
 #include "test_lpm6_data.h"
@@ -51,6 +54,8 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
+static int32_t test30(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -83,6 +88,8 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
+	test30,
 };
 
 #define NUM_LPM6_TESTS                (sizeof(tests6)/sizeof(tests6[0]))
@@ -1771,6 +1778,115 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * rte_lpm6_rcu_qsbr_add positive and negative tests.
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	struct rte_lpm6_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	size_t sz;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Invalid arguments */
+	status = rte_lpm6_rcu_qsbr_add(NULL, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EINVAL);
+	status = rte_lpm6_rcu_qsbr_add(lpm, NULL, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EINVAL);
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EINVAL);
+
+	rcu_cfg.v = qsv;
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Only one RCU QSBR variable can be attached */
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_SYNC;
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status != 0 && rte_errno == EEXIST);
+
+	rte_lpm6_free(lpm);
+	rte_free(qsv);
+
+	return PASS;
+}
+
+/*
+ * Add and delete a deep rule more times than there are tbl8s, with the
+ * tbl8s released through the RCU defer queue, and check they are all
+ * reused.
+ */
+int32_t
+test30(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	struct rte_lpm6_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint8_t ip[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint8_t depth = 128;
+	uint32_t next_hop_add = 100, next_hop_return = 0;
+	size_t sz;
+	int32_t status;
+	unsigned int i;
+
+	config.max_rules = MAX_RULES;
+	/* 13 tbl8s are needed to store a /128 rule */
+	config.number_tbl8s = 16;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	TEST_LPM_ASSERT(status == 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_DQ;
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg, NULL);
+	TEST_LPM_ASSERT(status == 0);
+
+	for (i = 0; i < 8; i++) {
+		status = rte_lpm6_add(lpm, ip, depth, next_hop_add + i);
+		TEST_LPM_ASSERT(status == 0);
+
+		status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+		TEST_LPM_ASSERT(status == 0 &&
+				next_hop_return == next_hop_add + i);
+
+		status = rte_lpm6_delete(lpm, ip, depth);
+		TEST_LPM_ASSERT(status == 0);
+
+		status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+		TEST_LPM_ASSERT(status == -ENOENT);
+	}
+
+	rte_lpm6_free(lpm);
+	rte_free(qsv);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
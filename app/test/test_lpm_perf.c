@@ -10,8 +10,12 @@
 #include <rte_cycles.h>
 #include <rte_random.h>
 #include <rte_branch_prediction.h>
+#include <rte_malloc.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_ip.h>
 #include <rte_lpm.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test.h"
 #include "test_xmmt_ops.h"
@@ -29,6 +33,12 @@
 
 #define MAX_RULE_NUM (1200000)
 
+/* Number of tbl8 routes updated by the writer in the RCU test */
+#define RCU_ROUTE_NUM 512
+#define RCU_ITERATIONS 64
+/* Number of lookups between two quiescent state reports */
+#define QSBR_REPORTING_INTERVAL 1024
+
 struct route_rule {
 	uint32_t ip;
 	uint8_t depth;
@@ -316,6 +326,162 @@ print_route_distribution(const struct route_rule *table, uint32_t n)
 	printf("\n");
 }
 
+static struct rte_lpm *rcu_lpm;
+static struct rte_rcu_qsbr *rv;
+static volatile uint8_t writer_done;
+static uint32_t rcu_route_ip[RCU_ROUTE_NUM];
+static uint8_t rcu_route_depth[RCU_ROUTE_NUM];
+static uint32_t rcu_route_num;
+
+/* Reader thread: lookup routes updated by the writer */
+static int
+test_lpm_rcu_qsbr_reader(void *arg)
+{
+	unsigned int i;
+	uint32_t thread_id = rte_lcore_id();
+	uint32_t next_hop_return = 0;
+	uint64_t lookups = 0, hits = 0;
+
+	RTE_SET_USED(arg);
+
+	/* Register this thread to report quiescent state */
+	rte_rcu_qsbr_thread_register(rv, thread_id);
+	rte_rcu_qsbr_thread_online(rv, thread_id);
+
+	do {
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i++)
+			if (rte_lpm_lookup(rcu_lpm,
+					rcu_route_ip[i % rcu_route_num],
+					&next_hop_return) == 0)
+				hits++;
+		lookups += QSBR_REPORTING_INTERVAL;
+
+		/* Update quiescent state */
+		rte_rcu_qsbr_quiescent(rv, thread_id);
+	} while (!writer_done);
+
+	rte_rcu_qsbr_thread_offline(rv, thread_id);
+	rte_rcu_qsbr_thread_unregister(rv, thread_id);
+
+	printf("Reader on lcore %u: %"PRIu64" lookups, %"PRIu64" hits\n",
+		thread_id, lookups, hits);
+
+	return 0;
+}
+
+/*
+ * Measure route add/delete cost while readers look up the updated
+ * routes concurrently, with tbl8 groups reclaimed through RCU.
+ */
+static int
+test_lpm_rcu_perf(enum rte_lpm_qsbr_mode mode)
+{
+	struct rte_lpm_config config;
+	struct rte_lpm_rcu_config rcu_cfg = {0};
+	uint64_t begin, total_cycles;
+	unsigned int i, j, num_readers;
+	uint32_t next_hop_add = 0xAA;
+	size_t sz;
+
+	num_readers = rte_lcore_count() - 1;
+	if (num_readers == 0) {
+		printf("Not enough lcores for the RCU perf test, skipping\n");
+		return 0;
+	}
+
+	printf("\nPerf test: 1 writer, %u readers, RCU %s mode\n",
+		num_readers,
+		mode == RTE_LPM_QSBR_MODE_DQ ? "defer queue" : "sync");
+
+	/* Pick the routes which need a tbl8 group */
+	rcu_route_num = 0;
+	for (i = 0; i < NUM_ROUTE_ENTRIES && rcu_route_num < RCU_ROUTE_NUM;
+			i++) {
+		if (large_route_table[i].depth <= 24)
+			continue;
+		for (j = 0; j < rcu_route_num; j++)
+			if (rcu_route_ip[j] == large_route_table[i].ip &&
+				rcu_route_depth[j] == large_route_table[i].depth)
+				break;
+		if (j != rcu_route_num)
+			continue;
+		rcu_route_ip[rcu_route_num] = large_route_table[i].ip;
+		rcu_route_depth[rcu_route_num] = large_route_table[i].depth;
+		rcu_route_num++;
+	}
+
+	config.max_rules = RCU_ROUTE_NUM;
+	config.number_tbl8s = RCU_ROUTE_NUM * 2;
+	config.flags = 0;
+	rcu_lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(rcu_lpm != NULL);
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	rv = rte_zmalloc("rcu0", sz, RTE_CACHE_LINE_SIZE);
+	TEST_LPM_ASSERT(rv != NULL);
+	rte_rcu_qsbr_init(rv, RTE_MAX_LCORE);
+
+	rcu_cfg.v = rv;
+	rcu_cfg.mode = mode;
+	if (rte_lpm_rcu_qsbr_add(rcu_lpm, &rcu_cfg, NULL) != 0) {
+		printf("RCU variable assignment failed\n");
+		goto error;
+	}
+
+	/* Add all the routes once so readers have something to find */
+	for (i = 0; i < rcu_route_num; i++)
+		if (rte_lpm_add(rcu_lpm, rcu_route_ip[i], rcu_route_depth[i],
+				next_hop_add) != 0) {
+			printf("Failed to add route %u\n", i);
+			goto error;
+		}
+
+	writer_done = 0;
+	rte_eal_mp_remote_launch(test_lpm_rcu_qsbr_reader, NULL, SKIP_MASTER);
+
+	total_cycles = 0;
+	for (j = 0; j < RCU_ITERATIONS; j++) {
+		begin = rte_rdtsc_precise();
+		for (i = 0; i < rcu_route_num; i++)
+			if (rte_lpm_delete(rcu_lpm, rcu_route_ip[i],
+					rcu_route_depth[i]) != 0) {
+				printf("Failed to delete route %u\n", i);
+				goto error_readers;
+			}
+		for (i = 0; i < rcu_route_num; i++)
+			if (rte_lpm_add(rcu_lpm, rcu_route_ip[i],
+					rcu_route_depth[i], next_hop_add) != 0) {
+				printf("Failed to add route %u\n", i);
+				goto error_readers;
+			}
+		total_cycles += rte_rdtsc_precise() - begin;
+	}
+
+	writer_done = 1;
+	rte_eal_mp_wait_lcore();
+
+	printf("Average LPM Add/Del: %g cycles\n",
+		(double)total_cycles / (rcu_route_num * RCU_ITERATIONS * 2));
+
+	rte_lpm_free(rcu_lpm);
+	rte_free(rv);
+	rcu_lpm = NULL;
+	rv = NULL;
+
+	return 0;
+
+error_readers:
+	writer_done = 1;
+	rte_eal_mp_wait_lcore();
+error:
+	rte_lpm_free(rcu_lpm);
+	rte_free(rv);
+	rcu_lpm = NULL;
+	rv = NULL;
+
+	return -1;
+}
+
 static int
 test_lpm_perf(void)
 {
@@ -478,6 +644,12 @@ test_lpm_perf(void)
 	rte_lpm_delete_all(lpm);
 	rte_lpm_free(lpm);
 
+	if (test_lpm_rcu_perf(RTE_LPM_QSBR_MODE_DQ) < 0)
+		return -1;
+
+	if (test_lpm_rcu_perf(RTE_LPM_QSBR_MODE_SYNC) < 0)
+		return -1;
+
 	return 0;
 }
 
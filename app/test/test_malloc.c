@@ -4,12 +4,14 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
 #include <stdarg.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <sys/queue.h>
 
+#include <rte_atomic.h>
 #include <rte_common.h>
 #include <rte_memory.h>
 #include <rte_eal_memconfig.h>
@@ -19,10 +21,12 @@
 #include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_cycles.h>
+#include <rte_pause.h>
 #include <rte_random.h>
 #include <rte_string_fns.h>
 
 #include "test.h"
+#include "process.h"
 
 #define N 10000
 
@@ -262,6 +266,26 @@ test_str_to_size(void)
 	return 0;
 }
 
+/*
+ * Check whether small allocations are served by the lcore cache
+ * (--malloc-lcore-cache): a refill takes a batch of elements from the
+ * heap, and a cache hit none, instead of one per allocation.
+ */
+static int
+malloc_lcore_cache_enabled(void)
+{
+	struct rte_malloc_socket_stats pre_stats, post_stats;
+	int socket = rte_socket_id();
+	void *p;
+
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+	p = rte_malloc_socket(NULL, RTE_CACHE_LINE_SIZE, 0, socket);
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	rte_free(p);
+
+	return post_stats.alloc_count != pre_stats.alloc_count + 1;
+}
+
 static int
 test_multi_alloc_statistics(void)
 {
@@ -271,6 +295,12 @@ test_multi_alloc_statistics(void)
 	int align = 1024;
 	int overhead = 0;
 
+	/* the heap statistics do not follow each cached allocation */
+	if (malloc_lcore_cache_enabled()) {
+		printf("lcore cache enabled, skipping statistics checks\n");
+		return 0;
+	}
+
 	/* Dynamically calculate the overhead by allocating one cacheline and
 	 * then comparing what was allocated from the heap.
 	 */
@@ -426,6 +456,8 @@ test_realloc(void)
 			return -1;
 		}
 	rte_free(ptr2);
+	/* give ptr2 back to the heap if the lcore cache holds it */
+	rte_malloc_lcore_cache_flush();
 	/* first resize to half the size of the freed block */
 	char *ptr4 = rte_realloc(ptr3, size4, RTE_CACHE_LINE_SIZE);
 	if (!ptr4){
@@ -494,16 +526,17 @@ test_realloc(void)
 	rte_free(ptr8);
 
 	/* test behaviour when there is a free block after current one,
-	 * but its not big enough
+	 * but its not big enough. The blocks are aligned above a cache line
+	 * to be allocated from the heap, not from the lcore cache.
 	 */
 	unsigned size9 = 1024, size10 = 1024;
 	unsigned size11 = size9 + size10 + 256;
-	char *ptr9 = rte_malloc(NULL, size9, RTE_CACHE_LINE_SIZE);
+	char *ptr9 = rte_malloc(NULL, size9, RTE_CACHE_LINE_SIZE * 2);
 	if (!ptr9){
 		printf("NULL pointer returned from rte_malloc\n");
 		return -1;
 	}
-	char *ptr10 = rte_malloc(NULL, size10, RTE_CACHE_LINE_SIZE);
+	char *ptr10 = rte_malloc(NULL, size10, RTE_CACHE_LINE_SIZE * 2);
 	if (!ptr10){
 		printf("NULL pointer returned from rte_malloc\n");
 		return -1;
@@ -967,3 +1000,222 @@ test_malloc(void)
 }
 
 REGISTER_TEST_COMMAND(malloc_autotest, test_malloc);
+
+/*
+ * Malloc performance
+ * ==================
+ *
+ * All lcores allocate and free bursts of objects of the same size at the
+ * same time, to measure the contention on the heap. Run with the EAL option
+ * --malloc-lcore-cache to measure the lcore caches.
+ */
+
+#define MALLOC_PERF_ITERATIONS 100000
+#define MALLOC_PERF_BURST 16
+
+static const size_t malloc_perf_sizes[] = { 64, 256, 1024, 4096 };
+
+static rte_atomic32_t malloc_perf_synchro;
+static size_t malloc_perf_size;
+static uint64_t malloc_perf_cycles[RTE_MAX_LCORE];
+
+static int
+malloc_perf_per_lcore(__attribute__((unused)) void *arg)
+{
+	void *objs[MALLOC_PERF_BURST];
+	unsigned int i, j;
+	uint64_t start;
+	int ret = 0;
+
+	/* wait for the master lcore to start all lcores together */
+	if (rte_lcore_id() == rte_get_master_lcore())
+		rte_atomic32_set(&malloc_perf_synchro, 1);
+	else
+		while (rte_atomic32_read(&malloc_perf_synchro) == 0)
+			rte_pause();
+
+	start = rte_rdtsc();
+	for (i = 0; i < MALLOC_PERF_ITERATIONS / MALLOC_PERF_BURST; i++) {
+		for (j = 0; j < MALLOC_PERF_BURST; j++) {
+			objs[j] = rte_malloc(NULL, malloc_perf_size, 0);
+			if (objs[j] == NULL)
+				break;
+		}
+		if (j != MALLOC_PERF_BURST)
+			ret = -1;
+		while (j > 0)
+			rte_free(objs[--j]);
+		if (ret < 0)
+			break;
+	}
+	malloc_perf_cycles[rte_lcore_id()] = rte_rdtsc() - start;
+
+	rte_malloc_lcore_cache_flush();
+	return ret;
+}
+
+static int
+test_malloc_perf(void)
+{
+	unsigned int i, lcore_id;
+	uint64_t cycles;
+	int ret = 0;
+
+	for (i = 0; i < RTE_DIM(malloc_perf_sizes); i++) {
+		malloc_perf_size = malloc_perf_sizes[i];
+		rte_atomic32_set(&malloc_perf_synchro, 0);
+		memset(malloc_perf_cycles, 0, sizeof(malloc_perf_cycles));
+
+		rte_eal_mp_remote_launch(malloc_perf_per_lcore, NULL,
+				CALL_MASTER);
+		RTE_LCORE_FOREACH(lcore_id) {
+			if (rte_eal_wait_lcore(lcore_id) < 0)
+				ret = -1;
+		}
+		if (ret < 0) {
+			printf("malloc of %zu bytes failed\n", malloc_perf_size);
+			return ret;
+		}
+
+		cycles = 0;
+		RTE_LCORE_FOREACH(lcore_id)
+			cycles += malloc_perf_cycles[lcore_id];
+
+		printf("size %4zu, %u lcores: %"PRIu64" cycles per "
+			"rte_malloc/rte_free\n", malloc_perf_size,
+			rte_lcore_count(), cycles /
+			(MALLOC_PERF_ITERATIONS * rte_lcore_count()));
+	}
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(malloc_perf_autotest, test_malloc_perf);
+
+/*
+ * Lcore caches
+ * ============
+ *
+ * --malloc-lcore-cache cannot be enabled at runtime, so the checks run in a
+ * new process started with the option:
+ *
+ * - a freed object is cached only once, even when freed twice
+ * - an object taken from the cache by rte_zmalloc() is zeroed
+ * - objects overflowing a cache or flushed go back to the heap
+ */
+
+#define MALLOC_CACHE_TEST_OBJS 128
+#define MALLOC_CACHE_TEST_SIZE 256
+
+#define launch_proc(ARGV) \
+	process_dup(ARGV, sizeof(ARGV)/(sizeof(ARGV[0])), __func__)
+
+static int
+malloc_lcore_cache_spawn(void)
+{
+	char core[16];
+#ifdef RTE_EXEC_ENV_LINUX
+	char tmp[PATH_MAX] = {0};
+	char prefix[PATH_MAX] = {0};
+
+	/* do not share the runtime directory of this process */
+	get_current_prefix(tmp, sizeof(tmp));
+	snprintf(prefix, sizeof(prefix), "--file-prefix=%s_lcore_cache", tmp);
+#else
+	const char *prefix = "";
+#endif
+	char const *argv[] = {
+		prgname,
+		"-l", core,
+		prefix,
+		"--no-huge",
+		"--no-shconf",
+		"--no-pci",
+		"--malloc-lcore-cache"
+	};
+
+	snprintf(core, sizeof(core), "%u", rte_get_master_lcore());
+
+	return launch_proc(argv);
+}
+
+int
+test_malloc_lcore_cache(void)
+{
+	struct rte_malloc_socket_stats pre_stats, post_stats;
+	void *objs[MALLOC_CACHE_TEST_OBJS];
+	int socket = rte_socket_id();
+	unsigned int i;
+	char *p1, *p2;
+
+	rte_malloc_lcore_cache_flush();
+	rte_malloc_get_socket_stats(socket, &pre_stats);
+
+	p1 = rte_malloc(NULL, MALLOC_CACHE_TEST_SIZE, 0);
+	if (p1 == NULL) {
+		printf("rte_malloc() failed\n");
+		return -1;
+	}
+	rte_free(p1);
+	rte_free(p1);
+	p1 = rte_malloc(NULL, MALLOC_CACHE_TEST_SIZE, 0);
+	p2 = rte_malloc(NULL, MALLOC_CACHE_TEST_SIZE, 0);
+	if (p1 == NULL || p2 == NULL || p1 == p2) {
+		printf("double free was cached twice\n");
+		return -1;
+	}
+	rte_free(p2);
+
+	memset(p1, 0xff, MALLOC_CACHE_TEST_SIZE);
+	rte_free(p1);
+	p1 = rte_zmalloc(NULL, MALLOC_CACHE_TEST_SIZE, 0);
+	if (p1 == NULL) {
+		printf("rte_zmalloc() failed\n");
+		return -1;
+	}
+	for (i = 0; i < MALLOC_CACHE_TEST_SIZE; i++) {
+		if (p1[i] != 0) {
+			printf("cached object is not zeroed\n");
+			return -1;
+		}
+	}
+	rte_free(p1);
+
+	for (i = 0; i < MALLOC_CACHE_TEST_OBJS; i++) {
+		objs[i] = rte_malloc(NULL, MALLOC_CACHE_TEST_SIZE, 0);
+		if (objs[i] == NULL) {
+			printf("rte_malloc() failed\n");
+			return -1;
+		}
+	}
+	for (i = 0; i < MALLOC_CACHE_TEST_OBJS; i++)
+		rte_free(objs[i]);
+	rte_malloc_lcore_cache_flush();
+	/* the heap must reject a free of an object it already got back */
+	rte_free(objs[0]);
+
+	rte_malloc_get_socket_stats(socket, &post_stats);
+	if (pre_stats.heap_allocsz_bytes != post_stats.heap_allocsz_bytes ||
+			pre_stats.alloc_count != post_stats.alloc_count) {
+		printf("heap usage changed: %zu bytes in %u objects, "
+			"expected %zu bytes in %u objects\n",
+			post_stats.heap_allocsz_bytes, post_stats.alloc_count,
+			pre_stats.heap_allocsz_bytes, pre_stats.alloc_count);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_malloc_lcore_cache_spawn(void)
+{
+	if (malloc_lcore_cache_spawn() != 0) {
+		printf("malloc lcore cache tests failed\n");
+		return -1;
+	}
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(malloc_lcore_cache_autotest,
+		test_malloc_lcore_cache_spawn);
@@ -28,6 +28,7 @@
 #include <rte_random.h>
 #include <rte_cycles.h>
 #include <rte_malloc.h>
+#include <rte_errno.h>
 
 #include "test.h"
 
@@ -502,8 +503,6 @@ test_attach_from_different_pool(struct rte_mempool *pktmbuf_pool,
 		rte_pktmbuf_free(clone2);
 	return -1;
 }
-#undef GOTO_FAIL
-
 /*
  * test allocation and free of mbufs
  */
@@ -1121,6 +1120,197 @@ test_tx_offload(void)
 	return (v1 == v2) ? 0 : -EINVAL;
 }
 
+static int
+test_mbuf_dyn(struct rte_mempool *pktmbuf_pool)
+{
+	const struct rte_mbuf_dynfield dynfield = {
+		.name = "test-dynfield",
+		.size = sizeof(uint8_t),
+		.align = __alignof__(uint8_t),
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynfield dynfield2 = {
+		.name = "test-dynfield2",
+		.size = sizeof(uint16_t),
+		.align = __alignof__(uint16_t),
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynfield dynfield3 = {
+		.name = "test-dynfield3",
+		.size = sizeof(uint64_t),
+		.align = __alignof__(uint64_t),
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynfield dynfield_fail_big = {
+		.name = "test-dynfield-fail-big",
+		.size = 256,
+		.align = 1,
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynfield dynfield_fail_align = {
+		.name = "test-dynfield-fail-align",
+		.size = 1,
+		.align = 3,
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynfield dynfield_fail_busy = {
+		.name = "test-dynfield-fail-busy",
+		.size = 1,
+		.align = 1,
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynflag dynflag = {
+		.name = "test-dynflag",
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynflag dynflag2 = {
+		.name = "test-dynflag2",
+		.flags = 0,
+	};
+	const struct rte_mbuf_dynflag dynflag3 = {
+		.name = "test-dynflag3",
+		.flags = 0,
+	};
+	struct rte_mbuf_dynfield params;
+	struct rte_mbuf *m = NULL, *clone = NULL;
+	int offset, offset2, offset3;
+	int flag, flag2, flag3;
+	int ret;
+	size_t base = offsetof(struct rte_mbuf, dynfield1);
+
+	printf("Test mbuf dynamic fields and flags\n");
+	rte_mbuf_dyn_dump(stdout);
+
+	offset = rte_mbuf_dynfield_register(&dynfield);
+	if (offset == -1)
+		GOTO_FAIL("failed to register dynamic field, offset=%d: %s",
+			offset, rte_strerror(rte_errno));
+	if ((size_t)offset < base || (size_t)offset >= sizeof(*m))
+		GOTO_FAIL("dynamic field outside of reserved area");
+
+	ret = rte_mbuf_dynfield_register(&dynfield);
+	if (ret != offset)
+		GOTO_FAIL("failed to lookup dynamic field, ret=%d: %s",
+			ret, rte_strerror(rte_errno));
+
+	/* the least aligned offset is chosen first */
+	offset2 = rte_mbuf_dynfield_register(&dynfield2);
+	if (offset2 == -1 || offset2 == offset || offset2 % 2 != 0 ||
+			offset2 % 4 == 0)
+		GOTO_FAIL("failed to register dynamic field 2, offset2=%d: %s",
+			offset2, rte_strerror(rte_errno));
+
+	offset3 = rte_mbuf_dynfield_register_offset(&dynfield3,
+				base + 8);
+	if (offset3 != (int)(base + 8))
+		GOTO_FAIL("failed to register dynamic field 3, offset=%d: %s",
+			offset3, rte_strerror(rte_errno));
+
+	printf("dynfield: offset=%d, offset2=%d, offset3=%d\n",
+		offset, offset2, offset3);
+
+	ret = rte_mbuf_dynfield_register_offset(&dynfield3, base);
+	if (ret != -1 || rte_errno != EEXIST)
+		GOTO_FAIL("dynamic field 3 registered at a different offset");
+
+	ret = rte_mbuf_dynfield_register_offset(&dynfield_fail_busy,
+				offset3);
+	if (ret != -1 || rte_errno != EBUSY)
+		GOTO_FAIL("dynamic field registered over a busy offset");
+
+	ret = rte_mbuf_dynfield_register_offset(&dynfield_fail_busy, 0);
+	if (ret != -1 || rte_errno != EBUSY)
+		GOTO_FAIL("dynamic field registered at offset 0");
+
+	ret = rte_mbuf_dynfield_register(&dynfield_fail_big);
+	if (ret != -1 || rte_errno != EINVAL)
+		GOTO_FAIL("dynamic field creation should fail (too big)");
+
+	ret = rte_mbuf_dynfield_register(&dynfield_fail_align);
+	if (ret != -1 || rte_errno != EINVAL)
+		GOTO_FAIL("dynamic field creation should fail (bad alignment)");
+
+	ret = rte_mbuf_dynfield_lookup(dynfield2.name, &params);
+	if (ret != offset2 || params.size != dynfield2.size ||
+			params.align != dynfield2.align)
+		GOTO_FAIL("failed to lookup dynamic field 2");
+
+	ret = rte_mbuf_dynfield_lookup("test-dynfield-unknown", NULL);
+	if (ret != -1 || rte_errno != ENOENT)
+		GOTO_FAIL("lookup of an unknown dynamic field should fail");
+
+	flag = rte_mbuf_dynflag_register(&dynflag);
+	if (flag == -1)
+		GOTO_FAIL("failed to register dynamic flag, flag=%d: %s",
+			flag, rte_strerror(rte_errno));
+	if (flag < (int)rte_bsf64(PKT_FIRST_FREE) ||
+			flag > (int)rte_bsf64(PKT_LAST_FREE))
+		GOTO_FAIL("dynamic flag outside of free bits");
+
+	ret = rte_mbuf_dynflag_register(&dynflag);
+	if (ret != flag)
+		GOTO_FAIL("failed to lookup dynamic flag, ret=%d: %s",
+			ret, rte_strerror(rte_errno));
+
+	flag2 = rte_mbuf_dynflag_register(&dynflag2);
+	if (flag2 == -1 || flag2 == flag)
+		GOTO_FAIL("failed to register dynamic flag 2, flag2=%d: %s",
+			flag2, rte_strerror(rte_errno));
+
+	flag3 = rte_mbuf_dynflag_register_bitnum(&dynflag3,
+						rte_bsf64(PKT_LAST_FREE));
+	if (flag3 != (int)rte_bsf64(PKT_LAST_FREE))
+		GOTO_FAIL("failed to register dynamic flag 3, flag3=%d: %s",
+			flag3, rte_strerror(rte_errno));
+
+	printf("dynflag: flag=%d, flag2=%d, flag3=%d\n", flag, flag2, flag3);
+
+	ret = rte_mbuf_dynflag_register_bitnum(&dynflag3, flag);
+	if (ret != -1 || rte_errno != EEXIST)
+		GOTO_FAIL("dynamic flag 3 registered at a different bit");
+
+	ret = rte_mbuf_dynflag_register_bitnum(&dynflag3, 64);
+	if (ret != -1 || rte_errno != EINVAL)
+		GOTO_FAIL("dynamic flag registered with an invalid bitnum");
+
+	ret = rte_mbuf_dynflag_lookup("test-dynflag-unknown", NULL);
+	if (ret != -1 || rte_errno != ENOENT)
+		GOTO_FAIL("lookup of an unknown dynamic flag should fail");
+
+	rte_mbuf_dyn_dump(stdout);
+
+	/* set, get dynamic field and check that it is kept by a clone */
+	m = rte_pktmbuf_alloc(pktmbuf_pool);
+	if (m == NULL)
+		GOTO_FAIL("Cannot allocate mbuf");
+
+	*RTE_MBUF_DYNFIELD(m, offset, uint8_t *) = 1;
+	*RTE_MBUF_DYNFIELD(m, offset2, uint16_t *) = 1000;
+	*RTE_MBUF_DYNFIELD(m, offset3, uint64_t *) = UINT64_MAX - 1;
+	m->ol_flags |= 1ULL << flag;
+
+	clone = rte_pktmbuf_clone(m, pktmbuf_pool);
+	if (clone == NULL)
+		GOTO_FAIL("cannot clone mbuf");
+
+	if (*RTE_MBUF_DYNFIELD(clone, offset, uint8_t *) != 1 ||
+			*RTE_MBUF_DYNFIELD(clone, offset2, uint16_t *) != 1000 ||
+			*RTE_MBUF_DYNFIELD(clone, offset3, uint64_t *) !=
+				UINT64_MAX - 1)
+		GOTO_FAIL("dynamic fields not copied to the clone");
+
+	rte_pktmbuf_free(clone);
+	rte_pktmbuf_free(m);
+
+	return 0;
+
+fail:
+	rte_pktmbuf_free(clone);
+	rte_pktmbuf_free(m);
+	return -1;
+}
+#undef GOTO_FAIL
+
 static int
 test_mbuf(void)
 {
@@ -1225,6 +1415,11 @@ test_mbuf(void)
 		goto err;
 	}
 
+	if (test_mbuf_dyn(pktmbuf_pool) < 0) {
+		printf("test_mbuf_dyn() failed\n");
+		goto err;
+	}
+
 	ret = 0;
 err:
 	rte_mempool_free(pktmbuf_pool);
@@ -3,11 +3,13 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
 
 #include <rte_lcore.h>
+#include <rte_launch.h>
 #include <rte_metrics.h>
 
 #include "test.h"
@@ -17,6 +19,8 @@
 #define	METRIC_LESSER_COUNT	3
 #define	KEY	1
 #define	VALUE	1
+#define	LCORE_PORT	3
+#define	LCORE_ITERATIONS	100000
 
 /* Initializes metric module. This function must be called
  * from a primary process before metrics are used
@@ -259,6 +263,99 @@ test_metrics_get_values(void)
 	return TEST_SUCCESS;
 }
 
+static int lcore_key;
+
+static int
+metrics_lcore_set(void *arg __rte_unused)
+{
+	const uint64_t value[2] = {rte_lcore_id() + 1, 1};
+
+	return rte_metrics_lcore_update_values(LCORE_PORT, lcore_key,
+			value, 2);
+}
+
+static int
+metrics_lcore_write(void *arg __rte_unused)
+{
+	uint64_t value[2];
+	uint64_t i;
+
+	for (i = 0; i < LCORE_ITERATIONS; i++) {
+		value[0] = value[1] = i;
+		if (rte_metrics_lcore_update_values(LCORE_PORT + 1, lcore_key,
+				value, 2) < 0)
+			return -1;
+	}
+	return 0;
+}
+
+/* Test case to validate the sum of the values updated per lcore */
+static int
+test_metrics_lcore_update_values(void)
+{
+	const char * const mnames[] = { "lcore_sum", "lcore_count" };
+	struct rte_metric_value *getvalues;
+	const uint64_t value[2] = {100, 0};
+	uint64_t sum = 0, count = 0;
+	unsigned int lcore_id;
+	int err, len, i;
+
+	lcore_key = rte_metrics_reg_names(&mnames[0], ARRAY_SIZE(mnames));
+	TEST_ASSERT(lcore_key >= 0, "%s, %d", __func__, __LINE__);
+
+	/* Failed Test: Invalid port_id, array and count size */
+	err = rte_metrics_lcore_update_values(-2, lcore_key, value, 2);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_lcore_update_values(LCORE_PORT, lcore_key, NULL, 2);
+	TEST_ASSERT(err == -EINVAL, "%s, %d", __func__, __LINE__);
+	err = rte_metrics_lcore_update_values(LCORE_PORT, lcore_key, value, 3);
+	TEST_ASSERT(err == -ERANGE, "%s, %d", __func__, __LINE__);
+
+	/* The shared value is added to the values of the lcores */
+	err = rte_metrics_update_values(LCORE_PORT, lcore_key, value, 2);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+	err = rte_eal_mp_remote_launch(metrics_lcore_set, NULL, CALL_MASTER);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	RTE_LCORE_FOREACH(lcore_id) {
+		TEST_ASSERT(rte_eal_wait_lcore(lcore_id) == 0, "%s, %d",
+				__func__, __LINE__);
+		sum += lcore_id + 1;
+		count++;
+	}
+
+	len = rte_metrics_get_values(LCORE_PORT, NULL, 0);
+	TEST_ASSERT(len > lcore_key + 1, "%s, %d", __func__, __LINE__);
+	getvalues = calloc(len, sizeof(*getvalues));
+	TEST_ASSERT_NOT_NULL(getvalues, "%s, %d", __func__, __LINE__);
+
+	err = rte_metrics_get_values(LCORE_PORT, getvalues, len);
+	TEST_ASSERT(err == len, "%s, %d", __func__, __LINE__);
+	TEST_ASSERT(getvalues[lcore_key].value == sum + 100,
+			"%s, %d", __func__, __LINE__);
+	TEST_ASSERT(getvalues[lcore_key + 1].value == count,
+			"%s, %d", __func__, __LINE__);
+
+	/* Concurrent reads get consistent snapshots of a set */
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	if (lcore_id < RTE_MAX_LCORE) {
+		rte_eal_remote_launch(metrics_lcore_write, NULL, lcore_id);
+		for (i = 0; i < LCORE_ITERATIONS; i++) {
+			rte_metrics_get_values(LCORE_PORT + 1, getvalues, len);
+			if (getvalues[lcore_key].value !=
+					getvalues[lcore_key + 1].value)
+				break;
+		}
+		err = rte_eal_wait_lcore(lcore_id);
+		TEST_ASSERT(i == LCORE_ITERATIONS, "%s, %d", __func__,
+				__LINE__);
+		TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+	}
+	free(getvalues);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite metrics_testsuite  = {
 	.suite_name = "Metrics Unit Test Suite",
 	.setup = NULL,
@@ -300,6 +397,11 @@ static struct unit_test_suite metrics_testsuite  = {
 		 * arraylist, count size
 		 */
 		TEST_CASE(test_metrics_get_values),
+
+		/* TEST CASE 8: Test to update values per lcore, and get their
+		 * sum while they are updated
+		 */
+		TEST_CASE(test_metrics_lcore_update_values),
 		TEST_CASES_END()
 	}
 };
@@ -4,12 +4,14 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <rte_pause.h>
 #include <rte_rcu_qsbr.h>
 #include <rte_hash.h>
 #include <rte_hash_crc.h>
 #include <rte_malloc.h>
 #include <rte_cycles.h>
+#include <rte_errno.h>
 #include <unistd.h>
 
 #include "test.h"
@@ -615,6 +617,178 @@ test_rcu_qsbr_dump(void)
 	return 0;
 }
 
+static uint32_t dq_freed;
+static uint32_t dq_next_val;
+static int dq_error;
+
+/* Free callback of the defer queue tests */
+static void
+test_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
+{
+	uint32_t *data = e;
+
+	/* resources must be freed in the order they were enqueued */
+	if (p != &dq_freed || data[0] != dq_next_val)
+		dq_error = 1;
+	dq_next_val++;
+	dq_freed += n;
+}
+
+/*
+ * rte_rcu_qsbr_dq_create: create a queue used to store the data structure
+ * elements that can be freed later.
+ */
+static int
+test_rcu_qsbr_dq_create(void)
+{
+	struct rte_rcu_qsbr_dq_parameters params;
+	struct rte_rcu_qsbr_dq *dq;
+
+	printf("\nTest rte_rcu_qsbr_dq_create()\n");
+
+	rte_rcu_qsbr_init(t[0], RTE_MAX_LCORE);
+
+	/* Invalid parameters */
+	dq = rte_rcu_qsbr_dq_create(NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL), "dq create invalid params");
+
+	memset(&params, 0, sizeof(params));
+	params.name = "TEST_RCU";
+	params.size = 1;
+	params.esize = 4;
+	params.v = t[0];
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL), "dq create NULL free_fn");
+
+	params.free_fn = test_rcu_qsbr_free_resource;
+	params.esize = 3;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL || rte_errno != EINVAL),
+		"dq create invalid esize");
+
+	/* auto reclamation enabled without a reclaim budget */
+	params.esize = 4;
+	params.size = 8;
+	params.trigger_reclaim_limit = 4;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL || rte_errno != EINVAL),
+		"dq create invalid max_reclaim_size");
+
+	params.max_reclaim_size = 2;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create valid params");
+
+	TEST_RCU_QSBR_RETURN_IF_ERROR((rte_rcu_qsbr_dq_enqueue(NULL, &params)
+		!= 1), "dq enqueue invalid params");
+	TEST_RCU_QSBR_RETURN_IF_ERROR((rte_rcu_qsbr_dq_enqueue(dq, NULL) != 1),
+		"dq enqueue invalid params");
+	TEST_RCU_QSBR_RETURN_IF_ERROR((rte_rcu_qsbr_dq_reclaim(NULL, 1, NULL,
+		NULL, NULL) != 1), "dq reclaim invalid params");
+
+	TEST_RCU_QSBR_RETURN_IF_ERROR((rte_rcu_qsbr_dq_delete(dq) != 0),
+		"dq delete valid params");
+	TEST_RCU_QSBR_RETURN_IF_ERROR((rte_rcu_qsbr_dq_delete(NULL) != 0),
+		"dq delete NULL");
+
+	return 0;
+}
+
+/*
+ * Enqueue resources on a defer queue and check that they are reclaimed,
+ * in order, only after the reader thread reported its quiescent state.
+ */
+static int
+test_rcu_qsbr_dq_functional(uint32_t size, uint32_t esize, uint32_t flags,
+	uint32_t trigger_reclaim_limit)
+{
+	struct rte_rcu_qsbr_dq_parameters params;
+	struct rte_rcu_qsbr_dq *dq;
+	unsigned int freed, pending, available;
+	uint32_t *e;
+	uint32_t i, total;
+	int ret;
+
+	printf("\nTest defer queue, size = %u, esize = %u, flags = 0x%x, trigger reclaim limit = %u\n",
+		size, esize, flags, trigger_reclaim_limit);
+
+	e = rte_zmalloc(NULL, esize, 0);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((e == NULL), "element alloc");
+
+	rte_rcu_qsbr_init(t[0], RTE_MAX_LCORE);
+	rte_rcu_qsbr_thread_register(t[0], enabled_core_ids[0]);
+	rte_rcu_qsbr_thread_online(t[0], enabled_core_ids[0]);
+
+	memset(&params, 0, sizeof(params));
+	params.name = "TEST_RCU";
+	params.flags = flags;
+	params.size = size;
+	params.esize = esize;
+	params.trigger_reclaim_limit = trigger_reclaim_limit;
+	params.max_reclaim_size = size;
+	params.free_fn = test_rcu_qsbr_free_resource;
+	params.p = &dq_freed;
+	params.v = t[0];
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create");
+
+	dq_freed = 0;
+	dq_next_val = 0;
+	dq_error = 0;
+
+	/* The reader is online and has not reported quiescent state,
+	 * nothing can be reclaimed. Enqueue must not block on it.
+	 */
+	for (total = 0; total < size; total++) {
+		e[0] = total;
+		ret = rte_rcu_qsbr_dq_enqueue(dq, e);
+		TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "dq enqueue");
+	}
+	e[0] = total;
+	ret = rte_rcu_qsbr_dq_enqueue(dq, e);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1 || rte_errno != ENOSPC),
+		"dq enqueue on full queue");
+
+	ret = rte_rcu_qsbr_dq_reclaim(dq, size, &freed, &pending, &available);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || freed != 0 ||
+		pending != size || available != 0 || dq_freed != 0),
+		"dq reclaim before quiescent state");
+
+	ret = rte_rcu_qsbr_dq_delete(dq);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1 || rte_errno != EAGAIN),
+		"dq delete with pending resources");
+
+	/* Reclaim within the given budget once the grace period is over */
+	rte_rcu_qsbr_quiescent(t[0], enabled_core_ids[0]);
+	ret = rte_rcu_qsbr_dq_reclaim(dq, size / 2, &freed, &pending,
+					&available);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || freed != size / 2 ||
+		pending != size - size / 2 || available != size / 2),
+		"dq reclaim after quiescent state");
+
+	/* Resources enqueued now need another grace period */
+	for (i = 0; i < size / 2; i++, total++) {
+		e[0] = total;
+		ret = rte_rcu_qsbr_dq_enqueue(dq, e);
+		TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "dq enqueue");
+	}
+	ret = rte_rcu_qsbr_dq_reclaim(dq, size, &freed, &pending, NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || pending != size / 2 ||
+		dq_freed != size),
+		"dq reclaim of new resources");
+
+	rte_rcu_qsbr_quiescent(t[0], enabled_core_ids[0]);
+	ret = rte_rcu_qsbr_dq_delete(dq);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "dq delete");
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq_freed != total || dq_error != 0),
+		"resources freed out of order or more than once");
+
+	rte_rcu_qsbr_thread_offline(t[0], enabled_core_ids[0]);
+	rte_rcu_qsbr_thread_unregister(t[0], enabled_core_ids[0]);
+	rte_free(e);
+
+	return 0;
+}
+
 static int
 test_rcu_qsbr_reader(void *arg)
 {
@@ -1026,6 +1200,23 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_thread_offline() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_dq_create() < 0)
+		goto test_fail;
+
+	/* Defer queue, without and with automatic reclamation */
+	if (test_rcu_qsbr_dq_functional(2, 8, 0, 3) < 0)
+		goto test_fail;
+
+	if (test_rcu_qsbr_dq_functional(16, 4, 0, 17) < 0)
+		goto test_fail;
+
+	if (test_rcu_qsbr_dq_functional(16, 4, RTE_RCU_QSBR_DQ_MT_UNSAFE,
+			0) < 0)
+		goto test_fail;
+
+	if (test_rcu_qsbr_dq_functional(64, 20, 0, 8) < 0)
+		goto test_fail;
+
 	printf("\nFunctional tests\n");
 
 	if (test_rcu_qsbr_sw_sv_3qs() < 0)
@@ -23,6 +23,7 @@
 #include <rte_branch_prediction.h>
 #include <rte_malloc.h>
 #include <rte_ring.h>
+#include <rte_ring_elem.h>
 #include <rte_random.h>
 #include <rte_errno.h>
 #include <rte_hexdump.h>
@@ -47,6 +48,24 @@
  *      - Dequeue one object, two objects, MAX_BULK objects
  *      - Check that dequeued pointers are correct
  *
+ *    - Using rings with a user defined element size:
+ *
+ *      - Enqueue/dequeue elements of 4, 8, 16 and 32 bytes in bulk and
+ *        burst mode, wrapping around the end of the ring
+ *      - Check that dequeued elements are correct
+ *
+ *    - Using rings in relaxed tail sync (RTS) and head/tail sync (HTS)
+ *      modes:
+ *
+ *      - Enqueue/dequeue through the default and the mode specific APIs
+ *      - Check the head/tail distance controls and invalid flag combinations
+ *
+ *    - Using the peek and zero copy APIs in SP/SC and HTS modes:
+ *
+ *      - Reserve space, abort or commit the enqueue
+ *      - Peek at dequeued objects and remove only part of them
+ *      - Read and write elements directly in the ring, across its end
+ *
  * #. Performance tests.
  *
  * Tests done in test_ring_perf.c
@@ -807,6 +826,443 @@ test_ring_with_exact_size(void)
 	return ret;
 }
 
+/*
+ * Enqueue/dequeue elements of the given size through all the element ring
+ * APIs, crossing the ring boundary a number of times.
+ */
+static int
+test_ring_elem_esize(unsigned int esize)
+{
+	const unsigned int ring_sz = 64;
+	unsigned int i, j, n, iter;
+	uint32_t *src = NULL, *dst = NULL;
+	struct rte_ring *r;
+	unsigned int nb_words;
+	int ret = -1;
+
+	r = rte_ring_create_elem("test_ring_elem", esize, ring_sz,
+			SOCKET_ID_ANY, 0);
+	if (r == NULL) {
+		printf("%s: cannot create ring with esize %u\n", __func__,
+				esize);
+		return -1;
+	}
+
+	nb_words = esize / sizeof(uint32_t);
+	src = rte_zmalloc(NULL, MAX_BULK * esize, 0);
+	dst = rte_zmalloc(NULL, MAX_BULK * esize, 0);
+	if (src == NULL || dst == NULL)
+		goto end;
+
+	/* odd bulk sizes make the ring wrap at different offsets */
+	for (iter = 0; iter < 3 * ring_sz; iter++) {
+		n = (iter % (MAX_BULK - 1)) + 1;
+		for (i = 0; i < n * nb_words; i++)
+			src[i] = (iter << 16) | i;
+		memset(dst, 0, MAX_BULK * esize);
+
+		switch (iter % 3) {
+		case 0:
+			TEST_RING_VERIFY(rte_ring_sp_enqueue_bulk_elem(r, src,
+					esize, n, NULL) == n);
+			TEST_RING_VERIFY(rte_ring_sc_dequeue_bulk_elem(r, dst,
+					esize, n, NULL) == n);
+			break;
+		case 1:
+			TEST_RING_VERIFY(rte_ring_mp_enqueue_burst_elem(r, src,
+					esize, n, NULL) == n);
+			TEST_RING_VERIFY(rte_ring_mc_dequeue_burst_elem(r, dst,
+					esize, n, NULL) == n);
+			break;
+		default:
+			for (j = 0; j < n; j++)
+				TEST_RING_VERIFY(rte_ring_enqueue_elem(r,
+					src + j * nb_words, esize) == 0);
+			for (j = 0; j < n; j++)
+				TEST_RING_VERIFY(rte_ring_dequeue_elem(r,
+					dst + j * nb_words, esize) == 0);
+			break;
+		}
+		if (memcmp(src, dst, n * esize) != 0) {
+			printf("%s: esize %u, iteration %u: data mismatch\n",
+					__func__, esize, iter);
+			goto end;
+		}
+	}
+
+	/* fill the ring and check that bulk and burst limits are honoured */
+	for (i = 0; i < ring_sz - 1; i++)
+		TEST_RING_VERIFY(rte_ring_enqueue_elem(r, src, esize) == 0);
+	TEST_RING_VERIFY(rte_ring_full(r));
+	TEST_RING_VERIFY(rte_ring_enqueue_elem(r, src, esize) == -ENOBUFS);
+	TEST_RING_VERIFY(rte_ring_dequeue_bulk_elem(r, dst, esize,
+			MAX_BULK, NULL) == MAX_BULK);
+	TEST_RING_VERIFY(rte_ring_dequeue_burst_elem(r, dst, esize,
+			MAX_BULK, NULL) == ring_sz - 1 - MAX_BULK);
+	TEST_RING_VERIFY(rte_ring_empty(r));
+	TEST_RING_VERIFY(rte_ring_dequeue_elem(r, dst, esize) == -ENOENT);
+
+	ret = 0;
+end:
+	rte_free(src);
+	rte_free(dst);
+	rte_ring_free(r);
+	return ret;
+}
+
+static int
+test_ring_elem(void)
+{
+	static const unsigned int esizes[] = { 4, 8, 12, 16, 20, 32 };
+	unsigned int i;
+
+	/* element size must be a non-zero multiple of 4 */
+	if (rte_ring_get_memsize_elem(6, RING_SIZE) != -EINVAL ||
+			rte_ring_get_memsize_elem(0, RING_SIZE) != -EINVAL) {
+		printf("%s: invalid element size accepted\n", __func__);
+		return -1;
+	}
+	if (rte_ring_create_elem("test_ring_elem", 10, RING_SIZE,
+			SOCKET_ID_ANY, 0) != NULL) {
+		printf("%s: ring with invalid element size created\n",
+				__func__);
+		return -1;
+	}
+	if (rte_ring_get_memsize_elem(sizeof(void *), RING_SIZE) !=
+			rte_ring_get_memsize(RING_SIZE)) {
+		printf("%s: pointer ring size mismatch\n", __func__);
+		return -1;
+	}
+
+	for (i = 0; i < RTE_DIM(esizes); i++)
+		if (test_ring_elem_esize(esizes[i]) < 0)
+			return -1;
+
+	return 0;
+}
+
+/*
+ * Enqueue/dequeue through the default functions and the sync mode specific
+ * ones for a ring created with the given flags.
+ */
+static int
+test_ring_sync_mode(const char *name, unsigned int flags,
+	unsigned int (*enq)(struct rte_ring *, void * const *, unsigned int,
+			unsigned int *),
+	unsigned int (*deq)(struct rte_ring *, void **, unsigned int,
+			unsigned int *))
+{
+	void *src[MAX_BULK], *dst[MAX_BULK];
+	unsigned int i, iter, n, avail;
+	struct rte_ring *r;
+	int ret = -1;
+
+	r = rte_ring_create(name, RING_SIZE, SOCKET_ID_ANY, flags);
+	if (r == NULL) {
+		printf("%s: cannot create ring %s\n", __func__, name);
+		return -1;
+	}
+
+	for (i = 0; i < MAX_BULK; i++)
+		src[i] = (void *)(uintptr_t)(i + 1);
+
+	for (iter = 0; iter < 2 * RING_SIZE / MAX_BULK; iter++) {
+		n = (iter % MAX_BULK) + 1;
+		memset(dst, 0, sizeof(dst));
+
+		if (iter & 1) {
+			if (enq(r, src, n, NULL) != n ||
+					deq(r, dst, n, &avail) != n)
+				goto end;
+		} else {
+			if (rte_ring_enqueue_bulk(r, src, n, NULL) != n ||
+					rte_ring_dequeue_burst(r, dst, MAX_BULK,
+						&avail) != n)
+				goto end;
+		}
+		if (avail != 0 || memcmp(src, dst, n * sizeof(src[0])) != 0)
+			goto end;
+	}
+
+	/* single object and full ring checks go through the default API */
+	for (i = 0; i < RING_SIZE - 1; i++)
+		if (rte_ring_enqueue(r, src[0]) != 0)
+			goto end;
+	if (rte_ring_enqueue(r, src[0]) != -ENOBUFS || !rte_ring_full(r))
+		goto end;
+	for (i = 0; i < RING_SIZE - 1; i++)
+		if (rte_ring_dequeue(r, &dst[0]) != 0 || dst[0] != src[0])
+			goto end;
+	if (rte_ring_dequeue(r, &dst[0]) != -ENOENT || !rte_ring_empty(r))
+		goto end;
+
+	ret = 0;
+end:
+	if (ret != 0) {
+		printf("%s: ring %s failed at iteration %u\n", __func__, name,
+				iter);
+		rte_ring_dump(stdout, r);
+	}
+	rte_ring_free(r);
+	return ret;
+}
+
+static int
+test_ring_sync_modes(void)
+{
+	struct rte_ring *r;
+
+	if (test_ring_sync_mode("test_ring_rts",
+			RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ,
+			rte_ring_mp_rts_enqueue_bulk,
+			rte_ring_mc_rts_dequeue_bulk) < 0)
+		return -1;
+	if (test_ring_sync_mode("test_ring_hts",
+			RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ,
+			rte_ring_mp_hts_enqueue_burst,
+			rte_ring_mc_hts_dequeue_burst) < 0)
+		return -1;
+	/* producer and consumer sync modes are independent */
+	if (test_ring_sync_mode("test_ring_rts_hts",
+			RING_F_MP_RTS_ENQ | RING_F_MC_HTS_DEQ,
+			rte_ring_mp_rts_enqueue_burst,
+			rte_ring_mc_hts_dequeue_bulk) < 0)
+		return -1;
+	if (test_ring_sync_mode("test_ring_sp_rts", RING_F_SP_ENQ |
+			RING_F_MC_RTS_DEQ, rte_ring_sp_enqueue_bulk,
+			rte_ring_mc_rts_dequeue_burst) < 0)
+		return -1;
+
+	/* conflicting sync mode flags */
+	r = rte_ring_create("test_ring_bad_sync", RING_SIZE, SOCKET_ID_ANY,
+			RING_F_SP_ENQ | RING_F_MP_HTS_ENQ);
+	if (r != NULL || rte_errno != EINVAL) {
+		printf("%s: ring with conflicting producer flags created\n",
+				__func__);
+		rte_ring_free(r);
+		return -1;
+	}
+	r = rte_ring_create("test_ring_bad_sync", RING_SIZE, SOCKET_ID_ANY,
+			RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ);
+	if (r != NULL || rte_errno != EINVAL) {
+		printf("%s: ring with conflicting consumer flags created\n",
+				__func__);
+		rte_ring_free(r);
+		return -1;
+	}
+
+	/* head/tail distance is only available in RTS mode */
+	r = rte_ring_create("test_ring_htd", RING_SIZE, SOCKET_ID_ANY,
+			RING_F_MP_RTS_ENQ | RING_F_SC_DEQ);
+	if (r == NULL)
+		return -1;
+	if (rte_ring_get_prod_htd_max(r) != (RING_SIZE - 1) / 8 ||
+			rte_ring_set_prod_htd_max(r, 0) != 0 ||
+			rte_ring_get_prod_htd_max(r) != 0 ||
+			rte_ring_get_cons_htd_max(r) != UINT32_MAX ||
+			rte_ring_set_cons_htd_max(r, 1) != -ENOTSUP) {
+		printf("%s: unexpected head/tail distance handling\n",
+				__func__);
+		rte_ring_free(r);
+		return -1;
+	}
+	rte_ring_free(r);
+
+	return 0;
+}
+
+/*
+ * Use the two-phase peek API to enqueue objects and to inspect them in the
+ * ring before deciding how many to actually remove.
+ */
+static int
+test_ring_peek(const char *name, unsigned int flags)
+{
+	const unsigned int ring_sz = 64;
+	void *src[MAX_BULK], *dst[MAX_BULK];
+	unsigned int i, iter, n, k, avail;
+	struct rte_ring *r;
+	int ret = -1;
+
+	r = rte_ring_create(name, ring_sz, SOCKET_ID_ANY, flags);
+	if (r == NULL) {
+		printf("%s: cannot create ring %s\n", __func__, name);
+		return -1;
+	}
+
+	for (i = 0; i < MAX_BULK; i++)
+		src[i] = (void *)(uintptr_t)(i + 1);
+
+	for (iter = 0; iter < 3 * ring_sz; iter++) {
+		n = (iter % MAX_BULK) + 1;
+		memset(dst, 0, sizeof(dst));
+
+		/* an aborted enqueue leaves the ring untouched */
+		if (rte_ring_enqueue_bulk_start(r, n, NULL) != n)
+			goto end;
+		rte_ring_enqueue_finish(r, src, 0);
+		if (!rte_ring_empty(r))
+			goto end;
+
+		if (rte_ring_enqueue_burst_start(r, n, &avail) != n ||
+				avail != ring_sz - 1 - n)
+			goto end;
+		rte_ring_enqueue_finish(r, src, n);
+
+		/* peek at all objects, but remove only half of them */
+		k = n / 2;
+		if (rte_ring_dequeue_bulk_start(r, dst, n, &avail) != n ||
+				avail != 0 ||
+				memcmp(src, dst, n * sizeof(src[0])) != 0)
+			goto end;
+		rte_ring_dequeue_finish(r, k);
+		if (rte_ring_count(r) != n - k)
+			goto end;
+
+		/* the objects left behind are seen again, in order */
+		if (rte_ring_dequeue_burst_start(r, dst, MAX_BULK, NULL) !=
+				n - k || memcmp(src + k, dst,
+					(n - k) * sizeof(src[0])) != 0)
+			goto end;
+		rte_ring_dequeue_finish(r, n - k);
+		if (!rte_ring_empty(r))
+			goto end;
+	}
+
+	ret = 0;
+end:
+	if (ret != 0) {
+		printf("%s: ring %s failed at iteration %u\n", __func__, name,
+				iter);
+		rte_ring_dump(stdout, r);
+	}
+	rte_ring_free(r);
+	return ret;
+}
+
+/* copy between a linear buffer and the ring space described by zcd */
+static void
+test_ring_zc_copy(struct rte_ring_zc_data *zcd, void *buf, unsigned int esize,
+	unsigned int n, int to_ring)
+{
+	unsigned int n1 = RTE_MIN(zcd->n1, n);
+	char *p = buf;
+
+	if (to_ring) {
+		memcpy(zcd->ptr1, p, n1 * esize);
+		if (n > n1)
+			memcpy(zcd->ptr2, p + n1 * esize, (n - n1) * esize);
+	} else {
+		memcpy(p, zcd->ptr1, n1 * esize);
+		if (n > n1)
+			memcpy(p + n1 * esize, zcd->ptr2, (n - n1) * esize);
+	}
+}
+
+/*
+ * Produce and consume elements directly in the ring memory with the zero
+ * copy API, wrapping around the end of the ring.
+ */
+static int
+test_ring_peek_zc(const char *name, unsigned int flags, unsigned int esize)
+{
+	const unsigned int ring_sz = 64;
+	struct rte_ring_zc_data zcd;
+	unsigned int i, iter = 0, n, k;
+	uint32_t *src = NULL, *dst = NULL;
+	struct rte_ring *r;
+	int ret = -1;
+
+	r = rte_ring_create_elem(name, esize, ring_sz, SOCKET_ID_ANY, flags);
+	if (r == NULL) {
+		printf("%s: cannot create ring %s\n", __func__, name);
+		return -1;
+	}
+
+	src = rte_zmalloc(NULL, MAX_BULK * esize, 0);
+	dst = rte_zmalloc(NULL, MAX_BULK * esize, 0);
+	if (src == NULL || dst == NULL)
+		goto end;
+
+	for (iter = 0; iter < 3 * ring_sz; iter++) {
+		n = (iter % MAX_BULK) + 1;
+		for (i = 0; i < n * esize / sizeof(uint32_t); i++)
+			src[i] = (iter << 16) | i;
+		memset(dst, 0, MAX_BULK * esize);
+
+		if (rte_ring_enqueue_zc_burst_elem_start(r, esize, n, &zcd,
+				NULL) != n)
+			goto end;
+		if (zcd.n1 > n || (zcd.n1 != n && zcd.ptr2 == NULL))
+			goto end;
+		test_ring_zc_copy(&zcd, src, esize, n, 1);
+		rte_ring_enqueue_zc_elem_finish(r, n);
+
+		/* consume the first half, leave the rest in the ring */
+		k = n / 2;
+		if (rte_ring_dequeue_zc_bulk_elem_start(r, esize, n, &zcd,
+				NULL) != n)
+			goto end;
+		test_ring_zc_copy(&zcd, dst, esize, n, 0);
+		rte_ring_dequeue_zc_elem_finish(r, k);
+		if (memcmp(src, dst, n * esize) != 0 ||
+				rte_ring_count(r) != n - k)
+			goto end;
+
+		if (rte_ring_dequeue_zc_burst_elem_start(r, esize, MAX_BULK,
+				&zcd, NULL) != n - k)
+			goto end;
+		test_ring_zc_copy(&zcd, dst, esize, n - k, 0);
+		rte_ring_dequeue_zc_elem_finish(r, n - k);
+		if (memcmp((char *)src + k * esize, dst,
+				(n - k) * esize) != 0 || !rte_ring_empty(r))
+			goto end;
+	}
+
+	/* bulk reservation fails when there is not enough room */
+	if (rte_ring_enqueue_zc_bulk_elem_start(r, esize, ring_sz, &zcd,
+			NULL) != 0)
+		goto end;
+
+	ret = 0;
+end:
+	if (ret != 0) {
+		printf("%s: ring %s esize %u failed at iteration %u\n",
+				__func__, name, esize, iter);
+		rte_ring_dump(stdout, r);
+	}
+	rte_free(src);
+	rte_free(dst);
+	rte_ring_free(r);
+	return ret;
+}
+
+static int
+test_ring_peek_modes(void)
+{
+	static const struct {
+		const char *name;
+		unsigned int flags;
+	} modes[] = {
+		{ "test_peek_st", RING_F_SP_ENQ | RING_F_SC_DEQ },
+		{ "test_peek_hts", RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ },
+		{ "test_peek_st_hts", RING_F_SP_ENQ | RING_F_MC_HTS_DEQ },
+	};
+	static const unsigned int esizes[] = { 4, 8, 16, 20 };
+	unsigned int i, j;
+
+	for (i = 0; i < RTE_DIM(modes); i++) {
+		if (test_ring_peek(modes[i].name, modes[i].flags) < 0)
+			return -1;
+		for (j = 0; j < RTE_DIM(esizes); j++)
+			if (test_ring_peek_zc(modes[i].name, modes[i].flags,
+					esizes[j]) < 0)
+				return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_ring(void)
 {
@@ -860,6 +1316,18 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	/* rings with user defined element size */
+	if (test_ring_elem() < 0)
+		goto test_fail;
+
+	/* rings using RTS and HTS sync modes */
+	if (test_ring_sync_modes() < 0)
+		goto test_fail;
+
+	/* two-phase peek and zero copy API */
+	if (test_ring_peek_modes() < 0)
+		goto test_fail;
+
 	/* dump the ring status */
 	rte_ring_list_dump(stdout);
 
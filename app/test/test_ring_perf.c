@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <inttypes.h>
 #include <rte_ring.h>
+#include <rte_ring_elem.h>
 #include <rte_cycles.h>
 #include <rte_launch.h>
 #include <rte_pause.h>
@@ -20,11 +21,31 @@
  *  * Empty ring dequeue
  *  * Enqueue/dequeue of bursts in 1 threads
  *  * Enqueue/dequeue of bursts in 2 threads
+ *
+ * All tests are repeated for the legacy pointer ring and for rings with
+ * several user defined element sizes.
+ *
+ * Finally, all available lcores run enqueue/dequeue bursts concurrently
+ * on a ring using each of the MP/MC sync modes (default, RTS and HTS).
+ * Mapping more lcores than physical cores (e.g. --lcores='(0-7)@(0-1)')
+ * turns this into an oversubscription scenario, where producer/consumer
+ * threads get preempted in the middle of a ring operation.
  */
 
 #define RING_NAME "RING_PERF"
 #define RING_SIZE 4096
 #define MAX_BURST 32
+#define MAX_ESIZE 32
+#define MT_SYNC_DURATION_MS 1000
+
+/* element size used to select the legacy void * ring API */
+#define ESIZE_PTR (-1)
+
+/*
+ * the element sizes to test, in bytes
+ * (ESIZE_PTR stands for the legacy rte_ring API)
+ */
+static const int esizes[] = { ESIZE_PTR, 4, 8, 16, 32 };
 
 /*
  * the sizes to enqueue and dequeue in testing
@@ -38,6 +59,52 @@ struct lcore_pair {
 
 static volatile unsigned lcore_count = 0;
 
+/**** Wrappers selecting the pointer or the element ring API ****/
+
+static __rte_always_inline unsigned int
+enqueue_bulk_esize(struct rte_ring *r, void *obj, int esize, unsigned int n,
+		unsigned int single)
+{
+	if (esize == ESIZE_PTR)
+		return single ? rte_ring_sp_enqueue_bulk(r, obj, n, NULL) :
+			rte_ring_mp_enqueue_bulk(r, obj, n, NULL);
+	return single ? rte_ring_sp_enqueue_bulk_elem(r, obj, esize, n, NULL) :
+		rte_ring_mp_enqueue_bulk_elem(r, obj, esize, n, NULL);
+}
+
+static __rte_always_inline unsigned int
+dequeue_bulk_esize(struct rte_ring *r, void *obj, int esize, unsigned int n,
+		unsigned int single)
+{
+	if (esize == ESIZE_PTR)
+		return single ? rte_ring_sc_dequeue_bulk(r, obj, n, NULL) :
+			rte_ring_mc_dequeue_bulk(r, obj, n, NULL);
+	return single ? rte_ring_sc_dequeue_bulk_elem(r, obj, esize, n, NULL) :
+		rte_ring_mc_dequeue_bulk_elem(r, obj, esize, n, NULL);
+}
+
+static __rte_always_inline unsigned int
+enqueue_burst_esize(struct rte_ring *r, void *obj, int esize, unsigned int n,
+		unsigned int single)
+{
+	if (esize == ESIZE_PTR)
+		return single ? rte_ring_sp_enqueue_burst(r, obj, n, NULL) :
+			rte_ring_mp_enqueue_burst(r, obj, n, NULL);
+	return single ? rte_ring_sp_enqueue_burst_elem(r, obj, esize, n, NULL) :
+		rte_ring_mp_enqueue_burst_elem(r, obj, esize, n, NULL);
+}
+
+static __rte_always_inline unsigned int
+dequeue_burst_esize(struct rte_ring *r, void *obj, int esize, unsigned int n,
+		unsigned int single)
+{
+	if (esize == ESIZE_PTR)
+		return single ? rte_ring_sc_dequeue_burst(r, obj, n, NULL) :
+			rte_ring_mc_dequeue_burst(r, obj, n, NULL);
+	return single ? rte_ring_sc_dequeue_burst_elem(r, obj, esize, n, NULL) :
+		rte_ring_mc_dequeue_burst_elem(r, obj, esize, n, NULL);
+}
+
 /**** Functions to analyse our core mask to get cores for different tests ***/
 
 static int
@@ -114,21 +181,21 @@ get_two_sockets(struct lcore_pair *lcp)
 
 /* Get cycle counts for dequeuing from an empty ring. Should be 2 or 3 cycles */
 static void
-test_empty_dequeue(struct rte_ring *r)
+test_empty_dequeue(struct rte_ring *r, int esize)
 {
 	const unsigned iter_shift = 26;
 	const unsigned iterations = 1<<iter_shift;
 	unsigned i = 0;
-	void *burst[MAX_BURST];
+	void *burst[MAX_BURST * MAX_ESIZE / sizeof(void *)];
 
 	const uint64_t sc_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_ring_sc_dequeue_bulk(r, burst, bulk_sizes[0], NULL);
+		dequeue_bulk_esize(r, burst, esize, bulk_sizes[0], __IS_SC);
 	const uint64_t sc_end = rte_rdtsc();
 
 	const uint64_t mc_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_ring_mc_dequeue_bulk(r, burst, bulk_sizes[0], NULL);
+		dequeue_bulk_esize(r, burst, esize, bulk_sizes[0], __IS_MC);
 	const uint64_t mc_end = rte_rdtsc();
 
 	printf("SC empty dequeue: %.2F\n",
@@ -143,6 +210,7 @@ test_empty_dequeue(struct rte_ring *r)
  */
 struct thread_params {
 	struct rte_ring *r;
+	int esize;            /* input value, the element size */
 	unsigned size;        /* input value, the burst size */
 	double spsc, mpmc;    /* output value, the single or multi timings */
 };
@@ -158,9 +226,10 @@ enqueue_bulk(void *p)
 	const unsigned iterations = 1<<iter_shift;
 	struct thread_params *params = p;
 	struct rte_ring *r = params->r;
+	const int esize = params->esize;
 	const unsigned size = params->size;
 	unsigned i;
-	void *burst[MAX_BURST] = {0};
+	void *burst[MAX_BURST * MAX_ESIZE / sizeof(void *)] = {0};
 
 #ifdef RTE_USE_C11_MEM_MODEL
 	if (__atomic_add_fetch(&lcore_count, 1, __ATOMIC_RELAXED) != 2)
@@ -172,13 +241,15 @@ enqueue_bulk(void *p)
 
 	const uint64_t sp_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		while (rte_ring_sp_enqueue_bulk(r, burst, size, NULL) == 0)
+		while (enqueue_bulk_esize(r, burst, esize, size,
+				__IS_SP) == 0)
 			rte_pause();
 	const uint64_t sp_end = rte_rdtsc();
 
 	const uint64_t mp_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		while (rte_ring_mp_enqueue_bulk(r, burst, size, NULL) == 0)
+		while (enqueue_bulk_esize(r, burst, esize, size,
+				__IS_MP) == 0)
 			rte_pause();
 	const uint64_t mp_end = rte_rdtsc();
 
@@ -198,9 +269,10 @@ dequeue_bulk(void *p)
 	const unsigned iterations = 1<<iter_shift;
 	struct thread_params *params = p;
 	struct rte_ring *r = params->r;
+	const int esize = params->esize;
 	const unsigned size = params->size;
 	unsigned i;
-	void *burst[MAX_BURST] = {0};
+	void *burst[MAX_BURST * MAX_ESIZE / sizeof(void *)] = {0};
 
 #ifdef RTE_USE_C11_MEM_MODEL
 	if (__atomic_add_fetch(&lcore_count, 1, __ATOMIC_RELAXED) != 2)
@@ -212,13 +284,15 @@ dequeue_bulk(void *p)
 
 	const uint64_t sc_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		while (rte_ring_sc_dequeue_bulk(r, burst, size, NULL) == 0)
+		while (dequeue_bulk_esize(r, burst, esize, size,
+				__IS_SC) == 0)
 			rte_pause();
 	const uint64_t sc_end = rte_rdtsc();
 
 	const uint64_t mc_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		while (rte_ring_mc_dequeue_bulk(r, burst, size, NULL) == 0)
+		while (dequeue_bulk_esize(r, burst, esize, size,
+				__IS_MC) == 0)
 			rte_pause();
 	const uint64_t mc_end = rte_rdtsc();
 
@@ -232,7 +306,7 @@ dequeue_bulk(void *p)
  * used to measure ring perf between hyperthreads, cores and sockets.
  */
 static void
-run_on_core_pair(struct lcore_pair *cores, struct rte_ring *r,
+run_on_core_pair(struct lcore_pair *cores, struct rte_ring *r, int esize,
 		lcore_function_t f1, lcore_function_t f2)
 {
 	struct thread_params param1 = {0}, param2 = {0};
@@ -240,6 +314,7 @@ run_on_core_pair(struct lcore_pair *cores, struct rte_ring *r,
 	for (i = 0; i < sizeof(bulk_sizes)/sizeof(bulk_sizes[0]); i++) {
 		lcore_count = 0;
 		param1.size = param2.size = bulk_sizes[i];
+		param1.esize = param2.esize = esize;
 		param1.r = param2.r = r;
 		if (cores->c1 == rte_get_master_lcore()) {
 			rte_eal_remote_launch(f2, &param2, cores->c2);
@@ -263,24 +338,24 @@ run_on_core_pair(struct lcore_pair *cores, struct rte_ring *r,
  * takes on a single lcore. Result is for comparison with the bulk enq+deq.
  */
 static void
-test_single_enqueue_dequeue(struct rte_ring *r)
+test_single_enqueue_dequeue(struct rte_ring *r, int esize)
 {
 	const unsigned iter_shift = 24;
 	const unsigned iterations = 1<<iter_shift;
 	unsigned i = 0;
-	void *burst = NULL;
+	void *burst[MAX_ESIZE / sizeof(void *)] = {0};
 
 	const uint64_t sc_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++) {
-		rte_ring_sp_enqueue(r, burst);
-		rte_ring_sc_dequeue(r, &burst);
+		enqueue_bulk_esize(r, burst, esize, 1, __IS_SP);
+		dequeue_bulk_esize(r, burst, esize, 1, __IS_SC);
 	}
 	const uint64_t sc_end = rte_rdtsc();
 
 	const uint64_t mc_start = rte_rdtsc();
 	for (i = 0; i < iterations; i++) {
-		rte_ring_mp_enqueue(r, burst);
-		rte_ring_mc_dequeue(r, &burst);
+		enqueue_bulk_esize(r, burst, esize, 1, __IS_MP);
+		dequeue_bulk_esize(r, burst, esize, 1, __IS_MC);
 	}
 	const uint64_t mc_end = rte_rdtsc();
 
@@ -296,29 +371,29 @@ test_single_enqueue_dequeue(struct rte_ring *r)
  * as for the bulk function called on a single lcore.
  */
 static void
-test_burst_enqueue_dequeue(struct rte_ring *r)
+test_burst_enqueue_dequeue(struct rte_ring *r, int esize)
 {
 	const unsigned iter_shift = 23;
 	const unsigned iterations = 1<<iter_shift;
 	unsigned sz, i = 0;
-	void *burst[MAX_BURST] = {0};
+	void *burst[MAX_BURST * MAX_ESIZE / sizeof(void *)] = {0};
 
 	for (sz = 0; sz < sizeof(bulk_sizes)/sizeof(bulk_sizes[0]); sz++) {
 		const uint64_t sc_start = rte_rdtsc();
 		for (i = 0; i < iterations; i++) {
-			rte_ring_sp_enqueue_burst(r, burst,
-					bulk_sizes[sz], NULL);
-			rte_ring_sc_dequeue_burst(r, burst,
-					bulk_sizes[sz], NULL);
+			enqueue_burst_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_SP);
+			dequeue_burst_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_SC);
 		}
 		const uint64_t sc_end = rte_rdtsc();
 
 		const uint64_t mc_start = rte_rdtsc();
 		for (i = 0; i < iterations; i++) {
-			rte_ring_mp_enqueue_burst(r, burst,
-					bulk_sizes[sz], NULL);
-			rte_ring_mc_dequeue_burst(r, burst,
-					bulk_sizes[sz], NULL);
+			enqueue_burst_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_MP);
+			dequeue_burst_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_MC);
 		}
 		const uint64_t mc_end = rte_rdtsc();
 
@@ -334,29 +409,29 @@ test_burst_enqueue_dequeue(struct rte_ring *r)
 
 /* Times enqueue and dequeue on a single lcore */
 static void
-test_bulk_enqueue_dequeue(struct rte_ring *r)
+test_bulk_enqueue_dequeue(struct rte_ring *r, int esize)
 {
 	const unsigned iter_shift = 23;
 	const unsigned iterations = 1<<iter_shift;
 	unsigned sz, i = 0;
-	void *burst[MAX_BURST] = {0};
+	void *burst[MAX_BURST * MAX_ESIZE / sizeof(void *)] = {0};
 
 	for (sz = 0; sz < sizeof(bulk_sizes)/sizeof(bulk_sizes[0]); sz++) {
 		const uint64_t sc_start = rte_rdtsc();
 		for (i = 0; i < iterations; i++) {
-			rte_ring_sp_enqueue_bulk(r, burst,
-					bulk_sizes[sz], NULL);
-			rte_ring_sc_dequeue_bulk(r, burst,
-					bulk_sizes[sz], NULL);
+			enqueue_bulk_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_SP);
+			dequeue_bulk_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_SC);
 		}
 		const uint64_t sc_end = rte_rdtsc();
 
 		const uint64_t mc_start = rte_rdtsc();
 		for (i = 0; i < iterations; i++) {
-			rte_ring_mp_enqueue_bulk(r, burst,
-					bulk_sizes[sz], NULL);
-			rte_ring_mc_dequeue_bulk(r, burst,
-					bulk_sizes[sz], NULL);
+			enqueue_bulk_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_MP);
+			dequeue_bulk_esize(r, burst, esize,
+					bulk_sizes[sz], __IS_MC);
 		}
 		const uint64_t mc_end = rte_rdtsc();
 
@@ -372,40 +447,155 @@ test_bulk_enqueue_dequeue(struct rte_ring *r)
 	}
 }
 
+/*
+ * Parameters of the concurrent enqueue/dequeue test, one per lcore.
+ */
+struct mt_sync_params {
+	struct rte_ring *r;
+	uint64_t ops;         /* output value, the number of objects moved */
+} __rte_cache_aligned;
+
+static struct mt_sync_params mt_sync_params[RTE_MAX_LCORE];
+static volatile int mt_sync_stop;
+
+/*
+ * Enqueue then dequeue bursts using the default (creation time selected)
+ * sync mode until told to stop.
+ */
 static int
-test_ring_perf(void)
+mt_sync_enqueue_dequeue(void *p)
+{
+	struct mt_sync_params *params = p;
+	struct rte_ring *r = params->r;
+	void *burst[MAX_BURST] = {0};
+	uint64_t ops = 0;
+	unsigned int n;
+
+	while (mt_sync_stop == 0) {
+		n = rte_ring_enqueue_burst(r, burst, bulk_sizes[0], NULL);
+		n = rte_ring_dequeue_burst(r, burst, n, NULL);
+		ops += n;
+	}
+
+	params->ops = ops;
+	return 0;
+}
+
+/*
+ * Run enqueue/dequeue on all slave lcores concurrently for a fixed amount
+ * of time, for each of the MP/MC ring sync modes. The aggregated
+ * throughput shows how each mode copes with lcores sharing a physical core.
+ */
+static void
+test_mt_sync_modes(void)
+{
+	static const struct {
+		const char *name;
+		unsigned int flags;
+	} modes[] = {
+		{ "MP/MC", 0 },
+		{ "MP_RTS/MC_RTS", RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ },
+		{ "MP_HTS/MC_HTS", RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ },
+	};
+	unsigned int i, lcore_id, nb_workers;
+	struct rte_ring *r;
+	uint64_t ops;
+
+	nb_workers = rte_lcore_count() - 1;
+	if (nb_workers < 2) {
+		printf("Not enough lcores, skipping\n");
+		return;
+	}
+
+	for (i = 0; i < RTE_DIM(modes); i++) {
+		r = rte_ring_create(RING_NAME, RING_SIZE, rte_socket_id(),
+				modes[i].flags);
+		if (r == NULL) {
+			printf("Cannot create %s ring\n", modes[i].name);
+			return;
+		}
+
+		mt_sync_stop = 0;
+		RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+			mt_sync_params[lcore_id].r = r;
+			mt_sync_params[lcore_id].ops = 0;
+			rte_eal_remote_launch(mt_sync_enqueue_dequeue,
+					&mt_sync_params[lcore_id], lcore_id);
+		}
+
+		rte_delay_ms(MT_SYNC_DURATION_MS);
+		mt_sync_stop = 1;
+		rte_eal_mp_wait_lcore();
+
+		ops = 0;
+		RTE_LCORE_FOREACH_SLAVE(lcore_id)
+			ops += mt_sync_params[lcore_id].ops;
+
+		printf("%s burst enq/dequeue (size: %u, lcores: %u): "
+			"%.2F Mobj/s\n", modes[i].name, bulk_sizes[0],
+			nb_workers, (double)ops / (MT_SYNC_DURATION_MS * 1000));
+
+		rte_ring_free(r);
+	}
+}
+
+static int
+test_ring_perf_esize(int esize)
 {
 	struct lcore_pair cores;
 	struct rte_ring *r = NULL;
 
-	r = rte_ring_create(RING_NAME, RING_SIZE, rte_socket_id(), 0);
+	if (esize == ESIZE_PTR) {
+		printf("\n##### Testing legacy ring API #####\n");
+		r = rte_ring_create(RING_NAME, RING_SIZE, rte_socket_id(), 0);
+	} else {
+		printf("\n##### Testing element ring API, esize %d #####\n",
+				esize);
+		r = rte_ring_create_elem(RING_NAME, esize, RING_SIZE,
+				rte_socket_id(), 0);
+	}
 	if (r == NULL)
 		return -1;
 
 	printf("### Testing single element and burst enq/deq ###\n");
-	test_single_enqueue_dequeue(r);
-	test_burst_enqueue_dequeue(r);
+	test_single_enqueue_dequeue(r, esize);
+	test_burst_enqueue_dequeue(r, esize);
 
 	printf("\n### Testing empty dequeue ###\n");
-	test_empty_dequeue(r);
+	test_empty_dequeue(r, esize);
 
 	printf("\n### Testing using a single lcore ###\n");
-	test_bulk_enqueue_dequeue(r);
+	test_bulk_enqueue_dequeue(r, esize);
 
 	if (get_two_hyperthreads(&cores) == 0) {
 		printf("\n### Testing using two hyperthreads ###\n");
-		run_on_core_pair(&cores, r, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, r, esize, enqueue_bulk, dequeue_bulk);
 	}
 	if (get_two_cores(&cores) == 0) {
 		printf("\n### Testing using two physical cores ###\n");
-		run_on_core_pair(&cores, r, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, r, esize, enqueue_bulk, dequeue_bulk);
 	}
 	if (get_two_sockets(&cores) == 0) {
 		printf("\n### Testing using two NUMA nodes ###\n");
-		run_on_core_pair(&cores, r, enqueue_bulk, dequeue_bulk);
+		run_on_core_pair(&cores, r, esize, enqueue_bulk, dequeue_bulk);
 	}
 	rte_ring_free(r);
 	return 0;
 }
 
+static int
+test_ring_perf(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(esizes); i++)
+		if (test_ring_perf_esize(esizes[i]) < 0)
+			return -1;
+
+	printf("\n### Testing MP/MC sync modes using all lcores ###\n");
+	test_mt_sync_modes();
+
+	return 0;
+}
+
 REGISTER_TEST_COMMAND(ring_perf_autotest, test_ring_perf);
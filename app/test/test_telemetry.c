@@ -0,0 +1,246 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include <rte_eal.h>
+#include <rte_telemetry.h>
+
+#include "test.h"
+
+#define TEST_SOCKET_NAME "dpdk_telemetry.v2"
+#define TEST_BUF_LEN (1024 * 64)
+
+static char test_buf[TEST_BUF_LEN];
+
+static int
+test_cb_data(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_tel_data *array;
+
+	array = rte_tel_data_alloc();
+	if (array == NULL)
+		return -ENOMEM;
+	rte_tel_data_start_array(array, RTE_TEL_U64_VAL);
+	rte_tel_data_add_array_u64(array, 0);
+	rte_tel_data_add_array_u64(array, UINT64_MAX);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "params",
+		params != NULL ? params : "none");
+	rte_tel_data_add_dict_string(d, "quoted", "a\"b\\c\n");
+	rte_tel_data_add_dict_int(d, "int", -1);
+	rte_tel_data_add_dict_container(d, "array", array);
+	return 0;
+}
+
+static int
+test_cb_fail(const char *cmd __rte_unused, const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	/* the data set before the failure must not be sent */
+	rte_tel_data_string(d, "ignored");
+	return -EINVAL;
+}
+
+/* Check the errors of the data container functions */
+static int
+test_telemetry_data(void)
+{
+	char str[RTE_TEL_MAX_STRING_LEN + 1];
+	struct rte_tel_data *d, *c;
+	int i;
+
+	d = rte_tel_data_alloc();
+	TEST_ASSERT_NOT_NULL(d, "Cannot allocate data");
+
+	/* adding to a container not started */
+	TEST_ASSERT_EQUAL(rte_tel_data_add_array_int(d, 1), -EINVAL,
+		"Added to an array not started");
+	TEST_ASSERT_EQUAL(rte_tel_data_add_dict_int(d, "x", 1), -EINVAL,
+		"Added to a dictionary not started");
+
+	/* adding a value of the wrong type */
+	TEST_ASSERT_SUCCESS(rte_tel_data_start_array(d, RTE_TEL_INT_VAL),
+		"Cannot start array");
+	TEST_ASSERT_EQUAL(rte_tel_data_add_array_u64(d, 1), -EINVAL,
+		"Added a u64 to an int array");
+	TEST_ASSERT_EQUAL(rte_tel_data_add_dict_int(d, "x", 1), -EINVAL,
+		"Added a named value to an array");
+
+	/* filling an array */
+	for (i = 0; i < RTE_TEL_MAX_ARRAY_ENTRIES; i++)
+		TEST_ASSERT_SUCCESS(rte_tel_data_add_array_int(d, i),
+			"Cannot add value %d", i);
+	TEST_ASSERT_EQUAL(rte_tel_data_add_array_int(d, i), -ENOSPC,
+		"Added a value to a full array");
+
+	/* truncating a string */
+	memset(str, 'a', sizeof(str) - 1);
+	str[sizeof(str) - 1] = '\0';
+	TEST_ASSERT_SUCCESS(rte_tel_data_start_dict(d),
+		"Cannot start dictionary");
+	TEST_ASSERT_EQUAL(rte_tel_data_add_dict_string(d, "x", str), -E2BIG,
+		"Long string not reported as truncated");
+	TEST_ASSERT_EQUAL(rte_tel_data_add_dict_int(d, str, 1), -E2BIG,
+		"Long name not reported as truncated");
+
+	/* nesting a container in itself */
+	TEST_ASSERT_EQUAL(rte_tel_data_add_dict_container(d, "x", d), -EINVAL,
+		"Added a container to itself");
+
+	/* the nested container is freed with its parent */
+	c = rte_tel_data_alloc();
+	TEST_ASSERT_NOT_NULL(c, "Cannot allocate data");
+	TEST_ASSERT_SUCCESS(rte_tel_data_start_array(c, RTE_TEL_STRING_VAL),
+		"Cannot start array");
+	TEST_ASSERT_SUCCESS(rte_tel_data_add_array_string(c, "x"),
+		"Cannot add string");
+	TEST_ASSERT_SUCCESS(rte_tel_data_add_dict_container(d, "c", c),
+		"Cannot add container");
+	rte_tel_data_free(d);
+
+	return TEST_SUCCESS;
+}
+
+/* Check the registration of invalid and duplicate commands */
+static int
+test_telemetry_register(void)
+{
+	TEST_ASSERT_EQUAL(rte_telemetry_register_cmd("test", test_cb_data,
+		NULL), -EINVAL, "Registered a command without '/'");
+	TEST_ASSERT_EQUAL(rte_telemetry_register_cmd("/test,x", test_cb_data,
+		NULL), -EINVAL, "Registered a command with a comma");
+	TEST_ASSERT_EQUAL(rte_telemetry_register_cmd("/test/null", NULL,
+		NULL), -EINVAL, "Registered a command without callback");
+	TEST_ASSERT_EQUAL(rte_telemetry_register_cmd("/", test_cb_data,
+		NULL), -EEXIST, "Registered a command twice");
+
+	return TEST_SUCCESS;
+}
+
+/* Send a command and compare the reply with the expected one */
+static int
+test_telemetry_cmd(int fd, const char *cmd, const char *expected)
+{
+	ssize_t len;
+
+	TEST_ASSERT(send(fd, cmd, strlen(cmd), 0) >= 0,
+		"Cannot send %s: %s", cmd, strerror(errno));
+	len = recv(fd, test_buf, sizeof(test_buf) - 1, 0);
+	TEST_ASSERT(len > 0, "Cannot receive reply to %s", cmd);
+	test_buf[len] = '\0';
+
+	TEST_ASSERT(strcmp(test_buf, expected) == 0,
+		"Unexpected reply to %s: %s, expected %s",
+		cmd, test_buf, expected);
+	return TEST_SUCCESS;
+}
+
+/* Check the replies to commands sent on the socket */
+static int
+test_telemetry_socket(void)
+{
+	struct timeval timeout = { .tv_sec = 5, .tv_usec = 0 };
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	ssize_t len;
+	int fd, ret;
+
+	ret = rte_telemetry_register_cmd("/test/data", test_cb_data,
+		"Returns test data. Parameters: string");
+	TEST_ASSERT(ret == 0 || ret == -EEXIST, "Cannot register command");
+	ret = rte_telemetry_register_cmd("/test/fail", test_cb_fail, NULL);
+	TEST_ASSERT(ret == 0 || ret == -EEXIST, "Cannot register command");
+
+	ret = rte_telemetry_init();
+	TEST_ASSERT(ret == 0 || ret == -EALREADY,
+		"Cannot initialize telemetry: %d", ret);
+
+	snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/%s",
+		rte_eal_get_runtime_dir(), TEST_SOCKET_NAME);
+	fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+	TEST_ASSERT(fd >= 0, "Cannot create socket");
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printf("Cannot connect to %s: %s\n", addr.sun_path,
+			strerror(errno));
+		close(fd);
+		return TEST_FAILED;
+	}
+
+	ret = TEST_FAILED;
+	len = recv(fd, test_buf, sizeof(test_buf) - 1, 0);
+	if (len <= 0) {
+		printf("Cannot receive greeting\n");
+		goto exit;
+	}
+	test_buf[len] = '\0';
+	if (strncmp(test_buf, "{\"/info\":{\"version\":", 20) != 0) {
+		printf("Unexpected greeting: %s\n", test_buf);
+		goto exit;
+	}
+
+	if (test_telemetry_cmd(fd, "/test/data,a b",
+			"{\"/test/data\":{\"params\":\"a b\","
+			"\"quoted\":\"a\\\"b\\\\c\\u000a\",\"int\":-1,"
+			"\"array\":[0,18446744073709551615]}}") < 0 ||
+			test_telemetry_cmd(fd, "/test/data\n",
+			"{\"/test/data\":{\"params\":\"none\","
+			"\"quoted\":\"a\\\"b\\\\c\\u000a\",\"int\":-1,"
+			"\"array\":[0,18446744073709551615]}}") < 0 ||
+			test_telemetry_cmd(fd, "/test/fail",
+			"{\"/test/fail\":null}") < 0 ||
+			test_telemetry_cmd(fd, "/test/unknown",
+			"{\"/test/unknown\":null}") < 0 ||
+			test_telemetry_cmd(fd, "/help,/test/data",
+			"{\"/help\":{\"/test/data\":"
+			"\"Returns test data. Parameters: string\"}}") < 0)
+		goto exit;
+
+	/* the command list is sorted */
+	len = -1;
+	if (send(fd, "/", 1, 0) >= 0)
+		len = recv(fd, test_buf, sizeof(test_buf) - 1, 0);
+	if (len <= 0) {
+		printf("Cannot list commands\n");
+		goto exit;
+	}
+	test_buf[len] = '\0';
+	if (strstr(test_buf, "\"/test/data\",\"/test/fail\"") == NULL) {
+		printf("Commands not listed: %s\n", test_buf);
+		goto exit;
+	}
+
+	ret = TEST_SUCCESS;
+exit:
+	close(fd);
+	return ret;
+}
+
+static struct unit_test_suite telemetry_testsuite = {
+	.suite_name = "Telemetry Unit Test Suite",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_telemetry_data),
+		TEST_CASE(test_telemetry_register),
+		TEST_CASE(test_telemetry_socket),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_telemetry(void)
+{
+	return unit_test_suite_runner(&telemetry_testsuite);
+}
+
+REGISTER_TEST_COMMAND(telemetry_autotest, test_telemetry);
@@ -85,6 +85,7 @@
  *      - It is stopped at t=25s by timer2.
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
@@ -598,3 +599,281 @@ test_timer(void)
 }
 
 REGISTER_TEST_COMMAND(timer_autotest, test_timer);
+
+/*
+ * Timing wheel test
+ * =================
+ *
+ * Functional checks of the timing wheel backend, run on the master lcore:
+ *
+ * - a resolution of 2^63 cycles or more is rejected
+ * - timers expire once and not before their expiry time, including the
+ *   ones added to the upper levels of the wheel and cascaded down
+ * - a stopped timer does not expire, before or after being cascaded
+ * - a reset timer only expires at its new expiry time
+ * - a periodic timer expires once per period until it is stopped
+ */
+
+#define WHEEL_NB_TIMERS 8
+/* ticks of 16 cycles */
+#define WHEEL_TICK_SHIFT 4
+/* a wheel level is indexed by 6 bits of the tick, see rte_timer.c */
+#define WHEEL_LEVEL_BITS 6
+/* time bits below the slots of the fourth level */
+#define WHEEL_CASCADE_BITS (WHEEL_TICK_SHIFT + 3 * WHEEL_LEVEL_BITS)
+
+struct wheel_timer {
+	struct rte_timer tim;
+	unsigned int count;
+	uint64_t expired_at; /* cycles of the last expiry */
+};
+
+static struct wheel_timer wheel_timers[WHEEL_NB_TIMERS];
+
+static void
+wheel_timer_cb(struct rte_timer *tim)
+{
+	struct wheel_timer *wt = container_of(tim, struct wheel_timer, tim);
+
+	wt->count++;
+	wt->expired_at = rte_get_timer_cycles();
+}
+
+static int
+wheel_timer_start(uint32_t id, struct wheel_timer *wt, uint64_t ticks,
+		enum rte_timer_type type)
+{
+	return rte_timer_alt_reset(id, &wt->tim, ticks, type, rte_lcore_id(),
+			NULL, NULL);
+}
+
+/*
+ * Start a timer expiring in about delay cycles, in the middle of a slot of
+ * the fourth wheel level, so that it is cascaded down from the start of
+ * this slot. Return a time after the cascade and before the expiry.
+ */
+static uint64_t
+wheel_timer_start_cascaded(uint32_t id, struct wheel_timer *wt,
+		uint64_t delay)
+{
+	const uint64_t mask = (UINT64_C(1) << WHEEL_CASCADE_BITS) - 1;
+	uint64_t cur_time = rte_get_timer_cycles();
+	uint64_t expire = ((cur_time + delay) | mask) - (mask >> 1);
+
+	wheel_timer_start(id, wt, expire - cur_time, SINGLE);
+	return (wt->tim.expire & ~mask) + (mask >> 2);
+}
+
+static void
+wheel_manage_until(uint32_t id, uint64_t end)
+{
+	while (rte_get_timer_cycles() < end) {
+		rte_timer_alt_manage(id, NULL, 0, wheel_timer_cb);
+		rte_pause();
+	}
+}
+
+static void
+wheel_manage_ms(uint32_t id, unsigned int ms)
+{
+	wheel_manage_until(id, rte_get_timer_cycles() +
+			rte_get_timer_hz() * ms / 1000);
+}
+
+static void
+wheel_timers_init(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < WHEEL_NB_TIMERS; i++) {
+		memset(&wheel_timers[i], 0, sizeof(wheel_timers[i]));
+		rte_timer_init(&wheel_timers[i].tim);
+	}
+}
+
+static int
+wheel_test_expiry(uint32_t id)
+{
+	/* spread over the first four levels of the wheel */
+	static const uint64_t delays_us[WHEEL_NB_TIMERS] = {
+		0, 1, 10, 100, 1000, 5000, 10000, 20000
+	};
+	uint64_t us = rte_get_timer_hz() / 1000000;
+	struct wheel_timer *wt;
+	unsigned int i;
+
+	wheel_timers_init();
+	for (i = 0; i < WHEEL_NB_TIMERS; i++)
+		wheel_timer_start(id, &wheel_timers[i], delays_us[i] * us,
+				SINGLE);
+	wheel_manage_ms(id, 30);
+
+	for (i = 0; i < WHEEL_NB_TIMERS; i++) {
+		wt = &wheel_timers[i];
+		if (wt->count != 1 || rte_timer_pending(&wt->tim)) {
+			printf("%"PRIu64" us timer expired %u times\n",
+				delays_us[i], wt->count);
+			return -1;
+		}
+		if (wt->expired_at < wt->tim.expire) {
+			printf("%"PRIu64" us timer expired %"PRIu64
+				" cycles early\n", delays_us[i],
+				wt->tim.expire - wt->expired_at);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+wheel_test_stop(uint32_t id)
+{
+	uint64_t ms = rte_get_timer_hz() / 1000;
+	struct wheel_timer *wt0 = &wheel_timers[0];
+	struct wheel_timer *wt1 = &wheel_timers[1];
+	uint64_t cascaded;
+
+	wheel_timers_init();
+
+	/* stopped in the slot it was added to */
+	wheel_timer_start(id, wt0, ms, SINGLE);
+	if (rte_timer_alt_stop(id, &wt0->tim) != 0) {
+		printf("cannot stop a pending timer\n");
+		return -1;
+	}
+
+	/* stopped after being cascaded */
+	cascaded = wheel_timer_start_cascaded(id, wt1, 10 * ms);
+	wheel_manage_until(id, cascaded);
+	if (wt1->count != 0 || rte_timer_alt_stop(id, &wt1->tim) != 0) {
+		printf("cannot stop a cascaded timer\n");
+		return -1;
+	}
+
+	wheel_manage_until(id, wt1->tim.expire + ms);
+	if (wt0->count != 0 || wt1->count != 0 ||
+			rte_timer_pending(&wt0->tim) ||
+			rte_timer_pending(&wt1->tim)) {
+		printf("stopped timer expired\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+wheel_test_reset(uint32_t id)
+{
+	uint64_t ms = rte_get_timer_hz() / 1000;
+	struct wheel_timer *wt0 = &wheel_timers[0];
+	struct wheel_timer *wt1 = &wheel_timers[1];
+	uint64_t cascaded, old_expire;
+
+	wheel_timers_init();
+
+	/* reset to an earlier expiry, in a lower level */
+	wheel_timer_start(id, wt0, 50 * ms, SINGLE);
+	wheel_manage_ms(id, 1);
+	wheel_timer_start(id, wt0, ms, SINGLE);
+	wheel_manage_until(id, wt0->tim.expire + ms);
+	if (wt0->count != 1 || wt0->expired_at < wt0->tim.expire) {
+		printf("timer reset earlier expired %u times\n", wt0->count);
+		return -1;
+	}
+
+	/* reset to a later expiry, after being cascaded */
+	cascaded = wheel_timer_start_cascaded(id, wt1, 10 * ms);
+	old_expire = wt1->tim.expire;
+	wheel_manage_until(id, cascaded);
+	wheel_timer_start(id, wt1, 5 * ms, SINGLE);
+	wheel_manage_until(id, old_expire + ms);
+	if (wt1->count != 0) {
+		printf("timer reset later expired at its old expiry time\n");
+		return -1;
+	}
+	wheel_manage_until(id, wt1->tim.expire + ms);
+	if (wt1->count != 1 || wt1->expired_at < wt1->tim.expire) {
+		printf("timer reset later expired %u times\n", wt1->count);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+wheel_test_periodic(uint32_t id)
+{
+	uint64_t ms = rte_get_timer_hz() / 1000;
+	struct wheel_timer *wt0 = &wheel_timers[0];
+	struct wheel_timer *wt1 = &wheel_timers[1];
+	unsigned int count0, count1;
+
+	wheel_timers_init();
+
+	/* the second period is long enough to be cascaded */
+	wheel_timer_start(id, wt0, ms, PERIODICAL);
+	wheel_timer_start(id, wt1, 5 * ms, PERIODICAL);
+	wheel_manage_ms(id, 21);
+	if (wt0->count < 10 || wt0->count > 21 ||
+			wt1->count < 2 || wt1->count > 4) {
+		printf("periodic timers expired %u and %u times\n",
+			wt0->count, wt1->count);
+		return -1;
+	}
+
+	if (rte_timer_alt_stop(id, &wt0->tim) != 0 ||
+			rte_timer_alt_stop(id, &wt1->tim) != 0) {
+		printf("cannot stop a periodic timer\n");
+		return -1;
+	}
+	count0 = wt0->count;
+	count1 = wt1->count;
+	wheel_manage_ms(id, 6);
+	if (wt0->count != count0 || wt1->count != count1) {
+		printf("stopped periodic timer expired\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_timer_wheel(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	uint32_t id;
+	int ret;
+
+	if (rte_timer_data_alloc_wheel(&id, UINT64_C(1) << 63) != -EINVAL ||
+			rte_timer_data_alloc_wheel(&id, UINT64_MAX) != -EINVAL) {
+		printf("invalid wheel resolution accepted\n");
+		return TEST_FAILED;
+	}
+	if (rte_timer_data_alloc_wheel(&id, UINT64_C(1) << 62) != 0) {
+		printf("cannot allocate a wheel with a 2^62 cycles tick\n");
+		return TEST_FAILED;
+	}
+	rte_timer_data_dealloc(id);
+
+	if (rte_timer_data_alloc_wheel(&id,
+			UINT64_C(1) << WHEEL_TICK_SHIFT) != 0) {
+		printf("cannot allocate a timing wheel\n");
+		return TEST_FAILED;
+	}
+
+	ret = wheel_test_expiry(id);
+	if (ret == 0)
+		ret = wheel_test_stop(id);
+	if (ret == 0)
+		ret = wheel_test_reset(id);
+	if (ret == 0)
+		ret = wheel_test_periodic(id);
+
+	rte_timer_stop_all(id, &lcore_id, 1, NULL, NULL);
+	rte_timer_data_dealloc(id);
+
+	return ret == 0 ? TEST_SUCCESS : TEST_FAILED;
+}
+
+REGISTER_TEST_COMMAND(timer_wheel_autotest, test_timer_wheel);
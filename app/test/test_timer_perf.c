@@ -27,12 +27,120 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 
 #define DELAY_SECONDS 1
 
+#define BACKEND_NB_TIMERS (1 << 20)
+
+static unsigned int early_count;
+
+static void
+timer_alt_cb(struct rte_timer *t)
+{
+	if (rte_get_timer_cycles() < t->expire)
+		early_count++;
+	outstanding_count--;
+}
+
 #ifdef RTE_EXEC_ENV_LINUX
 #define do_delay() usleep(10)
 #else
 #define do_delay() rte_pause()
 #endif
 
+static void
+print_per_timer(const char *what, uint64_t cycles, unsigned int nb)
+{
+	printf("  %-24s %"PRIu64" cycles per timer\n", what,
+			(cycles + nb / 2) / nb);
+}
+
+/* compare the skiplist and timing wheel timer data backends */
+static int
+test_timer_perf_backend(struct rte_timer *tms, int wheel)
+{
+	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t start_tsc, end_tsc, delay_start;
+	uint32_t data_id;
+	unsigned int i;
+	int ret;
+
+	if (wheel)
+		ret = rte_timer_data_alloc_wheel(&data_id, 0);
+	else
+		ret = rte_timer_data_alloc(&data_id);
+	if (ret < 0) {
+		printf("Cannot allocate timer data\n");
+		return -1;
+	}
+
+	printf("%s backend, %u timers:\n", wheel ? "Wheel" : "Skiplist",
+			BACKEND_NB_TIMERS);
+
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_init(&tms[i]);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_reset(data_id, &tms[i],
+				ticks / 2 + rte_rand() % (ticks / 2), SINGLE,
+				lcore_id, timer_cb, NULL);
+	end_tsc = rte_rdtsc();
+	print_per_timer("arm:", end_tsc - start_tsc, BACKEND_NB_TIMERS);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_reset(data_id, &tms[i],
+				ticks / 2 + rte_rand() % (ticks / 2), SINGLE,
+				lcore_id, timer_cb, NULL);
+	end_tsc = rte_rdtsc();
+	print_per_timer("re-arm pending:", end_tsc - start_tsc,
+			BACKEND_NB_TIMERS);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_stop(data_id, &tms[i]);
+	end_tsc = rte_rdtsc();
+	print_per_timer("cancel:", end_tsc - start_tsc, BACKEND_NB_TIMERS);
+
+	for (i = 0; i < BACKEND_NB_TIMERS; i++)
+		rte_timer_alt_reset(data_id, &tms[i], rte_rand() % ticks,
+				SINGLE, lcore_id, timer_cb, NULL);
+	outstanding_count = BACKEND_NB_TIMERS;
+	early_count = 0;
+
+	delay_start = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() < delay_start + ticks)
+		do_delay();
+
+	start_tsc = rte_rdtsc();
+	while (outstanding_count > 0 &&
+			rte_get_timer_cycles() < delay_start + 2 * ticks)
+		rte_timer_alt_manage(data_id, NULL, 0, timer_alt_cb);
+	end_tsc = rte_rdtsc();
+	print_per_timer("expire:", end_tsc - start_tsc, BACKEND_NB_TIMERS);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < MAX_ITERATIONS; i++)
+		rte_timer_alt_manage(data_id, NULL, 0, timer_alt_cb);
+	end_tsc = rte_rdtsc();
+	printf("  %-24s %"PRIu64" cycles\n", "manage with zero timers:",
+			(end_tsc - start_tsc + MAX_ITERATIONS / 2) /
+			MAX_ITERATIONS);
+
+	rte_timer_data_dealloc(data_id);
+
+	if (outstanding_count != 0) {
+		printf("Error: outstanding callback count = %d\n",
+				outstanding_count);
+		return -1;
+	}
+	if (early_count != 0) {
+		printf("Error: %u timers expired early\n", early_count);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_timer_perf(void)
 {
@@ -42,7 +150,10 @@ test_timer_perf(void)
 	uint64_t start_tsc, end_tsc, delay_start;
 	unsigned lcore_id = rte_lcore_id();
 
-	tms = rte_malloc(NULL, sizeof(*tms) * MAX_ITERATIONS, 0);
+	tms = rte_malloc(NULL, sizeof(*tms) *
+			RTE_MAX(MAX_ITERATIONS, BACKEND_NB_TIMERS), 0);
+	if (tms == NULL)
+		return -1;
 
 	for (i = 0; i < MAX_ITERATIONS; i++)
 		rte_timer_init(&tms[i]);
@@ -126,6 +237,14 @@ test_timer_perf(void)
 	end_tsc = rte_rdtsc();
 	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
+	rte_timer_stop_sync(&tms[0]);
+
+	printf("\n");
+	if (test_timer_perf_backend(tms, 0) < 0 ||
+			test_timer_perf_backend(tms, 1) < 0) {
+		rte_free(tms);
+		return -1;
+	}
 
 	rte_free(tms);
 	return 0;
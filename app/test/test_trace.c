@@ -0,0 +1,248 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <errno.h>
+
+#include <rte_lcore.h>
+#include <rte_trace.h>
+
+#include "test.h"
+#include "test_trace.h"
+
+static int32_t
+test_trace_point_globbing(void)
+{
+	int rc;
+
+	rc = rte_trace_pattern("app.dpdk.test*", false);
+	if (rc != 1)
+		goto failed;
+
+	if (rte_trace_point_is_enabled(&__app_dpdk_test_tp))
+		goto failed;
+
+	rc = rte_trace_pattern("app.dpdk.test*", true);
+	if (rc != 1)
+		goto failed;
+
+	if (!rte_trace_point_is_enabled(&__app_dpdk_test_tp))
+		goto failed;
+
+	rc = rte_trace_pattern("invalid_testpoint.*", true);
+	if (rc != 0)
+		goto failed;
+
+	rc = rte_trace_pattern("app.dpdk.test*", false);
+	if (rc != 1)
+		goto failed;
+
+	return TEST_SUCCESS;
+
+failed:
+	return TEST_FAILED;
+}
+
+static int32_t
+test_trace_point_regex(void)
+{
+	int rc;
+
+	rc = rte_trace_regexp("app.dpdk.test*", false);
+	if (rc != 1)
+		goto failed;
+
+	if (rte_trace_point_is_enabled(&__app_dpdk_test_tp))
+		goto failed;
+
+	rc = rte_trace_regexp("app.dpdk.test*", true);
+	if (rc != 1)
+		goto failed;
+
+	if (!rte_trace_point_is_enabled(&__app_dpdk_test_tp))
+		goto failed;
+
+	rc = rte_trace_regexp("invalid_testpoint.*", true);
+	if (rc != 0)
+		goto failed;
+
+	rc = rte_trace_regexp("[", true);
+	if (rc != -EINVAL)
+		goto failed;
+
+	rc = rte_trace_regexp("app.dpdk.test*", false);
+	if (rc != 1)
+		goto failed;
+
+	return TEST_SUCCESS;
+
+failed:
+	return TEST_FAILED;
+}
+
+static int32_t
+test_trace_point_disable_enable(void)
+{
+	int rc;
+
+	rc = rte_trace_point_disable(&__app_dpdk_test_tp);
+	if (rc < 0)
+		goto failed;
+
+	if (rte_trace_point_is_enabled(&__app_dpdk_test_tp))
+		goto failed;
+
+	/* Emit the event while the tracepoint is disabled */
+	app_dpdk_test_tp("app.dpdk.test.tp");
+
+	rc = rte_trace_point_enable(&__app_dpdk_test_tp);
+	if (rc < 0)
+		goto failed;
+
+	if (!rte_trace_point_is_enabled(&__app_dpdk_test_tp))
+		goto failed;
+
+	if (!rte_trace_is_enabled())
+		goto failed;
+
+	/* Emit the event while the tracepoint is enabled */
+	app_dpdk_test_tp("app.dpdk.test.tp");
+
+	rc = rte_trace_point_disable(&__app_dpdk_test_tp);
+	if (rc < 0)
+		goto failed;
+
+	if (rte_trace_point_is_enabled(&__app_dpdk_test_tp))
+		goto failed;
+
+	return TEST_SUCCESS;
+
+failed:
+	return TEST_FAILED;
+}
+
+static int
+test_trace_mode(void)
+{
+	enum rte_trace_mode current;
+
+	current = rte_trace_mode_get();
+
+	rte_trace_mode_set(RTE_TRACE_MODE_DISCARD);
+	if (rte_trace_mode_get() != RTE_TRACE_MODE_DISCARD)
+		goto failed;
+
+	rte_trace_mode_set(RTE_TRACE_MODE_OVERWRITE);
+	if (rte_trace_mode_get() != RTE_TRACE_MODE_OVERWRITE)
+		goto failed;
+
+	rte_trace_mode_set(current);
+	return TEST_SUCCESS;
+
+failed:
+	rte_trace_mode_set(current);
+	return TEST_FAILED;
+}
+
+static int
+test_trace_points_lookup(void)
+{
+	rte_trace_point_t *trace;
+
+	trace = rte_trace_point_lookup("app.dpdk.test.tp");
+	if (trace != &__app_dpdk_test_tp)
+		goto fail;
+	trace = rte_trace_point_lookup("this_trace_point_does_not_exist");
+	if (trace != NULL)
+		goto fail;
+	trace = rte_trace_point_lookup(NULL);
+	if (trace != NULL)
+		goto fail;
+
+	if (rte_trace_point_enable(NULL) != -ERANGE)
+		goto fail;
+	if (rte_trace_point_is_enabled(NULL))
+		goto fail;
+
+	return TEST_SUCCESS;
+fail:
+	return TEST_FAILED;
+}
+
+static int
+test_trace_fastpath_point(void)
+{
+	int i;
+
+	if (rte_trace_pattern("app.dpdk.test.*", true) != 1)
+		return TEST_FAILED;
+
+	/* Wrap the per-thread buffer in overwrite mode */
+	for (i = 0; i < 1024; i++) {
+		app_dpdk_test_fp();
+		app_dpdk_test_types(UINT8_MAX, INT16_MIN, i, -i, 0.5,
+			&__app_dpdk_test_types);
+		app_dpdk_test_tp(NULL);
+	}
+
+	if (rte_trace_pattern("app.dpdk.test.*", false) != 1)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_generic_trace_points(void)
+{
+	int tmp = 0;
+
+	app_dpdk_test_tp("app.dpdk.test.tp");
+	app_dpdk_test_types(rte_lcore_id(), -1, 0xdeadbeef, INT64_MAX, -1.0,
+		&tmp);
+	app_dpdk_test_fp();
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_trace_dump(void)
+{
+	rte_trace_dump(stdout);
+	return 0;
+}
+
+static int
+test_trace_save(void)
+{
+	if (rte_trace_save() < 0)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite trace_tests = {
+	.suite_name = "trace autotest",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_trace_mode),
+		TEST_CASE(test_generic_trace_points),
+		TEST_CASE(test_trace_points_lookup),
+		TEST_CASE(test_trace_point_globbing),
+		TEST_CASE(test_trace_point_regex),
+		TEST_CASE(test_trace_point_disable_enable),
+		TEST_CASE(test_trace_fastpath_point),
+		TEST_CASE(test_trace_dump),
+		TEST_CASE(test_trace_save),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_trace(void)
+{
+	return unit_test_suite_runner(&trace_tests);
+}
+
+REGISTER_TEST_COMMAND(trace_autotest, test_trace);
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <rte_trace_point.h>
+
+RTE_TRACE_POINT(
+	app_dpdk_test_tp,
+	RTE_TRACE_POINT_ARGS(const char *str),
+	rte_trace_point_emit_string(str);
+)
+
+RTE_TRACE_POINT(
+	app_dpdk_test_fp,
+	RTE_TRACE_POINT_ARGS(void),
+)
+
+RTE_TRACE_POINT(
+	app_dpdk_test_types,
+	RTE_TRACE_POINT_ARGS(uint8_t u8, int16_t i16, uint32_t u32,
+		int64_t i64, double dbl, void *ptr),
+	rte_trace_point_emit_u8(u8);
+	rte_trace_point_emit_i16(i16);
+	rte_trace_point_emit_u32(u32);
+	rte_trace_point_emit_i64(i64);
+	rte_trace_point_emit_double(dbl);
+	rte_trace_point_emit_ptr(ptr);
+)
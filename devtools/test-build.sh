@@ -11,7 +11,6 @@ default_path=$PATH
 # - DPDK_DEP_CFLAGS
 # - DPDK_DEP_ELF (y/[n])
 # - DPDK_DEP_ISAL (y/[n])
-# - DPDK_DEP_JSON (y/[n])
 # - DPDK_DEP_LDFLAGS
 # - DPDK_DEP_MLX (y/[n])
 # - DPDK_DEP_NUMA ([y]/n)
@@ -100,7 +99,6 @@ reset_env ()
 	unset DPDK_DEP_CFLAGS
 	unset DPDK_DEP_ELF
 	unset DPDK_DEP_ISAL
-	unset DPDK_DEP_JSON
 	unset DPDK_DEP_LDFLAGS
 	unset DPDK_DEP_MLX
 	unset DPDK_DEP_NUMA
@@ -193,8 +191,6 @@ config () # <directory> <target> <options>
 		sed -ri         's,(MVNETA_PMD=)n,\1y,' $1/.config
 		test "$DPDK_DEP_ELF" != y || \
 		sed -ri            's,(BPF_ELF=)n,\1y,' $1/.config
-		test "$DPDK_DEP_JSON" != y || \
-		sed -ri          's,(TELEMETRY=)n,\1y,' $1/.config
 		build_config_hook $1 $2 $3
 
 		# Explicit enabler/disabler (uppercase)
@@ -19,6 +19,7 @@
 #define NUMA_NODE_ARG "numa_node"
 #define SCHED_QUANTA_ARG "sched_quanta"
 #define CREDIT_QUANTA_ARG "credit_quanta"
+#define SCHED_INSTANCES_ARG "sched_instances"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
@@ -114,7 +115,9 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 		}
 	}
 
-	p->unlinks_in_progress += unlinked;
+	/* every scheduler instance has to ack the unlinks */
+	for (i = 0; i < sw->nb_sched; i++)
+		sw_sched_port(sw, i, p->id)->unlinks_in_progress += unlinked;
 	rte_smp_mb();
 
 	return unlinked;
@@ -123,44 +126,37 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 static int
 sw_port_unlinks_in_progress(struct rte_eventdev *dev, void *port)
 {
-	RTE_SET_USED(dev);
+	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = port;
-	return p->unlinks_in_progress;
+	int unlinks = 0;
+	unsigned int i;
+
+	for (i = 0; i < sw->nb_sched; i++)
+		unlinks += sw_sched_port(sw, i, p->id)->unlinks_in_progress;
+	return unlinks;
 }
 
+/* Create the rings between a port and one scheduler instance, and reset the
+ * scheduler side state of the port in that instance.
+ */
 static int
-sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
+sw_sched_port_setup(struct rte_eventdev *dev, struct sw_sched *s,
+		struct sw_port *p, uint8_t port_id,
 		const struct rte_event_port_conf *conf)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
-	struct sw_port *p = &sw->ports[port_id];
 	char buf[RTE_RING_NAMESIZE];
 	unsigned int i;
 
-	struct rte_event_dev_info info;
-	sw_info_get(dev, &info);
-
-	/* detect re-configuring and return credits to instance if needed */
-	if (p->initialized) {
-		/* taking credits from pool is done one quanta at a time, and
-		 * credits may be spend (counted in p->inflights) or still
-		 * available in the port (p->inflight_credits). We must return
-		 * the sum to no leak credits
-		 */
-		int possible_inflights = p->inflight_credits + p->inflights;
-		rte_atomic32_sub(&sw->inflights, possible_inflights);
-	}
-
-	*p = (struct sw_port){0}; /* zero entire structure */
-	p->id = port_id;
-	p->sw = sw;
-
 	/* check to see if rings exists - port_setup() can be called multiple
 	 * times legally (assuming device is stopped). If ring exists, free it
 	 * to so it gets re-created with the correct size
 	 */
-	snprintf(buf, sizeof(buf), "sw%d_p%u_%s", dev->data->dev_id,
-			port_id, "rx_worker_ring");
+	if (s->id == 0)
+		snprintf(buf, sizeof(buf), "sw%d_p%u_%s", dev->data->dev_id,
+				port_id, "rx_worker_ring");
+	else
+		snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_%s",
+				dev->data->dev_id, port_id, s->id, "rx_ring");
 	struct rte_event_ring *existing_ring = rte_event_ring_lookup(buf);
 	if (existing_ring)
 		rte_event_ring_free(existing_ring);
@@ -174,12 +170,13 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		return -1;
 	}
 
-	p->inflight_max = conf->new_event_threshold;
-	p->implicit_release = !conf->disable_implicit_release;
-
 	/* check if ring exists, same as rx_worker above */
-	snprintf(buf, sizeof(buf), "sw%d_p%u, %s", dev->data->dev_id,
-			port_id, "cq_worker_ring");
+	if (s->id == 0)
+		snprintf(buf, sizeof(buf), "sw%d_p%u, %s", dev->data->dev_id,
+				port_id, "cq_worker_ring");
+	else
+		snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_%s",
+				dev->data->dev_id, port_id, s->id, "cq_ring");
 	existing_ring = rte_event_ring_lookup(buf);
 	if (existing_ring)
 		rte_event_ring_free(existing_ring);
@@ -189,17 +186,79 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
 	if (p->cq_worker_ring == NULL) {
 		rte_event_ring_free(p->rx_worker_ring);
+		p->rx_worker_ring = NULL;
 		SW_LOG_ERR("Error creating CQ worker ring for port %d\n",
 				port_id);
 		return -1;
 	}
-	sw->cq_ring_space[port_id] = conf->dequeue_depth;
+	s->cq_ring_space[port_id] = conf->dequeue_depth;
 
 	/* set hist list contents to empty */
 	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
 		p->hist_list[i].fid = -1;
 		p->hist_list[i].qid = -1;
 	}
+
+	return 0;
+}
+
+static int
+sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
+		const struct rte_event_port_conf *conf)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_port *p = &sw->ports[port_id];
+	uint8_t *deq_sched = p->deq_sched;
+	unsigned int i;
+
+	struct rte_event_dev_info info;
+	sw_info_get(dev, &info);
+
+	/* detect re-configuring and return credits to instance if needed */
+	if (p->initialized) {
+		/* taking credits from pool is done one quanta at a time, and
+		 * credits may be spend (counted in p->inflights) or still
+		 * available in the port (p->inflight_credits). We must return
+		 * the sum to no leak credits
+		 */
+		int possible_inflights = p->inflight_credits;
+		for (i = 0; i < sw->nb_sched; i++)
+			possible_inflights +=
+				sw_sched_port(sw, i, port_id)->inflights;
+		rte_atomic32_sub(&sw->inflights, possible_inflights);
+	}
+
+	for (i = 0; i < sw->nb_sched; i++) {
+		struct sw_port *sp = sw_sched_port(sw, i, port_id);
+
+		*sp = (struct sw_port){0}; /* zero entire structure */
+		sp->id = port_id;
+		sp->sw = sw;
+	}
+
+	if (sw->nb_sched > 1) {
+		if (deq_sched == NULL)
+			deq_sched = rte_malloc_socket(NULL,
+					SW_PORT_DEQ_SCHED_FIFO, 0,
+					dev->data->socket_id);
+		if (deq_sched == NULL) {
+			SW_LOG_ERR("Error allocating release fifo for port %d\n",
+					port_id);
+			return -ENOMEM;
+		}
+		p->deq_sched = deq_sched;
+	}
+
+	for (i = 0; i < sw->nb_sched; i++) {
+		if (sw_sched_port_setup(dev, &sw->sched[i],
+				sw_sched_port(sw, i, port_id), port_id,
+				conf) < 0)
+			return -1;
+	}
+
+	p->inflight_max = conf->new_event_threshold;
+	p->implicit_release = !conf->disable_implicit_release;
+
 	dev->data->ports[port_id] = p;
 
 	rte_smp_wmb();
@@ -211,11 +270,21 @@ static void
 sw_port_release(void *port)
 {
 	struct sw_port *p = (void *)port;
-	if (p == NULL)
+	unsigned int i;
+	if (p == NULL || p->sw == NULL)
 		return;
 
+	for (i = 1; i < p->sw->nb_sched; i++) {
+		struct sw_port *sp = sw_sched_port(p->sw, i, p->id);
+
+		rte_event_ring_free(sp->rx_worker_ring);
+		rte_event_ring_free(sp->cq_worker_ring);
+		memset(sp, 0, sizeof(*sp));
+	}
+
 	rte_event_ring_free(p->rx_worker_ring);
 	rte_event_ring_free(p->cq_worker_ring);
+	rte_free(p->deq_sched);
 	memset(p, 0, sizeof(*p));
 }
 
@@ -369,7 +438,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(&sw->sched[qid->sched_id], &qid->iq[j]);
 	}
 }
 
@@ -385,18 +454,32 @@ sw_qids_empty(struct sw_evdev *sw)
 		}
 	}
 
+	/* events handed over between scheduler instances */
+	for (i = 0; i < sw->nb_sched; i++) {
+		for (j = 0; j < sw->nb_sched; j++) {
+			if (sw->sched[i].fwd_buf_count[j] ||
+			    (sw->sched[i].fwd_ring[j] &&
+			     rte_event_ring_count(sw->sched[i].fwd_ring[j])))
+				return 0;
+		}
+	}
+
 	return 1;
 }
 
 static int
 sw_ports_empty(struct sw_evdev *sw)
 {
-	unsigned int i;
+	unsigned int i, j;
 
 	for (i = 0; i < sw->port_count; i++) {
-		if ((rte_event_ring_count(sw->ports[i].rx_worker_ring)) ||
-		     rte_event_ring_count(sw->ports[i].cq_worker_ring))
-			return 0;
+		for (j = 0; j < sw->nb_sched; j++) {
+			const struct sw_port *p = sw_sched_port(sw, j, i);
+
+			if ((rte_event_ring_count(p->rx_worker_ring)) ||
+			     rte_event_ring_count(p->cq_worker_ring))
+				return 0;
+		}
 	}
 
 	return 1;
@@ -429,9 +512,8 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_sched *s, struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -443,7 +525,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(s, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -457,8 +539,11 @@ sw_drain_queues(struct rte_eventdev *dev)
 	unsigned int i, j;
 
 	for (i = 0; i < sw->qid_count; i++) {
+		struct sw_qid *qid = &sw->qids[i];
+
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, &sw->sched[qid->sched_id],
+					&qid->iq[j]);
 	}
 }
 
@@ -475,7 +560,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(&sw->sched[qid->sched_id],
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -517,16 +603,27 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	const struct rte_eventdev_data *data = dev->data;
 	const struct rte_event_dev_config *conf = &data->dev_conf;
-	int num_chunks, i;
+	int num_chunks, i, j;
+	int sched_chunks[SW_SCHED_MAX];
+	uint32_t qid_count;
 
 	sw->qid_count = conf->nb_event_queues;
 	sw->port_count = conf->nb_event_ports;
 	sw->nb_events_limit = conf->nb_events_limit;
 	rte_atomic32_set(&sw->inflights, 0);
 
-	/* Number of chunks sized for worst-case spread of events across IQs */
-	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
-			sw->qid_count*SW_IQS_MAX*2;
+	/* Number of chunks sized for worst-case spread of events across IQs,
+	 * for each scheduler instance and the QIDs it handles
+	 */
+	num_chunks = 0;
+	for (i = 0; i < sw->nb_sched; i++) {
+		qid_count = (sw->qid_count + sw->nb_sched - 1 - i) /
+				sw->nb_sched;
+		sched_chunks[i] =
+			((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
+			qid_count*SW_IQS_MAX*2;
+		num_chunks += sched_chunks[i];
+	}
 
 	/* If this is a reconfiguration, free the previous IQ allocation. All
 	 * IQ chunk references were cleaned out of the QIDs in sw_stop(), and
@@ -543,9 +640,38 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	if (!sw->chunks)
 		return -ENOMEM;
 
-	sw->chunk_list_head = NULL;
-	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+	num_chunks = 0;
+	for (i = 0; i < sw->nb_sched; i++) {
+		struct sw_sched *s = &sw->sched[i];
+
+		s->chunk_list_head = NULL;
+		for (j = 0; j < sched_chunks[i]; j++)
+			iq_free_chunk(s, &sw->chunks[num_chunks + j]);
+		num_chunks += sched_chunks[i];
+	}
+
+	/* Rings between each pair of instances, sized to hold all the
+	 * events of the device so that handing events over never fails
+	 */
+	for (i = 0; i < sw->nb_sched; i++) {
+		for (j = 0; j < sw->nb_sched; j++) {
+			char buf[RTE_RING_NAMESIZE];
+
+			if (i == j)
+				continue;
+
+			/* free the ring of a previous configuration */
+			snprintf(buf, sizeof(buf), "sw%d_s%d_fwd_s%d",
+					data->dev_id, i, j);
+			rte_event_ring_free(rte_event_ring_lookup(buf));
+			sw->sched[i].fwd_ring[j] = rte_event_ring_create(buf,
+					rte_align32pow2(sw->nb_events_limit + 1),
+					data->socket_id,
+					RING_F_SP_ENQ | RING_F_SC_DEQ);
+			if (sw->sched[i].fwd_ring[j] == NULL)
+				return -ENOMEM;
+		}
+	}
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
@@ -630,15 +756,27 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 			"Ordered", "Atomic", "Parallel", "Directed"
 	};
 	uint32_t i;
-	fprintf(f, "EventDev %s: ports %d, qids %d\n", "todo-fix-name",
-			sw->port_count, sw->qid_count);
-
-	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+	fprintf(f, "EventDev %s: ports %d, qids %d, sched instances %d\n",
+			"todo-fix-name", sw->port_count, sw->qid_count,
+			sw->nb_sched);
+
+	for (i = 0; i < sw->nb_sched; i++) {
+		const struct sw_sched *s = &sw->sched[i];
+
+		if (sw->nb_sched > 1)
+			fprintf(f, "  Sched instance %d\n", i);
+		fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64
+			"\n\ttx   %"PRIu64"\n",
+			s->stats.rx_pkts, s->stats.rx_dropped,
+			s->stats.tx_pkts);
+		fprintf(f, "\tsched calls: %"PRIu64"\n", s->sched_called);
+		fprintf(f, "\tsched cq/qid call: %"PRIu64"\n",
+			s->sched_cq_qid_called);
+		fprintf(f, "\tsched no IQ enq: %"PRIu64"\n",
+			s->sched_no_iq_enqueues);
+		fprintf(f, "\tsched no CQ enq: %"PRIu64"\n",
+			s->sched_no_cq_enqueues);
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -656,13 +794,21 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 		}
 		fprintf(f, "  Port %d %s\n", i,
 			p->is_directed ? " (SingleCons)" : "");
+		struct sw_point_stats stats = {0};
+		int port_inflights = 0;
+		for (j = 0; j < sw->nb_sched; j++) {
+			const struct sw_port *sp = sw_sched_port(sw, j, i);
+			stats.rx_pkts += sp->stats.rx_pkts;
+			stats.rx_dropped += sp->stats.rx_dropped;
+			stats.tx_pkts += sp->stats.tx_pkts;
+			port_inflights += sp->inflights;
+		}
 		fprintf(f, "\trx   %"PRIu64"\tdrop %"PRIu64"\ttx   %"PRIu64
-			"\t%sinflight %d%s\n", sw->ports[i].stats.rx_pkts,
-			sw->ports[i].stats.rx_dropped,
-			sw->ports[i].stats.tx_pkts,
-			(p->inflights == p->inflight_max) ?
+			"\t%sinflight %d%s\n", stats.rx_pkts,
+			stats.rx_dropped, stats.tx_pkts,
+			(port_inflights == p->inflight_max) ?
 				COL_RED : COL_RESET,
-			sw->ports[i].inflights, COL_RESET);
+			port_inflights, COL_RESET);
 
 		fprintf(f, "\tMax New: %u"
 			"\tAvg cycles PP: %"PRIu64"\tCredits: %u\n",
@@ -800,18 +946,25 @@ sw_start(struct rte_eventdev *dev)
 			return -ENOLINK;
 		}
 
-	/* build up our prioritized array of qids */
+	/* spread the qids across the scheduler instances */
+	for (i = 0; i < sw->nb_sched; i++)
+		sw->sched[i].qid_count = 0;
+	for (i = 0; i < sw->qid_count; i++)
+		sw->qids[i].sched_id = i % sw->nb_sched;
+
+	/* build up the prioritized array of qids of each instance */
 	/* We don't use qsort here, as if all/multiple entries have the same
 	 * priority, the result is non-deterministic. From "man 3 qsort":
 	 * "If two members compare as equal, their order in the sorted
 	 * array is undefined."
 	 */
-	uint32_t qidx = 0;
 	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
 		for (i = 0; i < sw->qid_count; i++) {
 			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
+				struct sw_sched *s =
+					&sw->sched[sw->qids[i].sched_id];
+				s->qids_prioritized[s->qid_count++] =
+					&sw->qids[i];
 			}
 		}
 	}
@@ -871,11 +1024,21 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->nb_sched; i++) {
+		struct sw_sched *s = &sw->sched[i];
+		unsigned int j;
+
+		for (j = 0; j < RTE_DIM(s->fwd_ring); j++) {
+			rte_event_ring_free(s->fwd_ring[j]);
+			s->fwd_ring[j] = NULL;
+		}
+
+		memset(&s->stats, 0, sizeof(s->stats));
+		s->sched_called = 0;
+		s->sched_no_iq_enqueues = 0;
+		s->sched_no_cq_enqueues = 0;
+		s->sched_cq_qid_called = 0;
+	}
 
 	return 0;
 }
@@ -910,6 +1073,29 @@ set_credit_quanta(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_instances(const char *key __rte_unused, const char *value,
+		void *opaque)
+{
+	int *instances = opaque;
+	*instances = atoi(value);
+	if (*instances < 1 || *instances > SW_SCHED_MAX)
+		return -1;
+	return 0;
+}
+
+
+/* free the port views of the scheduler instances allocated at probe */
+static void
+sw_sched_free(struct sw_evdev *sw)
+{
+	unsigned int i;
+
+	for (i = 1; i < sw->nb_sched; i++) {
+		rte_free(sw->sched[i].ports);
+		sw->sched[i].ports = NULL;
+	}
+}
 
 static int32_t sw_sched_service_func(void *args)
 {
@@ -957,6 +1143,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		NUMA_NODE_ARG,
 		SCHED_QUANTA_ARG,
 		CREDIT_QUANTA_ARG,
+		SCHED_INSTANCES_ARG,
 		NULL
 	};
 	const char *name;
@@ -966,6 +1153,8 @@ sw_probe(struct rte_vdev_device *vdev)
 	int socket_id = rte_socket_id();
 	int sched_quanta  = SW_DEFAULT_SCHED_QUANTA;
 	int credit_quanta = SW_DEFAULT_CREDIT_QUANTA;
+	int sched_instances = 1;
+	int i;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1007,13 +1196,24 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_INSTANCES_ARG,
+					set_sched_instances, &sched_instances);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing sched instances parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
 
 	SW_LOG_INFO(
-			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d\n",
-			name, socket_id, sched_quanta, credit_quanta);
+			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d, sched_instances=%d\n",
+			name, socket_id, sched_quanta, credit_quanta,
+			sched_instances);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1038,6 +1238,33 @@ sw_probe(struct rte_vdev_device *vdev)
 	/* copy values passed from vdev command line to instance */
 	sw->credit_update_quanta = credit_quanta;
 	sw->sched_quanta = sched_quanta;
+	sw->nb_sched = sched_instances;
+
+	/* instance 0 schedules straight on the device ports, the others get
+	 * their own view of the ports
+	 */
+	for (i = 0; i < sw->nb_sched; i++) {
+		struct sw_sched *s = &sw->sched[i];
+
+		s->sw = sw;
+		s->id = i;
+		rte_spinlock_init(&s->lock);
+		if (i == 0) {
+			s->ports = sw->ports;
+			continue;
+		}
+
+		s->ports = rte_zmalloc_socket(NULL,
+				sizeof(struct sw_port) * SW_PORTS_MAX,
+				RTE_CACHE_LINE_SIZE, socket_id);
+		if (s->ports == NULL) {
+			SW_LOG_ERR("%s: Error allocating sched instance ports",
+					name);
+			sw_sched_free(sw);
+			rte_event_pmd_vdev_uninit(name);
+			return -ENOMEM;
+		}
+	}
 
 	/* register service with EAL */
 	struct rte_service_spec service;
@@ -1048,6 +1275,9 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	/* scheduler instances can be run by several service lcores */
+	if (sw->nb_sched > 1)
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
@@ -1064,6 +1294,7 @@ sw_probe(struct rte_vdev_device *vdev)
 static int
 sw_remove(struct rte_vdev_device *vdev)
 {
+	struct rte_eventdev *dev;
 	const char *name;
 
 	name = rte_vdev_device_name(vdev);
@@ -1072,6 +1303,10 @@ sw_remove(struct rte_vdev_device *vdev)
 
 	SW_LOG_INFO("Closing eventdev sw device %s\n", name);
 
+	dev = rte_event_pmd_get_named_dev(name);
+	if (dev != NULL && rte_eal_process_type() == RTE_PROC_PRIMARY)
+		sw_sched_free(sw_pmd_priv(dev));
+
 	return rte_event_pmd_vdev_uninit(name);
 }
 
@@ -1082,7 +1317,8 @@ static struct rte_vdev_driver evdev_sw_pmd_drv = {
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
-		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>");
+		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
+		SCHED_INSTANCES_ARG "=<int>");
 
 /* declared extern in header, for access from other .c files */
 int eventdev_sw_log_level;
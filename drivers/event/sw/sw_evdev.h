@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <rte_eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,8 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+/* max number of scheduler instances, each handling a subset of the QIDs */
+#define SW_SCHED_MAX 4
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -32,6 +35,8 @@
 #define SCHED_DEQUEUE_BURST_SIZE 32
 
 #define SW_PORT_HIST_LIST (MAX_SW_PROD_Q_DEPTH) /* size of our history list */
+/* a port can have a full history list in each scheduler instance */
+#define SW_PORT_DEQ_SCHED_FIFO (SW_PORT_HIST_LIST * SW_SCHED_MAX)
 #define NUM_SAMPLES 64 /* how many data points use for average stats */
 
 #define EVENTDEV_NAME_SW_PMD event_sw
@@ -127,6 +132,7 @@ struct sw_qid {
 	uint32_t window_size;          /* Used to wrap reorder_buffer_index */
 
 	uint8_t priority;
+	uint8_t sched_id; /* scheduler instance handling this QID */
 };
 
 struct sw_hist_list_entry {
@@ -176,6 +182,15 @@ struct sw_port {
 	uint16_t inflight_credits; /* num credits this port has right now */
 	uint8_t implicit_release; /* release events before dequeueing */
 
+	/* Scheduler instance each outstanding event was dequeued from, in
+	 * dequeue order, so that its release is returned to that instance.
+	 * Only allocated when the device has more than one instance.
+	 */
+	uint8_t *deq_sched;
+	uint16_t deq_sched_head;
+	uint16_t deq_sched_tail;
+	uint8_t deq_sched_next; /* instance polled first on next dequeue */
+
 	uint16_t last_dequeue_burst_sz; /* how big the burst was */
 	uint64_t last_dequeue_ticks; /* used to track burst processing time */
 	uint64_t avg_pkt_ticks;      /* tracks average over NUM_SAMPLES burst */
@@ -203,6 +218,46 @@ struct sw_port {
 	uint8_t num_qids_mapped;
 };
 
+/*
+ * A scheduler instance. Each instance owns a subset of the QIDs, and is the
+ * only one to touch their IQs, flows and reorder buffers, so instances can
+ * run concurrently on different service lcores. Workers exchange events
+ * with each instance through a dedicated pair of rings per port.
+ */
+struct sw_sched {
+	struct sw_evdev *sw;
+	/* Ports as seen by this instance: worker rings, history list and
+	 * scheduling buffers. Instance 0 uses the device ports directly.
+	 */
+	struct sw_port *ports;
+	uint8_t id;
+	/* taken by the service lcore running this instance */
+	rte_spinlock_t lock;
+
+	uint32_t qid_count;
+	struct sw_queue_chunk *chunk_list_head;
+
+	/* Events going to QIDs owned by other instances, buffered and then
+	 * pushed to the ring read by the owner
+	 */
+	struct rte_event_ring *fwd_ring[SW_SCHED_MAX];
+	uint16_t fwd_buf_count[SW_SCHED_MAX];
+	struct rte_event fwd_buf[SW_SCHED_MAX][SCHED_DEQUEUE_BURST_SIZE];
+
+	/* Cache how many packets are in each cq */
+	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
+
+	/* Array of pointers to load-balanced QIDs sorted by priority level */
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Stats */
+	struct sw_point_stats stats __rte_cache_aligned;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+} __rte_cache_aligned;
+
 struct sw_evdev {
 	struct rte_eventdev_data *data;
 
@@ -227,22 +282,14 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV] __rte_cache_aligned;
-	struct sw_queue_chunk *chunk_list_head;
 	struct sw_queue_chunk *chunks;
 
-	/* Cache how many packets are in each cq */
-	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
-
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	/* Scheduler instances, QID n is handled by instance n % nb_sched */
+	struct sw_sched sched[SW_SCHED_MAX];
+	uint8_t nb_sched;
+	rte_atomic32_t sched_next; /* instance tried first by next service run */
 
-	/* Stats */
-	struct sw_point_stats stats __rte_cache_aligned;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
 
 	uint8_t started;
 	uint32_t credit_update_quanta;
@@ -270,6 +317,13 @@ sw_pmd_priv_const(const struct rte_eventdev *eventdev)
 	return eventdev->data->dev_private;
 }
 
+/* view of port port_id from scheduler instance sched_id */
+static inline struct sw_port *
+sw_sched_port(const struct sw_evdev *sw, uint8_t sched_id, uint8_t port_id)
+{
+	return &sw->sched[sched_id].ports[port_id];
+}
+
 uint16_t sw_event_enqueue(void *port, const struct rte_event *ev);
 uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 		uint16_t num);
@@ -27,7 +27,7 @@
 #define SW_HASH_FLOWID(f) (((f) ^ (f >> 10)) & FLOWID_MASK)
 
 static inline uint32_t
-sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_atomic_to_cq(struct sw_sched *s, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count)
 {
 	struct rte_event qes[MAX_PER_IQ_DEQUEUE]; /* count <= MAX */
@@ -43,7 +43,7 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	 */
 	uint32_t qid_id = qid->id;
 
-	iq_dequeue_burst(sw, &qid->iq[iq_num], qes, count);
+	iq_dequeue_burst(s, &qid->iq[iq_num], qes, count);
 	for (i = 0; i < count; i++) {
 		const struct rte_event *qe = &qes[i];
 		const uint16_t flow_id = SW_HASH_FLOWID(qes[i].flow_id);
@@ -59,11 +59,11 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			cq = qid->cq_map[cq_idx];
 
 			/* find least used */
-			int cq_free_cnt = sw->cq_ring_space[cq];
+			int cq_free_cnt = s->cq_ring_space[cq];
 			for (cq_idx = 0; cq_idx < qid->cq_num_mapped_cqs;
 					cq_idx++) {
 				int test_cq = qid->cq_map[cq_idx];
-				int test_cq_free = sw->cq_ring_space[test_cq];
+				int test_cq_free = s->cq_ring_space[test_cq];
 				if (test_cq_free > cq_free_cnt) {
 					cq = test_cq;
 					cq_free_cnt = test_cq_free;
@@ -73,19 +73,19 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			fid->cq = cq; /* this pins early */
 		}
 
-		if (sw->cq_ring_space[cq] == 0 ||
-				sw->ports[cq].inflights == SW_PORT_HIST_LIST) {
+		if (s->cq_ring_space[cq] == 0 ||
+				s->ports[cq].inflights == SW_PORT_HIST_LIST) {
 			blocked_qes[nb_blocked++] = *qe;
 			continue;
 		}
 
-		struct sw_port *p = &sw->ports[cq];
+		struct sw_port *p = &s->ports[cq];
 
 		/* at this point we can queue up the packet on the cq_buf */
 		fid->pcount++;
 		p->cq_buf[p->cq_buf_count++] = *qe;
 		p->inflights++;
-		sw->cq_ring_space[cq]--;
+		s->cq_ring_space[cq]--;
 
 		int head = (p->hist_head++ & (SW_PORT_HIST_LIST-1));
 		p->hist_list[head].fid = flow_id;
@@ -96,21 +96,21 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 		qid->to_port[cq]++;
 
 		/* if we just filled in the last slot, flush the buffer */
-		if (sw->cq_ring_space[cq] == 0) {
+		if (s->cq_ring_space[cq] == 0) {
 			struct rte_event_ring *worker = p->cq_worker_ring;
 			rte_event_ring_enqueue_burst(worker, p->cq_buf,
 					p->cq_buf_count,
-					&sw->cq_ring_space[cq]);
+					&s->cq_ring_space[cq]);
 			p->cq_buf_count = 0;
 		}
 	}
-	iq_put_back(sw, &qid->iq[iq_num], blocked_qes, nb_blocked);
+	iq_put_back(s, &qid->iq[iq_num], blocked_qes, nb_blocked);
 
 	return count - nb_blocked;
 }
 
 static inline uint32_t
-sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_parallel_to_cq(struct sw_sched *s, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count, int keep_order)
 {
 	uint32_t i;
@@ -147,15 +147,15 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			cq = qid->cq_map[cq_idx++];
 
 		} while (rte_event_ring_free_count(
-				sw->ports[cq].cq_worker_ring) == 0 ||
-				sw->ports[cq].inflights == SW_PORT_HIST_LIST);
+				s->ports[cq].cq_worker_ring) == 0 ||
+				s->ports[cq].inflights == SW_PORT_HIST_LIST);
 
-		struct sw_port *p = &sw->ports[cq];
-		if (sw->cq_ring_space[cq] == 0 ||
+		struct sw_port *p = &s->ports[cq];
+		if (s->cq_ring_space[cq] == 0 ||
 				p->inflights == SW_PORT_HIST_LIST)
 			break;
 
-		sw->cq_ring_space[cq]--;
+		s->cq_ring_space[cq]--;
 
 		qid->stats.tx_pkts++;
 
@@ -167,8 +167,8 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			rte_ring_sc_dequeue(qid->reorder_buffer_freelist,
 					(void *)&p->hist_list[head].rob_entry);
 
-		sw->ports[cq].cq_buf[sw->ports[cq].cq_buf_count++] = *qe;
-		iq_pop(sw, &qid->iq[iq_num]);
+		s->ports[cq].cq_buf[s->ports[cq].cq_buf_count++] = *qe;
+		iq_pop(s, &qid->iq[iq_num]);
 
 		rte_compiler_barrier();
 		p->inflights++;
@@ -181,20 +181,20 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 }
 
 static uint32_t
-sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_dir_to_cq(struct sw_sched *s, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count __rte_unused)
 {
 	uint32_t cq_id = qid->cq_map[0];
-	struct sw_port *port = &sw->ports[cq_id];
+	struct sw_port *port = &s->ports[cq_id];
 
 	/* get max burst enq size for cq_ring */
-	uint32_t count_free = sw->cq_ring_space[cq_id];
+	uint32_t count_free = s->cq_ring_space[cq_id];
 	if (count_free == 0)
 		return 0;
 
 	/* burst dequeue from the QID IQ ring */
 	struct sw_iq *iq = &qid->iq[iq_num];
-	uint32_t ret = iq_dequeue_burst(sw, iq,
+	uint32_t ret = iq_dequeue_burst(s, iq,
 			&port->cq_buf[port->cq_buf_count], count_free);
 	port->cq_buf_count += ret;
 
@@ -203,21 +203,21 @@ sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	port->stats.tx_pkts += ret;
 
 	/* Subtract credits from cached value */
-	sw->cq_ring_space[cq_id] -= ret;
+	s->cq_ring_space[cq_id] -= ret;
 
 	return ret;
 }
 
 static uint32_t
-sw_schedule_qid_to_cq(struct sw_evdev *sw)
+sw_schedule_qid_to_cq(struct sw_sched *s)
 {
 	uint32_t pkts = 0;
 	uint32_t qid_idx;
 
-	sw->sched_cq_qid_called++;
+	s->sched_cq_qid_called++;
 
-	for (qid_idx = 0; qid_idx < sw->qid_count; qid_idx++) {
-		struct sw_qid *qid = sw->qids_prioritized[qid_idx];
+	for (qid_idx = 0; qid_idx < s->qid_count; qid_idx++) {
+		struct sw_qid *qid = s->qids_prioritized[qid_idx];
 
 		int type = qid->type;
 		int iq_num = PKT_MASK_TO_IQ(qid->iq_pkt_mask);
@@ -231,13 +231,13 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 
 		if (count > 0) {
 			if (type == SW_SCHED_TYPE_DIRECT)
-				pkts_done += sw_schedule_dir_to_cq(sw, qid,
+				pkts_done += sw_schedule_dir_to_cq(s, qid,
 						iq_num, count);
 			else if (type == RTE_SCHED_TYPE_ATOMIC)
-				pkts_done += sw_schedule_atomic_to_cq(sw, qid,
+				pkts_done += sw_schedule_atomic_to_cq(s, qid,
 						iq_num, count);
 			else
-				pkts_done += sw_schedule_parallel_to_cq(sw, qid,
+				pkts_done += sw_schedule_parallel_to_cq(s, qid,
 						iq_num, count,
 						type == RTE_SCHED_TYPE_ORDERED);
 		}
@@ -254,14 +254,82 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 	return pkts;
 }
 
+/* Push the events buffered for the QIDs of another instance to the ring it
+ * pulls from. The events which do not fit stay buffered until the next try.
+ */
+static inline void
+sw_fwd_flush(struct sw_sched *s, uint8_t dst)
+{
+	uint16_t count = s->fwd_buf_count[dst];
+	uint16_t enq;
+
+	enq = rte_event_ring_enqueue_burst(s->fwd_ring[dst], s->fwd_buf[dst],
+			count, NULL);
+	if (unlikely(enq != count))
+		memmove(s->fwd_buf[dst], &s->fwd_buf[dst][enq],
+				(count - enq) * sizeof(s->fwd_buf[dst][0]));
+	s->fwd_buf_count[dst] = count - enq;
+}
+
+/* Check that an event can be handed over to the instance handling its QID,
+ * if it is not handled by this one. When the buffer for that instance is
+ * still full after a flush, the event must be left where it is and pulled
+ * again on a later iteration.
+ */
+static __rte_always_inline int
+sw_fwd_full(struct sw_sched *s, const struct rte_event *qe)
+{
+	const struct sw_evdev *sw = s->sw;
+	uint8_t dst;
+
+	if (likely(sw->nb_sched == 1) || (qe->op & QE_FLAG_VALID) == 0 ||
+			qe->queue_id >= sw->qid_count)
+		return 0;
+
+	dst = sw->qids[qe->queue_id].sched_id;
+	if (dst == s->id ||
+			s->fwd_buf_count[dst] < SCHED_DEQUEUE_BURST_SIZE)
+		return 0;
+
+	sw_fwd_flush(s, dst);
+	return s->fwd_buf_count[dst] == SCHED_DEQUEUE_BURST_SIZE;
+}
+
+/* Push an event into the IQ of its QID at the right priority, or hand it
+ * over to the instance handling that QID. Returns the number of events
+ * pushed into a local IQ.
+ */
+static __rte_always_inline uint32_t
+sw_qid_enqueue(struct sw_sched *s, const struct rte_event *qe)
+{
+	struct sw_qid *qid = &s->sw->qids[qe->queue_id];
+	const uint32_t iq_num = PRIO_TO_IQ(qe->priority);
+
+	if (unlikely(qid->sched_id != s->id)) {
+		const uint8_t dst = qid->sched_id;
+
+		s->fwd_buf[dst][s->fwd_buf_count[dst]++] = *qe;
+		if (s->fwd_buf_count[dst] == SCHED_DEQUEUE_BURST_SIZE)
+			sw_fwd_flush(s, dst);
+		return 0;
+	}
+
+	qid->iq_pkt_mask |= (1 << (iq_num));
+	iq_enqueue(s, &qid->iq[iq_num], qe);
+	qid->iq_pkt_count[iq_num]++;
+	qid->stats.rx_pkts++;
+	return 1;
+}
+
 /* This function will perform re-ordering of packets, and injecting into
  * the appropriate QID IQ. As LB and DIR QIDs are in the same array, but *NOT*
  * contiguous in that array, this function accepts a "range" of QIDs to scan.
  */
 static uint16_t
-sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
+sw_schedule_reorder(struct sw_sched *s, int qid_start, int qid_end)
 {
 	/* Perform egress reordering */
+	struct sw_evdev *sw = s->sw;
 	struct rte_event *qe;
 	uint32_t pkts_iter = 0;
 
@@ -269,7 +337,8 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 		struct sw_qid *qid = &sw->qids[qid_start];
 		int i, num_entries_in_use;
 
-		if (qid->type != RTE_SCHED_TYPE_ORDERED)
+		if (qid->type != RTE_SCHED_TYPE_ORDERED ||
+				qid->sched_id != s->id)
 			continue;
 
 		num_entries_in_use = rte_ring_free_count(
@@ -286,31 +355,24 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 
 			for (j = 0; j < entry->num_fragments; j++) {
 				uint16_t dest_qid;
-				uint16_t dest_iq;
 
 				int idx = entry->fragment_index + j;
 				qe = &entry->fragments[idx];
 
+				if (unlikely(sw_fwd_full(s, qe)))
+					break;
+
 				dest_qid = qe->queue_id;
-				dest_iq  = PRIO_TO_IQ(qe->priority);
 
 				if (dest_qid >= sw->qid_count) {
-					sw->stats.rx_dropped++;
+					s->stats.rx_dropped++;
 					continue;
 				}
 
-				pkts_iter++;
-
-				struct sw_qid *q = &sw->qids[dest_qid];
-				struct sw_iq *iq = &q->iq[dest_iq];
-
 				/* we checked for space above, so enqueue must
 				 * succeed
 				 */
-				iq_enqueue(sw, iq, qe);
-				q->iq_pkt_mask |= (1 << (dest_iq));
-				q->iq_pkt_count[dest_iq]++;
-				q->stats.rx_pkts++;
+				pkts_iter += sw_qid_enqueue(s, qe);
 			}
 
 			entry->ready = (j != entry->num_fragments);
@@ -326,6 +388,9 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 
 				qid->reorder_buffer_index++;
 				qid->reorder_buffer_index %= qid->window_size;
+			} else {
+				/* wait for room to hand over the rest */
+				break;
 			}
 		}
 	}
@@ -333,9 +398,9 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 }
 
 static __rte_always_inline void
-sw_refill_pp_buf(struct sw_evdev *sw, struct sw_port *port)
+sw_refill_pp_buf(struct sw_sched *s, struct sw_port *port)
 {
-	RTE_SET_USED(sw);
+	RTE_SET_USED(s);
 	struct rte_event_ring *worker = port->rx_worker_ring;
 	port->pp_buf_start = 0;
 	port->pp_buf_count = rte_event_ring_dequeue_burst(worker, port->pp_buf,
@@ -343,15 +408,16 @@ sw_refill_pp_buf(struct sw_evdev *sw, struct sw_port *port)
 }
 
 static __rte_always_inline uint32_t
-__pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
+__pull_port_lb(struct sw_sched *s, uint32_t port_id, int allow_reorder)
 {
 	static struct reorder_buffer_entry dummy_rob;
+	struct sw_evdev *sw = s->sw;
 	uint32_t pkts_iter = 0;
-	struct sw_port *port = &sw->ports[port_id];
+	struct sw_port *port = &s->ports[port_id];
 
 	/* If shadow ring has 0 pkts, pull from worker ring */
 	if (port->pp_buf_count == 0)
-		sw_refill_pp_buf(sw, port);
+		sw_refill_pp_buf(s, port);
 
 	while (port->pp_buf_count) {
 		const struct rte_event *qe = &port->pp_buf[port->pp_buf_start];
@@ -359,19 +425,15 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 		uint8_t flags = qe->op;
 		const uint16_t eop = !(flags & QE_FLAG_NOT_EOP);
 		int needs_reorder = 0;
+
+		/* back-pressure from the instance handling the QID */
+		if (unlikely(sw_fwd_full(s, qe)))
+			break;
+
 		/* if no-reordering, having PARTIAL == NEW */
 		if (!allow_reorder && !eop)
 			flags = QE_FLAG_VALID;
 
-		/*
-		 * if we don't have space for this packet in an IQ,
-		 * then move on to next queue. Technically, for a
-		 * packet that needs reordering, we don't need to check
-		 * here, but it simplifies things not to special-case
-		 */
-		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
-		struct sw_qid *qid = &sw->qids[qe->queue_id];
-
 		/* now process based on flags. Note that for directed
 		 * queues, the enqueue_flush masks off all but the
 		 * valid flag. This makes FWD and PARTIAL enqueues just
@@ -422,7 +484,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				 */
 				int num_frag = rob_entry->num_fragments;
 				if (num_frag == SW_FRAGMENTS_MAX)
-					sw->stats.rx_dropped++;
+					s->stats.rx_dropped++;
 				else {
 					int idx = rob_entry->num_fragments++;
 					rob_entry->fragments[idx] = *qe;
@@ -430,15 +492,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				goto end_qe;
 			}
 
-			/* Use the iq_num from above to push the QE
-			 * into the qid at the right priority
-			 */
-
-			qid->iq_pkt_mask |= (1 << (iq_num));
-			iq_enqueue(sw, &qid->iq[iq_num], qe);
-			qid->iq_pkt_count[iq_num]++;
-			qid->stats.rx_pkts++;
-			pkts_iter++;
+			pkts_iter += sw_qid_enqueue(s, qe);
 		}
 
 end_qe:
@@ -450,26 +504,26 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 }
 
 static uint32_t
-sw_schedule_pull_port_lb(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_lb(struct sw_sched *s, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 1);
+	return __pull_port_lb(s, port_id, 1);
 }
 
 static uint32_t
-sw_schedule_pull_port_no_reorder(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_no_reorder(struct sw_sched *s, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 0);
+	return __pull_port_lb(s, port_id, 0);
 }
 
 static uint32_t
-sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_dir(struct sw_sched *s, uint32_t port_id)
 {
 	uint32_t pkts_iter = 0;
-	struct sw_port *port = &sw->ports[port_id];
+	struct sw_port *port = &s->ports[port_id];
 
 	/* If shadow ring has 0 pkts, pull from worker ring */
 	if (port->pp_buf_count == 0)
-		sw_refill_pp_buf(sw, port);
+		sw_refill_pp_buf(s, port);
 
 	while (port->pp_buf_count) {
 		const struct rte_event *qe = &port->pp_buf[port->pp_buf_start];
@@ -478,20 +532,11 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 		if ((flags & QE_FLAG_VALID) == 0)
 			goto end_qe;
 
-		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
-		struct sw_qid *qid = &sw->qids[qe->queue_id];
-		struct sw_iq *iq = &qid->iq[iq_num];
+		if (unlikely(sw_fwd_full(s, qe)))
+			break;
 
 		port->stats.rx_pkts++;
-
-		/* Use the iq_num from above to push the QE
-		 * into the qid at the right priority
-		 */
-		qid->iq_pkt_mask |= (1 << (iq_num));
-		iq_enqueue(sw, iq, qe);
-		qid->iq_pkt_count[iq_num]++;
-		qid->stats.rx_pkts++;
-		pkts_iter++;
+		pkts_iter += sw_qid_enqueue(s, qe);
 
 end_qe:
 		port->pp_buf_start++;
@@ -501,16 +546,41 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 	return pkts_iter;
 }
 
-void
-sw_event_schedule(struct rte_eventdev *dev)
+/* Pull the events other instances handed over to the QIDs of this one */
+static uint32_t
+sw_schedule_pull_fwd(struct sw_sched *s)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_evdev *sw = s->sw;
+	struct rte_event qes[SCHED_DEQUEUE_BURST_SIZE];
+	uint32_t pkts_iter = 0;
+	uint32_t i;
+	uint8_t src;
+
+	for (src = 0; src < sw->nb_sched; src++) {
+		struct rte_event_ring *ring = sw->sched[src].fwd_ring[s->id];
+		uint32_t n;
+
+		if (ring == NULL)
+			continue;
+
+		n = rte_event_ring_dequeue_burst(ring, qes, RTE_DIM(qes), NULL);
+		for (i = 0; i < n; i++)
+			pkts_iter += sw_qid_enqueue(s, &qes[i]);
+	}
+
+	return pkts_iter;
+}
+
+static void
+sw_schedule_instance(struct sw_sched *s)
+{
+	struct sw_evdev *sw = s->sw;
 	uint32_t in_pkts, out_pkts;
 	uint32_t out_pkts_total = 0, in_pkts_total = 0;
 	int32_t sched_quanta = sw->sched_quanta;
 	uint32_t i;
 
-	sw->sched_called++;
+	s->sched_called++;
 	if (unlikely(!sw->started))
 		return;
 
@@ -522,25 +592,29 @@ sw_event_schedule(struct rte_eventdev *dev)
 			in_pkts = 0;
 			for (i = 0; i < sw->port_count; i++) {
 				/* ack the unlinks in progress as done */
-				if (sw->ports[i].unlinks_in_progress)
-					sw->ports[i].unlinks_in_progress = 0;
+				if (s->ports[i].unlinks_in_progress)
+					s->ports[i].unlinks_in_progress = 0;
 
 				if (sw->ports[i].is_directed)
-					in_pkts += sw_schedule_pull_port_dir(sw, i);
+					in_pkts += sw_schedule_pull_port_dir(s, i);
 				else if (sw->ports[i].num_ordered_qids > 0)
-					in_pkts += sw_schedule_pull_port_lb(sw, i);
+					in_pkts += sw_schedule_pull_port_lb(s, i);
 				else
-					in_pkts += sw_schedule_pull_port_no_reorder(sw, i);
+					in_pkts += sw_schedule_pull_port_no_reorder(s, i);
 			}
 
+			/* events handed over by the other instances */
+			if (sw->nb_sched > 1)
+				in_pkts += sw_schedule_pull_fwd(s);
+
 			/* QID scan for re-ordered */
-			in_pkts += sw_schedule_reorder(sw, 0,
+			in_pkts += sw_schedule_reorder(s, 0,
 					sw->qid_count);
 			in_pkts_this_iteration += in_pkts;
 		} while (in_pkts > 4 &&
 				(int)in_pkts_this_iteration < sched_quanta);
 
-		out_pkts = sw_schedule_qid_to_cq(sw);
+		out_pkts = sw_schedule_qid_to_cq(s);
 		out_pkts_total += out_pkts;
 		in_pkts_total += in_pkts_this_iteration;
 
@@ -548,21 +622,51 @@ sw_event_schedule(struct rte_eventdev *dev)
 			break;
 	} while ((int)out_pkts_total < sched_quanta);
 
-	sw->stats.tx_pkts += out_pkts_total;
-	sw->stats.rx_pkts += in_pkts_total;
+	s->stats.tx_pkts += out_pkts_total;
+	s->stats.rx_pkts += in_pkts_total;
 
-	sw->sched_no_iq_enqueues += (in_pkts_total == 0);
-	sw->sched_no_cq_enqueues += (out_pkts_total == 0);
+	s->sched_no_iq_enqueues += (in_pkts_total == 0);
+	s->sched_no_cq_enqueues += (out_pkts_total == 0);
 
 	/* push all the internal buffered QEs in port->cq_ring to the
 	 * worker cores: aka, do the ring transfers batched.
 	 */
 	for (i = 0; i < sw->port_count; i++) {
-		struct rte_event_ring *worker = sw->ports[i].cq_worker_ring;
-		rte_event_ring_enqueue_burst(worker, sw->ports[i].cq_buf,
-				sw->ports[i].cq_buf_count,
-				&sw->cq_ring_space[i]);
-		sw->ports[i].cq_buf_count = 0;
+		struct rte_event_ring *worker = s->ports[i].cq_worker_ring;
+		rte_event_ring_enqueue_burst(worker, s->ports[i].cq_buf,
+				s->ports[i].cq_buf_count,
+				&s->cq_ring_space[i]);
+		s->ports[i].cq_buf_count = 0;
 	}
 
+	for (i = 0; i < sw->nb_sched; i++) {
+		if (s->fwd_buf_count[i])
+			sw_fwd_flush(s, i);
+	}
+}
+
+void
+sw_event_schedule(struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	uint32_t start, i;
+
+	if (likely(sw->nb_sched == 1)) {
+		sw_schedule_instance(&sw->sched[0]);
+		return;
+	}
+
+	/* With several instances the service is MT safe: each call runs the
+	 * instances no other service lcore is running, starting from a
+	 * different one every time to spread them across the lcores.
+	 */
+	start = rte_atomic32_add_return(&sw->sched_next, 1);
+	for (i = 0; i < sw->nb_sched; i++) {
+		struct sw_sched *s = &sw->sched[(start + i) % sw->nb_sched];
+
+		if (!rte_spinlock_trylock(&s->lock))
+			continue;
+		sw_schedule_instance(s);
+		rte_spinlock_unlock(&s->lock);
+	}
 }
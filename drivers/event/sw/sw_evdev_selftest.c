@@ -18,6 +18,7 @@
 #include <rte_ethdev.h>
 #include <rte_cycles.h>
 #include <rte_eventdev.h>
+#include <rte_event_ring.h>
 #include <rte_pause.h>
 #include <rte_service.h>
 #include <rte_service_component.h>
@@ -2236,6 +2237,7 @@ static int
 invalid_qid(struct test *t)
 {
 	struct test_event_dev_stats stats;
+	const uint32_t service_id = t->service_id;
 	const int rx_enq = 0;
 	int err;
 	uint32_t i;
@@ -2246,6 +2248,7 @@ invalid_qid(struct test *t)
 		printf("%d: Error initializing device\n", __LINE__);
 		return -1;
 	}
+	t->service_id = service_id;
 
 	/* CQ mapping to QID */
 	for (i = 0; i < 4; i++) {
@@ -2266,9 +2269,10 @@ invalid_qid(struct test *t)
 	 * Send in a packet with an invalid qid to the scheduler.
 	 * We should see the packed enqueued OK, but the inflights for
 	 * that packet should not be incremented, and the rx_dropped
-	 * should be incremented.
+	 * should be incremented. The last qid is beyond the maximum number
+	 * of queues of a device.
 	 */
-	static uint32_t flows1[] = {20};
+	static uint32_t flows1[] = {20, UINT8_MAX};
 
 	for (i = 0; i < RTE_DIM(flows1); i++) {
 		struct rte_mbuf *arp = rte_gen_arp(0, t->mbuf_pool);
@@ -2309,7 +2313,7 @@ invalid_qid(struct test *t)
 		rte_event_dev_dump(evdev, stdout);
 		return -1;
 	}
-	if (stats.port_rx_dropped[0] != 1) {
+	if (stats.port_rx_dropped[0] != RTE_DIM(flows1)) {
 		printf("%d:%s: port 1 drops\n", __LINE__, __func__);
 		rte_event_dev_dump(evdev, stdout);
 		return -1;
@@ -2951,6 +2955,310 @@ dev_stop_flush(struct test *t) /* test to check we can properly flush events */
 	return -1;
 }
 
+/* run the invalid QID test on a device with several scheduler instances */
+static int
+invalid_qid_multi_sched(struct test *t)
+{
+	const char *eventdev_name = "event_sw_multi_sched";
+	const int saved_evdev = evdev;
+	const uint32_t saved_service_id = t->service_id;
+	int ret = -1;
+
+	if (rte_vdev_init(eventdev_name, "sched_instances=2") < 0) {
+		printf("%d: Error creating eventdev\n", __LINE__);
+		return -1;
+	}
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0 ||
+			rte_event_dev_service_id_get(evdev,
+				&t->service_id) < 0) {
+		printf("%d: Error finding eventdev\n", __LINE__);
+		goto out;
+	}
+	rte_service_runstate_set(t->service_id, 1);
+	rte_service_set_runstate_mapped_check(t->service_id, 0);
+
+	ret = invalid_qid(t);
+out:
+	rte_vdev_uninit(eventdev_name);
+	evdev = saved_evdev;
+	t->service_id = saved_service_id;
+	return ret;
+}
+
+/* check that ordered and atomic stages handled by different scheduler
+ * instances keep flow order when events go from one instance to another
+ */
+static int
+multi_sched_pipeline(struct test *t)
+{
+#define MULTI_SCHED_NB_EVS 64
+#define MULTI_SCHED_NB_FLOWS 8
+	const char *eventdev_name = "event_sw_multi_sched";
+	const uint8_t rx_port = 0;
+	const uint8_t tx_port = 3;
+	const int saved_evdev = evdev;
+	const uint32_t saved_service_id = t->service_id;
+	uint64_t last_seq[MULTI_SCHED_NB_FLOWS];
+	uint32_t service_id;
+	int received = 0;
+	int ret = -1;
+	int i, iter;
+
+	if (rte_vdev_init(eventdev_name, "sched_instances=2") < 0) {
+		printf("%d: Error creating eventdev\n", __LINE__);
+		return -1;
+	}
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0 ||
+			rte_event_dev_service_id_get(evdev, &service_id) < 0) {
+		printf("%d: Error finding eventdev\n", __LINE__);
+		goto out;
+	}
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+
+	/* qid 0 (ordered) and 2 (directed) are handled by instance 0, qid 1
+	 * (atomic) by instance 1
+	 */
+	if (init(t, 3, tx_port + 1) < 0 ||
+			create_ports(t, tx_port + 1) < 0 ||
+			create_ordered_qids(t, 1) < 0 ||
+			create_atomic_qids(t, 1) < 0 ||
+			create_directed_qids(t, 1, &tx_port) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		goto out;
+	}
+	t->service_id = service_id;
+
+	for (i = 1; i < tx_port; i++) {
+		if (rte_event_port_link(evdev, t->port[i], t->qid, NULL,
+				2) != 2) {
+			printf("%d: error mapping lb qids\n", __LINE__);
+			goto out;
+		}
+	}
+
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto out;
+	}
+
+	for (i = 0; i < MULTI_SCHED_NB_EVS; i++) {
+		struct rte_event ev = {
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[0],
+			.flow_id = (i / 2) % MULTI_SCHED_NB_FLOWS,
+			.u64 = i,
+		};
+
+		if (rte_event_enqueue_burst(evdev, t->port[rx_port], &ev,
+				1) != 1) {
+			printf("%d: Failed to enqueue event %d\n", __LINE__, i);
+			goto out;
+		}
+	}
+
+	memset(last_seq, 0xff, sizeof(last_seq));
+	for (iter = 0; iter < 1000 && received < MULTI_SCHED_NB_EVS; iter++) {
+		struct rte_event evs[tx_port][MULTI_SCHED_NB_EVS];
+		uint16_t nb_evs[tx_port];
+		uint16_t j;
+
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+		/* dequeue from both workers, forward to the next stage in
+		 * reverse port order to give the reordering some work
+		 */
+		for (i = 1; i < tx_port; i++)
+			nb_evs[i] = rte_event_dequeue_burst(evdev, t->port[i],
+					evs[i], MULTI_SCHED_NB_EVS, 0);
+		for (i = tx_port - 1; i > 0; i--) {
+			for (j = 0; j < nb_evs[i]; j++) {
+				evs[i][j].op = RTE_EVENT_OP_FORWARD;
+				evs[i][j].queue_id++;
+			}
+			if (rte_event_enqueue_burst(evdev, t->port[i], evs[i],
+					nb_evs[i]) != nb_evs[i]) {
+				printf("%d: Failed to forward\n", __LINE__);
+				goto out;
+			}
+		}
+
+		nb_evs[0] = rte_event_dequeue_burst(evdev, t->port[tx_port],
+				evs[0], MULTI_SCHED_NB_EVS, 0);
+		for (j = 0; j < nb_evs[0]; j++) {
+			uint8_t flow = evs[0][j].flow_id;
+
+			if (last_seq[flow] != UINT64_MAX &&
+					evs[0][j].u64 <= last_seq[flow]) {
+				printf("%d: flow %u out of order: %"PRIu64
+					" after %"PRIu64"\n", __LINE__, flow,
+					evs[0][j].u64, last_seq[flow]);
+				goto out;
+			}
+			last_seq[flow] = evs[0][j].u64;
+		}
+		received += nb_evs[0];
+	}
+
+	if (received != MULTI_SCHED_NB_EVS) {
+		printf("%d: expected %d events at tx port, got %d\n", __LINE__,
+				MULTI_SCHED_NB_EVS, received);
+		rte_event_dev_dump(evdev, stdout);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	if (evdev >= 0)
+		cleanup(t);
+	rte_vdev_uninit(eventdev_name);
+	evdev = saved_evdev;
+	t->service_id = saved_service_id;
+	return ret;
+}
+
+/* check that a burst enqueue stopping on the full rx ring of one instance
+ * keeps the release of the events not enqueued for the next attempt
+ */
+static int
+multi_sched_full_ring(struct test *t)
+{
+	const char *eventdev_name = "event_sw_multi_sched";
+	const uint8_t wrk_port = 0;
+	const uint8_t tx_port = 1;
+	const int saved_evdev = evdev;
+	const uint32_t saved_service_id = t->service_id;
+	struct rte_event filler[64];
+	struct rte_event evs[2];
+	struct rte_event_ring *ring;
+	struct sw_evdev *sw;
+	uint32_t service_id;
+	unsigned int inflight_id;
+	uint16_t enq, nb_evs = 0;
+	int ret = -1;
+	int i;
+
+	if (rte_vdev_init(eventdev_name, "sched_instances=2") < 0) {
+		printf("%d: Error creating eventdev\n", __LINE__);
+		return -1;
+	}
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0 ||
+			rte_event_dev_service_id_get(evdev, &service_id) < 0) {
+		printf("%d: Error finding eventdev\n", __LINE__);
+		goto out;
+	}
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+
+	/* qid 0 (atomic) and 2 (directed) are handled by instance 0, qid 1
+	 * (atomic) by instance 1
+	 */
+	if (init(t, 3, tx_port + 1) < 0 ||
+			create_ports(t, tx_port + 1) < 0 ||
+			create_atomic_qids(t, 2) < 0 ||
+			create_directed_qids(t, 1, &tx_port) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		goto out;
+	}
+	t->service_id = service_id;
+
+	if (rte_event_port_link(evdev, t->port[wrk_port], t->qid, NULL,
+			2) != 2) {
+		printf("%d: error mapping lb qids\n", __LINE__);
+		goto out;
+	}
+
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto out;
+	}
+
+	/* the worker holds one event of each instance */
+	for (i = 0; i < 2; i++) {
+		evs[i] = (struct rte_event){
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[i],
+		};
+	}
+	if (rte_event_enqueue_burst(evdev, t->port[wrk_port], evs, 2) != 2) {
+		printf("%d: Failed to enqueue events\n", __LINE__);
+		goto out;
+	}
+	for (i = 0; i < 10 && nb_evs < 2; i++) {
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+		nb_evs += rte_event_dequeue_burst(evdev, t->port[wrk_port],
+				&evs[nb_evs], 2 - nb_evs, 0);
+	}
+	if (nb_evs != 2) {
+		printf("%d: expected 2 events at worker, got %u\n", __LINE__,
+				nb_evs);
+		goto out;
+	}
+
+	/* fill the rx ring of the worker port in instance 1 */
+	sw = sw_pmd_priv(&rte_eventdevs[evdev]);
+	ring = sw_sched_port(sw, 1, t->port[wrk_port])->rx_worker_ring;
+	memset(filler, 0, sizeof(filler));
+	while (rte_event_ring_enqueue_burst(ring, filler, RTE_DIM(filler),
+			NULL) != 0)
+		;
+
+	for (i = 0; i < 2; i++) {
+		evs[i].op = RTE_EVENT_OP_FORWARD;
+		evs[i].queue_id = t->qid[2];
+	}
+	enq = rte_event_enqueue_burst(evdev, t->port[wrk_port], evs, 2);
+	if (enq == 2) {
+		printf("%d: Forwarded to a full ring\n", __LINE__);
+		goto out;
+	}
+
+	/* once the ring is drained, the remaining events go through and
+	 * complete in the instance they came from
+	 */
+	while (rte_event_ring_dequeue_burst(ring, filler, RTE_DIM(filler),
+			NULL) != 0)
+		;
+	if (rte_event_enqueue_burst(evdev, t->port[wrk_port], &evs[enq],
+			2 - enq) != 2 - enq) {
+		printf("%d: Failed to forward remaining events\n", __LINE__);
+		goto out;
+	}
+
+	nb_evs = 0;
+	for (i = 0; i < 10 && nb_evs < 2; i++) {
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+		nb_evs += rte_event_dequeue_burst(evdev, t->port[tx_port],
+				&evs[nb_evs], 2 - nb_evs, 0);
+	}
+	if (nb_evs != 2) {
+		printf("%d: expected 2 events at tx port, got %u\n", __LINE__,
+				nb_evs);
+		rte_event_dev_dump(evdev, stdout);
+		goto out;
+	}
+
+	if (rte_event_dev_xstats_by_name_get(evdev, "port_0_inflight",
+			&inflight_id) != 0) {
+		printf("%d: worker port still has events inflight\n",
+				__LINE__);
+		rte_event_dev_dump(evdev, stdout);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	if (evdev >= 0)
+		cleanup(t);
+	rte_vdev_uninit(eventdev_name);
+	evdev = saved_evdev;
+	t->service_id = saved_service_id;
+	return ret;
+}
+
 static int
 worker_loopback_worker_fn(void *arg)
 {
@@ -3283,6 +3591,12 @@ test_sw_eventdev(void)
 		printf("ERROR - Invalid QID test FAILED.\n");
 		goto test_fail;
 	}
+	printf("*** Running Multi Sched Invalid QID test...\n");
+	ret = invalid_qid_multi_sched(t);
+	if (ret != 0) {
+		printf("ERROR - Multi Sched Invalid QID test FAILED.\n");
+		goto test_fail;
+	}
 	printf("*** Running Load Balancing History test...\n");
 	ret = load_balancing_history(t);
 	if (ret != 0) {
@@ -3367,6 +3681,18 @@ test_sw_eventdev(void)
 		printf("ERROR - Stop Flush test FAILED.\n");
 		goto test_fail;
 	}
+	printf("*** Running Multi Sched Pipeline test...\n");
+	ret = multi_sched_pipeline(t);
+	if (ret != 0) {
+		printf("ERROR - Multi Sched Pipeline test FAILED.\n");
+		goto test_fail;
+	}
+	printf("*** Running Multi Sched Full Ring test...\n");
+	ret = multi_sched_full_ring(t);
+	if (ret != 0) {
+		printf("ERROR - Multi Sched Full Ring test FAILED.\n");
+		goto test_fail;
+	}
 	if (rte_lcore_count() >= 3) {
 		printf("*** Running Worker loopback test...\n");
 		ret = worker_loopback(t, 0);
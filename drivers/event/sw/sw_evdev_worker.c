@@ -10,6 +10,14 @@
 
 #define PORT_ENQUEUE_MAX_BURST_SIZE 64
 
+/* scheduler instance of the oldest outstanding event of the port */
+static inline uint8_t
+sw_port_deq_sched_pop(struct sw_port *p)
+{
+	return p->deq_sched[p->deq_sched_tail++ &
+			(SW_PORT_DEQ_SCHED_FIFO - 1)];
+}
+
 static inline void
 sw_event_release(struct sw_port *p, uint8_t index)
 {
@@ -18,13 +26,19 @@ sw_event_release(struct sw_port *p, uint8_t index)
 	 * to clear any history before dequeuing more events.
 	 */
 	RTE_SET_USED(index);
+	struct rte_event_ring *ring = p->rx_worker_ring;
+
+	/* the release goes to the instance that scheduled the event */
+	if (p->deq_sched != NULL)
+		ring = sw_sched_port(p->sw, sw_port_deq_sched_pop(p),
+				p->id)->rx_worker_ring;
 
 	/* create drop message */
 	struct rte_event ev;
 	ev.op = sw_qe_flag_map[RTE_EVENT_OP_RELEASE];
 
 	uint16_t free_count;
-	rte_event_ring_enqueue_burst(p->rx_worker_ring, &ev, 1, &free_count);
+	rte_event_ring_enqueue_burst(ring, &ev, 1, &free_count);
 
 	/* each release returns one credit */
 	p->outstanding_releases--;
@@ -49,11 +63,84 @@ enqueue_burst_with_ops(struct rte_event_ring *r, const struct rte_event *events,
 	return rte_event_ring_enqueue_burst(r, tmp_evs, n, NULL);
 }
 
+/*
+ * rte_event ring enqueue for devices with several scheduler instances: each
+ * event goes to the rx ring of the port in instance sched_ids[i]. Runs of
+ * events for the same instance are enqueued together, keeping the order of
+ * the burst within each instance.
+ */
+static inline unsigned int
+enqueue_burst_multi_sched(struct sw_port *p, const struct rte_event *events,
+		unsigned int n, uint8_t *ops, const uint8_t *sched_ids)
+{
+	struct rte_event tmp_evs[PORT_ENQUEUE_MAX_BURST_SIZE];
+	unsigned int i, start, enq = 0;
+
+	memcpy(tmp_evs, events, n * sizeof(events[0]));
+	for (i = 0; i < n; i++)
+		tmp_evs[i].op = ops[i];
+
+	for (start = 0; start < n; start = i) {
+		const uint8_t sched_id = sched_ids[start];
+		struct rte_event_ring *r =
+			sw_sched_port(p->sw, sched_id, p->id)->rx_worker_ring;
+		unsigned int ret;
+
+		for (i = start + 1; i < n && sched_ids[i] == sched_id; i++)
+			;
+
+		ret = rte_event_ring_enqueue_burst(r, &tmp_evs[start],
+				i - start, NULL);
+		enq += ret;
+		if (ret != i - start)
+			break;
+	}
+
+	return enq;
+}
+
+/*
+ * rte_event ring dequeue for devices with several scheduler instances: poll
+ * the cq ring of the port in each instance, starting from a different one on
+ * every call, and record the origin of each event for its release.
+ */
+static inline uint16_t
+dequeue_burst_multi_sched(struct sw_port *p, struct rte_event *ev,
+		uint16_t num)
+{
+	const struct sw_evdev *sw = p->sw;
+	uint8_t sched_id = p->deq_sched_next;
+	uint16_t ndeq = 0;
+	unsigned int i;
+
+	if (++p->deq_sched_next == sw->nb_sched)
+		p->deq_sched_next = 0;
+
+	for (i = 0; i < sw->nb_sched && ndeq < num; i++) {
+		struct rte_event_ring *r =
+			sw_sched_port(sw, sched_id, p->id)->cq_worker_ring;
+		uint16_t n, j;
+
+		n = rte_event_ring_dequeue_burst(r, &ev[ndeq], num - ndeq,
+				NULL);
+		for (j = 0; j < n; j++)
+			p->deq_sched[p->deq_sched_head++ &
+					(SW_PORT_DEQ_SCHED_FIFO - 1)] = sched_id;
+		ndeq += n;
+
+		if (++sched_id == sw->nb_sched)
+			sched_id = 0;
+	}
+
+	return ndeq;
+}
+
 uint16_t
 sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 {
 	int32_t i;
 	uint8_t new_ops[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t sched_ids[PORT_ENQUEUE_MAX_BURST_SIZE];
 	struct sw_port *p = port;
 	struct sw_evdev *sw = (void *)p->sw;
 	uint32_t sw_inflights = rte_atomic32_read(&sw->inflights);
@@ -99,8 +186,16 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		 * correct usage of the API), providing very high correct
 		 * prediction rate.
 		 */
-		if ((new_ops[i] & QE_FLAG_COMPLETE) && outstanding)
+		if ((new_ops[i] & QE_FLAG_COMPLETE) && outstanding) {
 			p->outstanding_releases--;
+			if (p->deq_sched != NULL)
+				sched_ids[i] = sw_port_deq_sched_pop(p);
+		} else if (p->deq_sched != NULL) {
+			/* nothing to complete: straight to the QID owner */
+			new_ops[i] &= ~QE_FLAG_COMPLETE;
+			sched_ids[i] = invalid_qid ? 0 :
+					sw->qids[ev[i].queue_id].sched_id;
+		}
 
 		/* error case: branch to avoid touching p->stats */
 		if (unlikely(invalid_qid && op != RTE_EVENT_OP_RELEASE)) {
@@ -110,8 +205,32 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 	}
 
 	/* returns number of events actually enqueued */
-	uint32_t enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
+	uint32_t enq;
+	if (likely(p->deq_sched == NULL))
+		enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
 					     new_ops);
+	else {
+		enq = enqueue_burst_multi_sched(p, ev, i, new_ops, sched_ids);
+
+		/* the events not enqueued are still outstanding: push their
+		 * instances back and undo their credit accounting, the
+		 * application enqueues them again
+		 */
+		for (i = num - 1; i >= (int32_t)enq; i--) {
+			if (new_ops[i] & QE_FLAG_COMPLETE) {
+				p->deq_sched_tail--;
+				p->outstanding_releases++;
+				p->inflight_credits -=
+					(ev[i].op == RTE_EVENT_OP_RELEASE);
+			}
+			p->inflight_credits += (ev[i].op == RTE_EVENT_OP_NEW);
+			if (unlikely(ev[i].queue_id >= sw->qid_count &&
+					ev[i].op != RTE_EVENT_OP_RELEASE)) {
+				p->stats.rx_dropped--;
+				p->inflight_credits--;
+			}
+		}
+	}
 	if (p->outstanding_releases == 0 && p->last_dequeue_burst_sz != 0) {
 		uint64_t burst_ticks = rte_get_timer_cycles() -
 				p->last_dequeue_ticks;
@@ -162,7 +281,11 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 	}
 
 	/* returns number of events actually dequeued */
-	uint16_t ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	uint16_t ndeq;
+	if (likely(p->deq_sched == NULL))
+		ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	else
+		ndeq = dequeue_burst_multi_sched(p, ev, num);
 	if (unlikely(ndeq == 0)) {
 		p->zero_polls++;
 		p->total_polls++;
@@ -47,35 +47,41 @@ struct sw_xstats_entry {
 };
 
 static uint64_t
-get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
-		enum xstats_type type, int extra_arg __rte_unused)
+get_sched_stat(const struct sw_sched *s, enum xstats_type type)
 {
 	switch (type) {
-	case rx: return sw->stats.rx_pkts;
-	case tx: return sw->stats.tx_pkts;
-	case dropped: return sw->stats.rx_dropped;
-	case calls: return sw->sched_called;
-	case no_iq_enq: return sw->sched_no_iq_enqueues;
-	case no_cq_enq: return sw->sched_no_cq_enqueues;
+	case rx: return s->stats.rx_pkts;
+	case tx: return s->stats.tx_pkts;
+	case dropped: return s->stats.rx_dropped;
+	case calls: return s->sched_called;
+	case no_iq_enq: return s->sched_no_iq_enqueues;
+	case no_cq_enq: return s->sched_no_cq_enqueues;
 	default: return -1;
 	}
 }
 
 static uint64_t
-get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
+get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
 		enum xstats_type type, int extra_arg __rte_unused)
 {
-	const struct sw_port *p = &sw->ports[obj_idx];
+	uint64_t val = 0;
+	unsigned int i;
+
+	/* device stats are the sum over the scheduler instances */
+	for (i = 0; i < sw->nb_sched; i++)
+		val += get_sched_stat(&sw->sched[i], type);
+	return val;
+}
 
+/* stats the scheduler instances keep in their own view of the port */
+static uint64_t
+get_sched_port_stat(const struct sw_port *p, enum xstats_type type)
+{
 	switch (type) {
 	case rx: return p->stats.rx_pkts;
 	case tx: return p->stats.tx_pkts;
 	case dropped: return p->stats.rx_dropped;
 	case inflight: return p->inflights;
-	case pkt_cycles: return p->avg_pkt_ticks;
-	case calls: return p->total_polls;
-	case credits: return p->inflight_credits;
-	case poll_return: return p->zero_polls;
 	case rx_used: return rte_event_ring_count(p->rx_worker_ring);
 	case rx_free: return rte_event_ring_free_count(p->rx_worker_ring);
 	case tx_used: return rte_event_ring_count(p->cq_worker_ring);
@@ -84,6 +90,27 @@ get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 	}
 }
 
+static uint64_t
+get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
+		enum xstats_type type, int extra_arg __rte_unused)
+{
+	const struct sw_port *p = &sw->ports[obj_idx];
+	uint64_t val = 0;
+	unsigned int i;
+
+	switch (type) {
+	case pkt_cycles: return p->avg_pkt_ticks;
+	case calls: return p->total_polls;
+	case credits: return p->inflight_credits;
+	case poll_return: return p->zero_polls;
+	default:
+		for (i = 0; i < sw->nb_sched; i++)
+			val += get_sched_port_stat(
+					sw_sched_port(sw, i, obj_idx), type);
+		return val;
+	}
+}
+
 static uint64_t
 get_port_bucket_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 		enum xstats_type type, int extra_arg)
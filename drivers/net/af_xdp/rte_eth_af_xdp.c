@@ -29,6 +29,7 @@
 #include <rte_config.h>
 #include <rte_dev.h>
 #include <rte_eal.h>
+#include <rte_errno.h>
 #include <rte_ether.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
@@ -68,11 +69,15 @@ static int af_xdp_logtype;
 
 
 struct xsk_umem_info {
-	struct xsk_ring_prod fq;
-	struct xsk_ring_cons cq;
 	struct xsk_umem *umem;
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	/* mempool the umem is built on, NULL for a memzone umem */
+	struct rte_mempool *mb_pool;
+	void *buffer;
+#endif
 	struct rte_ring *buf_ring;
 	const struct rte_memzone *mz;
+	int refcnt;
 	int pmd_zc;
 };
 
@@ -84,6 +89,7 @@ struct rx_stats {
 
 struct pkt_rx_queue {
 	struct xsk_ring_cons rx;
+	struct xsk_ring_prod fq;
 	struct xsk_umem_info *umem;
 	struct xsk_socket *xsk;
 	struct rte_mempool *mb_pool;
@@ -93,6 +99,7 @@ struct pkt_rx_queue {
 	struct pkt_tx_queue *pair;
 	struct pollfd fds[1];
 	int xsk_queue_idx;
+	uint16_t port;
 };
 
 struct tx_stats {
@@ -103,6 +110,7 @@ struct tx_stats {
 
 struct pkt_tx_queue {
 	struct xsk_ring_prod tx;
+	struct xsk_ring_cons cq;
 
 	struct tx_stats stats;
 
@@ -119,6 +127,7 @@ struct pmd_internals {
 	int combined_queue_cnt;
 
 	int pmd_zc;
+	int shared_umem;
 	struct rte_ether_addr eth_addr;
 
 	struct pkt_rx_queue *rx_queues;
@@ -129,12 +138,14 @@ struct pmd_internals {
 #define ETH_AF_XDP_START_QUEUE_ARG		"start_queue"
 #define ETH_AF_XDP_QUEUE_COUNT_ARG		"queue_count"
 #define ETH_AF_XDP_PMD_ZC_ARG			"pmd_zero_copy"
+#define ETH_AF_XDP_SHARED_UMEM_ARG		"shared_umem"
 
 static const char * const valid_arguments[] = {
 	ETH_AF_XDP_IFACE_ARG,
 	ETH_AF_XDP_START_QUEUE_ARG,
 	ETH_AF_XDP_QUEUE_COUNT_ARG,
 	ETH_AF_XDP_PMD_ZC_ARG,
+	ETH_AF_XDP_SHARED_UMEM_ARG,
 	NULL
 };
 
@@ -145,10 +156,43 @@ static const struct rte_eth_link pmd_link = {
 	.link_autoneg = ETH_LINK_AUTONEG
 };
 
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+static inline int
+reserve_fill_queue_zc(struct xsk_umem_info *umem, uint16_t reserve_size,
+		      struct rte_mbuf **bufs, struct xsk_ring_prod *fq)
+{
+	uint32_t idx;
+	uint16_t i;
+
+	if (unlikely(!xsk_ring_prod__reserve(fq, reserve_size, &idx))) {
+		for (i = 0; i < reserve_size; i++)
+			rte_pktmbuf_free(bufs[i]);
+		AF_XDP_LOG(DEBUG, "Failed to reserve enough fq descs.\n");
+		return -1;
+	}
+
+	for (i = 0; i < reserve_size; i++) {
+		__u64 *fq_addr;
+		uint64_t addr;
+
+		fq_addr = xsk_ring_prod__fill_addr(fq, idx++);
+		/* umem frame is the whole mempool object */
+		addr = (uint64_t)bufs[i] - (uint64_t)umem->buffer -
+				umem->mb_pool->header_size;
+		*fq_addr = addr;
+	}
+
+	xsk_ring_prod__submit(fq, reserve_size);
+
+	return 0;
+}
+#endif
+
 static inline int
-reserve_fill_queue(struct xsk_umem_info *umem, uint16_t reserve_size)
+reserve_fill_queue_cp(struct xsk_umem_info *umem, uint16_t reserve_size,
+		      struct rte_mbuf **bufs __rte_unused,
+		      struct xsk_ring_prod *fq)
 {
-	struct xsk_ring_prod *fq = &umem->fq;
 	void *addrs[reserve_size];
 	uint32_t idx;
 	uint16_t i;
@@ -178,6 +222,87 @@ reserve_fill_queue(struct xsk_umem_info *umem, uint16_t reserve_size)
 	return 0;
 }
 
+static inline int
+reserve_fill_queue(struct xsk_umem_info *umem, uint16_t reserve_size,
+		   struct rte_mbuf **bufs, struct xsk_ring_prod *fq)
+{
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	if (umem->mb_pool != NULL)
+		return reserve_fill_queue_zc(umem, reserve_size, bufs, fq);
+#endif
+	return reserve_fill_queue_cp(umem, reserve_size, bufs, fq);
+}
+
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+static uint16_t
+af_xdp_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pkt_rx_queue *rxq = queue;
+	struct xsk_ring_cons *rx = &rxq->rx;
+	struct xsk_ring_prod *fq = &rxq->fq;
+	struct xsk_umem_info *umem = rxq->umem;
+	struct rte_mempool *mp = umem->mb_pool;
+	struct rte_mbuf *fq_bufs[ETH_AF_XDP_RX_BATCH_SIZE];
+	uint32_t idx_rx = 0;
+	unsigned long rx_bytes = 0;
+	int rcvd, i;
+
+	/* allocate bufs for fill queue replenishment after rx */
+	if (unlikely(rte_pktmbuf_alloc_bulk(mp, fq_bufs, nb_pkts) != 0)) {
+		AF_XDP_LOG(DEBUG, "Failed to get enough buffers for fq.\n");
+		return 0;
+	}
+
+	rcvd = xsk_ring_cons__peek(rx, nb_pkts, &idx_rx);
+	if (rcvd == 0) {
+#if defined(XDP_USE_NEED_WAKEUP)
+		if (xsk_ring_prod__needs_wakeup(fq))
+			(void)poll(rxq->fds, 1, 1000);
+#endif
+
+		goto out;
+	}
+
+	for (i = 0; i < rcvd; i++) {
+		const struct xdp_desc *desc;
+		uint64_t addr;
+		uint64_t offset;
+		uint32_t len;
+
+		desc = xsk_ring_cons__rx_desc(rx, idx_rx++);
+		len = desc->len;
+		offset = xsk_umem__extract_offset(desc->addr);
+		addr = xsk_umem__extract_addr(desc->addr);
+
+		/* the frame received into is an mbuf of the pool */
+		bufs[i] = (struct rte_mbuf *)xsk_umem__get_data(umem->buffer,
+				addr + mp->header_size);
+		bufs[i]->data_off = offset - sizeof(struct rte_mbuf) -
+			rte_pktmbuf_priv_size(mp) - mp->header_size;
+
+		bufs[i]->port = rxq->port;
+		rte_pktmbuf_pkt_len(bufs[i]) = len;
+		rte_pktmbuf_data_len(bufs[i]) = len;
+		rx_bytes += len;
+	}
+
+	xsk_ring_cons__release(rx, rcvd);
+
+	(void)reserve_fill_queue(umem, rcvd, fq_bufs, fq);
+
+	/* statistics */
+	rxq->stats.rx_pkts += rcvd;
+	rxq->stats.rx_bytes += rx_bytes;
+
+out:
+	if (rcvd != nb_pkts)
+		rte_mempool_put_bulk(mp, (void **)&fq_bufs[rcvd],
+				     nb_pkts - rcvd);
+
+	return rcvd;
+}
+#endif
+
 static void
 umem_buf_release_to_fq(void *addr, void *opaque)
 {
@@ -188,12 +313,12 @@ umem_buf_release_to_fq(void *addr, void *opaque)
 }
 
 static uint16_t
-eth_af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+af_xdp_rx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct pkt_rx_queue *rxq = queue;
 	struct xsk_ring_cons *rx = &rxq->rx;
 	struct xsk_umem_info *umem = rxq->umem;
-	struct xsk_ring_prod *fq = &umem->fq;
+	struct xsk_ring_prod *fq = &rxq->fq;
 	uint32_t idx_rx = 0;
 	uint32_t free_thresh = fq->size >> 1;
 	int pmd_zc = umem->pmd_zc;
@@ -202,8 +327,6 @@ eth_af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	unsigned long rx_bytes = 0;
 	int rcvd, i;
 
-	nb_pkts = RTE_MIN(nb_pkts, ETH_AF_XDP_RX_BATCH_SIZE);
-
 	if (unlikely(rte_pktmbuf_alloc_bulk(rxq->mb_pool, mbufs, nb_pkts) != 0))
 		return 0;
 
@@ -218,7 +341,8 @@ eth_af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	}
 
 	if (xsk_prod_nb_free(fq, free_thresh) >= free_thresh)
-		(void)reserve_fill_queue(umem, ETH_AF_XDP_RX_BATCH_SIZE);
+		(void)reserve_fill_queue(umem, ETH_AF_XDP_RX_BATCH_SIZE,
+					 NULL, fq);
 
 	for (i = 0; i < rcvd; i++) {
 		const struct xdp_desc *desc;
@@ -244,6 +368,7 @@ eth_af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 							pkt, len);
 			rte_ring_enqueue(umem->buf_ring, (void *)addr);
 		}
+		mbufs[i]->port = rxq->port;
 		rte_pktmbuf_pkt_len(mbufs[i]) = len;
 		rte_pktmbuf_data_len(mbufs[i]) = len;
 		rx_bytes += len;
@@ -264,10 +389,21 @@ eth_af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return rcvd;
 }
 
+static uint16_t
+eth_af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	nb_pkts = RTE_MIN(nb_pkts, ETH_AF_XDP_RX_BATCH_SIZE);
+
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	if (((struct pkt_rx_queue *)queue)->umem->mb_pool != NULL)
+		return af_xdp_rx_zc(queue, bufs, nb_pkts);
+#endif
+	return af_xdp_rx_cp(queue, bufs, nb_pkts);
+}
+
 static void
-pull_umem_cq(struct xsk_umem_info *umem, int size)
+pull_umem_cq(struct xsk_umem_info *umem, int size, struct xsk_ring_cons *cq)
 {
-	struct xsk_ring_cons *cq = &umem->cq;
 	size_t i, n;
 	uint32_t idx_cq = 0;
 
@@ -276,6 +412,15 @@ pull_umem_cq(struct xsk_umem_info *umem, int size)
 	for (i = 0; i < n; i++) {
 		uint64_t addr;
 		addr = *xsk_ring_cons__comp_addr(cq, idx_cq++);
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+		if (umem->mb_pool != NULL) {
+			addr = xsk_umem__extract_addr(addr);
+			rte_pktmbuf_free((struct rte_mbuf *)
+					 xsk_umem__get_data(umem->buffer,
+					addr + umem->mb_pool->header_size));
+			continue;
+		}
+#endif
 		rte_ring_enqueue(umem->buf_ring, (void *)addr);
 	}
 
@@ -283,7 +428,7 @@ pull_umem_cq(struct xsk_umem_info *umem, int size)
 }
 
 static void
-kick_tx(struct pkt_tx_queue *txq)
+kick_tx(struct pkt_tx_queue *txq, struct xsk_ring_cons *cq)
 {
 	struct xsk_umem_info *umem = txq->pair->umem;
 
@@ -298,11 +443,101 @@ kick_tx(struct pkt_tx_queue *txq)
 
 			/* pull from completion queue to leave more space */
 			if (errno == EAGAIN)
-				pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE);
+				pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE,
+					     cq);
 		}
-	pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE);
+	pull_umem_cq(umem, ETH_AF_XDP_TX_BATCH_SIZE, cq);
 }
 
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+/* Point a Tx descriptor at the data of an mbuf of the umem pool. */
+static inline void
+af_xdp_tx_desc_set(struct xsk_umem_info *umem, struct xdp_desc *desc,
+		   struct rte_mbuf *mbuf, uint32_t len)
+{
+	uint64_t addr, offset;
+
+	addr = (uint64_t)mbuf - (uint64_t)umem->buffer -
+			umem->mb_pool->header_size;
+	offset = rte_pktmbuf_mtod(mbuf, uint64_t) - (uint64_t)mbuf +
+			umem->mb_pool->header_size;
+	desc->addr = addr | (offset << XSK_UNALIGNED_BUF_OFFSET_SHIFT);
+	desc->len = len;
+}
+
+static uint16_t
+af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pkt_tx_queue *txq = queue;
+	struct xsk_umem_info *umem = txq->pair->umem;
+	struct xsk_ring_cons *cq = &txq->cq;
+	struct rte_mbuf *mbuf, *local_mbuf;
+	unsigned long tx_bytes = 0;
+	uint32_t free_thresh = cq->size >> 1;
+	uint32_t idx_tx;
+	uint32_t len;
+	uint16_t count = 0;
+	struct xdp_desc *desc;
+	const void *data;
+	void *pkt;
+	int i;
+
+	if (xsk_cons_nb_avail(cq, free_thresh) >= free_thresh)
+		pull_umem_cq(umem, XSK_RING_CONS__DEFAULT_NUM_DESCS, cq);
+
+	for (i = 0; i < nb_pkts; i++) {
+		mbuf = bufs[i];
+		len = mbuf->pkt_len;
+
+		if (mbuf->pool == umem->mb_pool && RTE_MBUF_DIRECT(mbuf) &&
+		    rte_pktmbuf_is_contiguous(mbuf)) {
+			/* mbuf is a umem frame, freed on completion */
+			local_mbuf = mbuf;
+		} else {
+			local_mbuf = rte_pktmbuf_alloc(umem->mb_pool);
+			if (local_mbuf == NULL)
+				break;
+			if (len > rte_pktmbuf_tailroom(local_mbuf)) {
+				rte_pktmbuf_free(local_mbuf);
+				rte_pktmbuf_free(mbuf);
+				txq->stats.err_pkts++;
+				continue;
+			}
+			pkt = rte_pktmbuf_mtod(local_mbuf, void *);
+			data = rte_pktmbuf_read(mbuf, 0, len, pkt);
+			if (data != pkt)
+				rte_memcpy(pkt, data, len);
+		}
+
+		if (!xsk_ring_prod__reserve(&txq->tx, 1, &idx_tx)) {
+			kick_tx(txq, cq);
+			if (!xsk_ring_prod__reserve(&txq->tx, 1, &idx_tx)) {
+				if (local_mbuf != mbuf)
+					rte_pktmbuf_free(local_mbuf);
+				break;
+			}
+		}
+
+		desc = xsk_ring_prod__tx_desc(&txq->tx, idx_tx);
+		af_xdp_tx_desc_set(umem, desc, local_mbuf, len);
+		if (local_mbuf != mbuf)
+			rte_pktmbuf_free(mbuf);
+
+		count++;
+		tx_bytes += len;
+	}
+
+	xsk_ring_prod__submit(&txq->tx, count);
+
+	kick_tx(txq, cq);
+
+	txq->stats.tx_pkts += count;
+	txq->stats.tx_bytes += tx_bytes;
+
+	return i;
+}
+#endif
+
 static inline bool
 in_umem_range(struct xsk_umem_info *umem, uint64_t addr)
 {
@@ -312,10 +547,11 @@ in_umem_range(struct xsk_umem_info *umem, uint64_t addr)
 }
 
 static uint16_t
-eth_af_xdp_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+af_xdp_tx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct pkt_tx_queue *txq = queue;
 	struct xsk_umem_info *umem = txq->pair->umem;
+	struct xsk_ring_cons *cq = &txq->cq;
 	struct rte_mbuf *mbuf;
 	int pmd_zc = umem->pmd_zc;
 	void *addrs[ETH_AF_XDP_TX_BATCH_SIZE];
@@ -323,9 +559,7 @@ eth_af_xdp_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	int i;
 	uint32_t idx_tx;
 
-	nb_pkts = RTE_MIN(nb_pkts, ETH_AF_XDP_TX_BATCH_SIZE);
-
-	pull_umem_cq(umem, nb_pkts);
+	pull_umem_cq(umem, nb_pkts, cq);
 
 	nb_pkts = rte_ring_dequeue_bulk(umem->buf_ring, addrs,
 					nb_pkts, NULL);
@@ -333,7 +567,7 @@ eth_af_xdp_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		return 0;
 
 	if (xsk_ring_prod__reserve(&txq->tx, nb_pkts, &idx_tx) != nb_pkts) {
-		kick_tx(txq);
+		kick_tx(txq, cq);
 		rte_ring_enqueue_bulk(umem->buf_ring, addrs, nb_pkts, NULL);
 		return 0;
 	}
@@ -368,7 +602,7 @@ eth_af_xdp_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	xsk_ring_prod__submit(&txq->tx, nb_pkts);
 
-	kick_tx(txq);
+	kick_tx(txq, cq);
 
 	txq->stats.tx_pkts += nb_pkts;
 	txq->stats.tx_bytes += tx_bytes;
@@ -379,6 +613,20 @@ eth_af_xdp_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return nb_pkts;
 }
 
+static uint16_t
+eth_af_xdp_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	struct pkt_tx_queue *txq = queue;
+
+	if (txq->pair->umem->mb_pool != NULL)
+		return af_xdp_tx_zc(queue, bufs, nb_pkts);
+#endif
+	nb_pkts = RTE_MIN(nb_pkts, ETH_AF_XDP_TX_BATCH_SIZE);
+
+	return af_xdp_tx_cp(queue, bufs, nb_pkts);
+}
+
 static int
 eth_dev_start(struct rte_eth_dev *dev)
 {
@@ -494,7 +742,8 @@ remove_xdp_program(struct pmd_internals *internals)
 static void
 xdp_umem_destroy(struct xsk_umem_info *umem)
 {
-	rte_memzone_free(umem->mz);
+	if (umem->mz != NULL)
+		rte_memzone_free(umem->mz);
 	umem->mz = NULL;
 
 	rte_ring_free(umem->buf_ring);
@@ -519,8 +768,11 @@ eth_dev_close(struct rte_eth_dev *dev)
 		if (rxq->umem == NULL)
 			break;
 		xsk_socket__delete(rxq->xsk);
-		(void)xsk_umem__delete(rxq->umem->umem);
-		xdp_umem_destroy(rxq->umem);
+		/* shared umem goes away with its last socket */
+		if (--rxq->umem->refcnt == 0) {
+			(void)xsk_umem__delete(rxq->umem->umem);
+			xdp_umem_destroy(rxq->umem);
+		}
 
 		/* free pkt_tx_queue */
 		rte_free(rxq->pair);
@@ -548,9 +800,119 @@ eth_link_update(struct rte_eth_dev *dev __rte_unused,
 	return 0;
 }
 
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+static inline uintptr_t
+get_base_addr(struct rte_mempool *mp, uint64_t *align)
+{
+	struct rte_mempool_memhdr *memhdr;
+	uintptr_t memhdr_addr, aligned_addr;
+
+	memhdr = STAILQ_FIRST(&mp->mem_list);
+	memhdr_addr = (uintptr_t)memhdr->addr;
+	aligned_addr = memhdr_addr & ~(getpagesize() - 1);
+	*align = memhdr_addr - aligned_addr;
+
+	return aligned_addr;
+}
+
+/* Look for a umem of this port already built on the same mempool. */
+static struct xsk_umem_info *
+xdp_umem_lookup(struct pmd_internals *internals, struct rte_mempool *mb_pool)
+{
+	struct xsk_umem_info *umem;
+	int i;
+
+	for (i = 0; i < internals->queue_cnt; i++) {
+		umem = internals->rx_queues[i].umem;
+		if (umem != NULL && umem->mb_pool == mb_pool)
+			return umem;
+	}
+
+	return NULL;
+}
+
+/*
+ * Build the umem on the memory of the Rx mempool. On failure, rte_errno is
+ * EINVAL when the mempool cannot be used as umem by this kernel.
+ */
 static struct
-xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
-				  struct pkt_rx_queue *rxq)
+xsk_umem_info *xdp_umem_configure_zc(struct pmd_internals *internals,
+				     struct pkt_rx_queue *rxq)
+{
+	struct xsk_umem_info *umem;
+	struct xsk_umem_config usr_config = {
+		.fill_size = ETH_AF_XDP_DFLT_NUM_DESCS,
+		.comp_size = ETH_AF_XDP_DFLT_NUM_DESCS,
+		.flags = XDP_UMEM_UNALIGNED_CHUNK_FLAG};
+	struct rte_mempool *mb_pool = rxq->mb_pool;
+	struct rte_mempool_memhdr *memhdr;
+	void *base_addr = NULL;
+	uint64_t align = 0;
+	int ret;
+
+	if (internals->shared_umem) {
+		umem = xdp_umem_lookup(internals, mb_pool);
+		if (umem != NULL) {
+			umem->refcnt++;
+			AF_XDP_LOG(INFO, "Sharing umem of mempool %s\n",
+				   mb_pool->name);
+			return umem;
+		}
+	}
+
+	/* umem must be a single virtually contiguous area */
+	if (mb_pool->nb_mem_chunks != 1) {
+		AF_XDP_LOG(INFO, "Mempool %s has more than one memory chunk\n",
+			   mb_pool->name);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* each mempool object (header, mbuf, data) is one umem frame */
+	usr_config.frame_size = rte_mempool_calc_obj_size(mb_pool->elt_size,
+							  mb_pool->flags,
+							  NULL);
+	usr_config.frame_headroom = mb_pool->header_size +
+					sizeof(struct rte_mbuf) +
+					rte_pktmbuf_priv_size(mb_pool) +
+					RTE_PKTMBUF_HEADROOM;
+
+	umem = rte_zmalloc_socket("umem", sizeof(*umem), 0, rte_socket_id());
+	if (umem == NULL) {
+		AF_XDP_LOG(ERR, "Failed to allocate umem info");
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	umem->mb_pool = mb_pool;
+	memhdr = STAILQ_FIRST(&mb_pool->mem_list);
+	base_addr = (void *)get_base_addr(mb_pool, &align);
+
+	/* kernels before v5.4 reject the unaligned chunk flag */
+	ret = xsk_umem__create(&umem->umem, base_addr, memhdr->len + align,
+			       &rxq->fq, &rxq->pair->cq,
+			       &usr_config);
+
+	if (ret) {
+		AF_XDP_LOG(INFO, "Failed to create umem on mempool %s\n",
+			   mb_pool->name);
+		rte_errno = -ret;
+		goto err;
+	}
+	umem->buffer = base_addr;
+	umem->refcnt = 1;
+
+	return umem;
+
+err:
+	xdp_umem_destroy(umem);
+	return NULL;
+}
+#endif
+
+static struct
+xsk_umem_info *xdp_umem_configure_cp(struct pmd_internals *internals,
+				     struct pkt_rx_queue *rxq)
 {
 	struct xsk_umem_info *umem;
 	const struct rte_memzone *mz;
@@ -599,7 +961,7 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 
 	ret = xsk_umem__create(&umem->umem, mz->addr,
 			       ETH_AF_XDP_NUM_BUFFERS * ETH_AF_XDP_FRAME_SIZE,
-			       &umem->fq, &umem->cq,
+			       &rxq->fq, &rxq->pair->cq,
 			       &usr_config);
 
 	if (ret) {
@@ -607,6 +969,7 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 		goto err;
 	}
 	umem->mz = mz;
+	umem->refcnt = 1;
 
 	return umem;
 
@@ -615,6 +978,22 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 	return NULL;
 }
 
+static struct
+xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
+				  struct pkt_rx_queue *rxq)
+{
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	struct xsk_umem_info *umem;
+
+	umem = xdp_umem_configure_zc(internals, rxq);
+	if (umem != NULL || rte_errno != EINVAL)
+		return umem;
+
+	AF_XDP_LOG(INFO, "Falling back to a copy mode umem\n");
+#endif
+	return xdp_umem_configure_cp(internals, rxq);
+}
+
 static int
 xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 	      int ring_size)
@@ -622,7 +1001,8 @@ xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 	struct xsk_socket_config cfg;
 	struct pkt_tx_queue *txq = rxq->pair;
 	int ret = 0;
-	int reserve_size;
+	int reserve_size = ETH_AF_XDP_DFLT_NUM_DESCS / 2;
+	struct rte_mbuf *fq_bufs[reserve_size];
 
 	rxq->umem = xdp_umem_configure(internals, rxq);
 	if (rxq->umem == NULL)
@@ -638,16 +1018,32 @@ xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 	cfg.bind_flags |= XDP_USE_NEED_WAKEUP;
 #endif
 
-	ret = xsk_socket__create(&rxq->xsk, internals->if_name,
-			rxq->xsk_queue_idx, rxq->umem->umem, &rxq->rx,
-			&txq->tx, &cfg);
+#if defined(RTE_LIBRTE_AF_XDP_PMD_SHARED_UMEM)
+	/* sockets after the first get their own fill/completion rings */
+	if (rxq->umem->refcnt > 1)
+		ret = xsk_socket__create_shared(&rxq->xsk, internals->if_name,
+				rxq->xsk_queue_idx, rxq->umem->umem, &rxq->rx,
+				&txq->tx, &rxq->fq, &txq->cq, &cfg);
+	else
+#endif
+		ret = xsk_socket__create(&rxq->xsk, internals->if_name,
+				rxq->xsk_queue_idx, rxq->umem->umem, &rxq->rx,
+				&txq->tx, &cfg);
 	if (ret) {
 		AF_XDP_LOG(ERR, "Failed to create xsk socket.\n");
 		goto err;
 	}
 
-	reserve_size = ETH_AF_XDP_DFLT_NUM_DESCS / 2;
-	ret = reserve_fill_queue(rxq->umem, reserve_size);
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	if (rxq->umem->mb_pool != NULL &&
+	    rte_pktmbuf_alloc_bulk(rxq->umem->mb_pool, fq_bufs, reserve_size)) {
+		AF_XDP_LOG(DEBUG, "Failed to get enough buffers for fq.\n");
+		xsk_socket__delete(rxq->xsk);
+		ret = -ENOMEM;
+		goto err;
+	}
+#endif
+	ret = reserve_fill_queue(rxq->umem, reserve_size, fq_bufs, &rxq->fq);
 	if (ret) {
 		xsk_socket__delete(rxq->xsk);
 		AF_XDP_LOG(ERR, "Failed to reserve fill queue.\n");
@@ -657,7 +1053,11 @@ xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 	return 0;
 
 err:
-	xdp_umem_destroy(rxq->umem);
+	if (--rxq->umem->refcnt == 0) {
+		(void)xsk_umem__delete(rxq->umem->umem);
+		xdp_umem_destroy(rxq->umem);
+	}
+	rxq->umem = NULL;
 
 	return ret;
 }
@@ -692,6 +1092,7 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	}
 
 	rxq->mb_pool = mb_pool;
+	rxq->port = dev->data->port_id;
 
 	if (xsk_configure(internals, rxq, nb_rx_desc)) {
 		AF_XDP_LOG(ERR, "Failed to configure xdp socket\n");
@@ -875,7 +1276,7 @@ xdp_get_channels_info(const char *if_name, int *max_queues,
 
 static int
 parse_parameters(struct rte_kvargs *kvlist, char *if_name, int *start_queue,
-			int *queue_cnt, int *pmd_zc)
+			int *queue_cnt, int *pmd_zc, int *shared_umem)
 {
 	int ret;
 
@@ -901,6 +1302,19 @@ parse_parameters(struct rte_kvargs *kvlist, char *if_name, int *start_queue,
 	if (ret < 0)
 		goto free_kvlist;
 
+	ret = rte_kvargs_process(kvlist, ETH_AF_XDP_SHARED_UMEM_ARG,
+				 &parse_integer_arg, shared_umem);
+	if (ret < 0)
+		goto free_kvlist;
+
+#if !defined(RTE_LIBRTE_AF_XDP_PMD_SHARED_UMEM)
+	if (*shared_umem) {
+		AF_XDP_LOG(ERR, "Shared umem is not supported by libbpf.\n");
+		ret = -ENOTSUP;
+		goto free_kvlist;
+	}
+#endif
+
 free_kvlist:
 	rte_kvargs_free(kvlist);
 	return ret;
@@ -938,7 +1352,8 @@ get_iface_info(const char *if_name,
 
 static struct rte_eth_dev *
 init_internals(struct rte_vdev_device *dev, const char *if_name,
-			int start_queue_idx, int queue_cnt, int pmd_zc)
+			int start_queue_idx, int queue_cnt, int pmd_zc,
+			int shared_umem)
 {
 	const char *name = rte_vdev_device_name(dev);
 	const unsigned int numa_node = dev->device.numa_node;
@@ -954,6 +1369,7 @@ init_internals(struct rte_vdev_device *dev, const char *if_name,
 	internals->start_queue_idx = start_queue_idx;
 	internals->queue_cnt = queue_cnt;
 	internals->pmd_zc = pmd_zc;
+	internals->shared_umem = shared_umem;
 	strlcpy(internals->if_name, if_name, IFNAMSIZ);
 
 	if (xdp_get_channels_info(if_name, &internals->max_queue_cnt,
@@ -1033,6 +1449,7 @@ rte_pmd_af_xdp_probe(struct rte_vdev_device *dev)
 	struct rte_eth_dev *eth_dev = NULL;
 	const char *name;
 	int pmd_zc = 0;
+	int shared_umem = 0;
 
 	AF_XDP_LOG(INFO, "Initializing pmd_af_xdp for %s\n",
 		rte_vdev_device_name(dev));
@@ -1060,7 +1477,7 @@ rte_pmd_af_xdp_probe(struct rte_vdev_device *dev)
 		dev->device.numa_node = rte_socket_id();
 
 	if (parse_parameters(kvlist, if_name, &xsk_start_queue_idx,
-			     &xsk_queue_cnt, &pmd_zc) < 0) {
+			     &xsk_queue_cnt, &pmd_zc, &shared_umem) < 0) {
 		AF_XDP_LOG(ERR, "Invalid kvargs value\n");
 		return -EINVAL;
 	}
@@ -1071,7 +1488,7 @@ rte_pmd_af_xdp_probe(struct rte_vdev_device *dev)
 	}
 
 	eth_dev = init_internals(dev, if_name, xsk_start_queue_idx,
-					xsk_queue_cnt, pmd_zc);
+					xsk_queue_cnt, pmd_zc, shared_umem);
 	if (eth_dev == NULL) {
 		AF_XDP_LOG(ERR, "Failed to init internals\n");
 		return -1;
@@ -1115,7 +1532,8 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_xdp,
 			      "iface=<string> "
 			      "start_queue=<int> "
 			      "queue_count=<int> "
-			      "pmd_zero_copy=<0|1>");
+			      "pmd_zero_copy=<0|1> "
+			      "shared_umem=<0|1>");
 
 RTE_INIT(af_xdp_init_log)
 {
@@ -596,6 +596,9 @@ memif_disconnect(struct rte_eth_dev *dev)
 			close(mq->intr_handle.fd);
 			mq->intr_handle.fd = -1;
 		}
+		/* release mbufs held by zero-copy rings */
+		if (rte_eal_process_type() == RTE_PROC_PRIMARY)
+			memif_free_queue_buffers(mq);
 	}
 	for (i = 0; i < pmd->cfg.num_m2s_rings; i++) {
 		if (pmd->role == MEMIF_ROLE_MASTER) {
@@ -613,6 +616,9 @@ memif_disconnect(struct rte_eth_dev *dev)
 			close(mq->intr_handle.fd);
 			mq->intr_handle.fd = -1;
 		}
+		/* release mbufs held by zero-copy rings */
+		if (rte_eal_process_type() == RTE_PROC_PRIMARY)
+			memif_free_queue_buffers(mq);
 	}
 
 	memif_free_regions(proc_private);
@@ -61,6 +61,8 @@ struct mp_region_msg {
 	char port_name[RTE_DEV_NAME_MAX_LEN];
 	memif_region_index_t idx;
 	memif_region_size_t size;
+	uint8_t is_external;	/**< zero-copy region in DPDK memory */
+	void *addr;		/**< address of external region */
 };
 
 static int
@@ -89,8 +91,18 @@ memif_mp_send_region(const struct rte_mp_msg *msg, const void *peer)
 	reply_param->idx = msg_param->idx;
 	if (proc_private->regions[msg_param->idx] != NULL) {
 		reply_param->size = proc_private->regions[msg_param->idx]->region_size;
-		reply.fds[0] = proc_private->regions[msg_param->idx]->fd;
-		reply.num_fds = 1;
+		/*
+		 * DPDK memory is mapped at the same address in every process,
+		 * so external regions are shared by address, not by fd.
+		 */
+		if (proc_private->regions[msg_param->idx]->is_external) {
+			reply_param->is_external = 1;
+			reply_param->addr =
+				proc_private->regions[msg_param->idx]->addr;
+		} else {
+			reply.fds[0] = proc_private->regions[msg_param->idx]->fd;
+			reply.num_fds = 1;
+		}
 	}
 	reply.len_param = sizeof(*reply_param);
 	if (rte_mp_reply(&reply, peer) < 0) {
@@ -147,13 +159,19 @@ memif_mp_request_regions(struct rte_eth_dev *dev)
 				return -ENOMEM;
 			}
 			r->region_size = reply_param->size;
-			if (reply->num_fds < 1) {
-				MIF_LOG(ERR, "Missing file descriptor.");
-				free(reply);
-				return -1;
+			if (reply_param->is_external) {
+				r->is_external = 1;
+				r->fd = -1;
+				r->addr = reply_param->addr;
+			} else {
+				if (reply->num_fds < 1) {
+					MIF_LOG(ERR, "Missing file descriptor.");
+					free(reply);
+					return -1;
+				}
+				r->fd = reply->fds[0];
+				r->addr = NULL;
 			}
-			r->fd = reply->fds[0];
-			r->addr = NULL;
 
 			proc_private->regions[reply_param->idx] = r;
 			proc_private->regions_num++;
@@ -484,6 +502,279 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return n_tx_pkts;
 }
 
+/*
+ * Find the zero-copy region holding [addr, addr + len). Region 0 holds
+ * the rings only, buffer regions start at index 1.
+ */
+static inline int
+memif_region_lookup(struct pmd_process_private *proc_private,
+		    struct memif_queue *mq, const void *addr, uint32_t len)
+{
+	struct memif_region *r;
+	int i;
+
+	r = proc_private->regions[mq->last_region];
+	if (likely(mq->last_region > 0 && r != NULL &&
+		   (const uint8_t *)addr >= (uint8_t *)r->addr &&
+		   (const uint8_t *)addr + len <=
+		   (uint8_t *)r->addr + r->region_size))
+		return mq->last_region;
+
+	for (i = 1; i < proc_private->regions_num; i++) {
+		r = proc_private->regions[i];
+		if ((const uint8_t *)addr >= (uint8_t *)r->addr &&
+		    (const uint8_t *)addr + len <=
+		    (uint8_t *)r->addr + r->region_size) {
+			mq->last_region = i;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static uint16_t
+eth_memif_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct memif_queue *mq = queue;
+	struct pmd_internals *pmd = rte_eth_devices[mq->in_port].data->dev_private;
+	struct pmd_process_private *proc_private =
+		rte_eth_devices[mq->in_port].process_private;
+	memif_ring_t *ring = memif_get_ring_from_queue(proc_private, mq);
+	uint16_t cur_slot, last_slot, n_slots, ring_size, mask, s0, head;
+	uint16_t n_rx_pkts = 0;
+	uint16_t n, i;
+	memif_desc_t *d0;
+	struct rte_mbuf *mbuf, *mbuf_head, *mbuf_tail;
+	uint64_t b;
+	ssize_t size __rte_unused;
+	int ri;
+	struct rte_eth_link link;
+
+	if (unlikely((pmd->flags & ETH_MEMIF_FLAG_CONNECTED) == 0))
+		return 0;
+	if (unlikely(ring == NULL)) {
+		/* Secondary process will attempt to request regions. */
+		rte_eth_link_get(mq->in_port, &link);
+		return 0;
+	}
+
+	/* consume interrupt */
+	if ((ring->flags & MEMIF_RING_FLAG_MASK_INT) == 0)
+		size = read(mq->intr_handle.fd, &b, sizeof(b));
+
+	ring_size = 1 << mq->log2_ring_size;
+	mask = ring_size - 1;
+
+	/* slave receives on M2S ring, descriptors point to our own mbufs */
+	cur_slot = mq->last_tail;
+	last_slot = ring->tail;
+	if (cur_slot == last_slot)
+		goto refill;
+	n_slots = last_slot - cur_slot;
+
+	while (n_slots && n_rx_pkts < nb_pkts) {
+		/* wait for the rest of the chain if it is not complete yet */
+		for (n = 0; n < n_slots; n++)
+			if ((ring->desc[(cur_slot + n) & mask].flags &
+			     MEMIF_DESC_FLAG_NEXT) == 0)
+				break;
+		if (unlikely(n == n_slots))
+			break;
+
+		s0 = cur_slot & mask;
+		d0 = &ring->desc[s0];
+		mbuf_head = mq->buffers[s0];
+		mq->buffers[s0] = NULL;
+		mbuf = mbuf_head;
+		mbuf->port = mq->in_port;
+		rte_pktmbuf_data_len(mbuf) = d0->length;
+		rte_pktmbuf_pkt_len(mbuf) = d0->length;
+		cur_slot++;
+		n_slots--;
+
+		while (d0->flags & MEMIF_DESC_FLAG_NEXT) {
+			s0 = cur_slot & mask;
+			d0 = &ring->desc[s0];
+			mbuf_tail = mbuf;
+			mbuf = mq->buffers[s0];
+			mq->buffers[s0] = NULL;
+			rte_pktmbuf_data_len(mbuf) = d0->length;
+			mbuf_tail->next = mbuf;
+			mbuf_head->nb_segs++;
+			rte_pktmbuf_pkt_len(mbuf_head) += d0->length;
+			cur_slot++;
+			n_slots--;
+		}
+
+		mq->n_bytes += rte_pktmbuf_pkt_len(mbuf_head);
+		*bufs++ = mbuf_head;
+		n_rx_pkts++;
+	}
+
+	mq->last_tail = cur_slot;
+
+refill:
+	head = ring->head;
+	n_slots = ring_size - head + mq->last_tail;
+
+	while (n_slots) {
+		/* allocate up to the end of the buffer array */
+		s0 = head & mask;
+		n = RTE_MIN(n_slots, (uint16_t)(ring_size - s0));
+		if (unlikely(rte_pktmbuf_alloc_bulk(mq->mempool,
+						    &mq->buffers[s0], n) < 0))
+			break;
+
+		for (i = 0; i < n; i++) {
+			mbuf = mq->buffers[s0 + i];
+			ri = memif_region_lookup(proc_private, mq,
+					rte_pktmbuf_mtod(mbuf, void *),
+					rte_pktmbuf_tailroom(mbuf));
+			if (unlikely(ri < 0)) {
+				/* mempool is not in shared memory */
+				for (; i < n; i++) {
+					rte_pktmbuf_free(mq->buffers[s0 + i]);
+					mq->buffers[s0 + i] = NULL;
+				}
+				n_slots = 0;
+				break;
+			}
+			d0 = &ring->desc[s0 + i];
+			d0->region = ri;
+			d0->offset = rte_pktmbuf_mtod(mbuf, uint8_t *) -
+				(uint8_t *)proc_private->regions[ri]->addr;
+			d0->length = rte_pktmbuf_tailroom(mbuf);
+			d0->flags = 0;
+			head++;
+			n_slots--;
+		}
+	}
+	rte_mb();
+	ring->head = head;
+
+	mq->n_pkts += n_rx_pkts;
+	return n_rx_pkts;
+}
+
+static uint16_t
+eth_memif_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct memif_queue *mq = queue;
+	struct pmd_internals *pmd = rte_eth_devices[mq->in_port].data->dev_private;
+	struct pmd_process_private *proc_private =
+		rte_eth_devices[mq->in_port].process_private;
+	memif_ring_t *ring = memif_get_ring_from_queue(proc_private, mq);
+	uint16_t slot, saved_slot, tail, n_free, ring_size, mask, s0;
+	uint16_t n_tx_pkts = 0, n_drop = 0;
+	memif_desc_t *d0;
+	struct rte_mbuf *mbuf;
+	struct rte_mbuf *mbuf_head;
+	uint64_t a;
+	ssize_t size;
+	int ri;
+	struct rte_eth_link link;
+
+	if (unlikely((pmd->flags & ETH_MEMIF_FLAG_CONNECTED) == 0))
+		return 0;
+	if (unlikely(ring == NULL)) {
+		/* Secondary process will attempt to request regions. */
+		rte_eth_link_get(mq->in_port, &link);
+		return 0;
+	}
+
+	ring_size = 1 << mq->log2_ring_size;
+	mask = ring_size - 1;
+
+	/* release mbufs already consumed by master */
+	tail = ring->tail;
+	while (mq->last_tail != tail) {
+		s0 = mq->last_tail++ & mask;
+		rte_pktmbuf_free_seg(mq->buffers[s0]);
+		mq->buffers[s0] = NULL;
+	}
+
+	/* slave transmits on S2M ring */
+	slot = ring->head;
+	n_free = ring_size - slot + mq->last_tail;
+
+	while (n_tx_pkts + n_drop < nb_pkts && n_free) {
+		mbuf_head = *bufs;
+		if (unlikely(mbuf_head->nb_segs > n_free))
+			break;
+		bufs++;
+		mbuf = mbuf_head;
+		saved_slot = slot;
+
+		do {
+			ri = memif_region_lookup(proc_private, mq,
+					rte_pktmbuf_mtod(mbuf, void *),
+					rte_pktmbuf_data_len(mbuf));
+			if (unlikely(ri < 0))
+				break;
+			s0 = slot & mask;
+			d0 = &ring->desc[s0];
+			d0->region = ri;
+			d0->offset = rte_pktmbuf_mtod(mbuf, uint8_t *) -
+				(uint8_t *)proc_private->regions[ri]->addr;
+			d0->length = rte_pktmbuf_data_len(mbuf);
+			d0->flags = (mbuf->next != NULL) ?
+				MEMIF_DESC_FLAG_NEXT : 0;
+			/* segment is freed once master consumes it */
+			mq->buffers[s0] = mbuf;
+			slot++;
+			mbuf = mbuf->next;
+		} while (mbuf != NULL);
+
+		if (unlikely(ri < 0)) {
+			/* mbuf not in shared memory, drop the packet and
+			 * rewind over the segments already described
+			 */
+			while (slot != saved_slot)
+				mq->buffers[--slot & mask] = NULL;
+			rte_pktmbuf_free(mbuf_head);
+			n_drop++;
+			continue;
+		}
+
+		mq->n_bytes += rte_pktmbuf_pkt_len(mbuf_head);
+		n_free -= mbuf_head->nb_segs;
+		n_tx_pkts++;
+	}
+
+	rte_mb();
+	ring->head = slot;
+
+	if ((ring->flags & MEMIF_RING_FLAG_MASK_INT) == 0) {
+		a = 1;
+		size = write(mq->intr_handle.fd, &a, sizeof(a));
+		if (unlikely(size < 0)) {
+			MIF_LOG(WARNING,
+				"Failed to send interrupt. %s", strerror(errno));
+		}
+	}
+
+	mq->n_err += n_drop;
+	mq->n_pkts += n_tx_pkts;
+	return n_tx_pkts + n_drop;
+}
+
+void
+memif_free_queue_buffers(struct memif_queue *mq)
+{
+	uint16_t i;
+
+	if (mq->buffers == NULL)
+		return;
+
+	for (i = 0; i < (1 << mq->log2_ring_size); i++) {
+		if (mq->buffers[i] != NULL)
+			rte_pktmbuf_free_seg(mq->buffers[i]);
+	}
+	rte_free(mq->buffers);
+	mq->buffers = NULL;
+}
+
 void
 memif_free_regions(struct pmd_process_private *proc_private)
 {
@@ -497,7 +788,8 @@ memif_free_regions(struct pmd_process_private *proc_private)
 	for (i = 0; i < proc_private->regions_num; i++) {
 		r = proc_private->regions[i];
 		if (r != NULL) {
-			if (r->addr != NULL) {
+			/* zero-copy regions belong to DPDK memory */
+			if (r->addr != NULL && !r->is_external) {
 				munmap(r->addr, r->region_size);
 				if (r->fd > 0) {
 					close(r->fd);
@@ -588,11 +880,93 @@ memif_region_init_shm(struct rte_eth_dev *dev, uint8_t has_buffers)
 	return ret;
 }
 
+/*
+ * Register DPDK memory segment as zero-copy region. Segments backed by the
+ * same file at contiguous offsets are merged, so with single file segments
+ * a whole memseg list is shared as one region.
+ */
+static int
+memif_region_init_zc(const struct rte_memseg_list *msl,
+		     const struct rte_memseg *ms, void *arg)
+{
+	struct pmd_process_private *proc_private = arg;
+	struct memif_region *r;
+	size_t offset;
+	int fd;
+
+	if (msl->external)
+		return 0;
+
+	fd = rte_memseg_get_fd_thread_unsafe(ms);
+	if (fd < 0) {
+		MIF_LOG(ERR, "Memory segment has no file descriptor: %s.",
+			strerror(rte_errno));
+		return -1;
+	}
+	if (rte_memseg_get_fd_offset_thread_unsafe(ms, &offset) < 0) {
+		MIF_LOG(ERR, "Failed to get memory segment offset: %s.",
+			strerror(rte_errno));
+		return -1;
+	}
+
+	/* descriptor offset is 32 bit */
+	if (offset + ms->len > (1ULL << 32)) {
+		MIF_LOG(WARNING, "Memory segment %p out of region range, skipping.",
+			ms->addr);
+		return 0;
+	}
+
+	r = proc_private->regions[proc_private->regions_num - 1];
+	if (r->is_external && r->fd == fd &&
+	    (uint8_t *)r->addr + offset == (uint8_t *)ms->addr) {
+		if (offset + ms->len > r->region_size)
+			r->region_size = offset + ms->len;
+		return 0;
+	}
+
+	if (proc_private->regions_num >= ETH_MEMIF_MAX_REGION_NUM) {
+		MIF_LOG(ERR, "Too many regions, use --single-file-segments.");
+		return -1;
+	}
+
+	r = rte_zmalloc("region", sizeof(struct memif_region), 0);
+	if (r == NULL) {
+		MIF_LOG(ERR, "Failed to alloc memif region.");
+		return -1;
+	}
+
+	/* region is mapped by master from the start of the file */
+	r->addr = (uint8_t *)ms->addr - offset;
+	r->region_size = offset + ms->len;
+	r->fd = fd;
+	r->is_external = 1;
+
+	proc_private->regions[proc_private->regions_num] = r;
+	proc_private->regions_num++;
+
+	return 0;
+}
+
 static int
 memif_regions_init(struct rte_eth_dev *dev)
 {
+	struct pmd_internals *pmd = dev->data->dev_private;
+	struct pmd_process_private *proc_private = dev->process_private;
 	int ret;
 
+	if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY) {
+		/* rings only, buffers are mbufs in DPDK memory */
+		ret = memif_region_init_shm(dev, /* has buffer */ 0);
+		if (ret < 0)
+			return ret;
+
+		ret = rte_memseg_walk(memif_region_init_zc, proc_private);
+		if (ret < 0)
+			return ret;
+
+		return 0;
+	}
+
 	/* create one buffer region */
 	ret = memif_region_init_shm(dev, /* has buffer */ 1);
 	if (ret < 0)
@@ -616,6 +990,9 @@ memif_init_rings(struct rte_eth_dev *dev)
 		ring->tail = 0;
 		ring->cookie = MEMIF_COOKIE;
 		ring->flags = 0;
+		/* zero-copy descriptors are filled in rx/tx */
+		if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY)
+			continue;
 		for (j = 0; j < (1 << pmd->run.log2_ring_size); j++) {
 			slot = i * (1 << pmd->run.log2_ring_size) + j;
 			ring->desc[j].region = 0;
@@ -632,6 +1009,8 @@ memif_init_rings(struct rte_eth_dev *dev)
 		ring->tail = 0;
 		ring->cookie = MEMIF_COOKIE;
 		ring->flags = 0;
+		if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY)
+			continue;
 		for (j = 0; j < (1 << pmd->run.log2_ring_size); j++) {
 			slot = (i + pmd->run.num_s2m_rings) *
 			    (1 << pmd->run.log2_ring_size) + j;
@@ -644,13 +1023,63 @@ memif_init_rings(struct rte_eth_dev *dev)
 	}
 }
 
-/* called only by slave */
+struct memif_mempool_check {
+	struct pmd_process_private *proc_private;
+	struct memif_queue *mq;
+	unsigned int n_bad;
+};
+
 static void
+memif_mempool_check_obj(struct rte_mempool *mp __rte_unused, void *arg,
+			void *obj, unsigned int obj_idx __rte_unused)
+{
+	struct memif_mempool_check *c = arg;
+	struct rte_mbuf *mbuf = obj;
+
+	if (memif_region_lookup(c->proc_private, c->mq, mbuf->buf_addr,
+				mbuf->buf_len) < 0)
+		c->n_bad++;
+}
+
+/* zero-copy: allocate mbuf tracking and check rx mbufs are shared */
+static int
+memif_init_queue_zc(struct rte_eth_dev *dev, struct memif_queue *mq)
+{
+	struct memif_mempool_check c;
+
+	memif_free_queue_buffers(mq);
+	mq->last_region = 0;
+	mq->buffers = rte_zmalloc("memif-zc-buffers", sizeof(struct rte_mbuf *) *
+				  (1 << mq->log2_ring_size), 0);
+	if (mq->buffers == NULL) {
+		MIF_LOG(ERR, "Failed to alloc zero-copy buffer array.");
+		return -ENOMEM;
+	}
+
+	if (mq->mempool == NULL)
+		return 0;
+
+	c.proc_private = dev->process_private;
+	c.mq = mq;
+	c.n_bad = 0;
+	rte_mempool_obj_iter(mq->mempool, memif_mempool_check_obj, &c);
+	if (c.n_bad > 0) {
+		MIF_LOG(ERR, "%u mbufs of mempool %s are not in shared memory.",
+			c.n_bad, mq->mempool->name);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* called only by slave */
+static int
 memif_init_queues(struct rte_eth_dev *dev)
 {
 	struct pmd_internals *pmd = dev->data->dev_private;
 	struct memif_queue *mq;
 	int i;
+	int ret;
 
 	for (i = 0; i < pmd->run.num_s2m_rings; i++) {
 		mq = dev->data->tx_queues[i];
@@ -666,6 +1095,11 @@ memif_init_queues(struct rte_eth_dev *dev)
 				"Failed to create eventfd for tx queue %d: %s.", i,
 				strerror(errno));
 		}
+		if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY) {
+			ret = memif_init_queue_zc(dev, mq);
+			if (ret < 0)
+				return ret;
+		}
 	}
 
 	for (i = 0; i < pmd->run.num_m2s_rings; i++) {
@@ -682,7 +1116,14 @@ memif_init_queues(struct rte_eth_dev *dev)
 				"Failed to create eventfd for rx queue %d: %s.", i,
 				strerror(errno));
 		}
+		if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY) {
+			ret = memif_init_queue_zc(dev, mq);
+			if (ret < 0)
+				return ret;
+		}
 	}
+
+	return 0;
 }
 
 int
@@ -696,7 +1137,9 @@ memif_init_regions_and_queues(struct rte_eth_dev *dev)
 
 	memif_init_rings(dev);
 
-	memif_init_queues(dev);
+	ret = memif_init_queues(dev);
+	if (ret < 0)
+		return ret;
 
 	return 0;
 }
@@ -904,6 +1347,7 @@ memif_queue_release(void *queue)
 	if (!mq)
 		return;
 
+	memif_free_queue_buffers(mq);
 	rte_free(mq);
 }
 
@@ -1027,6 +1471,20 @@ static const struct eth_dev_ops ops = {
 	.stats_reset = memif_stats_reset,
 };
 
+static void
+memif_set_burst_functions(struct rte_eth_dev *dev)
+{
+	struct pmd_internals *pmd = dev->data->dev_private;
+
+	if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY) {
+		dev->rx_pkt_burst = eth_memif_rx_zc;
+		dev->tx_pkt_burst = eth_memif_tx_zc;
+	} else {
+		dev->rx_pkt_burst = eth_memif_rx;
+		dev->tx_pkt_burst = eth_memif_tx;
+	}
+}
+
 static int
 memif_create(struct rte_vdev_device *vdev, enum memif_role_t role,
 	     memif_interface_id_t id, uint32_t flags,
@@ -1043,8 +1501,9 @@ memif_create(struct rte_vdev_device *vdev, enum memif_role_t role,
 	const unsigned int numa_node = vdev->device.numa_node;
 	const char *name = rte_vdev_device_name(vdev);
 
-	if (flags & ETH_MEMIF_FLAG_ZERO_COPY) {
-		MIF_LOG(ERR, "Zero-copy slave not supported.");
+	/* master always uses buffers provided by slave */
+	if (role == MEMIF_ROLE_MASTER && (flags & ETH_MEMIF_FLAG_ZERO_COPY)) {
+		MIF_LOG(ERR, "Zero-copy is only supported in slave role.");
 		return -1;
 	}
 
@@ -1094,8 +1553,7 @@ memif_create(struct rte_vdev_device *vdev, enum memif_role_t role,
 
 	eth_dev->dev_ops = &ops;
 	eth_dev->device = &vdev->device;
-	eth_dev->rx_pkt_burst = eth_memif_rx;
-	eth_dev->tx_pkt_burst = eth_memif_tx;
+	memif_set_burst_functions(eth_dev);
 
 	eth_dev->data->dev_flags &= RTE_ETH_DEV_CLOSE_REMOVE;
 
@@ -1271,8 +1729,7 @@ rte_pmd_memif_probe(struct rte_vdev_device *vdev)
 
 		eth_dev->dev_ops = &ops;
 		eth_dev->device = &vdev->device;
-		eth_dev->rx_pkt_burst = eth_memif_rx;
-		eth_dev->tx_pkt_burst = eth_memif_rx;
+		memif_set_burst_functions(eth_dev);
 
 		if (!rte_eal_primary_proc_alive(NULL)) {
 			MIF_LOG(ERR, "Primary process is missing");
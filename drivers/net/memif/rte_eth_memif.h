@@ -46,6 +46,8 @@ struct memif_region {
 	int fd;					/**< shared memory file descriptor */
 	uint32_t pkt_buffer_offset;
 	/**< offset from 'addr' to first packet buffer */
+	uint8_t is_external;
+	/**< set if memory is owned by DPDK (zero-copy), not by the PMD */
 };
 
 struct memif_queue {
@@ -63,6 +65,10 @@ struct memif_queue {
 	uint16_t last_head;			/**< last ring head */
 	uint16_t last_tail;			/**< last ring tail */
 
+	struct rte_mbuf **buffers;
+	/**< zero-copy: mbufs currently referenced by ring descriptors */
+	memif_region_index_t last_region;	/**< zero-copy: last region */
+
 	/* rx/tx info */
 	uint64_t n_pkts;			/**< number of rx/tx packets */
 	uint64_t n_bytes;			/**< number of rx/tx bytes */
@@ -134,6 +140,15 @@ struct pmd_process_private {
  */
 void memif_free_regions(struct pmd_process_private *proc_private);
 
+/**
+ * Release mbufs still referenced by zero-copy ring descriptors
+ * and free the buffer tracking array of the queue.
+ *
+ * @param mq
+ *   memif queue
+ */
+void memif_free_queue_buffers(struct memif_queue *mq);
+
 /**
  * Finalize connection establishment process. Map shared memory file
  * (master role), initialize ring queue, set link status up.
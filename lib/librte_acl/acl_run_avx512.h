@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include "acl_run_sse.h"
+
+/*
+ * 256-bit registers, 8 flows per register,
+ * two registers processed in parallel: 16 flows per iteration.
+ */
+#define _T_simd		__m256i
+#define _N_		(sizeof(__m256i) / sizeof(uint32_t))
+#define _F_(x)		x##_avx512x8
+#define _M_I_(x)	_mm256_##x
+#define _M_SI_(x)	_mm256_##x##_si256
+#define _M_HALF_LO(v)	_mm256_castsi256_si128(v)
+#define _M_HALF_HI(v)	_mm256_extracti128_si256(v, 1)
+#define _M_GATHER64(idx, base)	\
+	_mm256_mmask_i32gather_epi64(_mm256_setzero_si256(), UINT8_MAX, \
+		(idx), (const void *)(base), sizeof((base)[0]))
+#define _M_SET_IN(in)	\
+	_mm256_set_epi32((in)[7], (in)[6], (in)[5], (in)[4], \
+		(in)[3], (in)[2], (in)[1], (in)[0])
+#define _SPLIT_LO	_mm256_set_epi32(14, 12, 10, 8, 6, 4, 2, 0)
+#define _SPLIT_HI	_mm256_set_epi32(15, 13, 11, 9, 7, 5, 3, 1)
+
+#include "acl_run_avx512_common.h"
+
+#undef _SPLIT_HI
+#undef _SPLIT_LO
+#undef _M_SET_IN
+#undef _M_GATHER64
+#undef _M_HALF_HI
+#undef _M_HALF_LO
+#undef _M_SI_
+#undef _M_I_
+#undef _F_
+#undef _N_
+#undef _T_simd
+
+/*
+ * 512-bit registers, 16 flows per register,
+ * two registers processed in parallel: 32 flows per iteration.
+ */
+#define _T_simd		__m512i
+#define _N_		(sizeof(__m512i) / sizeof(uint32_t))
+#define _F_(x)		x##_avx512x16
+#define _M_I_(x)	_mm512_##x
+#define _M_SI_(x)	_mm512_##x##_si512
+#define _M_HALF_LO(v)	_mm512_castsi512_si256(v)
+#define _M_HALF_HI(v)	_mm512_extracti64x4_epi64(v, 1)
+#define _M_GATHER64(idx, base)	\
+	_mm512_i32gather_epi64((idx), (const void *)(base), sizeof((base)[0]))
+#define _M_SET_IN(in)	\
+	_mm512_set_epi32((in)[15], (in)[14], (in)[13], (in)[12], \
+		(in)[11], (in)[10], (in)[9], (in)[8], \
+		(in)[7], (in)[6], (in)[5], (in)[4], \
+		(in)[3], (in)[2], (in)[1], (in)[0])
+#define _SPLIT_LO	_mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, \
+				14, 12, 10, 8, 6, 4, 2, 0)
+#define _SPLIT_HI	_mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, \
+				15, 13, 11, 9, 7, 5, 3, 1)
+
+#include "acl_run_avx512_common.h"
+
+#undef _SPLIT_HI
+#undef _SPLIT_LO
+#undef _M_SET_IN
+#undef _M_GATHER64
+#undef _M_HALF_HI
+#undef _M_HALF_LO
+#undef _M_SI_
+#undef _M_I_
+#undef _F_
+#undef _N_
+#undef _T_simd
+
+static inline int
+search_avx512x16(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	return search_x2_avx512x8(ctx, data, results, total_packets,
+		categories);
+}
+
+static inline int
+search_avx512x32(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	return search_x2_avx512x16(ctx, data, results, total_packets,
+		categories);
+}
@@ -0,0 +1,251 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+/*
+ * This file is a template for the AVX512 classify methods.
+ * It is included once for each SIMD register width,
+ * with the following macros defined by the includer:
+ * _T_simd - SIMD register type.
+ * _N_ - number of flows (32-bit lanes) processed by one register.
+ * _F_(x) - adds register width suffix to the function/type names.
+ * _M_I_(x) - adds register width prefix to the intrinsic names.
+ * _M_SI_(x) - adds register width prefix and suffix to the
+ *	intrinsic names operating on the whole register.
+ * _M_HALF_LO(v), _M_HALF_HI(v) - lower/upper halves of the register.
+ * _M_GATHER64(idx, base) - gather _N_ / 2 64-bit values at given indexes.
+ * _M_SET_IN(in) - fill the register from an array of _N_ 32-bit values.
+ * _SPLIT_LO, _SPLIT_HI - indexes of the even/odd 32-bit elements
+ *	of two registers, as expected by permutex2var.
+ */
+
+/*
+ * Constants used by transition(), same values as their AVX2 counterparts,
+ * replicated over all 128-bit lanes of the register.
+ */
+struct _F_(acl_const) {
+	_T_simd index_mask;
+	_T_simd match_mask;
+	_T_simd shuffle_input;
+	_T_simd range_base;
+	_T_simd ones_8;
+	_T_simd ones_16;
+	_T_simd split_lo;
+	_T_simd split_hi;
+};
+
+static __rte_always_inline void
+_F_(acl_const_init)(struct _F_(acl_const) *c)
+{
+	c->index_mask = _M_I_(set1_epi32)(RTE_ACL_NODE_INDEX);
+	c->match_mask = _M_I_(set1_epi32)(RTE_ACL_NODE_MATCH);
+	c->shuffle_input = _M_I_(broadcast_i32x4)(_mm_set_epi32(0x0c0c0c0c,
+		0x08080808, 0x04040404, 0x00000000));
+	c->range_base = _M_I_(broadcast_i32x4)(_mm_set_epi32(0xffffff0c,
+		0xffffff08, 0xffffff04, 0xffffff00));
+	c->ones_8 = _M_I_(set1_epi8)(1);
+	c->ones_16 = _M_I_(set1_epi16)(1);
+	c->split_lo = _SPLIT_LO;
+	c->split_hi = _SPLIT_HI;
+}
+
+/*
+ * Process _N_ transitions in parallel.
+ * tr_lo contains low 32 bits for _N_ transitions.
+ * tr_hi contains high 32 bits for _N_ transitions.
+ * next_input contains up to 4 input bytes for _N_ flows.
+ * Same as ACL_TR_CALC_ADDR(), but with AVX512 mask registers
+ * used instead of byte masks for the comparisons and the blending.
+ */
+static __rte_always_inline _T_simd
+_F_(transition)(_T_simd next_input, const uint64_t *trans,
+	const struct _F_(acl_const) *c, _T_simd *tr_lo, _T_simd *tr_hi)
+{
+	_T_simd addr, in, node_type, r, t;
+	_T_simd dfa_ofs, quad_ofs, t0, t1;
+	uint32_t dfa_msk;
+	uint64_t gt_msk;
+
+	in = _M_I_(shuffle_epi8)(next_input, c->shuffle_input);
+
+	/* Calc node type and node addr */
+	node_type = _M_SI_(andnot)(c->index_mask, *tr_lo);
+	addr = _M_SI_(and)(c->index_mask, *tr_lo);
+
+	/* mask for DFA type(0) nodes */
+	dfa_msk = _M_I_(testn_epi32_mask)(node_type, node_type);
+
+	/* DFA calculations. */
+	r = _M_I_(srli_epi32)(in, 30);
+	r = _M_I_(add_epi8)(r, c->range_base);
+	t = _M_I_(srli_epi32)(in, 24);
+	r = _M_I_(shuffle_epi8)(*tr_hi, r);
+
+	dfa_ofs = _M_I_(sub_epi32)(t, r);
+
+	/* QUAD/SINGLE calculations: count the boundaries below input byte. */
+	gt_msk = _M_I_(cmpgt_epi8_mask)(in, *tr_hi);
+	t = _M_I_(maskz_mov_epi8)(gt_msk, c->ones_8);
+	t = _M_I_(maddubs_epi16)(t, c->ones_8);
+	quad_ofs = _M_I_(madd_epi16)(t, c->ones_16);
+
+	/* blend DFA and QUAD/SINGLE. */
+	t = _M_I_(mask_blend_epi32)(dfa_msk, quad_ofs, dfa_ofs);
+
+	/* calculate address for next transitions. */
+	addr = _M_I_(add_epi32)(addr, t);
+
+	/*
+	 * load _N_ transitions as a whole, with two 64-bit gathers:
+	 * that's half the memory accesses of two 32-bit gathers
+	 * for the low and high halves.
+	 */
+	t0 = _M_GATHER64(_M_HALF_LO(addr), trans);
+	t1 = _M_GATHER64(_M_HALF_HI(addr), trans);
+
+	next_input = _M_I_(srli_epi32)(next_input, CHAR_BIT);
+
+	/* put low 32 bits into tr_lo and high 32 bits into tr_hi. */
+	*tr_lo = _M_I_(permutex2var_epi32)(t0, c->split_lo, t1);
+	*tr_hi = _M_I_(permutex2var_epi32)(t0, c->split_hi, t1);
+
+	return next_input;
+}
+
+/*
+ * Gather 4 bytes of input data for _N_ flows starting from given slot.
+ * Values are inserted into the register directly, loading them
+ * back from the stack would stall on the store forwarding.
+ */
+static __rte_always_inline _T_simd
+_F_(get_next_4bytes)(struct parms *parms, uint32_t slot)
+{
+	uint32_t in[_N_];
+	uint32_t i;
+
+	for (i = 0; i != _N_; i++)
+		in[i] = GET_NEXT_4BYTES(parms, slot + i);
+
+	return _M_SET_IN(in);
+}
+
+/*
+ * Check for matches in _N_ flows starting from given slot.
+ * For each flow with a match node, resolve the match
+ * and replace the transition with the start of the next trie.
+ */
+static inline void
+_F_(match_check)(const struct rte_acl_ctx *ctx, struct parms *parms,
+	struct acl_flow_data *flows, uint32_t slot,
+	_T_simd *tr_lo, _T_simd *tr_hi, _T_simd match_mask)
+{
+	uint32_t i;
+	uint32_t msk;
+	uint64_t tr;
+	uint32_t lo[_N_] __rte_aligned(sizeof(_T_simd));
+
+	msk = _M_I_(test_epi32_mask)(*tr_lo, match_mask);
+
+	while (msk != 0) {
+
+		_M_SI_(store)((_T_simd *)lo, *tr_lo);
+
+		do {
+			i = __builtin_ctz(msk);
+			msk &= msk - 1;
+
+			/* low 32 bits are enough to process the match. */
+			tr = acl_match_check(lo[i], slot + i,
+				ctx, parms, flows, resolve_priority_sse);
+
+			/* update the transition for that flow only. */
+			*tr_lo = _M_I_(mask_set1_epi32)(*tr_lo, 1 << i,
+				(uint32_t)tr);
+			*tr_hi = _M_I_(mask_set1_epi32)(*tr_hi, 1 << i,
+				tr >> 32);
+		} while (msk != 0);
+
+		msk = _M_I_(test_epi32_mask)(*tr_lo, match_mask);
+	}
+}
+
+/*
+ * Execute trie traversal for 2 * _N_ flows in parallel.
+ * Flows are processed by two registers, so the gather latencies
+ * of one register are hidden by the computations for the other one.
+ */
+static inline int
+_F_(search_x2)(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t i, k, n;
+	struct acl_flow_data flows;
+	struct _F_(acl_const) c;
+	uint64_t index_array[2 * _N_];
+	struct completion cmplt[2 * _N_];
+	struct parms parms[2 * _N_];
+	uint32_t lo[_N_] __rte_aligned(sizeof(_T_simd));
+	uint32_t hi[_N_] __rte_aligned(sizeof(_T_simd));
+	_T_simd input[2], tr_lo[2], tr_hi[2];
+
+	_F_(acl_const_init)(&c);
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	for (n = 0; n != RTE_DIM(cmplt); n++) {
+		cmplt[n].count = 0;
+		index_array[n] = acl_start_next_trie(&flows, parms, n, ctx);
+	}
+
+	/* Split transitions into low and high 32 bits. */
+	for (k = 0; k != RTE_DIM(tr_lo); k++) {
+		for (i = 0; i != _N_; i++) {
+			lo[i] = (uint32_t)index_array[k * _N_ + i];
+			hi[i] = index_array[k * _N_ + i] >> 32;
+		}
+		tr_lo[k] = _M_SI_(load)((const _T_simd *)lo);
+		tr_hi[k] = _M_SI_(load)((const _T_simd *)hi);
+	}
+
+	/* Check for any matches. */
+	_F_(match_check)(ctx, parms, &flows, 0, &tr_lo[0], &tr_hi[0],
+		c.match_mask);
+	_F_(match_check)(ctx, parms, &flows, _N_, &tr_lo[1], &tr_hi[1],
+		c.match_mask);
+
+	while (flows.started > 0) {
+
+		/* Gather 4 bytes of input data for each flow. */
+		input[0] = _F_(get_next_4bytes)(parms, 0);
+		input[1] = _F_(get_next_4bytes)(parms, _N_);
+
+		input[0] = _F_(transition)(input[0], flows.trans, &c,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = _F_(transition)(input[1], flows.trans, &c,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = _F_(transition)(input[0], flows.trans, &c,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = _F_(transition)(input[1], flows.trans, &c,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = _F_(transition)(input[0], flows.trans, &c,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = _F_(transition)(input[1], flows.trans, &c,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = _F_(transition)(input[0], flows.trans, &c,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = _F_(transition)(input[1], flows.trans, &c,
+			&tr_lo[1], &tr_hi[1]);
+
+		/* Check for any matches. */
+		_F_(match_check)(ctx, parms, &flows, 0, &tr_lo[0], &tr_hi[0],
+			c.match_mask);
+		_F_(match_check)(ctx, parms, &flows, _N_, &tr_lo[1], &tr_hi[1],
+			c.match_mask);
+	}
+
+	return 0;
+}
@@ -43,6 +43,32 @@ rte_acl_classify_sse(__rte_unused const struct rte_acl_ctx *ctx,
 }
 #endif
 
+#ifndef CC_AVX512_SUPPORT
+/*
+ * If the compiler doesn't support AVX512 instructions,
+ * then the dummy ones would be used instead for AVX512 classify methods.
+ */
+int
+rte_acl_classify_avx512x16(__rte_unused const struct rte_acl_ctx *ctx,
+	__rte_unused const uint8_t **data,
+	__rte_unused uint32_t *results,
+	__rte_unused uint32_t num,
+	__rte_unused uint32_t categories)
+{
+	return -ENOTSUP;
+}
+
+int
+rte_acl_classify_avx512x32(__rte_unused const struct rte_acl_ctx *ctx,
+	__rte_unused const uint8_t **data,
+	__rte_unused uint32_t *results,
+	__rte_unused uint32_t num,
+	__rte_unused uint32_t categories)
+{
+	return -ENOTSUP;
+}
+#endif
+
 #ifndef RTE_ARCH_ARM
 #ifndef RTE_ARCH_ARM64
 int
@@ -76,6 +102,8 @@ static const rte_acl_classify_t classify_fns[] = {
 	[RTE_ACL_CLASSIFY_AVX2] = rte_acl_classify_avx2,
 	[RTE_ACL_CLASSIFY_NEON] = rte_acl_classify_neon,
 	[RTE_ACL_CLASSIFY_ALTIVEC] = rte_acl_classify_altivec,
+	[RTE_ACL_CLASSIFY_AVX512X16] = rte_acl_classify_avx512x16,
+	[RTE_ACL_CLASSIFY_AVX512X32] = rte_acl_classify_avx512x32,
 };
 
 /* by default, use always available scalar code path. */
@@ -88,44 +116,103 @@ rte_acl_set_default_classify(enum rte_acl_classify_alg alg)
 	rte_acl_default_classify = alg;
 }
 
+/*
+ * Check that given classify method can be used:
+ * at build time compiler supports the required instructions
+ * and target cpu supports them too.
+ */
+static int
+acl_check_alg(enum rte_acl_classify_alg alg)
+{
+	switch (alg) {
+	case RTE_ACL_CLASSIFY_DEFAULT:
+	case RTE_ACL_CLASSIFY_SCALAR:
+		return 0;
+	case RTE_ACL_CLASSIFY_NEON:
+#if defined(RTE_ARCH_ARM64)
+		return 0;
+#elif defined(RTE_ARCH_ARM)
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_NEON))
+			return 0;
+#endif
+		return -ENOTSUP;
+	case RTE_ACL_CLASSIFY_ALTIVEC:
+#if defined(RTE_ARCH_PPC_64)
+		return 0;
+#endif
+		return -ENOTSUP;
+	case RTE_ACL_CLASSIFY_SSE:
+#if defined(RTE_ARCH_X86)
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
+			return 0;
+#endif
+		return -ENOTSUP;
+	case RTE_ACL_CLASSIFY_AVX2:
+#ifdef CC_AVX2_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			return 0;
+#endif
+		return -ENOTSUP;
+	case RTE_ACL_CLASSIFY_AVX512X16:
+	case RTE_ACL_CLASSIFY_AVX512X32:
+#ifdef CC_AVX512_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+				rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) &&
+				rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512VL))
+			return 0;
+#endif
+		return -ENOTSUP;
+	default:
+		return -EINVAL;
+	}
+}
+
 extern int
 rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx, enum rte_acl_classify_alg alg)
 {
+	int ret;
+
 	if (ctx == NULL || (uint32_t)alg >= RTE_DIM(classify_fns))
 		return -EINVAL;
 
+	ret = acl_check_alg(alg);
+	if (ret != 0)
+		return ret;
+
+	if (alg == RTE_ACL_CLASSIFY_DEFAULT)
+		alg = rte_acl_default_classify;
+
 	ctx->alg = alg;
 	return 0;
 }
 
 /*
  * Select highest available classify method as default one.
- * Note that CLASSIFY_AVX2 should be set as a default only
- * if both conditions are met:
- * at build time compiler supports AVX2 and target cpu supports AVX2.
+ * The 32 flows AVX512 method is preferred, as it keeps more gathers
+ * in flight, while smaller bursts are handed over to the 16 flows
+ * method anyway. AVX2 comes before the 16 flows AVX512 method, which
+ * processes as many flows with wider instructions.
  */
 RTE_INIT(rte_acl_init)
 {
+	static const enum rte_acl_classify_alg alg_pref[] = {
+		RTE_ACL_CLASSIFY_AVX512X32,
+		RTE_ACL_CLASSIFY_AVX2,
+		RTE_ACL_CLASSIFY_AVX512X16,
+		RTE_ACL_CLASSIFY_SSE,
+		RTE_ACL_CLASSIFY_NEON,
+		RTE_ACL_CLASSIFY_ALTIVEC,
+	};
 	enum rte_acl_classify_alg alg = RTE_ACL_CLASSIFY_DEFAULT;
+	uint32_t i;
 
-#if defined(RTE_ARCH_ARM64)
-	alg =  RTE_ACL_CLASSIFY_NEON;
-#elif defined(RTE_ARCH_ARM)
-	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_NEON))
-		alg =  RTE_ACL_CLASSIFY_NEON;
-#elif defined(RTE_ARCH_PPC_64)
-	alg = RTE_ACL_CLASSIFY_ALTIVEC;
-#else
-#ifdef CC_AVX2_SUPPORT
-	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
-		alg = RTE_ACL_CLASSIFY_AVX2;
-	else if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
-#else
-	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
-#endif
-		alg = RTE_ACL_CLASSIFY_SSE;
+	for (i = 0; i != RTE_DIM(alg_pref); i++) {
+		if (acl_check_alg(alg_pref[i]) == 0) {
+			alg = alg_pref[i];
+			break;
+		}
+	}
 
-#endif
 	rte_acl_set_default_classify(alg);
 }
 
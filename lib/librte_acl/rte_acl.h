@@ -241,6 +241,10 @@ enum rte_acl_classify_alg {
 	RTE_ACL_CLASSIFY_AVX2 = 3,    /**< requires AVX2 support. */
 	RTE_ACL_CLASSIFY_NEON = 4,    /**< requires NEON support. */
 	RTE_ACL_CLASSIFY_ALTIVEC = 5,    /**< requires ALTIVEC support. */
+	/** requires AVX512F, AVX512BW and AVX512VL support, 16 flows per iteration. */
+	RTE_ACL_CLASSIFY_AVX512X16 = 6,
+	/** requires AVX512F, AVX512BW and AVX512VL support, 32 flows per iteration. */
+	RTE_ACL_CLASSIFY_AVX512X32 = 7,
 	RTE_ACL_CLASSIFY_NUM          /* should always be the last one. */
 };
 
@@ -326,10 +330,12 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx,
  *   ACL context to change classify function for.
  * @param alg
  *   New default classify algorithm for given ACL context.
- *   It is the caller responsibility to ensure that the value refers to the
- *   existing algorithm, and that it could be run on the given CPU.
+ *   RTE_ACL_CLASSIFY_DEFAULT selects the best algorithm available
+ *   on the given CPU.
  * @return
  *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the algorithm is not supported by this build
+ *     or can not be run on the given CPU.
  *   - Zero if operation completed successfully.
  */
 extern int
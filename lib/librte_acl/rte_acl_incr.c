@@ -0,0 +1,959 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <rte_spinlock.h>
+
+#include "rte_acl_incr.h"
+#include "acl.h"
+
+/* Max number of input buffers classified in one go. */
+#define ACL_INCR_BURST	32
+
+/*
+ * Rule flags, protected by the update lock.
+ * A deleted rule can be reused once no trie references it anymore.
+ */
+enum {
+	ACL_INCR_RULE_LIVE = 1 << 0,   /* not deleted. */
+	ACL_INCR_RULE_MAIN = 1 << 1,   /* in the published main trie. */
+	ACL_INCR_RULE_NEXT = 1 << 2,   /* in the main trie being merged. */
+	ACL_INCR_RULE_DEL = 1 << 3,    /* selected for deletion. */
+	ACL_INCR_RULE_SHADOW = 1 << 4, /* main rule copied to the delta. */
+};
+
+/* Rule state, the rule id is its index plus one. */
+struct acl_incr_rule {
+	uint32_t flags;  /* ACL_INCR_RULE_* */
+	uint32_t refs;   /* tries referencing the rule, not freed yet. */
+	struct rte_acl_rule_data data; /* rule data as given by the user. */
+};
+
+/*
+ * ACL trie built over a set of rules.
+ * The trie userdata are the rule ids, translated back by the lookups.
+ */
+struct acl_incr_trie {
+	struct rte_acl_ctx *ctx;
+	uint32_t num;
+	uint32_t ids[];
+};
+
+/*
+ * Set of tries published to the lookups, with a bitmap of the rules
+ * of the main trie deleted since it was built.
+ */
+struct acl_incr_view {
+	struct acl_incr_trie *main;
+	struct acl_incr_trie *delta;
+	uint64_t dead[];
+};
+
+/* Tries replaced by an update, freed once no lookup can use them. */
+struct acl_incr_retired {
+	struct acl_incr_view *view;
+	struct acl_incr_trie *main;
+	struct acl_incr_trie *delta;
+};
+
+struct rte_acl_incr {
+	struct acl_incr_view *view;   /**< Tries used by the lookups. */
+	struct acl_incr_rule *rules;  /**< Rule states. */
+	uint8_t *rule_mem;            /**< Rules, rule_sz bytes each. */
+	struct rte_rcu_qsbr *v;       /**< RCU QSBR variable. */
+	rte_spinlock_t lock;          /**< Serializes updates. */
+	int socket_id;
+	uint32_t rule_sz;
+	uint32_t max_rules;
+	uint32_t max_delta;
+	uint32_t dead_sz;             /**< Size of the view bitmap. */
+	uint32_t merging;             /**< Merge in progress. */
+	uint32_t nb_delta;
+	uint32_t nb_shadow;           /**< Main rules copied to the delta. */
+	uint32_t nb_dead;
+	uint32_t nb_free;
+	uint32_t *delta_ids;          /**< Rules to keep in the delta trie. */
+	uint32_t *dead_ids;           /**< Deleted rules, not reused yet. */
+	uint32_t *free_ids;           /**< Unused rule ids. */
+	uint32_t *next_ids;           /**< Rules of the main trie merged. */
+	uint32_t *tmp_ids;            /**< Delta trie rules being built. */
+	struct rte_acl_config cfg;    /**< Build configuration. */
+	char name[RTE_ACL_NAMESIZE];
+};
+
+static inline struct rte_acl_rule *
+acl_incr_rule(const struct rte_acl_incr *ai, uint32_t id)
+{
+	return (struct rte_acl_rule *)
+		(ai->rule_mem + (size_t)(id - 1) * ai->rule_sz);
+}
+
+static int
+acl_incr_check_rule(const struct rte_acl_rule_data *rd)
+{
+	if ((RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, typeof(rd->category_mask)) &
+			rd->category_mask) == 0 ||
+			rd->priority > RTE_ACL_MAX_PRIORITY ||
+			rd->priority < RTE_ACL_MIN_PRIORITY ||
+			rd->userdata == 0)
+		return -EINVAL;
+	return 0;
+}
+
+/*
+ * Field value of the given size, in host byte order.
+ */
+static inline uint64_t
+acl_incr_field_value(const union rte_acl_field_types *v, uint32_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return v->u8;
+	case sizeof(uint16_t):
+		return v->u16;
+	case sizeof(uint32_t):
+		return v->u32;
+	default:
+		return v->u64;
+	}
+}
+
+/*
+ * Field mask of the given type and size, in host byte order.
+ */
+static inline uint64_t
+acl_incr_field_mask(const struct rte_acl_field_def *def,
+	const struct rte_acl_field *fld)
+{
+	if (def->type == RTE_ACL_FIELD_TYPE_MASK)
+		return RTE_ACL_MASKLEN_TO_BITMASK(
+			(uint64_t)fld->mask_range.u32, def->size);
+	return acl_incr_field_value(&fld->mask_range, def->size);
+}
+
+/*
+ * Check if some input buffer can match both rules,
+ * with the same semantics as the trie built by rte_acl_build().
+ */
+static int
+acl_incr_rule_overlap(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	uint32_t n;
+	uint64_t v1, v2;
+	const struct rte_acl_field_def *def;
+	const struct rte_acl_field *f1, *f2;
+
+	for (n = 0; n != cfg->num_fields; n++) {
+
+		def = cfg->defs + n;
+		f1 = r1->field + def->field_index;
+		f2 = r2->field + def->field_index;
+		v1 = acl_incr_field_value(&f1->value, def->size);
+		v2 = acl_incr_field_value(&f2->value, def->size);
+
+		switch (def->type) {
+		case RTE_ACL_FIELD_TYPE_BITMASK:
+		case RTE_ACL_FIELD_TYPE_MASK:
+			if (((v1 ^ v2) & acl_incr_field_mask(def, f1) &
+					acl_incr_field_mask(def, f2)) != 0)
+				return 0;
+			break;
+		case RTE_ACL_FIELD_TYPE_RANGE:
+			if (v1 > acl_incr_field_value(&f2->mask_range,
+					def->size) ||
+					v2 > acl_incr_field_value(
+					&f1->mask_range, def->size))
+				return 0;
+			break;
+		default:
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* Check if the main trie result refers to a deleted rule. */
+static inline int
+acl_incr_view_dead(const struct acl_incr_view *view, uint32_t id)
+{
+	return (view->dead[id / 64] >> (id % 64)) & 1;
+}
+
+static inline void
+acl_incr_view_set_dead(struct acl_incr_view *view, uint32_t id)
+{
+	view->dead[id / 64] |= UINT64_C(1) << (id % 64);
+}
+
+static inline int
+acl_incr_classify_trie(const struct acl_incr_trie *trie, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories)
+{
+	if (trie == NULL) {
+		memset(results, 0, num * categories * sizeof(results[0]));
+		return 0;
+	}
+	return rte_acl_classify(trie->ctx, data, results, num, categories);
+}
+
+int
+rte_acl_incr_classify(const struct rte_acl_incr *ai, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories)
+{
+	int32_t rc;
+	uint32_t i, k, m, n, d, r;
+	const struct acl_incr_view *view;
+	uint32_t res_main[ACL_INCR_BURST * RTE_ACL_MAX_CATEGORIES];
+	uint32_t res_delta[ACL_INCR_BURST * RTE_ACL_MAX_CATEGORIES];
+
+	if (ai == NULL || data == NULL || results == NULL ||
+			categories == 0 ||
+			categories > RTE_ACL_MAX_CATEGORIES ||
+			(categories != 1 &&
+			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0))
+		return -EINVAL;
+
+	view = __atomic_load_n(&ai->view, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i < num; i += n) {
+
+		n = RTE_MIN(num - i, (uint32_t)ACL_INCR_BURST);
+
+		rc = acl_incr_classify_trie(view->main, data + i, res_main, n,
+			categories);
+		if (rc == 0)
+			rc = acl_incr_classify_trie(view->delta, data + i,
+				res_delta, n, categories);
+		if (rc != 0)
+			return rc;
+
+		/* pick the highest priority one of the two results. */
+		for (k = 0; k != n * categories; k++) {
+
+			m = res_main[k];
+			d = res_delta[k];
+
+			/*
+			 * the main rules a deleted one may hide are in
+			 * the delta trie, its result is the right one.
+			 */
+			if (m != 0 && acl_incr_view_dead(view, m))
+				m = 0;
+
+			if (d != 0 && (m == 0 ||
+					ai->rules[d - 1].data.priority >
+					ai->rules[m - 1].data.priority))
+				r = d;
+			else
+				r = m;
+
+			results[i * categories + k] = (r == 0) ? 0 :
+				ai->rules[r - 1].data.userdata;
+		}
+	}
+
+	return 0;
+}
+
+static void
+acl_incr_trie_free(struct acl_incr_trie *trie)
+{
+	if (trie == NULL)
+		return;
+	rte_acl_free(trie->ctx);
+	rte_free(trie);
+}
+
+/*
+ * Build an ACL trie over the given rules.
+ * An empty set of rules gives a NULL trie.
+ */
+static int
+acl_incr_trie_build(const struct rte_acl_incr *ai, const uint32_t *ids,
+	uint32_t num, struct acl_incr_trie **ptrie)
+{
+	int32_t rc;
+	uint32_t i;
+	struct rte_acl_ctx *ctx;
+	struct rte_acl_param prm;
+	struct rte_acl_rule *rule;
+	struct acl_incr_trie *trie;
+	char name[RTE_ACL_NAMESIZE];
+
+	*ptrie = NULL;
+	if (num == 0)
+		return 0;
+
+	trie = rte_zmalloc_socket(ai->name, sizeof(*trie) +
+		num * sizeof(trie->ids[0]), RTE_CACHE_LINE_SIZE,
+		ai->socket_id);
+	if (trie == NULL)
+		return -ENOMEM;
+
+	trie->num = num;
+	memcpy(trie->ids, ids, num * sizeof(trie->ids[0]));
+
+	/* context names have to be unique. */
+	snprintf(name, sizeof(name), "ACLI_%p", trie);
+
+	prm.name = name;
+	prm.socket_id = ai->socket_id;
+	prm.rule_size = ai->rule_sz;
+	prm.max_rule_num = num;
+
+	ctx = rte_acl_create(&prm);
+	if (ctx == NULL) {
+		rte_free(trie);
+		return -ENOMEM;
+	}
+
+	/* add the rules, with their ids as userdata. */
+	rc = 0;
+	for (i = 0; i != num && rc == 0; i++) {
+		rc = rte_acl_add_rules(ctx, acl_incr_rule(ai, ids[i]), 1);
+		if (rc == 0) {
+			rule = (struct rte_acl_rule *)((uintptr_t)ctx->rules +
+				i * ctx->rule_sz);
+			rule->data.userdata = ids[i];
+		}
+	}
+
+	if (rc == 0)
+		rc = rte_acl_build(ctx, &ai->cfg);
+
+	if (rc != 0) {
+		RTE_LOG(ERR, ACL, "%s(%s): build of %u rules failed: %d\n",
+			__func__, ai->name, num, rc);
+		rte_acl_free(ctx);
+		rte_free(trie);
+		return rc;
+	}
+
+	trie->ctx = ctx;
+	*ptrie = trie;
+	return 0;
+}
+
+/*
+ * New view, with the deleted rules of the current main trie.
+ */
+static struct acl_incr_view *
+acl_incr_view_alloc(const struct rte_acl_incr *ai, int copy_dead)
+{
+	struct acl_incr_view *view;
+
+	view = rte_zmalloc_socket(ai->name, sizeof(*view) +
+		ai->dead_sz * sizeof(view->dead[0]), 0, ai->socket_id);
+	if (view != NULL && copy_dead != 0)
+		memcpy(view->dead, ai->view->dead,
+			ai->dead_sz * sizeof(view->dead[0]));
+	return view;
+}
+
+static void
+acl_incr_trie_flags(struct rte_acl_incr *ai, const struct acl_incr_trie *trie,
+	uint32_t flag, int set)
+{
+	uint32_t i;
+
+	if (trie == NULL)
+		return;
+
+	for (i = 0; i != trie->num; i++) {
+		if (set != 0)
+			ai->rules[trie->ids[i] - 1].flags |= flag;
+		else
+			ai->rules[trie->ids[i] - 1].flags &= ~flag;
+	}
+}
+
+static void
+acl_incr_trie_refs(struct rte_acl_incr *ai, const struct acl_incr_trie *trie,
+	int32_t inc)
+{
+	uint32_t i;
+
+	if (trie == NULL)
+		return;
+
+	for (i = 0; i != trie->num; i++)
+		ai->rules[trie->ids[i] - 1].refs += inc;
+}
+
+/*
+ * Copy to the delta rules the live rules of the main trie which can
+ * match the same input buffers as the given deleted one, for one of
+ * its categories: the lookups ignore the main trie result when it is
+ * a deleted rule. Returns the new number of delta rules.
+ */
+static uint32_t
+acl_incr_shadow(struct rte_acl_incr *ai, const uint32_t *main_ids,
+	uint32_t main_num, uint32_t id, uint32_t *ids, uint32_t num)
+{
+	uint32_t i;
+	struct acl_incr_rule *r;
+	const struct acl_incr_rule *dr;
+
+	dr = ai->rules + id - 1;
+
+	for (i = 0; i != main_num; i++) {
+		r = ai->rules + main_ids[i] - 1;
+		if ((r->flags & (ACL_INCR_RULE_LIVE | ACL_INCR_RULE_DEL |
+				ACL_INCR_RULE_SHADOW)) != ACL_INCR_RULE_LIVE ||
+				(r->data.category_mask &
+				dr->data.category_mask) == 0 ||
+				acl_incr_rule_overlap(&ai->cfg,
+				acl_incr_rule(ai, id),
+				acl_incr_rule(ai, main_ids[i])) == 0)
+			continue;
+		r->flags |= ACL_INCR_RULE_SHADOW;
+		ids[num++] = main_ids[i];
+	}
+
+	return num;
+}
+
+static void
+acl_incr_free_id(struct rte_acl_incr *ai, uint32_t id)
+{
+	ai->rules[id - 1].flags = 0;
+	ai->free_ids[ai->nb_free++] = id;
+}
+
+/*
+ * Make the deleted rules which are not referenced by any trie anymore
+ * available again.
+ */
+static void
+acl_incr_reclaim(struct rte_acl_incr *ai)
+{
+	uint32_t i, k, id;
+
+	for (i = 0, k = 0; i != ai->nb_dead; i++) {
+		id = ai->dead_ids[i];
+		if (ai->rules[id - 1].refs == 0 &&
+				(ai->rules[id - 1].flags &
+				ACL_INCR_RULE_NEXT) == 0)
+			acl_incr_free_id(ai, id);
+		else
+			ai->dead_ids[k++] = id;
+	}
+
+	ai->nb_dead = k;
+}
+
+/*
+ * Publish new tries to the lookups, the replaced ones are returned
+ * to be retired once the update lock is released.
+ */
+static void
+acl_incr_publish(struct rte_acl_incr *ai, struct acl_incr_view *view,
+	struct acl_incr_retired *rt)
+{
+	struct acl_incr_view *old;
+
+	old = ai->view;
+	rt->view = old;
+	rt->main = NULL;
+	rt->delta = NULL;
+
+	if (old->main != view->main) {
+		acl_incr_trie_flags(ai, old->main, ACL_INCR_RULE_MAIN, 0);
+		acl_incr_trie_flags(ai, view->main, ACL_INCR_RULE_MAIN, 1);
+		acl_incr_trie_refs(ai, view->main, 1);
+		rt->main = old->main;
+	}
+	if (old->delta != view->delta) {
+		acl_incr_trie_refs(ai, view->delta, 1);
+		rt->delta = old->delta;
+	}
+
+	__atomic_store_n(&ai->view, view, __ATOMIC_RELEASE);
+}
+
+/*
+ * Free the tries replaced by an update, once no lookup can use them
+ * anymore, and the deleted rules they were the last to reference.
+ * Called without the update lock, so the updates are not blocked
+ * while waiting for the readers.
+ */
+static void
+acl_incr_retire(struct rte_acl_incr *ai, struct acl_incr_retired *rt)
+{
+	/* wait for the lookups to stop using the old tries. */
+	if (ai->v != NULL)
+		rte_rcu_qsbr_synchronize(ai->v, RTE_QSBR_THRID_INVALID);
+
+	rte_spinlock_lock(&ai->lock);
+	acl_incr_trie_refs(ai, rt->main, -1);
+	acl_incr_trie_refs(ai, rt->delta, -1);
+	acl_incr_reclaim(ai);
+	rte_spinlock_unlock(&ai->lock);
+
+	acl_incr_trie_free(rt->main);
+	acl_incr_trie_free(rt->delta);
+	rte_free(rt->view);
+}
+
+/*
+ * Rebuild the delta trie with the rules to keep in it
+ * and publish it with the current main trie.
+ */
+static int
+acl_incr_update_delta(struct rte_acl_incr *ai, struct acl_incr_retired *rt)
+{
+	int32_t rc;
+	struct acl_incr_view *view;
+	struct acl_incr_trie *delta;
+
+	view = acl_incr_view_alloc(ai, 1);
+	if (view == NULL)
+		return -ENOMEM;
+
+	rc = acl_incr_trie_build(ai, ai->delta_ids, ai->nb_delta, &delta);
+	if (rc != 0) {
+		rte_free(view);
+		return rc;
+	}
+
+	view->main = ai->view->main;
+	view->delta = delta;
+	acl_incr_publish(ai, view, rt);
+	return 0;
+}
+
+int
+rte_acl_incr_add_rules(struct rte_acl_incr *ai,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	int32_t rc;
+	uint32_t i, id;
+	const struct rte_acl_rule *rv;
+	struct acl_incr_retired rt;
+
+	if (ai == NULL || rules == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != num; i++) {
+		rv = (const struct rte_acl_rule *)
+			((uintptr_t)rules + i * ai->rule_sz);
+		rc = acl_incr_check_rule(&rv->data);
+		if (rc != 0) {
+			RTE_LOG(ERR, ACL, "%s(%s): rule #%u is invalid\n",
+				__func__, ai->name, i + 1);
+			return rc;
+		}
+	}
+
+	rte_spinlock_lock(&ai->lock);
+
+	if (ai->nb_delta - ai->nb_shadow + num > ai->max_delta) {
+		rte_spinlock_unlock(&ai->lock);
+		return -ENOSPC;
+	}
+	if (num > ai->nb_free) {
+		rte_spinlock_unlock(&ai->lock);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i != num; i++) {
+		rv = (const struct rte_acl_rule *)
+			((uintptr_t)rules + i * ai->rule_sz);
+		id = ai->free_ids[--ai->nb_free];
+		memcpy(acl_incr_rule(ai, id), rv, ai->rule_sz);
+		ai->rules[id - 1].data = rv->data;
+		ai->rules[id - 1].flags = ACL_INCR_RULE_LIVE;
+		ai->delta_ids[ai->nb_delta + i] = id;
+	}
+	ai->nb_delta += num;
+
+	rc = acl_incr_update_delta(ai, &rt);
+
+	/* revert, the new rules were never published. */
+	if (rc != 0) {
+		for (i = 0; i != num; i++) {
+			id = ai->delta_ids[--ai->nb_delta];
+			acl_incr_free_id(ai, id);
+		}
+	}
+
+	rte_spinlock_unlock(&ai->lock);
+
+	if (rc == 0)
+		acl_incr_retire(ai, &rt);
+	return rc;
+}
+
+/*
+ * Find a live rule equal to the given one, not yet selected for deletion.
+ */
+static uint32_t
+acl_incr_find(const struct rte_acl_incr *ai, const struct rte_acl_rule *rule)
+{
+	uint32_t i;
+	const struct acl_incr_rule *r;
+
+	for (i = 0; i != ai->max_rules; i++) {
+		r = ai->rules + i;
+		if ((r->flags & (ACL_INCR_RULE_LIVE | ACL_INCR_RULE_DEL)) ==
+				ACL_INCR_RULE_LIVE &&
+				r->data.userdata == rule->data.userdata &&
+				r->data.priority == rule->data.priority &&
+				r->data.category_mask ==
+				rule->data.category_mask &&
+				memcmp(acl_incr_rule(ai, i + 1)->field,
+				rule->field, ai->rule_sz -
+				sizeof(struct rte_acl_rule)) == 0)
+			return i + 1;
+	}
+
+	return 0;
+}
+
+int
+rte_acl_incr_del_rules(struct rte_acl_incr *ai,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	int32_t rc;
+	uint32_t i, k, m, n, s, id;
+	const struct acl_incr_trie *mtrie;
+	struct acl_incr_view *view;
+	struct acl_incr_retired rt;
+
+	if (ai == NULL || rules == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&ai->lock);
+
+	/* select all the rules first, so nothing is deleted on error. */
+	rc = 0;
+	for (i = 0; i != num; i++) {
+		id = acl_incr_find(ai, (const struct rte_acl_rule *)
+			((uintptr_t)rules + i * ai->rule_sz));
+		if (id == 0) {
+			rc = -ENOENT;
+			break;
+		}
+		ai->rules[id - 1].flags |= ACL_INCR_RULE_DEL;
+		ai->dead_ids[ai->nb_dead + i] = id;
+	}
+	n = i;
+
+	view = NULL;
+	if (rc == 0) {
+		view = acl_incr_view_alloc(ai, 1);
+		if (view == NULL)
+			rc = -ENOMEM;
+	}
+
+	if (rc != 0)
+		goto revert;
+
+	/* drop the deleted rules from the delta trie. */
+	for (i = 0, k = 0, s = 0; i != ai->nb_delta; i++) {
+		id = ai->delta_ids[i];
+		if ((ai->rules[id - 1].flags & ACL_INCR_RULE_DEL) == 0) {
+			ai->tmp_ids[k++] = id;
+			s += (ai->rules[id - 1].flags &
+				ACL_INCR_RULE_SHADOW) != 0;
+		}
+	}
+	m = k;
+
+	/* mask the ones of the main trie and add the rules they hide. */
+	mtrie = ai->view->main;
+	for (i = 0; i != num; i++) {
+		id = ai->dead_ids[ai->nb_dead + i];
+		if ((ai->rules[id - 1].flags & ACL_INCR_RULE_MAIN) != 0) {
+			acl_incr_view_set_dead(view, id);
+			k = acl_incr_shadow(ai, mtrie->ids, mtrie->num, id,
+				ai->tmp_ids, k);
+		}
+	}
+
+	view->main = ai->view->main;
+	if (k == ai->nb_delta && m == k)
+		view->delta = ai->view->delta;
+	else
+		rc = acl_incr_trie_build(ai, ai->tmp_ids, k, &view->delta);
+
+	if (rc != 0) {
+		for (i = m; i != k; i++)
+			ai->rules[ai->tmp_ids[i] - 1].flags &=
+				~ACL_INCR_RULE_SHADOW;
+		rte_free(view);
+		goto revert;
+	}
+
+	/* from now on the lookups ignore these rules. */
+	for (i = 0; i != num; i++) {
+		id = ai->dead_ids[ai->nb_dead + i];
+		ai->rules[id - 1].flags &= ~(ACL_INCR_RULE_LIVE |
+			ACL_INCR_RULE_DEL | ACL_INCR_RULE_SHADOW);
+	}
+	ai->nb_dead += num;
+
+	memcpy(ai->delta_ids, ai->tmp_ids, k * sizeof(ai->tmp_ids[0]));
+	ai->nb_delta = k;
+	ai->nb_shadow = s + k - m;
+
+	acl_incr_publish(ai, view, &rt);
+	rte_spinlock_unlock(&ai->lock);
+
+	/* deleted rules may still be returned by the lookups till then. */
+	acl_incr_retire(ai, &rt);
+	return 0;
+
+revert:
+	for (i = 0; i != n; i++)
+		ai->rules[ai->dead_ids[ai->nb_dead + i] - 1].flags &=
+			~ACL_INCR_RULE_DEL;
+	rte_spinlock_unlock(&ai->lock);
+	return rc;
+}
+
+int
+rte_acl_incr_merge(struct rte_acl_incr *ai)
+{
+	int32_t rc;
+	uint32_t i, k, n, s, id;
+	struct acl_incr_view *view;
+	struct acl_incr_trie *mtrie, *dtrie;
+	struct acl_incr_retired rt;
+
+	if (ai == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&ai->lock);
+
+	if (ai->merging != 0) {
+		rte_spinlock_unlock(&ai->lock);
+		return -EBUSY;
+	}
+
+	/* take all the live rules, they are not reused till merge ends. */
+	for (i = 0, n = 0; i != ai->max_rules; i++) {
+		if ((ai->rules[i].flags & ACL_INCR_RULE_LIVE) != 0) {
+			ai->rules[i].flags |= ACL_INCR_RULE_NEXT;
+			ai->next_ids[n++] = i + 1;
+		}
+	}
+	ai->merging = 1;
+
+	rte_spinlock_unlock(&ai->lock);
+
+	/* the long part, updates and lookups can go on meanwhile. */
+	rc = acl_incr_trie_build(ai, ai->next_ids, n, &mtrie);
+
+	rte_spinlock_lock(&ai->lock);
+
+	view = NULL;
+	dtrie = NULL;
+	k = 0;
+	s = 0;
+
+	if (rc == 0) {
+		view = acl_incr_view_alloc(ai, 0);
+		if (view == NULL)
+			rc = -ENOMEM;
+	}
+
+	/*
+	 * keep in the delta trie only the rules added meanwhile,
+	 * and the rules hidden by the ones deleted meanwhile.
+	 */
+	if (rc == 0) {
+		for (i = 0; i != ai->nb_delta; i++) {
+			id = ai->delta_ids[i];
+			ai->rules[id - 1].flags &= ~ACL_INCR_RULE_SHADOW;
+			if ((ai->rules[id - 1].flags & (ACL_INCR_RULE_LIVE |
+					ACL_INCR_RULE_NEXT)) ==
+					ACL_INCR_RULE_LIVE)
+				ai->tmp_ids[k++] = id;
+		}
+		s = k;
+		for (i = 0; i != n; i++) {
+			id = ai->next_ids[i];
+			if ((ai->rules[id - 1].flags &
+					ACL_INCR_RULE_LIVE) == 0) {
+				acl_incr_view_set_dead(view, id);
+				k = acl_incr_shadow(ai, ai->next_ids, n, id,
+					ai->tmp_ids, k);
+			}
+		}
+		rc = acl_incr_trie_build(ai, ai->tmp_ids, k, &dtrie);
+
+		/* on error, the rules of both tries are the shadow ones. */
+		if (rc != 0) {
+			for (i = 0; i != k; i++)
+				ai->rules[ai->tmp_ids[i] - 1].flags &=
+					~ACL_INCR_RULE_SHADOW;
+			for (i = 0; i != ai->nb_delta; i++) {
+				id = ai->delta_ids[i];
+				if ((ai->rules[id - 1].flags &
+						ACL_INCR_RULE_MAIN) != 0)
+					ai->rules[id - 1].flags |=
+						ACL_INCR_RULE_SHADOW;
+			}
+		}
+	}
+
+	for (i = 0; i != n; i++)
+		ai->rules[ai->next_ids[i] - 1].flags &= ~ACL_INCR_RULE_NEXT;
+
+	if (rc == 0) {
+		memcpy(ai->delta_ids, ai->tmp_ids, k * sizeof(ai->tmp_ids[0]));
+		ai->nb_delta = k;
+		ai->nb_shadow = k - s;
+		view->main = mtrie;
+		view->delta = dtrie;
+		acl_incr_publish(ai, view, &rt);
+	} else {
+		acl_incr_trie_free(mtrie);
+		rte_free(view);
+		acl_incr_reclaim(ai);
+	}
+
+	ai->merging = 0;
+
+	rte_spinlock_unlock(&ai->lock);
+
+	if (rc == 0)
+		acl_incr_retire(ai, &rt);
+	return rc;
+}
+
+uint32_t
+rte_acl_incr_pending(const struct rte_acl_incr *ai)
+{
+	if (ai == NULL)
+		return 0;
+
+	return ai->nb_delta + ai->nb_dead;
+}
+
+void
+rte_acl_incr_free(struct rte_acl_incr *ai)
+{
+	if (ai == NULL)
+		return;
+
+	if (ai->view != NULL) {
+		acl_incr_trie_free(ai->view->main);
+		acl_incr_trie_free(ai->view->delta);
+		rte_free(ai->view);
+	}
+
+	rte_free(ai->tmp_ids);
+	rte_free(ai->next_ids);
+	rte_free(ai->free_ids);
+	rte_free(ai->dead_ids);
+	rte_free(ai->delta_ids);
+	rte_free(ai->rule_mem);
+	rte_free(ai->rules);
+	rte_free(ai);
+}
+
+static int
+acl_incr_check_param(const struct rte_acl_incr_param *param)
+{
+	uint32_t i, num;
+	const struct rte_acl_config *cfg;
+
+	if (param == NULL || param->name == NULL || param->cfg == NULL ||
+			param->max_rule_num == 0 ||
+			param->max_rule_num > RTE_ACL_MAX_INDEX ||
+			param->max_delta_num == 0 ||
+			param->max_delta_num > param->max_rule_num ||
+			param->rule_size < sizeof(struct rte_acl_rule))
+		return -EINVAL;
+
+	cfg = param->cfg;
+	if (cfg->num_fields == 0 || cfg->num_fields > RTE_ACL_MAX_FIELDS ||
+			cfg->num_categories == 0 ||
+			cfg->num_categories > RTE_ACL_MAX_CATEGORIES)
+		return -EINVAL;
+
+	/* fields are compared when rules are deleted. */
+	num = (param->rule_size - sizeof(struct rte_acl_rule)) /
+		sizeof(struct rte_acl_field);
+	for (i = 0; i != cfg->num_fields; i++) {
+		if (cfg->defs[i].field_index >= num ||
+				cfg->defs[i].type > RTE_ACL_FIELD_TYPE_BITMASK)
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+struct rte_acl_incr *
+rte_acl_incr_create(const struct rte_acl_incr_param *param)
+{
+	uint32_t i;
+	struct rte_acl_incr *ai;
+	char name[RTE_ACL_NAMESIZE];
+
+	if (acl_incr_check_param(param) != 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(name, sizeof(name), "ACLI_%s", param->name);
+
+	ai = rte_zmalloc_socket(name, sizeof(*ai), RTE_CACHE_LINE_SIZE,
+		param->socket_id);
+	if (ai == NULL)
+		goto nomem;
+
+	strlcpy(ai->name, param->name, sizeof(ai->name));
+	ai->cfg = *param->cfg;
+	ai->v = param->v;
+	ai->socket_id = param->socket_id;
+	ai->rule_sz = param->rule_size;
+	ai->max_rules = param->max_rule_num;
+	ai->max_delta = param->max_delta_num;
+	rte_spinlock_init(&ai->lock);
+
+	ai->rules = rte_zmalloc_socket(name,
+		ai->max_rules * sizeof(ai->rules[0]), RTE_CACHE_LINE_SIZE,
+		ai->socket_id);
+	ai->rule_mem = rte_zmalloc_socket(name,
+		(size_t)ai->max_rules * ai->rule_sz, RTE_CACHE_LINE_SIZE,
+		ai->socket_id);
+	/* the delta trie also gets copies of the main trie rules. */
+	ai->delta_ids = rte_zmalloc_socket(name,
+		ai->max_rules * sizeof(ai->delta_ids[0]), 0, ai->socket_id);
+	ai->tmp_ids = rte_zmalloc_socket(name,
+		ai->max_rules * sizeof(ai->tmp_ids[0]), 0, ai->socket_id);
+	ai->dead_ids = rte_zmalloc_socket(name,
+		ai->max_rules * sizeof(ai->dead_ids[0]), 0, ai->socket_id);
+	ai->free_ids = rte_zmalloc_socket(name,
+		ai->max_rules * sizeof(ai->free_ids[0]), 0, ai->socket_id);
+	ai->next_ids = rte_zmalloc_socket(name,
+		ai->max_rules * sizeof(ai->next_ids[0]), 0, ai->socket_id);
+	ai->dead_sz = ai->max_rules / 64 + 1;
+	ai->view = acl_incr_view_alloc(ai, 0);
+
+	if (ai->rules == NULL || ai->rule_mem == NULL ||
+			ai->delta_ids == NULL || ai->tmp_ids == NULL ||
+			ai->dead_ids == NULL || ai->free_ids == NULL ||
+			ai->next_ids == NULL || ai->view == NULL) {
+		rte_acl_incr_free(ai);
+		goto nomem;
+	}
+
+	/* lowest ids go first. */
+	for (i = 0; i != ai->max_rules; i++)
+		ai->free_ids[i] = ai->max_rules - i;
+	ai->nb_free = ai->max_rules;
+
+	return ai;
+
+nomem:
+	RTE_LOG(ERR, ACL, "%s(%s): allocation on socket %d failed\n",
+		__func__, param->name, param->socket_id);
+	rte_errno = ENOMEM;
+	return NULL;
+}
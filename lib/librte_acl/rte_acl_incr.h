@@ -0,0 +1,221 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#ifndef _RTE_ACL_INCR_H_
+#define _RTE_ACL_INCR_H_
+
+/**
+ * @file
+ *
+ * RTE ACL with incremental rule updates.
+ *
+ * An incremental ACL keeps its rules in two ACL tries: a main one,
+ * holding the bulk of the rules, and a small delta one, holding the
+ * rules added since the last merge. Adding or deleting rules only
+ * rebuilds the delta trie, while rules deleted from the main trie are
+ * masked until the next merge, the rules of the main trie they may hide
+ * being copied to the delta trie. rte_acl_incr_merge() rebuilds the main
+ * trie from all the rules, it is expected to be called from a control
+ * thread, concurrently with the other updates and the lookups.
+ *
+ * Each update publishes a new set of tries atomically. When a RCU QSBR
+ * variable is given at creation time, the old tries are freed only
+ * after all the reader threads have reported a quiescent state, so
+ * rte_acl_incr_classify() can run concurrently with the updates.
+ */
+
+#include <rte_acl.h>
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Parameters used when creating an incremental ACL.
+ */
+struct rte_acl_incr_param {
+	const char *name;          /**< Name of the incremental ACL. */
+	int socket_id;             /**< Socket ID to allocate memory for. */
+	uint32_t rule_size;        /**< Size of each rule. */
+	uint32_t max_rule_num;     /**< Maximum number of rules. */
+	uint32_t max_delta_num;    /**< Max number of rules added to delta. */
+	const struct rte_acl_config *cfg; /**< Build configuration. */
+	struct rte_rcu_qsbr *v;    /**< RCU QSBR variable, can be NULL. */
+};
+
+struct rte_acl_incr;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new incremental ACL.
+ *
+ * @param param
+ *   Parameters used to create and initialise the incremental ACL.
+ *   If param->v is NULL, it is the caller responsibility to make sure
+ *   that no lookups are running while the ACL is updated.
+ * @return
+ *   Pointer to the incremental ACL, or NULL on error,
+ *   with error code set in rte_errno.
+ *   Possible rte_errno errors include:
+ *   - EINVAL - invalid parameter passed to function
+ *   - ENOMEM - no appropriate memory area found
+ */
+__rte_experimental
+struct rte_acl_incr *
+rte_acl_incr_create(const struct rte_acl_incr_param *param);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * De-allocate all memory used by an incremental ACL.
+ * No lookups should be running on it anymore.
+ *
+ * @param ai
+ *   Incremental ACL to free.
+ */
+__rte_experimental
+void
+rte_acl_incr_free(struct rte_acl_incr *ai);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add rules to an incremental ACL.
+ * Rules are added to the delta trie, which is rebuilt and published
+ * before the function returns.
+ * Updates are serialized, this function is multi-thread safe.
+ *
+ * @param ai
+ *   Incremental ACL to add rules to.
+ * @param rules
+ *   Array of rules to add, in the same format as for rte_acl_add_rules().
+ *   The userdata of each rule has to be non zero.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if there is no space in the delta for these rules,
+ *     rte_acl_incr_merge() has to complete before adding more rules.
+ *   - -ENOMEM if there is no space for these rules.
+ *   - Negative error code if the delta build failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_add_rules(struct rte_acl_incr *ai,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from an incremental ACL.
+ * A rule is deleted if all its fields, its priority, category mask
+ * and userdata are equal to the given one.
+ * Rules of the main trie which may match the same input buffers as
+ * a deleted one are copied to the delta trie, which is rebuilt.
+ * Deleted rules stop matching before the function returns: when a RCU
+ * QSBR variable was given at creation time, the function waits for all
+ * the reader threads to report a quiescent state.
+ * Updates are serialized, this function is multi-thread safe.
+ *
+ * @param ai
+ *   Incremental ACL to delete rules from.
+ * @param rules
+ *   Array of rules to delete.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOENT if one of the rules is not found, no rule is deleted then.
+ *   - -ENOMEM if there is no memory for the update.
+ *   - Negative error code if the delta build failed, no rule is deleted
+ *     then.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_del_rules(struct rte_acl_incr *ai,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Rebuild the main trie of an incremental ACL with all its rules,
+ * and empty the delta trie.
+ * The build runs without blocking the other updates and the lookups,
+ * which can proceed concurrently from other threads.
+ *
+ * @param ai
+ *   Incremental ACL to merge.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EBUSY if a merge is already in progress.
+ *   - Negative error code if the build failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_merge(struct rte_acl_incr *ai);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the number of pending rule updates: rules in the delta trie,
+ * and rules deleted but still present in the main trie.
+ * Can be used to decide when to call rte_acl_incr_merge().
+ *
+ * @param ai
+ *   Incremental ACL to query.
+ * @return
+ *   Number of pending rule updates.
+ */
+__rte_experimental
+uint32_t
+rte_acl_incr_pending(const struct rte_acl_incr *ai);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Perform search for a matching rule for each input data buffer,
+ * over both the main and the delta tries.
+ * Same semantics as rte_acl_classify(), the userdata of the rule
+ * with highest priority is returned for each category.
+ *
+ * @param ai
+ *   Incremental ACL to search with.
+ * @param data
+ *   Array of pointers to input data buffers to perform search.
+ *   Note that all fields in input data buffers supposed to be in network
+ *   byte order (MSB).
+ * @param results
+ *   Array of search results, *categories* results per each input data buffer.
+ * @param num
+ *   Number of elements in the input data buffers array.
+ * @param categories
+ *   Number of maximum possible matches for each input buffer, one possible
+ *   match per category.
+ * @return
+ *   zero on successful completion.
+ *   -EINVAL for incorrect arguments.
+ */
+__rte_experimental
+int
+rte_acl_incr_classify(const struct rte_acl_incr *ai, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_ACL_INCR_H_ */
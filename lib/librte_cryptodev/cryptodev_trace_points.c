@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <rte_trace_point_register.h>
+
+#include "rte_cryptodev_trace_fp.h"
+
+RTE_TRACE_POINT_REGISTER(rte_cryptodev_trace_enqueue_burst,
+	lib.cryptodev.enq.burst)
+
+RTE_TRACE_POINT_REGISTER(rte_cryptodev_trace_dequeue_burst,
+	lib.cryptodev.deq.burst)
@@ -0,0 +1,495 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <ctype.h>
+#include <fnmatch.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <regex.h>
+#include <stdlib.h>
+#include <sys/queue.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_per_lcore.h>
+#include <rte_string_fns.h>
+
+#include "eal_trace.h"
+
+RTE_DEFINE_PER_LCORE(void *, trace_mem);
+static RTE_DEFINE_PER_LCORE(struct trace_point *, trace_point_reg);
+static RTE_DEFINE_PER_LCORE(uint32_t, trace_point_sz);
+
+static struct trace_point_head tp_list = STAILQ_HEAD_INITIALIZER(tp_list);
+static struct trace trace = {
+	.args = STAILQ_HEAD_INITIALIZER(trace.args),
+	.lock = RTE_SPINLOCK_INITIALIZER,
+};
+
+struct trace *
+trace_obj_get(void)
+{
+	return &trace;
+}
+
+struct trace_point_head *
+trace_list_head_get(void)
+{
+	return &tp_list;
+}
+
+int
+eal_trace_init(void)
+{
+	struct trace_arg *arg;
+
+	/* Trace memory should start with 8B aligned for natural alignment */
+	RTE_BUILD_BUG_ON((offsetof(struct __rte_trace_header, mem) % 8) != 0);
+
+	/* One of the trace point registration failed */
+	if (trace.register_errno) {
+		rte_errno = trace.register_errno;
+		goto fail;
+	}
+
+	if (trace_has_duplicate_entry())
+		goto fail;
+
+	/* Identify this trace session in the metadata and the streams */
+	trace_uuid_generate();
+
+	/* Apply buffer size configuration for trace output */
+	trace_bufsz_args_apply();
+
+	/* Generate the trace directory name and save the epoch time */
+	if (trace_dir_name_generate() < 0)
+		goto fail;
+
+	if (trace_epoch_time_save() < 0)
+		goto fail;
+
+	/* Apply global configurations */
+	STAILQ_FOREACH(arg, &trace.args, next) {
+		if (trace_args_apply(arg->val) < 0)
+			goto fail;
+	}
+
+	rte_trace_mode_set(trace.mode);
+
+	return 0;
+
+fail:
+	trace_err("failed to initialize trace [%s]", rte_strerror(rte_errno));
+	return -rte_errno;
+}
+
+void
+eal_trace_fini(void)
+{
+	rte_trace_save();
+	trace_mem_free();
+	eal_trace_args_free();
+}
+
+bool
+rte_trace_is_enabled(void)
+{
+	return __atomic_load_n(&trace.status, __ATOMIC_ACQUIRE) != 0;
+}
+
+static void
+trace_mode_set(rte_trace_point_t *t, enum rte_trace_mode mode)
+{
+	if (mode == RTE_TRACE_MODE_OVERWRITE)
+		__atomic_and_fetch(t, ~__RTE_TRACE_FIELD_ENABLE_DISCARD,
+			__ATOMIC_RELEASE);
+	else
+		__atomic_or_fetch(t, __RTE_TRACE_FIELD_ENABLE_DISCARD,
+			__ATOMIC_RELEASE);
+}
+
+void
+rte_trace_mode_set(enum rte_trace_mode mode)
+{
+	struct trace_point *tp;
+
+	STAILQ_FOREACH(tp, &tp_list, next)
+		trace_mode_set(tp->handle, mode);
+
+	trace.mode = mode;
+}
+
+enum
+rte_trace_mode rte_trace_mode_get(void)
+{
+	return trace.mode;
+}
+
+static bool
+trace_point_is_invalid(rte_trace_point_t *t)
+{
+	struct trace_point *tp;
+
+	if (t == NULL)
+		return true;
+
+	STAILQ_FOREACH(tp, &tp_list, next)
+		if (tp->handle == t)
+			return false;
+
+	return true;
+}
+
+int
+rte_trace_point_is_enabled(rte_trace_point_t *t)
+{
+	uint64_t val;
+
+	if (trace_point_is_invalid(t))
+		return 0;
+
+	val = __atomic_load_n(t, __ATOMIC_ACQUIRE);
+	return (val & __RTE_TRACE_FIELD_ENABLE_MASK) != 0;
+}
+
+int
+rte_trace_point_enable(rte_trace_point_t *t)
+{
+	uint64_t prev;
+
+	if (trace_point_is_invalid(t))
+		return -ERANGE;
+
+	prev = __atomic_fetch_or(t, __RTE_TRACE_FIELD_ENABLE_MASK,
+		__ATOMIC_RELEASE);
+	if ((prev & __RTE_TRACE_FIELD_ENABLE_MASK) == 0)
+		__atomic_add_fetch(&trace.status, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+int
+rte_trace_point_disable(rte_trace_point_t *t)
+{
+	uint64_t prev;
+
+	if (trace_point_is_invalid(t))
+		return -ERANGE;
+
+	prev = __atomic_fetch_and(t, ~__RTE_TRACE_FIELD_ENABLE_MASK,
+		__ATOMIC_RELEASE);
+	if ((prev & __RTE_TRACE_FIELD_ENABLE_MASK) != 0)
+		__atomic_sub_fetch(&trace.status, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+int
+rte_trace_pattern(const char *pattern, bool enable)
+{
+	struct trace_point *tp;
+	int rc = 0, found = 0;
+
+	STAILQ_FOREACH(tp, &tp_list, next) {
+		if (fnmatch(pattern, tp->name, 0) == 0) {
+			if (enable)
+				rc = rte_trace_point_enable(tp->handle);
+			else
+				rc = rte_trace_point_disable(tp->handle);
+			found = 1;
+		}
+		if (rc < 0)
+			return rc;
+	}
+
+	return rc | found;
+}
+
+int
+rte_trace_regexp(const char *regex, bool enable)
+{
+	struct trace_point *tp;
+	int rc = 0, found = 0;
+	regex_t r;
+
+	if (regcomp(&r, regex, 0) != 0)
+		return -EINVAL;
+
+	STAILQ_FOREACH(tp, &tp_list, next) {
+		if (regexec(&r, tp->name, 0, NULL, 0) == 0) {
+			if (enable)
+				rc = rte_trace_point_enable(tp->handle);
+			else
+				rc = rte_trace_point_disable(tp->handle);
+			found = 1;
+		}
+		if (rc < 0)
+			break;
+	}
+	regfree(&r);
+
+	return rc < 0 ? rc : found;
+}
+
+rte_trace_point_t *
+rte_trace_point_lookup(const char *name)
+{
+	struct trace_point *tp;
+
+	if (name == NULL)
+		return NULL;
+
+	STAILQ_FOREACH(tp, &tp_list, next)
+		if (strncmp(tp->name, name, TRACE_POINT_NAME_SIZE) == 0)
+			return tp->handle;
+
+	return NULL;
+}
+
+static void
+trace_point_dump(FILE *f, struct trace_point *tp)
+{
+	rte_trace_point_t *handle = tp->handle;
+
+	fprintf(f, "\tid %d, %s, size is %d, %s\n",
+		trace_id_get(handle), tp->name,
+		(uint16_t)(*handle & __RTE_TRACE_FIELD_SIZE_MASK),
+		rte_trace_point_is_enabled(handle) ? "enabled" : "disabled");
+}
+
+static void
+trace_lcore_mem_dump(FILE *f)
+{
+	struct __rte_trace_header *header;
+	uint32_t count;
+
+	if (trace.nb_trace_mem_list == 0)
+		return;
+
+	rte_spinlock_lock(&trace.lock);
+	fprintf(f, "nb_trace_mem_list = %d\n", trace.nb_trace_mem_list);
+	fprintf(f, "\nTrace mem info\n--------------\n");
+	for (count = 0; count < trace.nb_trace_mem_list; count++) {
+		header = trace.lcore_meta[count].mem;
+		fprintf(f, "\tid %d, mem=%p, area=%s, lcore_id=%d, name=%s\n",
+		count, header,
+		trace_area_to_string(trace.lcore_meta[count].area),
+		header->stream_header.lcore_id,
+		header->stream_header.thread_name);
+	}
+	rte_spinlock_unlock(&trace.lock);
+}
+
+void
+rte_trace_dump(FILE *f)
+{
+	struct trace_point *tp;
+
+	fprintf(f, "\nGlobal info\n-----------\n");
+	fprintf(f, "status = %s\n",
+		rte_trace_is_enabled() ? "enabled" : "disabled");
+	fprintf(f, "mode = %s\n",
+		trace_mode_to_string(rte_trace_mode_get()));
+	fprintf(f, "dir = %s\n", trace.dir);
+	fprintf(f, "buffer len = %d\n", trace.buff_len);
+	fprintf(f, "number of trace points = %d\n", trace.nb_trace_points);
+
+	trace_lcore_mem_dump(f);
+	fprintf(f, "\nTrace point info\n----------------\n");
+	STAILQ_FOREACH(tp, &tp_list, next)
+		trace_point_dump(f, tp);
+}
+
+void
+__rte_trace_mem_per_thread_alloc(void)
+{
+	struct __rte_trace_header *header;
+	struct thread_mem_meta *meta;
+	uint32_t count;
+	char *name;
+
+	if (!rte_trace_is_enabled())
+		return;
+
+	if (RTE_PER_LCORE(trace_mem))
+		return;
+
+	rte_spinlock_lock(&trace.lock);
+
+	count = trace.nb_trace_mem_list;
+
+	/* Allocate room for storing the thread trace mem meta */
+	meta = realloc(trace.lcore_meta, sizeof(*meta) * (count + 1));
+	if (meta == NULL) {
+		trace_crit("trace mem meta memory realloc failed");
+		header = NULL;
+		goto fail;
+	}
+	trace.lcore_meta = meta;
+
+	/* First attempt from huge page */
+	header = rte_malloc(NULL, trace_mem_sz(trace.buff_len), 8);
+	if (header) {
+		trace.lcore_meta[count].area = TRACE_AREA_HUGEPAGE;
+		goto found;
+	}
+
+	/* Second attempt from heap */
+	header = malloc(trace_mem_sz(trace.buff_len));
+	if (header == NULL) {
+		trace_crit("trace mem malloc attempt failed");
+		header = NULL;
+		goto fail;
+	}
+
+	/* Second attempt from heap is success */
+	trace.lcore_meta[count].area = TRACE_AREA_HEAP;
+
+	/* Initialize the trace header */
+found:
+	header->offset = 0;
+	header->len = trace.buff_len;
+	header->stream_header.magic = TRACE_CTF_MAGIC;
+	rte_uuid_copy(header->stream_header.uuid, trace.uuid);
+	header->stream_header.lcore_id = rte_lcore_id();
+
+	/* Store the thread name */
+	name = header->stream_header.thread_name;
+	memset(name, 0, __RTE_TRACE_EMIT_STRING_LEN_MAX);
+	if (rte_lcore_id() != LCORE_ID_ANY)
+		snprintf(name, __RTE_TRACE_EMIT_STRING_LEN_MAX, "lcore-%u",
+			rte_lcore_id());
+	else
+		snprintf(name, __RTE_TRACE_EMIT_STRING_LEN_MAX,
+			"thread-%" PRIxPTR, (uintptr_t)pthread_self());
+
+	trace.lcore_meta[count].mem = header;
+	trace.nb_trace_mem_list++;
+fail:
+	RTE_PER_LCORE(trace_mem) = header;
+	rte_spinlock_unlock(&trace.lock);
+}
+
+void
+trace_mem_free(void)
+{
+	uint32_t count;
+
+	rte_spinlock_lock(&trace.lock);
+	for (count = 0; count < trace.nb_trace_mem_list; count++) {
+		if (trace.lcore_meta[count].area == TRACE_AREA_HUGEPAGE)
+			rte_free(trace.lcore_meta[count].mem);
+		else
+			free(trace.lcore_meta[count].mem);
+	}
+	free(trace.lcore_meta);
+	trace.lcore_meta = NULL;
+	trace.nb_trace_mem_list = 0;
+	RTE_PER_LCORE(trace_mem) = NULL;
+	rte_spinlock_unlock(&trace.lock);
+}
+
+void
+__rte_trace_point_emit_field(size_t sz, const char *in, const char *datatype)
+{
+	struct trace_point *tp = RTE_PER_LCORE(trace_point_reg);
+	char field[TRACE_POINT_NAME_SIZE];
+	size_t len, i;
+	int rc;
+
+	if (tp == NULL)
+		return;
+
+	/* CTF field names are C identifiers, with an optional array size */
+	strlcpy(field, in, sizeof(field));
+	for (i = 0; field[i] != '\0'; i++) {
+		if (!isalnum(field[i]) && field[i] != '_' &&
+				field[i] != '[' && field[i] != ']')
+			field[i] = '_';
+	}
+
+	len = strlen(tp->ctf_field);
+	rc = snprintf(tp->ctf_field + len, sizeof(tp->ctf_field) - len,
+		"        %s %s;\n", datatype, field);
+	if (rc < 0 || (size_t)rc >= sizeof(tp->ctf_field) - len) {
+		trace.register_errno = ENOSPC;
+		return;
+	}
+
+	RTE_PER_LCORE(trace_point_sz) += sz;
+}
+
+int
+__rte_trace_point_register(rte_trace_point_t *handle, const char *name,
+		void (*register_fn)(void))
+{
+	struct trace_point *tp;
+	uint32_t sz;
+
+	/* Sanity checks of arguments */
+	if (name == NULL || register_fn == NULL || handle == NULL) {
+		trace_err("invalid arguments");
+		rte_errno = EINVAL;
+		goto fail;
+	}
+
+	/* Check the size of the trace point name */
+	if (strlen(name) >= TRACE_POINT_NAME_SIZE) {
+		trace_err("name is too long %s", name);
+		rte_errno = ENAMETOOLONG;
+		goto fail;
+	}
+
+	/* Are we running out of space to store trace points? */
+	if (trace.nb_trace_points >= UINT16_MAX) {
+		trace_err("too many trace points");
+		rte_errno = ENOSPC;
+		goto fail;
+	}
+
+	/* Allocate the trace point object */
+	tp = calloc(1, sizeof(struct trace_point));
+	if (tp == NULL) {
+		trace_err("fail to allocate trace point memory");
+		rte_errno = ENOMEM;
+		goto fail;
+	}
+
+	/* Describe the payload by calling the function in register mode */
+	RTE_PER_LCORE(trace_point_reg) = tp;
+	RTE_PER_LCORE(trace_point_sz) = 0;
+	register_fn();
+	RTE_PER_LCORE(trace_point_reg) = NULL;
+
+	/* Event header and payload, aligned for the next event header */
+	sz = RTE_ALIGN_CEIL(__RTE_TRACE_EVENT_HEADER_SZ +
+		RTE_PER_LCORE(trace_point_sz), sizeof(uint64_t));
+	if (sz > UINT16_MAX) {
+		trace_err("payload of %s is too large", name);
+		free(tp);
+		rte_errno = E2BIG;
+		goto fail;
+	}
+
+	/* Initialize the trace point */
+	strlcpy(tp->name, name, TRACE_POINT_NAME_SIZE);
+
+	/* Form the trace handle */
+	*handle = sz;
+	*handle |= (uint64_t)trace.nb_trace_points <<
+		__RTE_TRACE_FIELD_ID_SHIFT;
+
+	trace.nb_trace_points++;
+	tp->handle = handle;
+
+	/* Add the trace point at tail */
+	STAILQ_INSERT_TAIL(&tp_list, tp, next);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	return 0;
+fail:
+	if (trace.register_errno == 0)
+		trace.register_errno = rte_errno;
+
+	return -rte_errno;
+}
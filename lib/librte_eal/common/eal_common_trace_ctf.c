@@ -0,0 +1,150 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_time.h>
+#include <rte_uuid.h>
+#include <rte_version.h>
+
+#include "eal_trace.h"
+
+/* CTF 1.8 metadata describing the trace streams */
+#define CTF_META_TYPES \
+"/* CTF 1.8 */\n" \
+"typealias integer {size = 8; base = x;}:= uint8_t;\n" \
+"typealias integer {size = 16; base = x;} := uint16_t;\n" \
+"typealias integer {size = 32; base = x;} := uint32_t;\n" \
+"typealias integer {size = 64; base = x;} := uint64_t;\n" \
+"typealias integer {size = 8; signed = true;} := int8_t;\n" \
+"typealias integer {size = 16; signed = true;} := int16_t;\n" \
+"typealias integer {size = 32; signed = true;} := int32_t;\n" \
+"typealias integer {size = 64; signed = true;} := int64_t;\n" \
+"typealias integer {size = %u; base = x;} := uintptr_t;\n" \
+"typealias integer {size = %u; signed = true;} := long;\n" \
+"typealias integer {size = 8; signed = false; encoding = ASCII; } := " \
+	"string_bounded_t;\n\n" \
+"typealias floating_point {\n" \
+"    exp_dig = 8;\n" \
+"    mant_dig = 24;\n" \
+"} := float;\n\n" \
+"typealias floating_point {\n" \
+"    exp_dig = 11;\n" \
+"    mant_dig = 53;\n" \
+"} := double;\n\n"
+
+#define CTF_META_TRACE \
+"trace {\n" \
+"    major = 1;\n" \
+"    minor = 8;\n" \
+"    uuid = \"%s\";\n" \
+"    byte_order = %s;\n" \
+"    packet.header := struct {\n" \
+"        uint32_t magic;\n" \
+"        uint8_t  uuid[16];\n" \
+"    };\n" \
+"};\n\n" \
+"env {\n" \
+"    dpdk_version = \"%s\";\n" \
+"    tracer_name = \"dpdk\";\n" \
+"};\n\n"
+
+#define CTF_META_CLOCK \
+"clock {\n" \
+"    name = \"dpdk\";\n" \
+"    freq = %" PRIu64 ";\n" \
+"    offset_s = %" PRIu64 ";\n" \
+"    offset = %" PRIu64 ";\n" \
+"};\n\n" \
+"typealias integer {\n" \
+"    size = 48; align = 1; signed = false;\n" \
+"    map = clock.dpdk.value;\n" \
+"} := uint48_clock_dpdk_t;\n\n"
+
+/*
+ * The event header is written as a single 64-bit word: the timestamp in
+ * the 48 low order bits and the event id in the 16 high order bits. CTF
+ * lays out bit fields from the least significant bit on little endian
+ * and from the most significant bit on big endian targets.
+ */
+static const char ctf_meta_stream[] =
+"struct event_header {\n"
+#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
+"    uint48_clock_dpdk_t timestamp;\n"
+"    uint16_t id;\n"
+#else
+"    uint16_t id;\n"
+"    uint48_clock_dpdk_t timestamp;\n"
+#endif
+"} align(64);\n\n"
+"stream {\n"
+"    packet.context := struct {\n"
+"        uint32_t cpu_id;\n"
+"        string_bounded_t name[" RTE_STR(__RTE_TRACE_EMIT_STRING_LEN_MAX)
+	"];\n"
+"    };\n"
+"    event.header := struct event_header;\n"
+"};\n\n";
+
+#define CTF_META_EVENT \
+"event {\n" \
+"    id = %d;\n" \
+"    name = \"%s\";\n" \
+"    fields := struct {\n" \
+"%s" \
+"    };\n" \
+"};\n\n"
+
+int
+trace_metadata_save(FILE *f)
+{
+	struct trace_point_head *tp_list = trace_list_head_get();
+	struct trace *trace = trace_obj_get();
+	char uustr[RTE_UUID_STRLEN];
+	struct trace_point *tp;
+	uint64_t hz, uptime_ns, epoch_ns, offset_s, offset;
+
+	rte_uuid_unparse(trace->uuid, uustr, sizeof(uustr));
+
+	/*
+	 * The clock counts TSC cycles: its origin is the epoch time saved at
+	 * init minus the corresponding number of cycles.
+	 */
+	hz = rte_get_tsc_hz();
+	uptime_ns = (trace->uptime_ticks / hz) * NSEC_PER_SEC +
+		((trace->uptime_ticks % hz) * NSEC_PER_SEC) / hz;
+	epoch_ns = trace->epoch_sec * NSEC_PER_SEC + trace->epoch_nsec;
+	offset_s = (epoch_ns - uptime_ns) / NSEC_PER_SEC;
+	offset = ((epoch_ns - uptime_ns) % NSEC_PER_SEC) * hz / NSEC_PER_SEC;
+
+	if (fprintf(f, CTF_META_TYPES, (unsigned int)sizeof(uintptr_t) * 8,
+			(unsigned int)sizeof(long) * 8) < 0)
+		goto fail;
+
+	if (fprintf(f, CTF_META_TRACE, uustr,
+			RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN ? "le" : "be",
+			rte_version()) < 0)
+		goto fail;
+
+	if (fprintf(f, CTF_META_CLOCK, hz, offset_s, offset) < 0)
+		goto fail;
+
+	if (fputs(ctf_meta_stream, f) < 0)
+		goto fail;
+
+	STAILQ_FOREACH(tp, tp_list, next) {
+		if (fprintf(f, CTF_META_EVENT, trace_id_get(tp->handle),
+				tp->name, tp->ctf_field) < 0)
+			goto fail;
+	}
+
+	return 0;
+fail:
+	trace_err("failed to write the trace metadata");
+	return -EIO;
+}
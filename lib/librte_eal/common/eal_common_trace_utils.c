@@ -0,0 +1,406 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_string_fns.h>
+
+#include "eal_filesystem.h"
+#include "eal_trace.h"
+
+const char *
+trace_mode_to_string(enum rte_trace_mode mode)
+{
+	switch (mode) {
+	case RTE_TRACE_MODE_OVERWRITE: return "overwrite";
+	case RTE_TRACE_MODE_DISCARD: return "discard";
+	default: return "unknown";
+	}
+}
+
+const char *
+trace_area_to_string(enum trace_area_e area)
+{
+	switch (area) {
+	case TRACE_AREA_HEAP: return "heap";
+	case TRACE_AREA_HUGEPAGE: return "hugepage";
+	default: return "unknown";
+	}
+}
+
+bool
+trace_has_duplicate_entry(void)
+{
+	struct trace_point_head *tp_list = trace_list_head_get();
+	struct trace_point *tp, *tmp;
+	int count;
+
+	/* Is duplicate trace name registered */
+	STAILQ_FOREACH(tp, tp_list, next) {
+		count = 0;
+		STAILQ_FOREACH(tmp, tp_list, next) {
+			if (strncmp(tp->name, tmp->name,
+					TRACE_POINT_NAME_SIZE) == 0)
+				count++;
+		}
+		if (count > 1) {
+			trace_err("found duplicate entry %s", tp->name);
+			rte_errno = EEXIST;
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+trace_uuid_generate(void)
+{
+	struct trace_point_head *tp_list = trace_list_head_get();
+	struct trace *trace = trace_obj_get();
+	struct trace_point *tp;
+	uint64_t sz_total = 0;
+	uint64_t tsc = rte_get_tsc_cycles();
+	uint32_t pid = getpid();
+
+	/* Go over the registered trace points to get total size of events */
+	STAILQ_FOREACH(tp, tp_list, next) {
+		const uint16_t sz = *tp->handle & __RTE_TRACE_FIELD_SIZE_MASK;
+		sz_total += sz;
+	}
+
+	/* Random UUID (version 4, variant 1) built from the session data */
+	memcpy(&trace->uuid[0], &tsc, sizeof(tsc));
+	memcpy(&trace->uuid[8], &pid, sizeof(pid));
+	trace->uuid[12] = sz_total & 0xff;
+	trace->uuid[13] = (sz_total >> 8) & 0xff;
+	trace->uuid[14] = trace->nb_trace_points & 0xff;
+	trace->uuid[15] = (trace->nb_trace_points >> 8) & 0xff;
+	trace->uuid[6] = (trace->uuid[6] & 0x0f) | 0x40;
+	trace->uuid[8] = (trace->uuid[8] & 0x3f) | 0x80;
+}
+
+static int
+trace_session_name_generate(char *trace_dir)
+{
+	struct tm *tm_result;
+	time_t tm;
+	int rc;
+
+	tm = time(NULL);
+	if (tm == (time_t)-1)
+		goto fail;
+
+	tm_result = localtime(&tm);
+	if (tm_result == NULL)
+		goto fail;
+
+	rc = rte_strscpy(trace_dir, eal_get_hugefile_prefix(),
+			TRACE_PREFIX_LEN);
+	if (rc == -E2BIG)
+		rc = TRACE_PREFIX_LEN - 1;
+	trace_dir[rc++] = '-';
+
+	rc = strftime(trace_dir + rc, TRACE_DIR_STR_LEN - rc,
+			"%Y-%m-%d-%p-%I-%M-%S", tm_result);
+	if (rc == 0)
+		goto fail;
+
+	return rc;
+fail:
+	rte_errno = errno;
+	return -rte_errno;
+}
+
+int
+eal_trace_args_save(const char *val)
+{
+	struct trace *trace = trace_obj_get();
+	struct trace_arg *arg = malloc(sizeof(*arg));
+
+	if (arg == NULL) {
+		trace_err("failed to allocate memory for %s", val);
+		return -ENOMEM;
+	}
+
+	arg->val = strdup(val);
+	if (arg->val == NULL) {
+		trace_err("failed to allocate memory for %s", val);
+		free(arg);
+		return -ENOMEM;
+	}
+
+	STAILQ_INSERT_TAIL(&trace->args, arg, next);
+	return 0;
+}
+
+void
+eal_trace_args_free(void)
+{
+	struct trace *trace = trace_obj_get();
+	struct trace_arg *arg;
+
+	while (!STAILQ_EMPTY(&trace->args)) {
+		arg = STAILQ_FIRST(&trace->args);
+		STAILQ_REMOVE_HEAD(&trace->args, next);
+		free(arg->val);
+		free(arg);
+	}
+}
+
+int
+trace_args_apply(const char *arg)
+{
+	if (rte_trace_regexp(arg, true) < 0) {
+		trace_err("cannot enable trace for %s", arg);
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+eal_trace_bufsz_args_save(char const *val)
+{
+	struct trace *trace = trace_obj_get();
+	uint64_t bufsz;
+
+	bufsz = rte_str_to_size(val);
+	if (bufsz == 0 ||
+			bufsz > UINT32_MAX - sizeof(struct __rte_trace_header)) {
+		trace_err("buffer size cannot be %s", val);
+		return -EINVAL;
+	}
+
+	trace->buff_len = bufsz;
+	return 0;
+}
+
+void
+trace_bufsz_args_apply(void)
+{
+	struct trace *trace = trace_obj_get();
+
+	if (trace->buff_len == 0)
+		trace->buff_len = TRACE_BUFF_LEN_DEFAULT;
+}
+
+int
+eal_trace_mode_args_save(const char *val)
+{
+	struct trace *trace = trace_obj_get();
+	size_t len = strlen(val);
+
+	if (len == 0) {
+		trace_err("value is not provided with option");
+		return -EINVAL;
+	}
+
+	if (strncmp(val, "overwrite", len) == 0)
+		trace->mode = RTE_TRACE_MODE_OVERWRITE;
+	else if (strncmp(val, "discard", len) == 0)
+		trace->mode = RTE_TRACE_MODE_DISCARD;
+	else {
+		trace_err("invalid value %s", val);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int
+eal_trace_dir_args_save(char const *val)
+{
+	struct trace *trace = trace_obj_get();
+	size_t len = strlen(val);
+
+	if (len == 0) {
+		trace_err("value is not provided with option");
+		return -EINVAL;
+	}
+
+	if (len + TRACE_DIR_STR_LEN + 1 >= sizeof(trace->dir)) {
+		trace_err("input string is too big");
+		return -ENAMETOOLONG;
+	}
+
+	snprintf(trace->dir, sizeof(trace->dir), "%s/", val);
+	trace->dir_offset = strlen(trace->dir);
+	return 0;
+}
+
+int
+trace_epoch_time_save(void)
+{
+	struct trace *trace = trace_obj_get();
+	struct timespec epoch = { 0, 0 };
+	uint64_t avg, start, end;
+
+	start = rte_get_tsc_cycles();
+	if (clock_gettime(CLOCK_REALTIME, &epoch) < 0) {
+		trace_err("failed to get the epoch time");
+		return -1;
+	}
+	end = rte_get_tsc_cycles();
+	avg = (start + end) >> 1;
+
+	trace->epoch_sec = (uint64_t) epoch.tv_sec;
+	trace->epoch_nsec = (uint64_t) epoch.tv_nsec;
+	trace->uptime_ticks = avg;
+
+	return 0;
+}
+
+int
+trace_dir_name_generate(void)
+{
+	struct trace *trace = trace_obj_get();
+	char session[TRACE_DIR_STR_LEN];
+	const char *home;
+	int rc;
+
+	rc = trace_session_name_generate(session);
+	if (rc < 0)
+		return rc;
+
+	/* Default base directory is $HOME/dpdk-traces/ */
+	if (trace->dir_offset == 0) {
+		home = getenv("HOME");
+		if (home == NULL) {
+			trace_err("failed to find the HOME directory");
+			rte_errno = ENOENT;
+			return -rte_errno;
+		}
+		rc = snprintf(trace->dir, sizeof(trace->dir),
+			"%s/dpdk-traces/", home);
+		if (rc < 0 || rc + TRACE_DIR_STR_LEN >= sizeof(trace->dir)) {
+			trace_err("HOME directory path is too long");
+			rte_errno = ENAMETOOLONG;
+			return -rte_errno;
+		}
+		trace->dir_offset = rc;
+	}
+
+	/* Append the session name, the directory is created on save */
+	strlcat(trace->dir, session, sizeof(trace->dir));
+	return 0;
+}
+
+static int
+trace_mkdir(const char *dir)
+{
+	if (mkdir(dir, 0700) < 0 && errno != EEXIST) {
+		trace_err("mkdir %s failed [%s]", dir, strerror(errno));
+		rte_errno = errno;
+		return -rte_errno;
+	}
+
+	return 0;
+}
+
+static int
+trace_dir_create(void)
+{
+	struct trace *trace = trace_obj_get();
+	char base[PATH_MAX];
+	int rc;
+
+	/* Create the base directory, then the session directory */
+	strlcpy(base, trace->dir, RTE_MIN((size_t)trace->dir_offset + 1,
+		sizeof(base)));
+	rc = trace_mkdir(base);
+	if (rc < 0)
+		return rc;
+
+	return trace_mkdir(trace->dir);
+}
+
+static int
+trace_meta_save(struct trace *trace)
+{
+	char file_name[PATH_MAX];
+	FILE *f;
+	int rc;
+
+	rc = snprintf(file_name, PATH_MAX, "%s/metadata", trace->dir);
+	if (rc < 0)
+		return rc;
+
+	f = fopen(file_name, "w");
+	if (f == NULL)
+		return -errno;
+
+	rc = trace_metadata_save(f);
+	if (fclose(f) != 0 && rc == 0)
+		rc = -errno;
+
+	return rc;
+}
+
+static int
+trace_mem_save(struct trace *trace, struct __rte_trace_header *hdr,
+		uint32_t cnt)
+{
+	char file_name[PATH_MAX];
+	FILE *f;
+	size_t sz;
+	int rc = 0;
+
+	rc = snprintf(file_name, PATH_MAX, "%s/channel0_%d", trace->dir, cnt);
+	if (rc < 0)
+		return rc;
+
+	f = fopen(file_name, "w");
+	if (f == NULL)
+		return -errno;
+
+	/* The stream header is the CTF packet header and context */
+	sz = sizeof(hdr->stream_header) + hdr->offset;
+	if (fwrite(&hdr->stream_header, sz, 1, f) != 1) {
+		trace_err("failed to write %s", file_name);
+		rc = -EIO;
+	}
+
+	if (fclose(f) != 0 && rc == 0)
+		rc = -errno;
+
+	return rc;
+}
+
+int
+rte_trace_save(void)
+{
+	struct trace *trace = trace_obj_get();
+	struct __rte_trace_header *header;
+	uint32_t count;
+	int rc = 0;
+
+	if (trace->nb_trace_mem_list == 0)
+		return rc;
+
+	rc = trace_dir_create();
+	if (rc < 0)
+		return rc;
+
+	rc = trace_meta_save(trace);
+	if (rc)
+		return rc;
+
+	rte_spinlock_lock(&trace->lock);
+	for (count = 0; count < trace->nb_trace_mem_list; count++) {
+		header = trace->lcore_meta[count].mem;
+		rc = trace_mem_save(trace, header, count);
+		if (rc)
+			break;
+	}
+	rte_spinlock_unlock(&trace->lock);
+	return rc;
+}
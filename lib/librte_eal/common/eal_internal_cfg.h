@@ -61,6 +61,8 @@ struct internal_config {
 	 */
 	volatile unsigned match_allocations;
 	/**< true to free hugepages exactly as allocated */
+	volatile unsigned malloc_lcore_cache;
+	/**< true to cache small rte_malloc objects per lcore */
 	volatile unsigned single_file_segments;
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
@@ -69,6 +69,16 @@ enum {
 	OPT_IOVA_MODE_NUM,
 #define OPT_MATCH_ALLOCATIONS  "match-allocations"
 	OPT_MATCH_ALLOCATIONS_NUM,
+#define OPT_MALLOC_LCORE_CACHE "malloc-lcore-cache"
+	OPT_MALLOC_LCORE_CACHE_NUM,
+#define OPT_TRACE              "trace"
+	OPT_TRACE_NUM,
+#define OPT_TRACE_DIR          "trace-dir"
+	OPT_TRACE_DIR_NUM,
+#define OPT_TRACE_BUF_SIZE     "trace-bufsz"
+	OPT_TRACE_BUF_SIZE_NUM,
+#define OPT_TRACE_MODE         "trace-mode"
+	OPT_TRACE_MODE_NUM,
 	OPT_LONG_MAX_NUM
 };
 
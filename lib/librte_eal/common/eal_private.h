@@ -374,6 +374,13 @@ rte_option_parse(const char *opt);
 void
 rte_option_init(void);
 
+/**
+ * Iterate through the registered options and execute the associated
+ * cleanup callback, if any.
+ */
+void
+rte_option_cleanup(void);
+
 /**
  * Iterate through the registered options and show the associated
  * usage string.
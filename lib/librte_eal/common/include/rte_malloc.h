@@ -254,6 +254,25 @@ rte_calloc_socket(const char *type, size_t num, size_t size, unsigned align, int
 void
 rte_free(void *ptr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Give the memory cached by the calling lcore back to the heap.
+ *
+ * When the EAL option --malloc-lcore-cache is used, each lcore keeps a
+ * cache of small freed objects, to serve small allocations without taking
+ * the heap lock. The objects are given back to the heap in batches when
+ * the cache is full. This function empties the cache of the calling lcore,
+ * e.g. before it stops allocating memory.
+ *
+ * The function does nothing if the cache is disabled, or when called from
+ * a non-EAL thread.
+ */
+__rte_experimental
+void
+rte_malloc_lcore_cache_flush(void);
+
 /**
  * If malloc debug is enabled, check a memory block for header
  * and trailer markers to indicate that all is well with the block.
@@ -42,6 +42,10 @@ struct rte_option {
 	const char *usage; /**< Option summary string. */
 	rte_option_cb cb;          /**< Function called when option is used. */
 	int enabled;               /**< Set when the option is used. */
+	/** Function called by rte_eal_cleanup(), whether the option was used
+	 * or not, can be NULL.
+	 */
+	rte_option_cb cleanup;
 };
 
 /**
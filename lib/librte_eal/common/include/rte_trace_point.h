@@ -0,0 +1,406 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#ifndef _RTE_TRACE_POINT_H_
+#define _RTE_TRACE_POINT_H_
+
+/**
+ * @file
+ *
+ * RTE Tracepoint API
+ *
+ * This file provides the tracepoint API to RTE applications and libraries.
+ *
+ * A tracepoint is declared with RTE_TRACE_POINT() in a header file, which
+ * creates an inline function emitting the tracepoint payload, and is
+ * registered with RTE_TRACE_POINT_REGISTER() in exactly one C file which
+ * includes rte_trace_point_register.h first.
+ *
+ * When a tracepoint is disabled, calling it costs a load and a branch.
+ * When enabled, the payload is copied into a per-thread buffer, without
+ * any lock nor atomic operation.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_cycles.h>
+#include <rte_per_lcore.h>
+#include <rte_string_fns.h>
+
+/** The tracepoint object. */
+typedef uint64_t rte_trace_point_t;
+
+/**
+ * Macro to define the tracepoint arguments in RTE_TRACE_POINT macro.
+ *
+ * @see RTE_TRACE_POINT
+ */
+#define RTE_TRACE_POINT_ARGS
+
+/** @internal Helper macro to support RTE_TRACE_POINT */
+#define __RTE_TRACE_POINT(tp, args, ...) \
+extern rte_trace_point_t __##tp; \
+static __rte_always_inline void \
+tp args \
+{ \
+	__rte_trace_point_emit_header_generic(&__##tp); \
+	__VA_ARGS__ \
+}
+
+/**
+ * Create a tracepoint.
+ *
+ * A tracepoint is defined by specifying:
+ * - its input arguments: they are the C function style parameters to define
+ *   the arguments of tracepoint function. These input arguments are embedded
+ *   using the RTE_TRACE_POINT_ARGS macro.
+ * - its output event fields: they are the sources of event fields that form
+ *   the payload of any event that the execution of the tracepoint macro
+ *   emits for this particular tracepoint. The application uses
+ *   rte_trace_point_emit_* macros to emit the output event fields.
+ *
+ * @param tp
+ *   Tracepoint object. Before using the tracepoint, an application needs to
+ *   define the tracepoint using RTE_TRACE_POINT_REGISTER macro.
+ * @param args
+ *   C function style input arguments to define the arguments to tracepoint
+ *   function.
+ * @param ...
+ *   Define the payload of trace function. The payload will be formed using
+ *   rte_trace_point_emit_* macros. Use ";" delimiter between two payloads.
+ *
+ * @see RTE_TRACE_POINT_ARGS, RTE_TRACE_POINT_REGISTER, rte_trace_point_emit_*
+ */
+#define RTE_TRACE_POINT(tp, args, ...) \
+	__RTE_TRACE_POINT(tp, args, __VA_ARGS__)
+
+#ifdef __DOXYGEN__
+
+/**
+ * Register a tracepoint.
+ *
+ * Defines the tracepoint object and registers it at constructor time.
+ * This macro is only available in a C file which includes
+ * rte_trace_point_register.h before any tracepoint header.
+ *
+ * @param trace
+ *   The tracepoint object created using RTE_TRACE_POINT.
+ * @param name
+ *   The name of the tracepoint object, in the "lib.<library>.<event>" form.
+ *   It is used to enable tracepoints with rte_trace_regexp() or
+ *   rte_trace_pattern() and to identify the events in the trace viewer.
+ */
+#define RTE_TRACE_POINT_REGISTER(trace, name)
+
+/** Tracepoint function payload for uint64_t datatype */
+#define rte_trace_point_emit_u64(val)
+/** Tracepoint function payload for int64_t datatype */
+#define rte_trace_point_emit_i64(val)
+/** Tracepoint function payload for uint32_t datatype */
+#define rte_trace_point_emit_u32(val)
+/** Tracepoint function payload for int32_t datatype */
+#define rte_trace_point_emit_i32(val)
+/** Tracepoint function payload for uint16_t datatype */
+#define rte_trace_point_emit_u16(val)
+/** Tracepoint function payload for int16_t datatype */
+#define rte_trace_point_emit_i16(val)
+/** Tracepoint function payload for uint8_t datatype */
+#define rte_trace_point_emit_u8(val)
+/** Tracepoint function payload for int8_t datatype */
+#define rte_trace_point_emit_i8(val)
+/** Tracepoint function payload for int datatype */
+#define rte_trace_point_emit_int(val)
+/** Tracepoint function payload for long datatype */
+#define rte_trace_point_emit_long(val)
+/** Tracepoint function payload for float datatype */
+#define rte_trace_point_emit_float(val)
+/** Tracepoint function payload for double datatype */
+#define rte_trace_point_emit_double(val)
+/** Tracepoint function payload for pointer datatype */
+#define rte_trace_point_emit_ptr(val)
+/** Tracepoint function payload for string datatype */
+#define rte_trace_point_emit_string(val)
+
+#endif /* __DOXYGEN__ */
+
+/** @internal Macro to define maximum emit length of string datatype. */
+#define __RTE_TRACE_EMIT_STRING_LEN_MAX 32
+/** @internal Macro to define event header size. */
+#define __RTE_TRACE_EVENT_HEADER_SZ sizeof(uint64_t)
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable recording events of the given tracepoint in the trace buffer.
+ *
+ * @param tp
+ *   The tracepoint object to enable.
+ * @return
+ *   - 0: Success.
+ *   - (-ERANGE): Trace object is not registered.
+ */
+__rte_experimental
+int rte_trace_point_enable(rte_trace_point_t *tp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Disable recording events of the given tracepoint in the trace buffer.
+ *
+ * @param tp
+ *   The tracepoint object to disable.
+ * @return
+ *   - 0: Success.
+ *   - (-ERANGE): Trace object is not registered.
+ */
+__rte_experimental
+int rte_trace_point_disable(rte_trace_point_t *tp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Test if recording events from the given tracepoint is enabled.
+ *
+ * @param tp
+ *    The tracepoint object.
+ * @return
+ *    1 if tracepoint is enabled, 0 otherwise.
+ */
+__rte_experimental
+int rte_trace_point_is_enabled(rte_trace_point_t *tp);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Lookup a tracepoint object from its name.
+ *
+ * @param name
+ *   The name of the tracepoint.
+ * @return
+ *   The tracepoint object or NULL if not found.
+ */
+__rte_experimental
+rte_trace_point_t *rte_trace_point_lookup(const char *name);
+
+/**
+ * @internal
+ *
+ * Allocate the trace buffer of the calling thread, on the first event
+ * emitted by this thread.
+ */
+__rte_experimental
+void __rte_trace_mem_per_thread_alloc(void);
+
+/**
+ * @internal
+ *
+ * Helper function to emit a field of a tracepoint while registering it.
+ *
+ * @param sz
+ *   The size of the field.
+ * @param field
+ *   The name of the field.
+ * @param type
+ *   The CTF type of the field.
+ */
+__rte_experimental
+void __rte_trace_point_emit_field(size_t sz, const char *field,
+	const char *type);
+
+/**
+ * @internal
+ *
+ * Helper function to register a tracepoint.
+ *
+ * @param trace
+ *   The tracepoint object created using RTE_TRACE_POINT.
+ * @param name
+ *   The name of the tracepoint object.
+ * @param register_fn
+ *   The tracepoint function, called in registration mode.
+ * @return
+ *   - 0: Successfully registered the tracepoint.
+ *   - <0: Failure to register the tracepoint.
+ */
+__rte_experimental
+int __rte_trace_point_register(rte_trace_point_t *trace, const char *name,
+	void (*register_fn)(void));
+
+/** @internal Tracepoint handle layout: payload size, id and status bits. */
+#define __RTE_TRACE_FIELD_SIZE_SHIFT 0
+#define __RTE_TRACE_FIELD_SIZE_MASK (0xffffULL << __RTE_TRACE_FIELD_SIZE_SHIFT)
+#define __RTE_TRACE_FIELD_ID_SHIFT (16)
+#define __RTE_TRACE_FIELD_ID_MASK (0xffffULL << __RTE_TRACE_FIELD_ID_SHIFT)
+#define __RTE_TRACE_FIELD_ENABLE_MASK (1ULL << 63)
+#define __RTE_TRACE_FIELD_ENABLE_DISCARD (1ULL << 62)
+
+/** @internal Event header layout: 48-bit timestamp, 16-bit event id. */
+#define __RTE_TRACE_EVENT_HEADER_ID_SHIFT (48)
+#define __RTE_TRACE_EVENT_HEADER_TS_MASK \
+	((1ULL << __RTE_TRACE_EVENT_HEADER_ID_SHIFT) - 1)
+
+/** @internal Packet header of each per-thread trace stream. */
+struct __rte_trace_stream_header {
+	uint32_t magic;
+	uint8_t uuid[16];
+	uint32_t lcore_id;
+	char thread_name[__RTE_TRACE_EMIT_STRING_LEN_MAX];
+} __rte_packed;
+
+/** @internal Per-thread trace buffer. */
+struct __rte_trace_header {
+	uint32_t offset;
+	uint32_t len;
+	struct __rte_trace_stream_header stream_header;
+	uint8_t mem[];
+};
+
+RTE_DECLARE_PER_LCORE(void *, trace_mem);
+
+#ifndef RTE_TRACE_POINT_REGISTER_SELECT
+
+#ifdef ALLOW_EXPERIMENTAL_API
+
+static __rte_always_inline void *
+__rte_trace_mem_get(uint64_t in)
+{
+	struct __rte_trace_header *trace = RTE_PER_LCORE(trace_mem);
+	const uint16_t sz = in & __RTE_TRACE_FIELD_SIZE_MASK;
+	void *mem;
+
+	/* Trace memory is not initialized for this thread */
+	if (unlikely(trace == NULL)) {
+		__rte_trace_mem_per_thread_alloc();
+		trace = RTE_PER_LCORE(trace_mem);
+		if (unlikely(trace == NULL))
+			return NULL;
+	}
+	/* Check the wrap around case */
+	if (unlikely(trace->offset + sz > trace->len)) {
+		if (unlikely(in & __RTE_TRACE_FIELD_ENABLE_DISCARD))
+			return NULL;
+		trace->offset = 0;
+	}
+	mem = RTE_PTR_ADD(&trace->mem[0], trace->offset);
+	trace->offset += sz;
+	return mem;
+}
+
+static __rte_always_inline void *
+__rte_trace_point_emit_ev_header(void *mem, uint64_t in)
+{
+	uint64_t val;
+
+	/* Event header [63:0] = id [63:48] | timestamp [47:0] */
+	val = rte_get_tsc_cycles() & __RTE_TRACE_EVENT_HEADER_TS_MASK;
+	val |= ((in & __RTE_TRACE_FIELD_ID_MASK) >>
+		__RTE_TRACE_FIELD_ID_SHIFT) << __RTE_TRACE_EVENT_HEADER_ID_SHIFT;
+
+	*(uint64_t *)mem = val;
+	return RTE_PTR_ADD(mem, __RTE_TRACE_EVENT_HEADER_SZ);
+}
+
+#define __rte_trace_point_emit_header_generic(t) \
+void *mem; \
+do { \
+	const uint64_t val = __atomic_load_n(t, __ATOMIC_RELAXED); \
+	if (likely(!(val & __RTE_TRACE_FIELD_ENABLE_MASK))) \
+		return; \
+	mem = __rte_trace_mem_get(val); \
+	if (unlikely(mem == NULL)) \
+		return; \
+	mem = __rte_trace_point_emit_ev_header(mem, val); \
+} while (0)
+
+#define __rte_trace_point_emit(in, type) \
+do { \
+	const type __val = (type)(in); \
+	memcpy(mem, &__val, sizeof(type)); \
+	mem = RTE_PTR_ADD(mem, sizeof(type)); \
+} while (0)
+
+#define rte_trace_point_emit_string(in) \
+do { \
+	const char *__str = (in); \
+	strlcpy(mem, __str != NULL ? __str : "", \
+		__RTE_TRACE_EMIT_STRING_LEN_MAX); \
+	mem = RTE_PTR_ADD(mem, __RTE_TRACE_EMIT_STRING_LEN_MAX); \
+} while (0)
+
+#else /* !ALLOW_EXPERIMENTAL_API */
+
+/*
+ * The trace API is experimental: tracepoints inlined in code which does
+ * not opt in for experimental API are compiled out.
+ */
+#define __rte_trace_point_emit_header_generic(t) \
+do { \
+	RTE_SET_USED(t); \
+	return; \
+} while (0)
+
+#define __rte_trace_point_emit(in, type) RTE_SET_USED(in)
+
+#define rte_trace_point_emit_string(in) RTE_SET_USED(in)
+
+#endif /* ALLOW_EXPERIMENTAL_API */
+
+#else /* RTE_TRACE_POINT_REGISTER_SELECT */
+
+#define __rte_trace_point_emit_header_generic(t) \
+do { \
+	RTE_SET_USED(t); \
+} while (0)
+
+#define __rte_trace_point_emit(in, type) \
+do { \
+	RTE_SET_USED(in); \
+	__rte_trace_point_emit_field(sizeof(type), RTE_STR(in), \
+		RTE_STR(type)); \
+} while (0)
+
+#define rte_trace_point_emit_string(in) \
+do { \
+	RTE_SET_USED(in); \
+	__rte_trace_point_emit_field(__RTE_TRACE_EMIT_STRING_LEN_MAX, \
+		RTE_STR(in)"[" RTE_STR(__RTE_TRACE_EMIT_STRING_LEN_MAX)"]", \
+		"string_bounded_t"); \
+} while (0)
+
+#endif /* RTE_TRACE_POINT_REGISTER_SELECT */
+
+#define rte_trace_point_emit_u64(in) __rte_trace_point_emit(in, uint64_t)
+#define rte_trace_point_emit_i64(in) __rte_trace_point_emit(in, int64_t)
+#define rte_trace_point_emit_u32(in) __rte_trace_point_emit(in, uint32_t)
+#define rte_trace_point_emit_i32(in) __rte_trace_point_emit(in, int32_t)
+#define rte_trace_point_emit_u16(in) __rte_trace_point_emit(in, uint16_t)
+#define rte_trace_point_emit_i16(in) __rte_trace_point_emit(in, int16_t)
+#define rte_trace_point_emit_u8(in) __rte_trace_point_emit(in, uint8_t)
+#define rte_trace_point_emit_i8(in) __rte_trace_point_emit(in, int8_t)
+#define rte_trace_point_emit_int(in) __rte_trace_point_emit(in, int32_t)
+#define rte_trace_point_emit_long(in) __rte_trace_point_emit(in, long)
+#define rte_trace_point_emit_float(in) __rte_trace_point_emit(in, float)
+#define rte_trace_point_emit_double(in) __rte_trace_point_emit(in, double)
+#define rte_trace_point_emit_ptr(in) __rte_trace_point_emit(in, uintptr_t)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_TRACE_POINT_H_ */
@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#ifndef _RTE_TRACE_POINT_REGISTER_H_
+#define _RTE_TRACE_POINT_REGISTER_H_
+
+/**
+ * @file
+ *
+ * RTE Tracepoint registration
+ *
+ * This file must be included, before any tracepoint header, in the C file
+ * registering the tracepoints with RTE_TRACE_POINT_REGISTER(). In this
+ * file, the tracepoint functions do not emit events: they describe their
+ * payload so that the trace metadata can be generated.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ */
+
+#ifdef _RTE_TRACE_POINT_H_
+#error for registration, include this file first before <rte_trace_point.h>
+#endif
+
+#include <rte_common.h>
+
+#define RTE_TRACE_POINT_REGISTER_SELECT
+
+#include <rte_trace_point.h>
+
+#define RTE_TRACE_POINT_REGISTER(trace, name) \
+rte_trace_point_t __##trace; \
+RTE_INIT(trace##_init) \
+{ \
+	__rte_trace_point_register(&__##trace, RTE_STR(name), \
+		(void (*)(void)) trace); \
+}
+
+#endif /* _RTE_TRACE_POINT_REGISTER_H_ */
@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_eal_memconfig.h>
+#include <rte_lcore.h>
+#include <rte_memory.h>
+
+#include "eal_memcfg.h"
+#include "malloc_cache.h"
+#include "malloc_elem.h"
+#include "malloc_heap.h"
+
+struct malloc_lcore_cache {
+	struct malloc_heap *heap; /**< heap of the cached elements */
+	unsigned int len[MALLOC_CACHE_NB_CLASSES];
+	/**< number of cached elements per class */
+	void *objs[MALLOC_CACHE_NB_CLASSES][MALLOC_CACHE_SIZE];
+	/**< data pointers of the cached elements, the last one is the hottest */
+};
+
+/* caches are only used by their lcore, so no locking is needed */
+static struct malloc_lcore_cache *lcore_caches[RTE_MAX_LCORE];
+
+static inline size_t
+malloc_cache_class_size(unsigned int cls)
+{
+	return (size_t)RTE_CACHE_LINE_SIZE << cls;
+}
+
+/* smallest class able to hold size bytes, or -1 */
+static inline int
+malloc_cache_class_ceil(size_t size)
+{
+	size_t lines = (size + RTE_CACHE_LINE_SIZE - 1) / RTE_CACHE_LINE_SIZE;
+	unsigned int cls;
+
+	if (size > MALLOC_CACHE_MAX_SIZE)
+		return -1;
+
+	cls = lines <= 1 ? 0 : 64 - __builtin_clzll(lines - 1);
+	return (int)cls;
+}
+
+/*
+ * largest class not larger than size, or -1: elements larger than twice
+ * the largest class are not cached.
+ */
+static inline int
+malloc_cache_class_floor(size_t size)
+{
+	size_t lines = size / RTE_CACHE_LINE_SIZE;
+	unsigned int cls;
+
+	if (lines == 0)
+		return -1;
+
+	cls = 63 - __builtin_clzll(lines);
+	return cls < MALLOC_CACHE_NB_CLASSES ? (int)cls : -1;
+}
+
+static struct malloc_lcore_cache *
+malloc_cache_get(void)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *cache;
+	int heap_id;
+
+	/* non-EAL threads use the heap directly */
+	if (lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+
+	cache = lcore_caches[lcore_id];
+	if (likely(cache != NULL))
+		return cache;
+
+	heap_id = malloc_socket_to_heap_id(malloc_get_numa_socket());
+	if (heap_id < 0)
+		return NULL;
+
+	cache = calloc(1, sizeof(*cache));
+	if (cache == NULL)
+		return NULL;
+
+	cache->heap = &mcfg->malloc_heaps[heap_id];
+	lcore_caches[lcore_id] = cache;
+	return cache;
+}
+
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket)
+{
+	struct malloc_lcore_cache *cache;
+	unsigned int *len, i;
+	void **objs;
+	int cls;
+
+	/* cached elements are only aligned on a cache line */
+	if (align > RTE_CACHE_LINE_SIZE)
+		return NULL;
+
+	cls = malloc_cache_class_ceil(size);
+	if (cls < 0)
+		return NULL;
+
+	cache = malloc_cache_get();
+	if (cache == NULL)
+		return NULL;
+
+	if (socket != SOCKET_ID_ANY &&
+			(unsigned int)socket != cache->heap->socket_id)
+		return NULL;
+
+	len = &cache->len[cls];
+	objs = cache->objs[cls];
+	if (*len == 0) {
+		*len = malloc_heap_alloc_bulk(cache->heap,
+				malloc_cache_class_size(cls), objs,
+				MALLOC_CACHE_BATCH);
+		if (*len == 0)
+			return NULL;
+		for (i = 0; i < *len; i++)
+			malloc_elem_from_data(objs[i])->state = ELEM_CACHED;
+	}
+
+	(*len)--;
+	malloc_elem_from_data(objs[*len])->state = ELEM_BUSY;
+	return objs[*len];
+}
+
+int
+malloc_cache_free(struct malloc_elem *elem)
+{
+	struct malloc_lcore_cache *cache;
+	unsigned int *len;
+	size_t size;
+	void **objs;
+	int cls;
+
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY ||
+			elem->pad != 0)
+		return -1;
+
+	cache = malloc_cache_get();
+	if (cache == NULL || elem->heap != cache->heap)
+		return -1;
+
+	size = elem->size - MALLOC_ELEM_OVERHEAD;
+	cls = malloc_cache_class_floor(size);
+	if (cls < 0)
+		return -1;
+
+	len = &cache->len[cls];
+	objs = cache->objs[cls];
+	if (*len == MALLOC_CACHE_SIZE) {
+		/* give the coldest elements back to the heap */
+		malloc_heap_free_bulk(cache->heap, objs, MALLOC_CACHE_BATCH);
+		*len -= MALLOC_CACHE_BATCH;
+		memmove(objs, &objs[MALLOC_CACHE_BATCH], *len * sizeof(*objs));
+	}
+
+	/* a second free of a cached element fails the state check above */
+	elem->state = ELEM_CACHED;
+	/* free heap memory is zeroed, keep it so for rte_zmalloc() */
+	objs[*len] = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
+	memset(objs[*len], 0, size);
+	(*len)++;
+
+	return 0;
+}
+
+void
+malloc_cache_flush(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *cache;
+	unsigned int cls;
+
+	if (lcore_id >= RTE_MAX_LCORE || lcore_caches[lcore_id] == NULL)
+		return;
+
+	cache = lcore_caches[lcore_id];
+	for (cls = 0; cls < MALLOC_CACHE_NB_CLASSES; cls++) {
+		if (cache->len[cls] == 0)
+			continue;
+		malloc_heap_free_bulk(cache->heap, cache->objs[cls],
+				cache->len[cls]);
+		cache->len[cls] = 0;
+	}
+}
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#ifndef MALLOC_CACHE_H_
+#define MALLOC_CACHE_H_
+
+#include <stddef.h>
+
+/* forward declarations */
+struct malloc_elem;
+
+/*
+ * Per-lcore caches of small elements, in front of the heap of the lcore
+ * socket. Size classes are powers of two cache lines, from one cache line
+ * to MALLOC_CACHE_MAX_SIZE.
+ */
+#define MALLOC_CACHE_NB_CLASSES 7
+#define MALLOC_CACHE_MAX_SIZE \
+	((size_t)RTE_CACHE_LINE_SIZE << (MALLOC_CACHE_NB_CLASSES - 1))
+/* Number of elements cached per size class */
+#define MALLOC_CACHE_SIZE 32
+/* Number of elements moved between a cache and its heap at once */
+#define MALLOC_CACHE_BATCH 16
+
+/*
+ * Allocate from the cache of the calling lcore. NULL is returned when the
+ * request cannot be served by the cache, in which case the caller must
+ * allocate from the heap.
+ */
+void *
+malloc_cache_alloc(size_t size, unsigned int align, int socket);
+
+/*
+ * Free to the cache of the calling lcore. A negative value is returned when
+ * the element cannot be cached, in which case the caller must free it to
+ * the heap.
+ */
+int
+malloc_cache_free(struct malloc_elem *elem);
+
+/* Give all the elements of the cache of the calling lcore back to the heap */
+void
+malloc_cache_flush(void);
+
+#endif /* MALLOC_CACHE_H_ */
@@ -731,6 +731,50 @@ malloc_heap_alloc(const char *type, size_t size, int socket_arg,
 	return NULL;
 }
 
+/*
+ * Allocate up to n elements of the same size from a heap, taking its lock
+ * only once. The heap is not expanded: fewer elements are returned when it
+ * has no more room.
+ */
+unsigned int
+malloc_heap_alloc_bulk(struct malloc_heap *heap, size_t size, void **objs,
+		unsigned int n)
+{
+	unsigned int i;
+
+	rte_spinlock_lock(&(heap->lock));
+	for (i = 0; i < n; i++) {
+		objs[i] = heap_alloc(heap, NULL, size, 0, RTE_CACHE_LINE_SIZE,
+				0, false);
+		if (objs[i] == NULL)
+			break;
+	}
+	rte_spinlock_unlock(&(heap->lock));
+
+	return i;
+}
+
+/*
+ * Free n elements to their heap, taking its lock only once. Unlike
+ * malloc_heap_free(), pages are not given back to the system, which is
+ * left to the next free of an adjacent element.
+ */
+void
+malloc_heap_free_bulk(struct malloc_heap *heap, void * const *objs,
+		unsigned int n)
+{
+	struct malloc_elem *elem;
+	unsigned int i;
+
+	rte_spinlock_lock(&(heap->lock));
+	for (i = 0; i < n; i++) {
+		elem = malloc_elem_from_data(objs[i]);
+		elem->state = ELEM_FREE;
+		malloc_elem_free(elem);
+	}
+	rte_spinlock_unlock(&(heap->lock));
+}
+
 static void *
 heap_alloc_biggest_on_heap_id(const char *type, unsigned int heap_id,
 		unsigned int flags, size_t align, bool contig)
@@ -61,6 +61,14 @@ malloc_heap_remove_external_memory(struct malloc_heap *heap, void *va_addr,
 int
 malloc_heap_free(struct malloc_elem *elem);
 
+unsigned int
+malloc_heap_alloc_bulk(struct malloc_heap *heap, size_t size, void **objs,
+		unsigned int n);
+
+void
+malloc_heap_free_bulk(struct malloc_heap *heap, void * const *objs,
+		unsigned int n);
+
 int
 malloc_heap_resize(struct malloc_elem *elem, size_t size);
 
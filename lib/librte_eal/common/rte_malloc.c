@@ -22,8 +22,10 @@
 #include <rte_spinlock.h>
 
 #include <rte_malloc.h>
+#include "malloc_cache.h"
 #include "malloc_elem.h"
 #include "malloc_heap.h"
+#include "eal_internal_cfg.h"
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 
@@ -31,11 +33,22 @@
 /* Free the memory space back to heap */
 void rte_free(void *addr)
 {
+	struct malloc_elem *elem;
+
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+	elem = malloc_elem_from_data(addr);
+	if (internal_config.malloc_lcore_cache && malloc_cache_free(elem) == 0)
+		return;
+	if (malloc_heap_free(elem) < 0)
 		RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
 }
 
+void
+rte_malloc_lcore_cache_flush(void)
+{
+	malloc_cache_flush();
+}
+
 /*
  * Allocate memory on specified heap.
  */
@@ -56,6 +69,14 @@ rte_malloc_socket(const char *type, size_t size, unsigned int align,
 				!rte_eal_has_hugepages())
 		socket_arg = SOCKET_ID_ANY;
 
+	/* small objects are served by the lcore cache, when enabled */
+	if (internal_config.malloc_lcore_cache) {
+		void *ptr = malloc_cache_alloc(size, align, socket_arg);
+
+		if (ptr != NULL)
+			return ptr;
+	}
+
 	return malloc_heap_alloc(type, size, socket_arg, 0,
 			align == 0 ? 1 : align, 0, false);
 }
@@ -77,6 +77,17 @@ rte_option_init(void)
 	}
 }
 
+void
+rte_option_cleanup(void)
+{
+	struct rte_option *option;
+
+	TAILQ_FOREACH(option, &rte_option_list, next) {
+		if (option->cleanup != NULL)
+			option->cleanup();
+	}
+}
+
 void
 rte_option_usage(void)
 {
@@ -59,6 +59,7 @@
 #include "eal_hugepages.h"
 #include "eal_memcfg.h"
 #include "eal_options.h"
+#include "eal_trace.h"
 #include "eal_vfio.h"
 #include "hotplug_mp.h"
 
@@ -1174,6 +1175,12 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	if (eal_trace_init() < 0) {
+		rte_eal_init_alert("Cannot init trace");
+		rte_errno = EFAULT;
+		return -1;
+	}
+
 	eal_check_mem_on_local_socket();
 
 	eal_thread_init_master(rte_config.master_lcore);
@@ -1298,8 +1305,10 @@ rte_eal_cleanup(void)
 	 */
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY)
 		rte_memseg_walk(mark_freeable, NULL);
+	rte_option_cleanup();
 	rte_service_finalize();
 	rte_mp_channel_cleanup();
+	eal_trace_fini();
 	eal_cleanup_config(&internal_config);
 	return 0;
 }
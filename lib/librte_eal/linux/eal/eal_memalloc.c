@@ -22,6 +22,7 @@
 #include <sys/time.h>
 #include <signal.h>
 #include <setjmp.h>
+#include <pthread.h>
 #ifdef F_ADD_SEALS /* if file sealing is supported, so is memfd */
 #include <linux/memfd.h>
 #define MEMFD_SUPPORTED
@@ -38,7 +39,9 @@
 #include <rte_eal_memconfig.h>
 #include <rte_eal.h>
 #include <rte_errno.h>
+#include <rte_lcore.h>
 #include <rte_memory.h>
+#include <rte_per_lcore.h>
 #include <rte_spinlock.h>
 
 #include "eal_filesystem.h"
@@ -46,6 +49,7 @@
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "eal_thread.h"
 
 const int anonymous_hugepages_supported =
 #ifdef MAP_HUGE_SHIFT
@@ -106,11 +110,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* pages may be faulted in by several threads at init, see alloc_seg_range */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -119,7 +124,7 @@ static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
  */
 static int __rte_unused huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
@@ -742,6 +747,184 @@ free_seg(struct rte_memseg *ms, struct hugepage_info *hi,
 	return ret < 0 ? -1 : 0;
 }
 
+/*
+ * allocate the segments [start_idx, start_idx + n_segs) of a memseg list,
+ * stopping at the first failure. returns the number of segments allocated.
+ */
+static unsigned int
+alloc_seg_range(struct rte_memseg_list *msl, unsigned int msl_idx,
+		int socket, struct hugepage_info *hi, int start_idx,
+		unsigned int n_segs)
+{
+	unsigned int i;
+
+	for (i = 0; i < n_segs; i++) {
+		int cur_idx = start_idx + i;
+		struct rte_memseg *cur;
+		void *map_addr;
+
+		cur = rte_fbarray_get(&msl->memseg_arr, cur_idx);
+		map_addr = RTE_PTR_ADD(msl->base_va,
+				(size_t)cur_idx * msl->page_sz);
+
+		if (alloc_seg(cur, map_addr, socket, hi, msl_idx, cur_idx))
+			break;
+	}
+	return i;
+}
+
+static void
+free_seg_range(struct rte_memseg_list *msl, unsigned int msl_idx,
+		struct hugepage_info *hi, int start_idx, unsigned int n_segs)
+{
+	unsigned int i;
+
+	for (i = 0; i < n_segs; i++) {
+		int cur_idx = start_idx + i;
+		struct rte_memseg *cur;
+
+		cur = rte_fbarray_get(&msl->memseg_arr, cur_idx);
+		/* free_seg may attempt to create a file, which may fail. */
+		if (free_seg(cur, hi, msl_idx, cur_idx))
+			RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+	}
+}
+
+/* do not create threads allocating less segments than this */
+#define ALLOC_SEG_WORKER_MIN_SEGS 8
+
+struct alloc_seg_worker {
+	pthread_t thread;
+	bool started;
+	struct rte_memseg_list *msl;
+	struct hugepage_info *hi;
+	unsigned int msl_idx;
+	int socket;
+	int start_idx;
+	unsigned int n_segs;
+	unsigned int segs_allocated;
+};
+
+static void *
+alloc_seg_worker_main(void *arg)
+{
+	struct alloc_seg_worker *w = arg;
+
+	w->segs_allocated = alloc_seg_range(w->msl, w->msl_idx, w->socket,
+			w->hi, w->start_idx, w->n_segs);
+	return NULL;
+}
+
+/*
+ * get the CPUs this process may run on in a socket, or all of them if there
+ * is none in the socket, and return their number.
+ */
+static unsigned int
+alloc_seg_workers_cpuset(int socket, rte_cpuset_t *cpuset)
+{
+	rte_cpuset_t allowed;
+	unsigned int cpu;
+
+	if (pthread_getaffinity_np(pthread_self(), sizeof(allowed),
+			&allowed) != 0)
+		return 0;
+
+	CPU_ZERO(cpuset);
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (CPU_ISSET(cpu, &allowed) &&
+				eal_cpu_socket_id(cpu) == (unsigned int)socket)
+			CPU_SET(cpu, cpuset);
+	}
+	if (CPU_COUNT(cpuset) == 0)
+		memcpy(cpuset, &allowed, sizeof(*cpuset));
+
+	return CPU_COUNT(cpuset);
+}
+
+/*
+ * same as alloc_seg_range, but split the range between temporary threads.
+ * mapping a hugepage makes the kernel fault it in and zero it, which is
+ * what takes most of the time when allocating a large amount of memory at
+ * init.
+ *
+ * the threads run on the CPUs of the socket the pages are allocated on, and
+ * inherit the NUMA memory policy of the calling thread.
+ */
+static unsigned int
+alloc_seg_range_parallel(struct rte_memseg_list *msl, unsigned int msl_idx,
+		int socket, struct hugepage_info *hi, int start_idx,
+		unsigned int n_segs)
+{
+	struct alloc_seg_worker *workers;
+	unsigned int n_workers, allocated, i;
+	rte_cpuset_t cpuset;
+	pthread_attr_t attr;
+	int cur_idx;
+
+	n_workers = RTE_MIN(alloc_seg_workers_cpuset(socket, &cpuset),
+			n_segs / ALLOC_SEG_WORKER_MIN_SEGS);
+	if (n_workers <= 1)
+		goto serial;
+
+	workers = calloc(n_workers, sizeof(*workers));
+	if (workers == NULL)
+		goto serial;
+
+	if (pthread_attr_init(&attr) != 0) {
+		free(workers);
+		goto serial;
+	}
+	pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+
+	RTE_LOG(DEBUG, EAL, "Allocating %u segments with %u threads\n",
+		n_segs, n_workers);
+
+	/* the calling thread allocates the first chunk itself */
+	cur_idx = start_idx;
+	for (i = 0; i < n_workers; i++) {
+		struct alloc_seg_worker *w = &workers[i];
+
+		w->msl = msl;
+		w->hi = hi;
+		w->msl_idx = msl_idx;
+		w->socket = socket;
+		w->start_idx = cur_idx;
+		w->n_segs = n_segs / n_workers + (i < n_segs % n_workers);
+		cur_idx += w->n_segs;
+
+		if (i > 0)
+			w->started = pthread_create(&w->thread, &attr,
+					alloc_seg_worker_main, w) == 0;
+	}
+	pthread_attr_destroy(&attr);
+
+	for (i = 0; i < n_workers; i++) {
+		struct alloc_seg_worker *w = &workers[i];
+
+		if (w->started)
+			pthread_join(w->thread, NULL);
+		else
+			alloc_seg_worker_main(w);
+	}
+
+	/* only keep the segments allocated contiguously from the start */
+	allocated = 0;
+	for (i = 0; i < n_workers; i++) {
+		struct alloc_seg_worker *w = &workers[i];
+
+		if (allocated == (unsigned int)(w->start_idx - start_idx))
+			allocated += w->segs_allocated;
+		else
+			free_seg_range(msl, msl_idx, hi, w->start_idx,
+					w->segs_allocated);
+	}
+	free(workers);
+
+	return allocated;
+serial:
+	return alloc_seg_range(msl, msl_idx, socket, hi, start_idx, n_segs);
+}
+
 struct alloc_walk_param {
 	struct hugepage_info *hi;
 	struct rte_memseg **ms;
@@ -757,17 +940,14 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
 	struct alloc_walk_param *wa = arg;
 	struct rte_memseg_list *cur_msl;
-	size_t page_sz;
-	int cur_idx, start_idx, j, dir_fd = -1;
-	unsigned int msl_idx, need, i;
+	int cur_idx, start_idx, dir_fd = -1;
+	unsigned int msl_idx, need, allocated, i;
 
 	if (msl->page_sz != wa->page_sz)
 		return 0;
 	if (msl->socket_id != wa->socket)
 		return 0;
 
-	page_sz = (size_t)msl->page_sz;
-
 	msl_idx = msl - mcfg->memsegs;
 	cur_msl = &mcfg->memsegs[msl_idx];
 
@@ -825,38 +1005,25 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
-	for (i = 0; i < need; i++, cur_idx++) {
-		struct rte_memseg *cur;
-		void *map_addr;
-
-		cur = rte_fbarray_get(&cur_msl->memseg_arr, cur_idx);
-		map_addr = RTE_PTR_ADD(cur_msl->base_va,
-				cur_idx * page_sz);
-
-		if (alloc_seg(cur, map_addr, wa->socket, wa->hi,
-				msl_idx, cur_idx)) {
-			RTE_LOG(DEBUG, EAL, "attempted to allocate %i segments, but only %i were allocated\n",
-				need, i);
+	/* at init, fault the pages in from several threads */
+	if (internal_config.process_type == RTE_PROC_PRIMARY &&
+			!internal_config.init_complete &&
+			!internal_config.single_file_segments)
+		allocated = alloc_seg_range_parallel(cur_msl, msl_idx,
+				wa->socket, wa->hi, start_idx, need);
+	else
+		allocated = alloc_seg_range(cur_msl, msl_idx, wa->socket,
+				wa->hi, start_idx, need);
 
-			/* if exact number wasn't requested, stop */
-			if (!wa->exact)
-				goto out;
+	if (allocated != need) {
+		RTE_LOG(DEBUG, EAL, "attempted to allocate %i segments, but only %i were allocated\n",
+			need, allocated);
 
+		/* if exact number wasn't requested, keep what we have */
+		if (wa->exact) {
 			/* clean up */
-			for (j = start_idx; j < cur_idx; j++) {
-				struct rte_memseg *tmp;
-				struct rte_fbarray *arr =
-						&cur_msl->memseg_arr;
-
-				tmp = rte_fbarray_get(arr, j);
-				rte_fbarray_set_free(arr, j);
-
-				/* free_seg may attempt to create a file, which
-				 * may fail.
-				 */
-				if (free_seg(tmp, wa->hi, msl_idx, j))
-					RTE_LOG(DEBUG, EAL, "Cannot free page\n");
-			}
+			free_seg_range(cur_msl, msl_idx, wa->hi, start_idx,
+					allocated);
 			/* clear the list */
 			if (wa->ms)
 				memset(wa->ms, 0, sizeof(*wa->ms) * wa->n_segs);
@@ -865,12 +1032,15 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 				close(dir_fd);
 			return -1;
 		}
+	}
+
+	for (i = 0; i < allocated; i++, cur_idx++) {
 		if (wa->ms)
-			wa->ms[i] = cur;
+			wa->ms[i] = rte_fbarray_get(&cur_msl->memseg_arr,
+					cur_idx);
 
 		rte_fbarray_set_used(&cur_msl->memseg_arr, cur_idx);
 	}
-out:
 	wa->segs_allocated = i;
 	if (i > 0)
 		cur_msl->version++;
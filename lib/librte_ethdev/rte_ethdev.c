@@ -37,6 +37,7 @@
 #include <rte_string_fns.h>
 #include <rte_kvargs.h>
 #include <rte_class.h>
+#include <rte_telemetry.h>
 
 #include "rte_ether.h"
 #include "rte_ethdev.h"
@@ -4545,6 +4546,185 @@ rte_eth_devargs_parse(const char *dargs, struct rte_eth_devargs *eth_da)
 	return result;
 }
 
+static int
+eth_dev_telemetry_port(const char *params, uint16_t *port_id)
+{
+	unsigned long pid;
+	char *end;
+
+	if (params == NULL || !isdigit((unsigned char)*params))
+		return -EINVAL;
+
+	pid = strtoul(params, &end, 0);
+	if (*end != '\0' || pid >= RTE_MAX_ETHPORTS ||
+			!rte_eth_dev_is_valid_port(pid))
+		return -EINVAL;
+
+	*port_id = pid;
+	return 0;
+}
+
+static int
+eth_dev_handle_port_list(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	int port_id;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	RTE_ETH_FOREACH_DEV(port_id)
+		rte_tel_data_add_array_int(d, port_id);
+	return 0;
+}
+
+static int
+eth_dev_add_port_queue_stats(struct rte_tel_data *d, const uint64_t *q_stats,
+		const char *name)
+{
+	struct rte_tel_data *q_data;
+	unsigned int q;
+
+	q_data = rte_tel_data_alloc();
+	if (q_data == NULL)
+		return -ENOMEM;
+
+	rte_tel_data_start_array(q_data, RTE_TEL_U64_VAL);
+	for (q = 0; q < RTE_ETHDEV_QUEUE_STAT_CNTRS; q++)
+		rte_tel_data_add_array_u64(q_data, q_stats[q]);
+	if (rte_tel_data_add_dict_container(d, name, q_data) < 0) {
+		rte_tel_data_free(q_data);
+		return -ENOSPC;
+	}
+
+	return 0;
+}
+
+#define ADD_DICT_STAT(stats, s) rte_tel_data_add_dict_u64(d, #s, stats.s)
+
+static int
+eth_dev_handle_port_stats(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_eth_stats stats;
+	uint16_t port_id;
+	int ret;
+
+	ret = eth_dev_telemetry_port(params, &port_id);
+	if (ret < 0)
+		return ret;
+
+	ret = rte_eth_stats_get(port_id, &stats);
+	if (ret < 0)
+		return ret;
+
+	rte_tel_data_start_dict(d);
+	ADD_DICT_STAT(stats, ipackets);
+	ADD_DICT_STAT(stats, opackets);
+	ADD_DICT_STAT(stats, ibytes);
+	ADD_DICT_STAT(stats, obytes);
+	ADD_DICT_STAT(stats, imissed);
+	ADD_DICT_STAT(stats, ierrors);
+	ADD_DICT_STAT(stats, oerrors);
+	ADD_DICT_STAT(stats, rx_nombuf);
+	eth_dev_add_port_queue_stats(d, stats.q_ipackets, "q_ipackets");
+	eth_dev_add_port_queue_stats(d, stats.q_opackets, "q_opackets");
+	eth_dev_add_port_queue_stats(d, stats.q_ibytes, "q_ibytes");
+	eth_dev_add_port_queue_stats(d, stats.q_obytes, "q_obytes");
+	eth_dev_add_port_queue_stats(d, stats.q_errors, "q_errors");
+
+	return 0;
+}
+
+static int
+eth_dev_handle_port_xstats(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_eth_xstat *eth_xstats;
+	struct rte_eth_xstat_name *xstat_names;
+	uint16_t port_id;
+	int num_xstats;
+	int i, ret;
+
+	ret = eth_dev_telemetry_port(params, &port_id);
+	if (ret < 0)
+		return ret;
+
+	num_xstats = rte_eth_xstats_get(port_id, NULL, 0);
+	if (num_xstats < 0)
+		return num_xstats;
+
+	/* one allocation for the names and the values */
+	eth_xstats = malloc((sizeof(struct rte_eth_xstat) +
+			sizeof(struct rte_eth_xstat_name)) * num_xstats);
+	if (eth_xstats == NULL)
+		return -ENOMEM;
+	xstat_names = (void *)&eth_xstats[num_xstats];
+
+	ret = rte_eth_xstats_get_names(port_id, xstat_names, num_xstats);
+	if (ret < 0 || ret > num_xstats) {
+		free(eth_xstats);
+		return -1;
+	}
+
+	ret = rte_eth_xstats_get(port_id, eth_xstats, num_xstats);
+	if (ret < 0 || ret > num_xstats) {
+		free(eth_xstats);
+		return -1;
+	}
+
+	rte_tel_data_start_dict(d);
+	for (i = 0; i < ret; i++)
+		rte_tel_data_add_dict_u64(d, xstat_names[i].name,
+			eth_xstats[i].value);
+
+	free(eth_xstats);
+	return 0;
+}
+
+static int
+eth_dev_handle_port_link_status(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_eth_link link;
+	uint16_t port_id;
+	int ret;
+
+	ret = eth_dev_telemetry_port(params, &port_id);
+	if (ret < 0)
+		return ret;
+
+	memset(&link, 0, sizeof(link));
+	rte_eth_link_get_nowait(port_id, &link);
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "status",
+		link.link_status ? "UP" : "DOWN");
+	if (!link.link_status)
+		return 0;
+
+	rte_tel_data_add_dict_u64(d, "speed", link.link_speed);
+	rte_tel_data_add_dict_string(d, "duplex",
+		(link.link_duplex == ETH_LINK_FULL_DUPLEX) ?
+			"full-duplex" : "half-duplex");
+	return 0;
+}
+
+RTE_INIT(ethdev_init_telemetry)
+{
+	rte_telemetry_register_cmd("/ethdev/list", eth_dev_handle_port_list,
+		"Returns list of available ethdev ports. Takes no parameters");
+	rte_telemetry_register_cmd("/ethdev/stats", eth_dev_handle_port_stats,
+		"Returns the common stats for a port. Parameters: int port_id");
+	rte_telemetry_register_cmd("/ethdev/xstats", eth_dev_handle_port_xstats,
+		"Returns the extended stats for a port. "
+		"Parameters: int port_id");
+	rte_telemetry_register_cmd("/ethdev/link_status",
+		eth_dev_handle_port_link_status,
+		"Returns the link status for a port. Parameters: int port_id");
+}
+
 RTE_INIT(ethdev_init_log)
 {
 	rte_eth_dev_logtype = rte_log_register("lib.ethdev");
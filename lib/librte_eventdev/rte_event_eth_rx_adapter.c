@@ -14,6 +14,7 @@
 #include <rte_ethdev.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
+#include <rte_mempool.h>
 #include <rte_service_component.h>
 #include <rte_thash.h>
 #include <rte_interrupts.h>
@@ -58,6 +59,29 @@ struct eth_rx_poll_entry {
 	uint16_t eth_rx_qid;
 };
 
+/* Event vector under construction for a Rx queue */
+struct eth_rx_vector_data {
+	TAILQ_ENTRY(eth_rx_vector_data) next;
+	/* Ethernet port identifier */
+	uint16_t port;
+	/* Rx queue identifier */
+	uint16_t queue;
+	/* Number of mbufs after which the vector is enqueued */
+	uint16_t max_vector_count;
+	/* Event template for the vector events of the queue */
+	uint64_t event;
+	/* TSC value when the first mbuf was added to the vector */
+	uint64_t ts;
+	/* Time after which a partial vector is enqueued, in TSC cycles */
+	uint64_t vector_timeout_ticks;
+	/* Mempool the vectors are allocated from */
+	struct rte_mempool *vector_pool;
+	/* Vector being filled, NULL if none */
+	struct rte_event_vector *vector_ev;
+} __rte_cache_aligned;
+
+TAILQ_HEAD(eth_rx_vector_data_list, eth_rx_vector_data);
+
 /* Instance per adapter */
 struct rte_eth_event_enqueue_buffer {
 	/* Count of events in this buffer */
@@ -131,6 +155,10 @@ struct rte_event_eth_rx_adapter {
 	uint8_t service_inited;
 	/* Total count of Rx queues in adapter */
 	uint32_t nb_queues;
+	/* Count of Rx queues with event vectorization enabled */
+	uint32_t nb_vector_queues;
+	/* Vectors being filled, in order of creation */
+	struct eth_rx_vector_data_list vector_list;
 	/* Memory allocation name */
 	char mem_name[ETH_RX_ADAPTER_MEM_NAME_LEN];
 	/* Socket identifier cached from eventdev */
@@ -200,6 +228,8 @@ struct eth_rx_queue_info {
 	uint16_t wt;		/* Polling weight */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
+	int ena_vector;		/* True if events are aggregated in vectors */
+	struct eth_rx_vector_data vector_data;
 };
 
 static struct rte_event_eth_rx_adapter **event_eth_rx_adapter;
@@ -741,6 +771,123 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 	return n;
 }
 
+/* Move the vector of a Rx queue to the event buffer */
+static inline void
+rxa_vector_enqueue(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vec)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&rx_adapter->event_enqueue_buffer;
+	struct rte_event *ev = &buf->events[buf->count++];
+
+	ev->event = vec->event;
+	ev->vec = vec->vector_ev;
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+}
+
+/* Enqueue the partial vector of a Rx queue, the mbufs are dropped if
+ * the event buffer is full
+ */
+static void
+rxa_vector_flush(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vec)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&rx_adapter->event_enqueue_buffer;
+	struct rte_event_vector *v = vec->vector_ev;
+	uint16_t i;
+
+	if (v == NULL)
+		return;
+
+	if (buf->count < ETH_EVENT_BUFFER_SIZE) {
+		rxa_vector_enqueue(rx_adapter, vec);
+		return;
+	}
+
+	for (i = 0; i < v->nb_elem; i++)
+		rte_pktmbuf_free(v->mbufs[i]);
+	rx_adapter->stats.rx_dropped += v->nb_elem;
+	rte_mempool_put(vec->vector_pool, v);
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+}
+
+/* Aggregate mbufs into event vectors, full vectors are moved to the
+ * event buffer
+ */
+static inline void
+rxa_create_event_vector(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info,
+		struct rte_mbuf **mbufs,
+		uint16_t num)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event_vector *v;
+	uint16_t i = 0;
+	uint16_t sz;
+
+	while (i < num) {
+		if (vec->vector_ev == NULL) {
+			if (unlikely(rte_mempool_get(vec->vector_pool,
+					(void **)&vec->vector_ev) < 0)) {
+				vec->vector_ev = NULL;
+				rx_adapter->stats.rx_dropped += num - i;
+				for (; i < num; i++)
+					rte_pktmbuf_free(mbufs[i]);
+				return;
+			}
+			v = vec->vector_ev;
+			v->nb_elem = 0;
+			v->attr_valid = 1;
+			v->port = vec->port;
+			v->queue = vec->queue;
+			vec->ts = rte_get_tsc_cycles();
+			TAILQ_INSERT_TAIL(&rx_adapter->vector_list, vec, next);
+		}
+
+		v = vec->vector_ev;
+		sz = RTE_MIN(num - i, vec->max_vector_count - v->nb_elem);
+		memcpy(&v->mbufs[v->nb_elem], &mbufs[i],
+			sz * sizeof(mbufs[0]));
+		v->nb_elem += sz;
+		i += sz;
+
+		if (v->nb_elem == vec->max_vector_count)
+			rxa_vector_enqueue(rx_adapter, vec);
+	}
+}
+
+/* Enqueue the partial vectors that have been waiting for longer
+ * than the timeout of their Rx queue
+ */
+static void
+rxa_vector_expire(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&rx_adapter->event_enqueue_buffer;
+	struct eth_rx_vector_data *vec;
+	struct eth_rx_vector_data *next;
+	uint64_t ts;
+
+	ts = rte_get_tsc_cycles();
+	for (vec = TAILQ_FIRST(&rx_adapter->vector_list); vec != NULL;
+	     vec = next) {
+		next = TAILQ_NEXT(vec, next);
+		if (ts - vec->ts < vec->vector_timeout_ticks)
+			continue;
+		if (buf->count >= BATCH_SIZE)
+			rxa_flush_event_buffer(rx_adapter);
+		if (buf->count == ETH_EVENT_BUFFER_SIZE)
+			break;
+		rxa_vector_enqueue(rx_adapter, vec);
+	}
+
+	if (buf->count > 0)
+		rxa_flush_event_buffer(rx_adapter);
+}
+
 static inline void
 rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		uint16_t eth_dev_id,
@@ -780,6 +927,12 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		}
 	}
 
+	if (eth_rx_queue_info->ena_vector) {
+		rxa_create_event_vector(rx_adapter, eth_rx_queue_info,
+					mbufs, num);
+		return;
+	}
+
 	for (i = 0; i < num; i++) {
 		m = mbufs[i];
 
@@ -1150,6 +1303,8 @@ rxa_service_func(void *args)
 	stats = &rx_adapter->stats;
 	stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter);
 	stats->rx_packets += rxa_poll(rx_adapter);
+	if (rx_adapter->nb_vector_queues)
+		rxa_vector_expire(rx_adapter);
 	rte_spinlock_unlock(&rx_adapter->rx_lock);
 	return 0;
 }
@@ -1650,6 +1805,48 @@ rxa_update_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	}
 }
 
+static void
+rxa_vector_disable(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info)
+{
+	if (!queue_info->ena_vector)
+		return;
+
+	rxa_vector_flush(rx_adapter, &queue_info->vector_data);
+	queue_info->ena_vector = 0;
+	rx_adapter->nb_vector_queues--;
+}
+
+static void
+rxa_vector_enable(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info,
+		uint16_t port_id,
+		uint16_t rx_queue_id,
+		const struct rte_event_eth_rx_adapter_queue_conf *conf)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event *qi_ev = (struct rte_event *)&vec->event;
+
+	vec->event = queue_info->event;
+	qi_ev->event_type = RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR;
+	/* All the mbufs of a vector share the flow id of the vector,
+	 * derive it from the port and queue if the application did not
+	 * provide one
+	 */
+	if (!queue_info->flow_id_mask)
+		qi_ev->flow_id = (rx_queue_id & 0xFFF) |
+				(port_id & 0xFF) << 12;
+	vec->port = port_id;
+	vec->queue = rx_queue_id;
+	vec->max_vector_count = conf->vector_sz;
+	vec->vector_pool = conf->vector_mp;
+	vec->vector_timeout_ticks = (uint64_t)
+		((double)conf->vector_timeout_ns * rte_get_tsc_hz() / 1E9);
+	vec->vector_ev = NULL;
+	queue_info->ena_vector = 1;
+	rx_adapter->nb_vector_queues++;
+}
+
 static void
 rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
@@ -1676,6 +1873,7 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
+	rxa_vector_disable(rx_adapter, &dev_info->rx_queue[rx_queue_id]);
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 0);
 	rx_adapter->num_rx_polled -= pollq;
 	dev_info->nb_rx_poll -= pollq;
@@ -1726,6 +1924,13 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	} else
 		qi_ev->flow_id = 0;
 
+	rxa_vector_disable(rx_adapter, queue_info);
+	if (conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR)
+		rxa_vector_enable(rx_adapter, queue_info,
+				dev_info->dev->data->port_id, rx_queue_id,
+				conf);
+
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 1);
 	if (rxa_polled_queue(dev_info, rx_queue_id)) {
 		rx_adapter->num_rx_polled += !pollq;
@@ -1977,6 +2182,7 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 	rx_adapter->conf_cb = conf_cb;
 	rx_adapter->conf_arg = conf_arg;
 	rx_adapter->id = id;
+	TAILQ_INIT(&rx_adapter->vector_list);
 	strcpy(rx_adapter->mem_name, mem_name);
 	rx_adapter->eth_devices = rte_zmalloc_socket(rx_adapter->mem_name,
 					RTE_MAX_ETHPORTS *
@@ -2088,6 +2294,27 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		return -EINVAL;
 	}
 
+	if (queue_conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR) {
+		if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) &&
+		    (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) == 0) {
+			RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+			return -ENOTSUP;
+		}
+
+		if (queue_conf->vector_sz == 0 ||
+		    queue_conf->vector_sz >
+			rte_event_vector_pool_elem_max(queue_conf->vector_mp) ||
+		    queue_conf->vector_timeout_ns == 0) {
+			RTE_EDEV_LOG_ERR("Invalid event vector configuration,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+			return -EINVAL;
+		}
+	}
+
 	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) == 0 &&
 		(rx_queue_id != -1)) {
 		RTE_EDEV_LOG_ERR("Rx queues can only be connected to single "
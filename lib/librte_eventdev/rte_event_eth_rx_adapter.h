@@ -77,6 +77,16 @@
  * allows the application to register a callback that selects which packets are
  * enqueued to the event device by the SW adapter. The callback interface is
  * event based so the callback can also modify the event data if it needs to.
+ *
+ * To amortize the event device scheduling cost over several packets, an
+ * ethernet Rx queue can be added with the
+ * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag. The adapter then
+ * aggregates the mbufs received from the queue into event vectors, allocated
+ * from the mempool given in the queue configuration, and enqueues an event of
+ * type RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR once a vector is full or its
+ * oldest mbuf has waited for the configured timeout. All the events of the
+ * queue share the same flow identifier, so they are ordered by the event
+ * device. The Rx callback is not invoked for these queues.
  */
 
 #ifdef __cplusplus
@@ -96,6 +106,12 @@ extern "C" {
 /**< This flag indicates the flow identifier is valid
  * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR	0x2
+/**< This flag indicates that mbufs arriving on the queue need to be
+ * vectorized
+ * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
+ * @see RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR
+ */
 
 /**
  * Adapter configuration structure that the adapter configuration callback
@@ -166,11 +182,34 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	 *		is set in rx_queue_flags, this flow_id is used for all
 	 *		packets received from this queue. Otherwise the flow ID
 	 *		is set to the RSS hash of the src and dst IPv4/6
-	 *		addresses.
+	 *		addresses, or for event vectors, to a value derived
+	 *		from the ethernet port and Rx queue identifiers.
 	 *
 	 * The event adapter sets ev.event_type to RTE_EVENT_TYPE_ETHDEV in the
 	 * enqueued event.
 	 */
+	uint16_t vector_sz;
+	/**<
+	 * Indicates the maximum number for mbufs to combine and create an
+	 * event vector, in the range [1, rte_event_vector_pool_elem_max()]
+	 * of the vector_mp mempool.
+	 * Valid when RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag is set in
+	 * rx_queue_flags.
+	 */
+	uint64_t vector_timeout_ns;
+	/**<
+	 * Indicates the maximum number of nanoseconds to wait for receiving
+	 * mbufs before enqueuing a partially filled event vector.
+	 * Valid when RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag is set in
+	 * rx_queue_flags.
+	 */
+	struct rte_mempool *vector_mp;
+	/**<
+	 * Indicates the mempool, created with rte_event_vector_pool_create(),
+	 * that should be used for allocating the event vectors.
+	 * Valid when RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag is set in
+	 * rx_queue_flags.
+	 */
 };
 
 /**
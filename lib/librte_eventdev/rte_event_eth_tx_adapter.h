@@ -68,6 +68,14 @@
  * and rte_event_eth_tx_adapter_txq_get() functions to access the transmit
  * queue index, using these macros will help with minimizing application
  * impact due to a change in how the transmit queue index is specified.
+ *
+ * Events of type #RTE_EVENT_TYPE_VECTOR carry a struct rte_event_vector of
+ * mbufs. If rte_event_vector::attr_valid is set, all the mbufs are
+ * transmitted on rte_event_vector::port and rte_event_vector::queue,
+ * else the port and transmit queue index are read from each mbuf. The
+ * vector is returned to its mempool once the mbufs are transmitted. The
+ * common implementation always supports event vectors, the eventdev PMD
+ * support is reported by #RTE_EVENT_ETH_TX_ADAPTER_CAP_EVENT_VECTOR.
  */
 
 #ifdef __cplusplus
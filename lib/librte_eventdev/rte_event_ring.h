@@ -91,7 +91,8 @@ rte_event_ring_enqueue_burst(struct rte_event_ring *r,
 	uint32_t prod_head, prod_next;
 	uint32_t free_entries;
 
-	n = __rte_ring_move_prod_head(&r->r, r->r.prod.single, n,
+	n = __rte_ring_move_prod_head(&r->r,
+			r->r.prod.sync_type == RTE_RING_SYNC_ST, n,
 			RTE_RING_QUEUE_VARIABLE,
 			&prod_head, &prod_next, &free_entries);
 	if (n == 0)
@@ -99,7 +100,8 @@ rte_event_ring_enqueue_burst(struct rte_event_ring *r,
 
 	ENQUEUE_PTRS(&r->r, &r[1], prod_head, events, n, struct rte_event);
 
-	update_tail(&r->r.prod, prod_head, prod_next, r->r.prod.single, 1);
+	update_tail(&r->r.prod, prod_head, prod_next,
+			r->r.prod.sync_type == RTE_RING_SYNC_ST, 1);
 end:
 	if (free_space != NULL)
 		*free_space = free_entries - n;
@@ -132,7 +134,8 @@ rte_event_ring_dequeue_burst(struct rte_event_ring *r,
 	uint32_t cons_head, cons_next;
 	uint32_t entries;
 
-	n = __rte_ring_move_cons_head(&r->r, r->r.cons.single, n,
+	n = __rte_ring_move_cons_head(&r->r,
+			r->r.cons.sync_type == RTE_RING_SYNC_ST, n,
 			RTE_RING_QUEUE_VARIABLE,
 			&cons_head, &cons_next, &entries);
 	if (n == 0)
@@ -140,7 +143,8 @@ rte_event_ring_dequeue_burst(struct rte_event_ring *r,
 
 	DEQUEUE_PTRS(&r->r, &r[1], cons_head, events, n, struct rte_event);
 
-	update_tail(&r->r.cons, cons_head, cons_next, r->r.cons.single, 0);
+	update_tail(&r->r.cons, cons_head, cons_next,
+			r->r.cons.sync_type == RTE_RING_SYNC_ST, 0);
 
 end:
 	if (available != NULL)
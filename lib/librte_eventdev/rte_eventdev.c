@@ -28,6 +28,7 @@
 #include <rte_branch_prediction.h>
 #include <rte_common.h>
 #include <rte_malloc.h>
+#include <rte_mempool.h>
 #include <rte_errno.h>
 #include <rte_ethdev.h>
 #include <rte_cryptodev.h>
@@ -1194,6 +1195,56 @@ int rte_event_dev_selftest(uint8_t dev_id)
 	return -ENOTSUP;
 }
 
+/* Private data of the event vector mempools */
+struct event_vector_pool_private {
+	uint16_t nb_elem;
+};
+
+struct rte_mempool *
+rte_event_vector_pool_create(const char *name, unsigned int n,
+			     unsigned int cache_size, uint16_t nb_elem,
+			     int socket_id)
+{
+	struct event_vector_pool_private *priv;
+	struct rte_mempool *mp;
+	size_t elt_size;
+
+	if (nb_elem == 0) {
+		RTE_EDEV_LOG_ERR("Invalid number of elements=%" PRIu16,
+				nb_elem);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	elt_size = sizeof(struct rte_event_vector) +
+		(size_t)nb_elem * sizeof(uintptr_t);
+	mp = rte_mempool_create(name, n, elt_size, cache_size, sizeof(*priv),
+			NULL, NULL, NULL, NULL, socket_id, 0);
+	if (mp == NULL)
+		return NULL;
+
+	priv = rte_mempool_get_priv(mp);
+	priv->nb_elem = nb_elem;
+
+	return mp;
+}
+
+uint16_t
+rte_event_vector_pool_elem_max(const struct rte_mempool *mp)
+{
+	const struct event_vector_pool_private *priv;
+
+	if (mp == NULL || mp->private_data_size < sizeof(*priv))
+		return 0;
+
+	priv = rte_mempool_get_priv((struct rte_mempool *)(uintptr_t)mp);
+	if (mp->elt_size < sizeof(struct rte_event_vector) +
+			(size_t)priv->nb_elem * sizeof(uintptr_t))
+		return 0;
+
+	return priv->nb_elem;
+}
+
 int
 rte_event_dev_start(uint8_t dev_id)
 {
@@ -214,8 +214,10 @@ extern "C" {
 #include <rte_config.h>
 #include <rte_memory.h>
 #include <rte_errno.h>
+#include <rte_compat.h>
 
 struct rte_mbuf; /* we just use mbuf pointers; no need to include rte_mbuf.h */
+struct rte_mempool;
 struct rte_event;
 
 /* Event device capability bitmap flags */
@@ -949,6 +951,29 @@ rte_event_dev_close(uint8_t dev_id);
  */
 #define RTE_EVENT_TYPE_ETH_RX_ADAPTER   0x4
 /**< The event generated from event eth Rx adapter */
+#define RTE_EVENT_TYPE_VECTOR           0x8
+/**< Indicates that the event is a vector.
+ * All vector event types should be a logical OR of RTE_EVENT_TYPE_VECTOR
+ * and the type of the event source.
+ * This simplifies the pipeline design as one can split processing the events
+ * between vector events and normal events across event types.
+ * Example:
+ *	if (ev.event_type & RTE_EVENT_TYPE_VECTOR) {
+ *		// Classify and handle vector event.
+ *	} else {
+ *		// Classify and handle event.
+ *	}
+ * @see struct rte_event_vector
+ */
+#define RTE_EVENT_TYPE_ETHDEV_VECTOR \
+	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_ETHDEV)
+/**< The event vector generated from ethdev subsystem */
+#define RTE_EVENT_TYPE_CPU_VECTOR \
+	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_CPU)
+/**< The event vector generated from cpu for pipelining. */
+#define RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR \
+	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_ETH_RX_ADAPTER)
+/**< The event vector generated from event eth Rx adapter. */
 #define RTE_EVENT_TYPE_MAX              0x10
 /**< Maximum number of event types */
 
@@ -998,6 +1023,54 @@ rte_event_dev_close(uint8_t dev_id);
  *
  */
 
+/**
+ * The generic *rte_event_vector* structure to hold a vector of objects,
+ * carried by the events of RTE_EVENT_TYPE_VECTOR type.
+ * Event vectors are allocated from a mempool created with
+ * rte_event_vector_pool_create(), and are freed back to it by the consumer.
+ */
+RTE_STD_C11
+struct rte_event_vector {
+	uint16_t nb_elem;
+	/**< Number of elements in this event vector. */
+	uint16_t rsvd:15;
+	/**< Reserved for future use */
+	uint16_t attr_valid:1;
+	/**< Indicates that the below union attributes have valid information.
+	 */
+	union {
+		/* Used by Rx/Tx adapter.
+		 * Indicates that all the elements in this vector belong to the
+		 * same port and queue pair. When originating from the Rx
+		 * adapter, these are the ethdev port and Rx queue the mbufs
+		 * were received from. When given to the Tx adapter, these
+		 * are the ethdev port and Tx queue to send the mbufs to.
+		 */
+		struct {
+			uint16_t port;
+			/**< Ethernet device port id. */
+			uint16_t queue;
+			/**< Ethernet device queue id. */
+		};
+	};
+	/**< Union to hold common attributes of the vector array. */
+	uint64_t impl_opaque;
+	/**< Implementation specific opaque value.
+	 * An implementation may use this field to hold implementation specific
+	 * value to share between dequeue and enqueue operation.
+	 * The application should not modify this field.
+	 */
+	union {
+		struct rte_mbuf *mbufs[0];
+		void *ptrs[0];
+		uint64_t u64s[0];
+	} __rte_aligned(16);
+	/**< Start of the vector array union. Depending upon the event type the
+	 * vector array can be an array of mbufs or pointers or opaque u64
+	 * values.
+	 */
+};
+
 /**
  * The generic *rte_event* structure to hold the event attributes
  * for dequeue and enqueue operation
@@ -1071,6 +1144,8 @@ struct rte_event {
 		/**< Opaque event pointer */
 		struct rte_mbuf *mbuf;
 		/**< mbuf pointer if dequeued event is associated with mbuf */
+		struct rte_event_vector *vec;
+		/**< Event vector pointer. */
 	};
 };
 
@@ -1090,6 +1165,12 @@ struct rte_event {
  * @see struct rte_event_eth_rx_adapter_queue_conf::ev
  * @see struct rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR	0x8
+/**< Adapter supports event vectorization per ethdev Rx queue. This flag is
+ * only meaningful along with RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT,
+ * the adapter service function always supports event vectorization.
+ * @see RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR
+ */
 
 /**
  * Retrieve the event device's ethdev Rx adapter capabilities for the
@@ -1186,6 +1267,12 @@ rte_event_crypto_adapter_caps_get(uint8_t dev_id, uint8_t cdev_id,
 #define RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT	0x1
 /**< This flag is sent when the PMD supports a packet transmit callback
  */
+#define RTE_EVENT_ETH_TX_ADAPTER_CAP_EVENT_VECTOR	0x2
+/**< This flag is sent when the PMD packet transmit callback supports
+ * event vectors. The adapter service function always supports event
+ * vectors.
+ * @see RTE_EVENT_TYPE_VECTOR
+ */
 
 /**
  * Retrieve the event device's eth Tx adapter capabilities
@@ -1969,6 +2056,58 @@ rte_event_dev_xstats_reset(uint8_t dev_id,
  */
 int rte_event_dev_selftest(uint8_t dev_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a mempool of event vectors.
+ *
+ * Each element of the mempool is a *rte_event_vector* with room for
+ * *nb_elem* objects in its vector array.
+ *
+ * @param name
+ *   The name of the mempool.
+ * @param n
+ *   The number of event vectors in the mempool.
+ * @param cache_size
+ *   Size of the per-core object cache. See rte_mempool_create() for
+ *   details.
+ * @param nb_elem
+ *   The maximum number of objects of each event vector.
+ * @param socket_id
+ *   The socket identifier where the memory should be allocated. The
+ *   value can be *SOCKET_ID_ANY* if there is no NUMA constraint for the
+ *   reserved zone.
+ * @return
+ *   The pointer to the newly allocated mempool, on success. NULL on error
+ *   with rte_errno set appropriately. Possible rte_errno values include:
+ *    - EINVAL - nb_elem is zero, or the element size is too large
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EEXIST - a memzone with the same name already exists
+ */
+__rte_experimental
+struct rte_mempool *
+rte_event_vector_pool_create(const char *name, unsigned int n,
+			     unsigned int cache_size, uint16_t nb_elem,
+			     int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the maximum number of objects of the event vectors of a mempool
+ * created with rte_event_vector_pool_create().
+ *
+ * @param mp
+ *   The event vector mempool.
+ * @return
+ *   The maximum number of objects of each event vector of the mempool,
+ *   or 0 if the mempool is not an event vector mempool.
+ */
+__rte_experimental
+uint16_t
+rte_event_vector_pool_elem_max(const struct rte_mempool *mp);
+
 #ifdef __cplusplus
 }
 #endif
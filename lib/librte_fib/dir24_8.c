@@ -0,0 +1,539 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_debug.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_memory.h>
+#include <rte_cpuflags.h>
+
+#include <rte_rib.h>
+#include <rte_fib.h>
+#include "dir24_8.h"
+
+#ifdef CC_DIR24_8_AVX512_SUPPORT
+#include "dir24_8_avx512.h"
+#endif
+
+#define DIR24_8_NAMESIZE	64
+
+#define BITMAP_SLAB_BIT_SIZE_LOG2	6
+#define BITMAP_SLAB_BIT_SIZE		(1 << BITMAP_SLAB_BIT_SIZE_LOG2)
+#define BITMAP_SLAB_BITMASK		(BITMAP_SLAB_BIT_SIZE - 1)
+
+static rte_fib_lookup_fn_t
+get_scalar_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return dir24_8_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return dir24_8_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return dir24_8_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return dir24_8_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+}
+
+static rte_fib_lookup_fn_t
+get_vector_fn(struct dir24_8_tbl *dp)
+{
+#ifdef CC_DIR24_8_AVX512_SUPPORT
+	/* tbl8 entry index must fit into a signed 32 bit gather index */
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0) ||
+			((uint64_t)dp->number_tbl8s *
+			DIR24_8_TBL8_GRP_NUM_ENT > INT32_MAX))
+		return NULL;
+
+	switch (dp->nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return rte_dir24_8_vec_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return rte_dir24_8_vec_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return rte_dir24_8_vec_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return rte_dir24_8_vec_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(dp);
+	return NULL;
+#endif
+}
+
+rte_fib_lookup_fn_t
+dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type)
+{
+	struct dir24_8_tbl *dp = p;
+	rte_fib_lookup_fn_t ret_fn;
+
+	if (dp == NULL)
+		return NULL;
+
+	switch (type) {
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR:
+		return get_scalar_fn(dp->nh_sz);
+	case RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512:
+		return get_vector_fn(dp);
+	case RTE_FIB_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn(dp);
+		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(dp->nh_sz);
+	default:
+		return NULL;
+	}
+}
+
+static uint64_t
+get_tbl24_ent(struct dir24_8_tbl *dp, uint32_t ip)
+{
+	uint32_t idx = ip >> 8;
+
+	switch (dp->nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return ((uint8_t *)dp->tbl24)[idx];
+	case RTE_FIB_DIR24_8_2B:
+		return ((uint16_t *)dp->tbl24)[idx];
+	case RTE_FIB_DIR24_8_4B:
+		return ((uint32_t *)dp->tbl24)[idx];
+	default:
+		return dp->tbl24[idx];
+	}
+}
+
+static void
+write_to_fib(void *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size, int n)
+{
+	int i;
+	uint8_t *ptr8 = (uint8_t *)ptr;
+	uint16_t *ptr16 = (uint16_t *)ptr;
+	uint32_t *ptr32 = (uint32_t *)ptr;
+	uint64_t *ptr64 = (uint64_t *)ptr;
+
+	switch (size) {
+	case RTE_FIB_DIR24_8_1B:
+		for (i = 0; i < n; i++)
+			ptr8[i] = (uint8_t)val;
+		break;
+	case RTE_FIB_DIR24_8_2B:
+		for (i = 0; i < n; i++)
+			ptr16[i] = (uint16_t)val;
+		break;
+	case RTE_FIB_DIR24_8_4B:
+		for (i = 0; i < n; i++)
+			ptr32[i] = (uint32_t)val;
+		break;
+	case RTE_FIB_DIR24_8_8B:
+		for (i = 0; i < n; i++)
+			ptr64[i] = (uint64_t)val;
+		break;
+	}
+}
+
+static void *
+get_tbl8_p(struct dir24_8_tbl *dp, uint32_t tbl8_idx)
+{
+	return (void *)&((uint8_t *)dp->tbl8)[(tbl8_idx *
+		DIR24_8_TBL8_GRP_NUM_ENT) << dp->nh_sz];
+}
+
+static int
+tbl8_get_idx(struct dir24_8_tbl *dp)
+{
+	uint32_t i, n_slabs;
+	uint32_t idx;
+
+	n_slabs = RTE_ALIGN_CEIL(dp->number_tbl8s, BITMAP_SLAB_BIT_SIZE) >>
+		BITMAP_SLAB_BIT_SIZE_LOG2;
+	for (i = 0; i < n_slabs; i++) {
+		if (dp->tbl8_idxes[i] == UINT64_MAX)
+			continue;
+		idx = (i << BITMAP_SLAB_BIT_SIZE_LOG2) +
+			__builtin_ctzll(~dp->tbl8_idxes[i]);
+		return (idx < dp->number_tbl8s) ? (int)idx : -ENOSPC;
+	}
+	return -ENOSPC;
+}
+
+static inline void
+tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
+{
+	dp->tbl8_idxes[idx >> BITMAP_SLAB_BIT_SIZE_LOG2] &=
+		~(1ULL << (idx & BITMAP_SLAB_BITMASK));
+	dp->cur_tbl8s--;
+}
+
+/*
+ * Allocate a tbl8 group and fill it with the given (not extended)
+ * entry, so that it reflects the tbl24 entry it is about to replace.
+ */
+static int
+tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
+{
+	int	tbl8_idx;
+
+	tbl8_idx = tbl8_get_idx(dp);
+	if (tbl8_idx < 0)
+		return tbl8_idx;
+	dp->tbl8_idxes[tbl8_idx >> BITMAP_SLAB_BIT_SIZE_LOG2] |=
+		1ULL << (tbl8_idx & BITMAP_SLAB_BITMASK);
+	dp->cur_tbl8s++;
+
+	write_to_fib(get_tbl8_p(dp, tbl8_idx), nh, dp->nh_sz,
+		DIR24_8_TBL8_GRP_NUM_ENT);
+	return tbl8_idx;
+}
+
+/*
+ * If all the entries of a tbl8 group are the same, collapse it back
+ * into the tbl24 entry and release the group.
+ */
+static void
+tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
+{
+	uint32_t i;
+	uint64_t nh;
+	uint8_t *ptr8;
+	uint16_t *ptr16;
+	uint32_t *ptr32;
+	uint64_t *ptr64;
+
+	switch (dp->nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		ptr8 = get_tbl8_p(dp, tbl8_idx);
+		nh = *ptr8;
+		for (i = 1; i < DIR24_8_TBL8_GRP_NUM_ENT; i++) {
+			if (nh != ptr8[i])
+				return;
+		}
+		((uint8_t *)dp->tbl24)[ip >> 8] = nh;
+		break;
+	case RTE_FIB_DIR24_8_2B:
+		ptr16 = get_tbl8_p(dp, tbl8_idx);
+		nh = *ptr16;
+		for (i = 1; i < DIR24_8_TBL8_GRP_NUM_ENT; i++) {
+			if (nh != ptr16[i])
+				return;
+		}
+		((uint16_t *)dp->tbl24)[ip >> 8] = nh;
+		break;
+	case RTE_FIB_DIR24_8_4B:
+		ptr32 = get_tbl8_p(dp, tbl8_idx);
+		nh = *ptr32;
+		for (i = 1; i < DIR24_8_TBL8_GRP_NUM_ENT; i++) {
+			if (nh != ptr32[i])
+				return;
+		}
+		((uint32_t *)dp->tbl24)[ip >> 8] = nh;
+		break;
+	case RTE_FIB_DIR24_8_8B:
+		ptr64 = get_tbl8_p(dp, tbl8_idx);
+		nh = *ptr64;
+		for (i = 1; i < DIR24_8_TBL8_GRP_NUM_ENT; i++) {
+			if (nh != ptr64[i])
+				return;
+		}
+		dp->tbl24[ip >> 8] = nh;
+		break;
+	}
+	tbl8_free_idx(dp, tbl8_idx);
+}
+
+/*
+ * Install next_hop for the [ledge, redge) range that lies inside
+ * a single /24, using a tbl8 group.
+ */
+static int
+install_to_tbl8(struct dir24_8_tbl *dp, uint64_t ledge, uint64_t redge,
+	uint64_t next_hop)
+{
+	uint64_t tbl24_tmp;
+	int tbl8_idx;
+
+	tbl24_tmp = get_tbl24_ent(dp, ledge);
+	if (!is_entry_extended(tbl24_tmp)) {
+		tbl8_idx = tbl8_alloc(dp, tbl24_tmp);
+		if (tbl8_idx < 0)
+			return -ENOSPC;
+		write_to_fib((uint8_t *)get_tbl8_p(dp, tbl8_idx) +
+			((ledge & ~DIR24_8_TBL24_MASK) << dp->nh_sz),
+			next_hop << 1, dp->nh_sz, redge - ledge);
+		/* make sure the tbl8 group is filled before linking it */
+		rte_wmb();
+		write_to_fib(get_tbl24_p(dp, ledge, dp->nh_sz),
+			((uint64_t)tbl8_idx << 1) | DIR24_8_EXT_ENT,
+			dp->nh_sz, 1);
+	} else {
+		tbl8_idx = tbl24_tmp >> 1;
+		write_to_fib((uint8_t *)get_tbl8_p(dp, tbl8_idx) +
+			((ledge & ~DIR24_8_TBL24_MASK) << dp->nh_sz),
+			next_hop << 1, dp->nh_sz, redge - ledge);
+	}
+	tbl8_recycle(dp, ledge, tbl8_idx);
+	return 0;
+}
+
+/*
+ * Install next_hop for the [ledge, redge) range.
+ * Edges are 64 bit wide to be able to express the whole address space.
+ */
+static int
+install_to_fib(struct dir24_8_tbl *dp, uint64_t ledge, uint64_t redge,
+	uint64_t next_hop)
+{
+	uint64_t tbl24_ledge, tbl24_redge, i, ent;
+	int ret;
+
+	tbl24_ledge = RTE_ALIGN_CEIL(ledge, DIR24_8_TBL8_GRP_NUM_ENT);
+	tbl24_redge = RTE_ALIGN_FLOOR(redge, DIR24_8_TBL8_GRP_NUM_ENT);
+
+	if (tbl24_ledge > tbl24_redge)
+		/* whole range is inside one /24 */
+		return install_to_tbl8(dp, ledge, redge, next_hop);
+
+	if (ledge != tbl24_ledge) {
+		ret = install_to_tbl8(dp, ledge, tbl24_ledge, next_hop);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (tbl24_redge > tbl24_ledge) {
+		/* release the tbl8 groups covered by the new route */
+		for (i = tbl24_ledge; i < tbl24_redge;
+				i += DIR24_8_TBL8_GRP_NUM_ENT) {
+			ent = get_tbl24_ent(dp, i);
+			if (is_entry_extended(ent)) {
+				write_to_fib(get_tbl24_p(dp, i, dp->nh_sz),
+					next_hop << 1, dp->nh_sz, 1);
+				tbl8_free_idx(dp, ent >> 1);
+			}
+		}
+		write_to_fib(get_tbl24_p(dp, tbl24_ledge, dp->nh_sz),
+			next_hop << 1, dp->nh_sz,
+			(tbl24_redge - tbl24_ledge) >> 8);
+	}
+
+	if (redge != tbl24_redge) {
+		ret = install_to_tbl8(dp, tbl24_redge, redge, next_hop);
+		if (ret < 0)
+			return ret;
+	}
+	return 0;
+}
+
+/*
+ * Write next_hop to the parts of ip/depth that are not covered
+ * by more specific routes.
+ */
+static int
+modify_fib(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth, uint64_t next_hop)
+{
+	struct rte_rib_node *tmp = NULL;
+	uint64_t ledge, redge;
+	uint32_t tmp_ip;
+	uint8_t tmp_depth;
+	int ret;
+
+	ledge = ip;
+	redge = (uint64_t)ip + (1ULL << (32 - depth));
+	while ((tmp = rte_rib_get_nxt(rib, ip, depth, tmp,
+			RTE_RIB_GET_NXT_COVER)) != NULL) {
+		rte_rib_get_depth(tmp, &tmp_depth);
+		rte_rib_get_ip(tmp, &tmp_ip);
+		if (tmp_ip > ledge) {
+			ret = install_to_fib(dp, ledge, tmp_ip, next_hop);
+			if (ret != 0)
+				return ret;
+		}
+		ledge = (uint64_t)tmp_ip + (1ULL << (32 - tmp_depth));
+	}
+	if (redge > ledge)
+		return install_to_fib(dp, ledge, redge, next_hop);
+
+	return 0;
+}
+
+int
+dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op)
+{
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *tmp = NULL;
+	struct rte_rib_node *node;
+	struct rte_rib_node *parent;
+	int ret = 0;
+	uint64_t par_nh, node_nh;
+
+	if ((fib == NULL) || (depth > RTE_FIB_MAXDEPTH))
+		return -EINVAL;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (next_hop > get_max_nh(dp->nh_sz))
+		return -EINVAL;
+
+	ip &= rte_rib_depth_to_mask(depth);
+
+	node = rte_rib_lookup_exact(rib, ip, depth);
+	switch (op) {
+	case RTE_FIB_ADD:
+		if (node != NULL) {
+			rte_rib_get_nh(node, &node_nh);
+			if (node_nh == next_hop)
+				return 0;
+			ret = modify_fib(dp, rib, ip, depth, next_hop);
+			if (ret == 0)
+				rte_rib_set_nh(node, next_hop);
+			return ret;
+		}
+		/*
+		 * A route longer than /24 needs a tbl8 group unless there
+		 * is already another one in the same /24, reserve it now
+		 * so modify_fib() can not run out of groups halfway.
+		 */
+		if (depth > 24) {
+			tmp = rte_rib_get_nxt(rib, ip, 24, NULL,
+				RTE_RIB_GET_NXT_COVER);
+			if ((tmp == NULL) &&
+					(dp->rsvd_tbl8s >= dp->number_tbl8s))
+				return -ENOSPC;
+		}
+		node = rte_rib_insert(rib, ip, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib_set_nh(node, next_hop);
+		parent = rte_rib_lookup_parent(node);
+		if (parent != NULL)
+			rte_rib_get_nh(parent, &par_nh);
+		else
+			par_nh = dp->def_nh;
+		if (par_nh != next_hop) {
+			ret = modify_fib(dp, rib, ip, depth, next_hop);
+			if (ret != 0) {
+				rte_rib_remove(rib, ip, depth);
+				return ret;
+			}
+		}
+		if ((depth > 24) && (tmp == NULL))
+			dp->rsvd_tbl8s++;
+		return 0;
+	case RTE_FIB_DEL:
+		if (node == NULL)
+			return -ENOENT;
+
+		parent = rte_rib_lookup_parent(node);
+		if (parent != NULL)
+			rte_rib_get_nh(parent, &par_nh);
+		else
+			par_nh = dp->def_nh;
+		rte_rib_get_nh(node, &node_nh);
+		if (par_nh != node_nh)
+			ret = modify_fib(dp, rib, ip, depth, par_nh);
+		if (ret == 0) {
+			rte_rib_remove(rib, ip, depth);
+			if (depth > 24) {
+				tmp = rte_rib_get_nxt(rib, ip, 24, NULL,
+					RTE_RIB_GET_NXT_COVER);
+				if (tmp == NULL)
+					dp->rsvd_tbl8s--;
+			}
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+void *
+dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
+{
+	char mem_name[DIR24_8_NAMESIZE];
+	struct dir24_8_tbl *dp;
+	uint64_t	def_nh;
+	uint64_t	tbl8_sz;
+	enum rte_fib_dir24_8_nh_sz	nh_sz;
+
+	if ((name == NULL) || (fib_conf == NULL) ||
+			(fib_conf->dir24_8.nh_sz < RTE_FIB_DIR24_8_1B) ||
+			(fib_conf->dir24_8.nh_sz > RTE_FIB_DIR24_8_8B) ||
+			(fib_conf->dir24_8.num_tbl8 >
+			get_max_nh(fib_conf->dir24_8.nh_sz)) ||
+			(fib_conf->dir24_8.num_tbl8 == 0) ||
+			(fib_conf->default_nh >
+			get_max_nh(fib_conf->dir24_8.nh_sz))) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	def_nh = fib_conf->default_nh;
+	nh_sz = fib_conf->dir24_8.nh_sz;
+
+	/*
+	 * Both tables are padded with a 32 bit word, so vector lookups
+	 * may use 32 bit gathers on 1 and 2 byte entries.
+	 */
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(mem_name, sizeof(struct dir24_8_tbl) +
+		(DIR24_8_TBL24_NUM_ENT * (1 << nh_sz)) + sizeof(uint32_t),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	/* Init table with default value */
+	write_to_fib(dp->tbl24, (def_nh << 1), nh_sz, 1 << 24);
+
+	snprintf(mem_name, sizeof(mem_name), "TBL8_%p", dp);
+	tbl8_sz = DIR24_8_TBL8_GRP_NUM_ENT * (1ULL << nh_sz) *
+			fib_conf->dir24_8.num_tbl8 + sizeof(uint32_t);
+	dp->tbl8 = rte_zmalloc_socket(mem_name, tbl8_sz,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->tbl8 == NULL) {
+		rte_errno = ENOMEM;
+		rte_free(dp);
+		return NULL;
+	}
+	dp->def_nh = def_nh;
+	dp->nh_sz = nh_sz;
+	dp->number_tbl8s = fib_conf->dir24_8.num_tbl8;
+
+	snprintf(mem_name, sizeof(mem_name), "TBL8_idxes_%p", dp);
+	dp->tbl8_idxes = rte_zmalloc_socket(mem_name,
+			RTE_ALIGN_CEIL(dp->number_tbl8s, BITMAP_SLAB_BIT_SIZE) >> 3,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->tbl8_idxes == NULL) {
+		rte_errno = ENOMEM;
+		rte_free(dp->tbl8);
+		rte_free(dp);
+		return NULL;
+	}
+
+	return dp;
+}
+
+void
+dir24_8_free(void *p)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+
+	rte_free(dp->tbl8_idxes);
+	rte_free(dp->tbl8);
+	rte_free(dp);
+}
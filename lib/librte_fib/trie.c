@@ -0,0 +1,622 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_debug.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_memory.h>
+#include <rte_cpuflags.h>
+
+#include <rte_rib6.h>
+#include <rte_fib6.h>
+#include "trie.h"
+
+#ifdef CC_TRIE_AVX512_SUPPORT
+#include "trie_avx512.h"
+#endif
+
+#define TRIE_NAMESIZE		64
+
+static rte_fib6_lookup_fn_t
+get_scalar_fn(enum rte_fib_trie_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return rte_trie_lookup_bulk_2b;
+	case RTE_FIB6_TRIE_4B:
+		return rte_trie_lookup_bulk_4b;
+	case RTE_FIB6_TRIE_8B:
+		return rte_trie_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+}
+
+static rte_fib6_lookup_fn_t
+get_vector_fn(struct rte_trie_tbl *dp)
+{
+#ifdef CC_TRIE_AVX512_SUPPORT
+	/* tbl8 entry index must fit into a signed 32 bit gather index */
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0) ||
+			((uint64_t)dp->number_tbl8s *
+			TRIE_TBL8_GRP_NUM_ENT > INT32_MAX))
+		return NULL;
+
+	switch (dp->nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return rte_trie_vec_lookup_bulk_2b;
+	case RTE_FIB6_TRIE_4B:
+		return rte_trie_vec_lookup_bulk_4b;
+	case RTE_FIB6_TRIE_8B:
+		return rte_trie_vec_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(dp);
+	return NULL;
+#endif
+}
+
+rte_fib6_lookup_fn_t
+trie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
+{
+	struct rte_trie_tbl *dp = p;
+	rte_fib6_lookup_fn_t ret_fn;
+
+	if (dp == NULL)
+		return NULL;
+
+	switch (type) {
+	case RTE_FIB6_LOOKUP_TRIE_SCALAR:
+		return get_scalar_fn(dp->nh_sz);
+	case RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512:
+		return get_vector_fn(dp);
+	case RTE_FIB6_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn(dp);
+		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(dp->nh_sz);
+	default:
+		return NULL;
+	}
+}
+
+static uint64_t
+get_ent(struct rte_trie_tbl *dp, void *tbl, uint32_t idx)
+{
+	switch (dp->nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return ((uint16_t *)tbl)[idx];
+	case RTE_FIB6_TRIE_4B:
+		return ((uint32_t *)tbl)[idx];
+	default:
+		return ((uint64_t *)tbl)[idx];
+	}
+}
+
+static void
+write_to_dp(void *ptr, uint64_t val, enum rte_fib_trie_nh_sz size, int n)
+{
+	int i;
+	uint16_t *ptr16 = (uint16_t *)ptr;
+	uint32_t *ptr32 = (uint32_t *)ptr;
+	uint64_t *ptr64 = (uint64_t *)ptr;
+
+	switch (size) {
+	case RTE_FIB6_TRIE_2B:
+		for (i = 0; i < n; i++)
+			ptr16[i] = (uint16_t)val;
+		break;
+	case RTE_FIB6_TRIE_4B:
+		for (i = 0; i < n; i++)
+			ptr32[i] = (uint32_t)val;
+		break;
+	case RTE_FIB6_TRIE_8B:
+		for (i = 0; i < n; i++)
+			ptr64[i] = (uint64_t)val;
+		break;
+	}
+}
+
+static void *
+get_tbl8_p(struct rte_trie_tbl *dp, uint32_t tbl8_idx)
+{
+	return (void *)&((uint8_t *)dp->tbl8)[(tbl8_idx *
+		TRIE_TBL8_GRP_NUM_ENT) << dp->nh_sz];
+}
+
+static void *
+get_ent_p(struct rte_trie_tbl *dp, void *tbl, uint32_t idx)
+{
+	return (void *)&((uint8_t *)tbl)[idx << dp->nh_sz];
+}
+
+/*
+ * Allocate a tbl8 group and fill it with the given (not extended)
+ * entry, so that it reflects the entry it is about to replace.
+ */
+static int
+tbl8_alloc(struct rte_trie_tbl *dp, uint64_t nh)
+{
+	uint32_t tbl8_idx;
+
+	if (dp->tbl8_pool_pos == dp->number_tbl8s)
+		return -ENOSPC;
+	tbl8_idx = dp->tbl8_pool[dp->tbl8_pool_pos++];
+	dp->cur_tbl8s++;
+
+	write_to_dp(get_tbl8_p(dp, tbl8_idx), nh, dp->nh_sz,
+		TRIE_TBL8_GRP_NUM_ENT);
+	return tbl8_idx;
+}
+
+static void
+tbl8_put(struct rte_trie_tbl *dp, uint32_t tbl8_idx)
+{
+	dp->tbl8_pool[--dp->tbl8_pool_pos] = tbl8_idx;
+	dp->cur_tbl8s--;
+}
+
+/* Release a tbl8 group and all the groups it points to. */
+static void
+tbl8_free_subtree(struct rte_trie_tbl *dp, uint32_t tbl8_idx)
+{
+	void *tbl = get_tbl8_p(dp, tbl8_idx);
+	uint64_t ent;
+	uint32_t i;
+
+	for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++) {
+		ent = get_ent(dp, tbl, i);
+		if (is_entry_extended(ent))
+			tbl8_free_subtree(dp, ent >> 1);
+	}
+	tbl8_put(dp, tbl8_idx);
+}
+
+/*
+ * If all the entries of a tbl8 group are the same, collapse it back
+ * into its parent entry and release the group.
+ */
+static void
+tbl8_recycle(struct rte_trie_tbl *dp, void *par_tbl, uint32_t par_idx,
+	uint32_t tbl8_idx)
+{
+	void *tbl = get_tbl8_p(dp, tbl8_idx);
+	uint64_t first;
+	uint32_t i;
+
+	first = get_ent(dp, tbl, 0);
+	if (is_entry_extended(first))
+		return;
+	for (i = 1; i < TRIE_TBL8_GRP_NUM_ENT; i++) {
+		if (get_ent(dp, tbl, i) != first)
+			return;
+	}
+	write_to_dp(get_ent_p(dp, par_tbl, par_idx), first, dp->nh_sz, 1);
+	tbl8_put(dp, tbl8_idx);
+}
+
+static inline uint8_t
+get_msk_part(uint8_t depth, int byte)
+{
+	uint8_t part;
+
+	byte &= 0xf;
+	depth = RTE_MIN(depth, RTE_FIB6_MAXDEPTH);
+	part = RTE_MAX((int16_t)depth - (byte * 8), 0);
+	part = (part > 8) ? 8 : part;
+	return (uint16_t)(~UINT8_MAX) >> part;
+}
+
+static inline int
+is_all(const uint8_t *p, uint8_t val, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (p[i] != val)
+			return 0;
+	return 1;
+}
+
+/* Write next_hop to the [from, to] entries of a table */
+static void
+write_full(struct rte_trie_tbl *dp, void *tbl, uint32_t from, uint32_t to,
+	uint64_t next_hop)
+{
+	uint64_t ent;
+	uint32_t i;
+
+	/* release the groups covered by the new entries */
+	for (i = from; i <= to; i++) {
+		ent = get_ent(dp, tbl, i);
+		if (is_entry_extended(ent)) {
+			write_to_dp(get_ent_p(dp, tbl, i), next_hop << 1,
+				dp->nh_sz, 1);
+			tbl8_free_subtree(dp, ent >> 1);
+		}
+	}
+	write_to_dp(get_ent_p(dp, tbl, from), next_hop << 1, dp->nh_sz,
+		to - from + 1);
+}
+
+static int
+install_to_dp(struct rte_trie_tbl *dp, void *tbl, int byte,
+	const uint8_t *ledge, const uint8_t *redge, uint64_t next_hop);
+
+/*
+ * Install the [ledge, redge] range that only partially covers
+ * entry idx of a table, descending into its tbl8 group.
+ */
+static int
+install_partial(struct rte_trie_tbl *dp, void *tbl, uint32_t idx,
+	int nxt_byte, const uint8_t *ledge, const uint8_t *redge,
+	uint64_t next_hop)
+{
+	uint64_t ent;
+	int tbl8_idx;
+	int ret;
+
+	ent = get_ent(dp, tbl, idx);
+	if (!is_entry_extended(ent)) {
+		tbl8_idx = tbl8_alloc(dp, ent);
+		if (tbl8_idx < 0)
+			return tbl8_idx;
+		ret = install_to_dp(dp, get_tbl8_p(dp, tbl8_idx), nxt_byte,
+			ledge, redge, next_hop);
+		/* make sure the tbl8 group is filled before linking it */
+		rte_wmb();
+		write_to_dp(get_ent_p(dp, tbl, idx),
+			((uint64_t)tbl8_idx << 1) | TRIE_EXT_ENT,
+			dp->nh_sz, 1);
+	} else {
+		tbl8_idx = ent >> 1;
+		ret = install_to_dp(dp, get_tbl8_p(dp, tbl8_idx), nxt_byte,
+			ledge, redge, next_hop);
+	}
+	tbl8_recycle(dp, tbl, idx, tbl8_idx);
+	return ret;
+}
+
+/*
+ * Install next_hop for the [ledge, redge] (both inclusive) range into
+ * the table resolving address byte "byte" onwards: tbl24 for byte 0,
+ * a tbl8 group for the next ones. Both edges share the address bytes
+ * resolved by the previous levels.
+ */
+static int
+install_to_dp(struct rte_trie_tbl *dp, void *tbl, int byte,
+	const uint8_t *ledge, const uint8_t *redge, uint64_t next_hop)
+{
+	uint8_t edge[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint32_t lidx, ridx;
+	int nxt_byte, lfull, rfull;
+	int ret;
+
+	if (byte == 0) {
+		lidx = get_tbl24_idx(ledge);
+		ridx = get_tbl24_idx(redge);
+		nxt_byte = TRIE_TBL8_FIRST_BYTE;
+	} else {
+		lidx = ledge[byte];
+		ridx = redge[byte];
+		nxt_byte = byte + 1;
+	}
+
+	/* check whether the edge entries are entirely covered */
+	lfull = is_all(ledge + nxt_byte, 0,
+		RTE_FIB6_IPV6_ADDR_SIZE - nxt_byte);
+	rfull = is_all(redge + nxt_byte, UINT8_MAX,
+		RTE_FIB6_IPV6_ADDR_SIZE - nxt_byte);
+
+	if (lidx == ridx) {
+		if (lfull && rfull) {
+			write_full(dp, tbl, lidx, ridx, next_hop);
+			return 0;
+		}
+		return install_partial(dp, tbl, lidx, nxt_byte, ledge, redge,
+			next_hop);
+	}
+
+	if (!lfull) {
+		memcpy(edge, ledge, RTE_FIB6_IPV6_ADDR_SIZE);
+		memset(edge + nxt_byte, UINT8_MAX,
+			RTE_FIB6_IPV6_ADDR_SIZE - nxt_byte);
+		ret = install_partial(dp, tbl, lidx, nxt_byte, ledge, edge,
+			next_hop);
+		if (ret < 0)
+			return ret;
+		lidx++;
+	}
+	if (!rfull) {
+		memcpy(edge, redge, RTE_FIB6_IPV6_ADDR_SIZE);
+		memset(edge + nxt_byte, 0, RTE_FIB6_IPV6_ADDR_SIZE - nxt_byte);
+		ret = install_partial(dp, tbl, ridx, nxt_byte, edge, redge,
+			next_hop);
+		if (ret < 0)
+			return ret;
+		ridx--;
+	}
+	if (lidx <= ridx)
+		write_full(dp, tbl, lidx, ridx, next_hop);
+
+	return 0;
+}
+
+/* Get the last address covered by ip/depth */
+static void
+get_last_addr(uint8_t *last, const uint8_t *ip, uint8_t depth)
+{
+	int i;
+
+	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
+		last[i] = ip[i] | ~get_msk_part(depth, i);
+}
+
+/* Increment an address, returns 1 if it wrapped around */
+static int
+inc_addr(uint8_t *ip)
+{
+	int i;
+
+	for (i = RTE_FIB6_IPV6_ADDR_SIZE - 1; i >= 0; i--)
+		if (++ip[i] != 0)
+			return 0;
+	return 1;
+}
+
+static void
+dec_addr(uint8_t *ip)
+{
+	int i;
+
+	for (i = RTE_FIB6_IPV6_ADDR_SIZE - 1; i >= 0; i--)
+		if (ip[i]-- != 0)
+			return;
+}
+
+/*
+ * Write next_hop to the parts of ip/depth that are not covered
+ * by more specific routes.
+ */
+static int
+modify_dp(struct rte_trie_tbl *dp, struct rte_rib6 *rib,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop)
+{
+	struct rte_rib6_node *tmp = NULL;
+	uint8_t ledge[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t redge[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t tmp_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t tmp_depth;
+	int ret;
+
+	rte_rib6_copy_addr(ledge, ip);
+	get_last_addr(redge, ip, depth);
+	while ((tmp = rte_rib6_get_nxt(rib, ip, depth, tmp,
+			RTE_RIB6_GET_NXT_COVER)) != NULL) {
+		rte_rib6_get_depth(tmp, &tmp_depth);
+		rte_rib6_get_ip(tmp, tmp_ip);
+		if (memcmp(tmp_ip, ledge, RTE_FIB6_IPV6_ADDR_SIZE) > 0) {
+			dec_addr(tmp_ip);
+			ret = install_to_dp(dp, dp->tbl24, 0, ledge, tmp_ip,
+				next_hop);
+			if (ret != 0)
+				return ret;
+			rte_rib6_get_ip(tmp, tmp_ip);
+		}
+		get_last_addr(ledge, tmp_ip, tmp_depth);
+		/* the subroute reaches the end of the address space */
+		if (inc_addr(ledge))
+			return 0;
+	}
+	if (memcmp(ledge, redge, RTE_FIB6_IPV6_ADDR_SIZE) <= 0)
+		return install_to_dp(dp, dp->tbl24, 0, ledge, redge, next_hop);
+
+	return 0;
+}
+
+/*
+ * Number of tbl8 groups a route would need that are not shared
+ * with other routes already present in the RIB.
+ */
+static uint32_t
+get_tbl8_need(struct rte_rib6 *rib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth)
+{
+	struct rte_rib6_node *tmp;
+	uint32_t cnt = 0;
+	int lvl_depth;
+
+	if (depth <= 24)
+		return 0;
+
+	/* groups are nested, stop at the first level shared with others */
+	for (lvl_depth = 24 + ((depth - 25) & ~7); lvl_depth >= 24;
+			lvl_depth -= 8) {
+		tmp = rte_rib6_get_nxt(rib, ip, lvl_depth, NULL,
+			RTE_RIB6_GET_NXT_COVER);
+		if (tmp != NULL)
+			break;
+		cnt++;
+	}
+	return cnt;
+}
+
+int
+trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop, int op)
+{
+	struct rte_trie_tbl *dp;
+	struct rte_rib6 *rib;
+	struct rte_rib6_node *node;
+	struct rte_rib6_node *parent;
+	uint8_t ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t par_nh, node_nh;
+	uint32_t tbl8_need;
+	int i, ret = 0;
+
+	if ((fib == NULL) || (ip == NULL) || (depth > RTE_FIB6_MAXDEPTH))
+		return -EINVAL;
+
+	dp = rte_fib6_get_dp(fib);
+	rib = rte_fib6_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (next_hop > get_max_nh(dp->nh_sz))
+		return -EINVAL;
+
+	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
+		ip_masked[i] = ip[i] & get_msk_part(depth, i);
+
+	node = rte_rib6_lookup_exact(rib, ip_masked, depth);
+	switch (op) {
+	case RTE_FIB6_ADD:
+		if (node != NULL) {
+			rte_rib6_get_nh(node, &node_nh);
+			if (node_nh == next_hop)
+				return 0;
+			ret = modify_dp(dp, rib, ip_masked, depth, next_hop);
+			if (ret == 0)
+				rte_rib6_set_nh(node, next_hop);
+			return ret;
+		}
+
+		/*
+		 * Reserve the tbl8 groups the route may need so that
+		 * modify_dp() can not run out of them halfway.
+		 */
+		tbl8_need = get_tbl8_need(rib, ip_masked, depth);
+		if (dp->rsvd_tbl8s + tbl8_need > dp->number_tbl8s)
+			return -ENOSPC;
+
+		node = rte_rib6_insert(rib, ip_masked, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib6_set_nh(node, next_hop);
+		parent = rte_rib6_lookup_parent(node);
+		if (parent != NULL)
+			rte_rib6_get_nh(parent, &par_nh);
+		else
+			par_nh = dp->def_nh;
+		if (par_nh != next_hop) {
+			ret = modify_dp(dp, rib, ip_masked, depth, next_hop);
+			if (ret != 0) {
+				rte_rib6_remove(rib, ip_masked, depth);
+				return ret;
+			}
+		}
+		dp->rsvd_tbl8s += tbl8_need;
+		return 0;
+	case RTE_FIB6_DEL:
+		if (node == NULL)
+			return -ENOENT;
+
+		parent = rte_rib6_lookup_parent(node);
+		if (parent != NULL)
+			rte_rib6_get_nh(parent, &par_nh);
+		else
+			par_nh = dp->def_nh;
+		rte_rib6_get_nh(node, &node_nh);
+		if (par_nh != node_nh)
+			ret = modify_dp(dp, rib, ip_masked, depth, par_nh);
+		if (ret == 0) {
+			rte_rib6_remove(rib, ip_masked, depth);
+			dp->rsvd_tbl8s -= get_tbl8_need(rib, ip_masked, depth);
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+void *
+trie_create(const char *name, int socket_id,
+	struct rte_fib6_conf *conf)
+{
+	char mem_name[TRIE_NAMESIZE];
+	struct rte_trie_tbl *dp = NULL;
+	uint64_t def_nh;
+	uint32_t num_tbl8;
+	uint32_t i;
+	enum rte_fib_trie_nh_sz nh_sz;
+
+	if ((name == NULL) || (conf == NULL) ||
+			(conf->trie.nh_sz < RTE_FIB6_TRIE_2B) ||
+			(conf->trie.nh_sz > RTE_FIB6_TRIE_8B) ||
+			(conf->trie.num_tbl8 >
+			get_max_nh(conf->trie.nh_sz)) ||
+			(conf->trie.num_tbl8 == 0) ||
+			(conf->default_nh >
+			get_max_nh(conf->trie.nh_sz))) {
+
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	def_nh = conf->default_nh;
+	nh_sz = conf->trie.nh_sz;
+	num_tbl8 = conf->trie.num_tbl8;
+
+	/*
+	 * Both tables are padded with a 32 bit word, so vector lookups
+	 * may use 32 bit gathers on 2 byte entries.
+	 */
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(mem_name, sizeof(struct rte_trie_tbl) +
+		(TRIE_TBL24_NUM_ENT << nh_sz) + sizeof(uint32_t),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return dp;
+	}
+
+	write_to_dp(&dp->tbl24, (def_nh << 1), nh_sz, 1 << 24);
+
+	snprintf(mem_name, sizeof(mem_name), "TBL8_%p", dp);
+	dp->tbl8 = rte_zmalloc_socket(mem_name, TRIE_TBL8_GRP_NUM_ENT *
+			(1ll << nh_sz) * num_tbl8 + sizeof(uint32_t),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->tbl8 == NULL) {
+		rte_errno = ENOMEM;
+		rte_free(dp);
+		return NULL;
+	}
+	dp->def_nh = def_nh;
+	dp->nh_sz = nh_sz;
+	dp->number_tbl8s = num_tbl8;
+
+	snprintf(mem_name, sizeof(mem_name), "TBL8_idxes_%p", dp);
+	dp->tbl8_pool = rte_zmalloc_socket(mem_name,
+			sizeof(uint32_t) * dp->number_tbl8s,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->tbl8_pool == NULL) {
+		rte_errno = ENOMEM;
+		rte_free(dp->tbl8);
+		rte_free(dp);
+		return NULL;
+	}
+
+	for (i = 0; i < dp->number_tbl8s; i++)
+		dp->tbl8_pool[i] = i;
+	dp->tbl8_pool_pos = 0;
+
+	return dp;
+}
+
+void
+trie_free(void *p)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+
+	rte_free(dp->tbl8_pool);
+	rte_free(dp->tbl8);
+	rte_free(dp);
+}
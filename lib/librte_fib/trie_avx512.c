@@ -0,0 +1,179 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_fib6.h>
+
+#include "trie.h"
+#include "trie_avx512.h"
+
+/*
+ * Address bytes are fetched with 32 bit gathers from within each
+ * 16 bytes address: byte j is the most significant byte of the word
+ * loaded at offset j - 3, so no load goes past the address.
+ */
+static __rte_always_inline __m512i
+get_addr_bytes_x16(uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], __m512i offsets,
+	__mmask16 msk, int byte)
+{
+	const __m512i zero = _mm512_set1_epi32(0);
+	__m512i res;
+
+	res = _mm512_mask_i32gather_epi32(zero, msk,
+		_mm512_add_epi32(offsets, _mm512_set1_epi32(byte - 3)),
+		(const int *)ips, 1);
+	return _mm512_srli_epi32(res, 24);
+}
+
+/* Lookup 16 addresses at once for 2 and 4 byte next hops. */
+static __rte_always_inline void
+trie_vec_lookup_x16(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, int size)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsb = _mm512_set1_epi32(1);
+	const __m512i lsbyte_msk = _mm512_set1_epi32(0xff);
+	const __m512i offsets = _mm512_set_epi32(
+		15 * 16, 14 * 16, 13 * 16, 12 * 16, 11 * 16, 10 * 16,
+		9 * 16, 8 * 16, 7 * 16, 6 * 16, 5 * 16, 4 * 16,
+		3 * 16, 2 * 16, 1 * 16, 0);
+	__m512i first, idxes, res, bytes, res_msk;
+	__mmask16 msk_ext;
+	int i;
+
+	if (size == sizeof(uint16_t))
+		res_msk = _mm512_set1_epi32(UINT16_MAX);
+	else
+		res_msk = _mm512_set1_epi32(UINT32_MAX);
+
+	/* tbl24 index is made of the 3 first bytes of the address */
+	first = _mm512_i32gather_epi32(offsets, (const int *)ips, 1);
+	idxes = _mm512_or_epi32(
+		_mm512_slli_epi32(_mm512_and_epi32(first, lsbyte_msk), 16),
+		_mm512_and_epi32(first, _mm512_set1_epi32(0xff00)));
+	idxes = _mm512_or_epi32(idxes,
+		_mm512_and_epi32(_mm512_srli_epi32(first, 16), lsbyte_msk));
+
+	if (size == sizeof(uint16_t))
+		res = _mm512_i32gather_epi32(idxes,
+			(const int *)dp->tbl24, 2);
+	else
+		res = _mm512_i32gather_epi32(idxes,
+			(const int *)dp->tbl24, 4);
+	res = _mm512_and_epi32(res, res_msk);
+
+	/* walk the tbl8 levels while some of the lanes are extended */
+	msk_ext = _mm512_test_epi32_mask(res, lsb);
+	for (i = TRIE_TBL8_FIRST_BYTE; (msk_ext != 0) &&
+			(i < RTE_FIB6_IPV6_ADDR_SIZE); i++) {
+		bytes = get_addr_bytes_x16(ips, offsets, msk_ext, i);
+		idxes = _mm512_srli_epi32(res, 1);
+		idxes = _mm512_slli_epi32(idxes, 8);
+		idxes = _mm512_maskz_add_epi32(msk_ext, idxes, bytes);
+		if (size == sizeof(uint16_t))
+			idxes = _mm512_mask_i32gather_epi32(zero, msk_ext,
+				idxes, (const int *)dp->tbl8, 2);
+		else
+			idxes = _mm512_mask_i32gather_epi32(zero, msk_ext,
+				idxes, (const int *)dp->tbl8, 4);
+		idxes = _mm512_and_epi32(idxes, res_msk);
+		res = _mm512_mask_blend_epi32(msk_ext, res, idxes);
+		msk_ext = _mm512_test_epi32_mask(res, lsb);
+	}
+
+	res = _mm512_srli_epi32(res, 1);
+	/* widen to 64 bit next hops */
+	_mm512_storeu_si512(next_hops,
+		_mm512_cvtepu32_epi64(_mm512_castsi512_si256(res)));
+	_mm512_storeu_si512(next_hops + 8,
+		_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(res, 1)));
+}
+
+/* Lookup 8 addresses at once for 8 byte next hops. */
+static __rte_always_inline void
+trie_vec_lookup_x8_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsb = _mm512_set1_epi64(1);
+	const __m256i lsbyte_msk = _mm256_set1_epi32(0xff);
+	const __m256i offsets = _mm256_set_epi32(7 * 16, 6 * 16, 5 * 16,
+		4 * 16, 3 * 16, 2 * 16, 1 * 16, 0);
+	__m256i first, idxes_256, bytes;
+	__m512i res, idxes;
+	__mmask8 msk_ext;
+	int i;
+
+	/* tbl24 index is made of the 3 first bytes of the address */
+	first = _mm256_i32gather_epi32((const int *)ips, offsets, 1);
+	idxes_256 = _mm256_or_si256(
+		_mm256_slli_epi32(_mm256_and_si256(first, lsbyte_msk), 16),
+		_mm256_and_si256(first, _mm256_set1_epi32(0xff00)));
+	idxes_256 = _mm256_or_si256(idxes_256,
+		_mm256_and_si256(_mm256_srli_epi32(first, 16), lsbyte_msk));
+
+	res = _mm512_i32gather_epi64(idxes_256, (const void *)dp->tbl24, 8);
+
+	/* walk the tbl8 levels while some of the lanes are extended */
+	msk_ext = _mm512_test_epi64_mask(res, lsb);
+	for (i = TRIE_TBL8_FIRST_BYTE; (msk_ext != 0) &&
+			(i < RTE_FIB6_IPV6_ADDR_SIZE); i++) {
+		bytes = _mm256_i32gather_epi32((const int *)ips,
+			_mm256_add_epi32(offsets, _mm256_set1_epi32(i - 3)), 1);
+		bytes = _mm256_srli_epi32(bytes, 24);
+		idxes = _mm512_srli_epi64(res, 1);
+		idxes = _mm512_slli_epi64(idxes, 8);
+		idxes = _mm512_maskz_add_epi64(msk_ext, idxes,
+			_mm512_cvtepu32_epi64(bytes));
+		idxes = _mm512_mask_i64gather_epi64(zero, msk_ext, idxes,
+			(const void *)dp->tbl8, 8);
+		res = _mm512_mask_blend_epi64(msk_ext, res, idxes);
+		msk_ext = _mm512_test_epi64_mask(res, lsb);
+	}
+
+	res = _mm512_srli_epi64(res, 1);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+rte_trie_vec_lookup_bulk_2b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		trie_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
+			sizeof(uint16_t));
+
+	rte_trie_lookup_bulk_2b(p, ips + i * 16, next_hops + i * 16,
+		n - i * 16);
+}
+
+void
+rte_trie_vec_lookup_bulk_4b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		trie_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
+			sizeof(uint32_t));
+
+	rte_trie_lookup_bulk_4b(p, ips + i * 16, next_hops + i * 16,
+		n - i * 16);
+}
+
+void
+rte_trie_vec_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		trie_vec_lookup_x8_8b(p, ips + i * 8, next_hops + i * 8);
+
+	rte_trie_lookup_bulk_8b(p, ips + i * 8, next_hops + i * 8, n - i * 8);
+}
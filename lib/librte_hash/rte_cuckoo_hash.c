@@ -31,6 +31,12 @@
 
 #include "rte_hash.h"
 #include "rte_cuckoo_hash.h"
+#if defined(CC_AVX2_SUPPORT)
+#include "rte_cuckoo_hash_avx2.h"
+#endif
+#if defined(CC_AVX512_SUPPORT)
+#include "rte_cuckoo_hash_avx512.h"
+#endif
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -121,6 +127,80 @@ get_alt_bucket_index(const struct rte_hash *h,
 	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
 }
 
+/*
+ * Get the key store entry of a key index. The key store of a resizable
+ * table is made of segments: segment 0 is allocated at creation, segment
+ * n >= 1 holds the key indexes [1 << (shift + n - 1), 1 << (shift + n)).
+ * Segments are never moved, so that readers can access the keys while
+ * the key store grows.
+ */
+static inline struct rte_hash_key *
+__hash_key_slot(const struct rte_hash *h, uint32_t idx)
+{
+	uint32_t seg;
+
+	if (likely(!h->resize_support))
+		return (struct rte_hash_key *)((char *)h->key_store +
+				(uintptr_t)idx * h->key_entry_size);
+
+	seg = idx >> h->key_seg_shift;
+	if (seg == 0)
+		return (struct rte_hash_key *)(h->key_seg[0] +
+				(uintptr_t)idx * h->key_entry_size);
+
+	seg = 32 - __builtin_clz(seg);
+	idx -= 1U << (h->key_seg_shift + seg - 1);
+	return (struct rte_hash_key *)(h->key_seg[seg] +
+			(uintptr_t)idx * h->key_entry_size);
+}
+
+/* Check a key index is in the key store, the dummy entry excluded */
+static inline int
+__hash_key_idx_valid(const struct rte_hash *h, uint32_t idx)
+{
+	uint32_t total_entries;
+
+	if (idx == EMPTY_SLOT)
+		return 0;
+
+	if (h->resize_support)
+		return idx < h->key_slots_first ||
+			(idx >= (1U << h->key_seg_shift) &&
+			idx < __atomic_load_n(&h->key_slots_end,
+					__ATOMIC_RELAXED));
+
+	total_entries = h->use_local_cache ?
+		h->entries + (RTE_MAX_LCORE - 1) * (LCORE_CACHE_SIZE - 1) + 1
+							: h->entries + 1;
+	return idx < total_entries;
+}
+
+/* Serialize the writers of a resizable table */
+static inline void
+__hash_resize_lock(const struct rte_hash *h)
+{
+	if (h->resize_support)
+		rte_spinlock_lock((rte_spinlock_t *)(uintptr_t)&h->resize_lock);
+}
+
+static inline void
+__hash_resize_unlock(const struct rte_hash *h)
+{
+	if (h->resize_support)
+		rte_spinlock_unlock(
+			(rte_spinlock_t *)(uintptr_t)&h->resize_lock);
+}
+
+/* Free a ring of free slots, which a resize may have allocated */
+static void
+__hash_ring_free(struct rte_ring *r)
+{
+	if (r != NULL && r->memzone == NULL)
+		rte_free(r);
+	else
+		rte_ring_free(r);
+}
+
 struct rte_hash *
 rte_hash_create(const struct rte_hash_parameters *params)
 {
@@ -145,6 +225,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	uint32_t *ext_bkt_to_free = NULL;
 	uint32_t *tbl_chng_cnt = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int aging_support = 0;
+	unsigned int resize_support = 0;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
 
@@ -199,6 +281,19 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		no_free_on_del = 1;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING)
+		aging_support = 1;
+
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZE) {
+		if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_EXT_TABLE) {
+			rte_errno = EINVAL;
+			RTE_LOG(ERR, HASH, "rte_hash_create: resize is not "
+				"supported with extendable bucket table\n");
+			return NULL;
+		}
+		resize_support = 1;
+	}
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (use_local_cache)
 		/*
@@ -407,8 +502,28 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->aging_support = aging_support;
+	h->resize_support = resize_support;
+	rte_spinlock_init(&h->resize_lock);
+	h->init_bucket_bitmask = h->bucket_bitmask;
+	h->key_seg[0] = k;
+	h->key_seg_shift = rte_bsf32(rte_align32pow2(num_key_slots));
+	h->key_slots_first = num_key_slots;
+	h->key_slots_end = 1U << h->key_seg_shift;
+	h->socket_id = params->socket_id;
 
 #if defined(RTE_ARCH_X86)
+#if defined(CC_AVX512_SUPPORT)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
+#if defined(CC_AVX2_SUPPORT)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX2;
+	else
+#endif
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -461,6 +576,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	uint32_t i;
 
 	if (h == NULL)
 		return;
@@ -484,13 +600,20 @@ rte_hash_free(struct rte_hash *h)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (h->dq != NULL)
+		rte_rcu_qsbr_dq_delete(h->dq);
 	if (h->use_local_cache)
 		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
 		rte_free(h->readwrite_lock);
-	rte_ring_free(h->free_slots);
+	__hash_ring_free(h->free_slots);
 	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
+	for (i = 1; i <= h->key_seg_num; i++)
+		rte_free(h->key_seg[i]);
+	for (i = 0; i < h->nb_retired; i++)
+		rte_free(h->retired_buckets[i]);
+	rte_free(h->old_buckets);
 	rte_free(h->buckets);
 	rte_free(h->buckets_ext);
 	rte_free(h->tbl_chng_cnt);
@@ -506,15 +629,13 @@ rte_hash_hash(const struct rte_hash *h, const void *key)
 	return h->hash_func(key, h->key_len, h->hash_func_init_val);
 }
 
-int32_t
-rte_hash_count(const struct rte_hash *h)
+/* Number of keys in the table, including the deleted keys not freed yet */
+static uint32_t
+__hash_count_keys(const struct rte_hash *h)
 {
 	uint32_t tot_ring_cnt, cached_cnt = 0;
 	uint32_t i, ret;
 
-	if (h == NULL)
-		return -EINVAL;
-
 	if (h->use_local_cache) {
 		tot_ring_cnt = h->entries + (RTE_MAX_LCORE - 1) *
 					(LCORE_CACHE_SIZE - 1);
@@ -530,6 +651,22 @@ rte_hash_count(const struct rte_hash *h)
 	return ret;
 }
 
+int32_t
+rte_hash_count(const struct rte_hash *h)
+{
+	int32_t ret;
+
+	if (h == NULL)
+		return -EINVAL;
+
+	/* A resize may replace the ring of free slots */
+	__hash_resize_lock(h);
+	ret = __hash_count_keys(h);
+	__hash_resize_unlock(h);
+
+	return ret;
+}
+
 /* Read write locks implemented using rte_rwlock */
 static inline void
 __hash_rw_writer_lock(const struct rte_hash *h)
@@ -576,10 +713,43 @@ rte_hash_reset(struct rte_hash *h)
 	if (h == NULL)
 		return;
 
+	__hash_resize_lock(h);
 	__hash_rw_writer_lock(h);
+
+	/* Wait for the readers and free the deleted keys still pending on
+	 * the defer queue, before the free lists are rebuilt.
+	 */
+	if (h->dq != NULL) {
+		rte_rcu_qsbr_synchronize(h->v, RTE_QSBR_THRID_INVALID);
+		rte_rcu_qsbr_dq_reclaim(h->dq, UINT32_MAX, NULL, NULL, NULL);
+	}
+
+	/* Drop the table being migrated from, and the old tables kept for
+	 * the lock free readers, none of them is running now.
+	 */
+	if (h->resize_support) {
+		rte_free(h->old_buckets);
+		h->old_buckets = NULL;
+		for (i = 0; i < h->nb_retired; i++) {
+			rte_free(h->retired_buckets[i]);
+			h->retired_buckets[i] = NULL;
+		}
+		h->nb_retired = 0;
+		if (h->resize_gen & 1)
+			h->resize_gen++;
+	}
+
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
-	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
+	if (h->resize_support) {
+		memset(h->key_store, 0,
+			(size_t)h->key_entry_size * h->key_slots_first);
+		for (i = 1; i <= h->key_seg_num; i++)
+			memset(h->key_seg[i], 0, (size_t)h->key_entry_size *
+				(1U << (h->key_seg_shift + i - 1)));
+	} else
+		memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
+	h->age_next = 0;
 
 	/* clear the free ring */
 	while (rte_ring_dequeue(h->free_slots, &ptr) == 0)
@@ -600,8 +770,19 @@ rte_hash_reset(struct rte_hash *h)
 	else
 		tot_ring_cnt = h->entries;
 
-	for (i = 1; i < tot_ring_cnt + 1; i++)
-		rte_ring_sp_enqueue(h->free_slots, (void *)((uintptr_t) i));
+	if (h->resize_support) {
+		/* Key indexes of segment 0, then of the other segments */
+		for (i = 1; i < h->key_slots_first; i++)
+			rte_ring_sp_enqueue(h->free_slots,
+					(void *)((uintptr_t) i));
+		for (i = 1U << h->key_seg_shift; i < h->key_slots_end; i++)
+			rte_ring_sp_enqueue(h->free_slots,
+					(void *)((uintptr_t) i));
+	} else {
+		for (i = 1; i < tot_ring_cnt + 1; i++)
+			rte_ring_sp_enqueue(h->free_slots,
+					(void *)((uintptr_t) i));
+	}
 
 	/* Repopulate the free ext bkt ring. */
 	if (h->ext_table_support) {
@@ -616,6 +797,7 @@ rte_hash_reset(struct rte_hash *h)
 			h->local_free_slots[i].len = 0;
 	}
 	__hash_rw_writer_unlock(h);
+	__hash_resize_unlock(h);
 }
 
 /*
@@ -635,6 +817,175 @@ enqueue_slot_back(const struct rte_hash *h,
 		rte_ring_sp_enqueue(h->free_slots, slot_id);
 }
 
+/*
+ * Return a key index to the cache/ring of free slots.
+ */
+static inline int
+free_slot(const struct rte_hash *h, uint32_t key_idx)
+{
+	unsigned int lcore_id, n_slots;
+	struct lcore_cache *cached_free_slots;
+
+	if (h->use_local_cache) {
+		lcore_id = rte_lcore_id();
+		cached_free_slots = &h->local_free_slots[lcore_id];
+		/* Cache full, need to free it. */
+		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
+			/* Need to enqueue the free slots in global ring. */
+			n_slots = rte_ring_mp_enqueue_burst(h->free_slots,
+						cached_free_slots->objs,
+						LCORE_CACHE_SIZE, NULL);
+			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
+			cached_free_slots->len -= n_slots;
+		}
+		/* Put index of new free slot in cache. */
+		cached_free_slots->objs[cached_free_slots->len] =
+					(void *)((uintptr_t)key_idx);
+		cached_free_slots->len++;
+	} else {
+		rte_ring_sp_enqueue(h->free_slots,
+				(void *)((uintptr_t)key_idx));
+	}
+
+	return 0;
+}
+
+/*
+ * Free a deleted key, and the ext bucket emptied by its deletion, or a
+ * bucket table retired by a resize, once the readers have reported a
+ * quiescent state. Called by the RCU defer queue, or directly in blocking
+ * mode, with the writer lock held.
+ */
+static void
+__hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
+{
+	const struct rte_hash *h = p;
+	struct __rte_hash_rcu_dq_entry *dq_entry = e;
+	struct rte_hash_key *k;
+
+	RTE_SET_USED(n);
+	if (dq_entry->buckets != NULL) {
+		rte_free(dq_entry->buckets);
+		return;
+	}
+
+	if (h->free_key_data_func != NULL) {
+		k = __hash_key_slot(h, dq_entry->key_idx);
+		h->free_key_data_func(h->key_data_ptr, k->pdata);
+	}
+
+	if (dq_entry->ext_bkt_idx != 0)
+		rte_ring_sp_enqueue(h->free_ext_bkts,
+			(void *)(uintptr_t)dq_entry->ext_bkt_idx);
+
+	free_slot(h, dq_entry->key_idx);
+}
+
+/*
+ * Free a deleted key with RCU configured. The key and its ext bucket
+ * are only returned to the free lists once the readers which may still
+ * reference them have reported a quiescent state.
+ * Writer holds the lock before calling this.
+ */
+static inline void
+__hash_rcu_qsbr_free(const struct rte_hash *h, uint32_t key_idx,
+		uint32_t ext_bkt_idx)
+{
+	struct __rte_hash_rcu_dq_entry dq_entry;
+
+	dq_entry.key_idx = key_idx;
+	dq_entry.ext_bkt_idx = ext_bkt_idx;
+	dq_entry.buckets = NULL;
+
+	/* Push into QSBR defer queue, fall back to blocking mode if full. */
+	if (h->rcu_mode == RTE_HASH_QSBR_MODE_DQ &&
+			rte_rcu_qsbr_dq_enqueue(h->dq, &dq_entry) == 0)
+		return;
+
+	/* Wait for quiescent state change. */
+	rte_rcu_qsbr_synchronize(h->v, RTE_QSBR_THRID_INVALID);
+	__hash_rcu_qsbr_free_resource((void *)(uintptr_t)h, &dq_entry, 1);
+}
+
+/*
+ * Reclaim deleted keys pending on the RCU defer queue when the free lists
+ * are exhausted. Waits for the readers rather than fail the add.
+ * Writer holds the lock before calling this.
+ */
+static inline unsigned int
+__hash_rcu_qsbr_reclaim(const struct rte_hash *h)
+{
+	unsigned int freed = 0, pending = 0;
+
+	if (h->dq == NULL)
+		return 0;
+
+	rte_rcu_qsbr_dq_reclaim(h->dq, RTE_HASH_RCU_DQ_RECLAIM_MAX,
+			&freed, &pending, NULL);
+	if (freed == 0 && pending != 0) {
+		rte_rcu_qsbr_synchronize(h->v, RTE_QSBR_THRID_INVALID);
+		rte_rcu_qsbr_dq_reclaim(h->dq, RTE_HASH_RCU_DQ_RECLAIM_MAX,
+				&freed, NULL, NULL);
+	}
+
+	return freed;
+}
+
+/*
+ * Get a free key index from the cache/ring of free slots.
+ * Returns EMPTY_SLOT if there is none.
+ */
+static inline uint32_t
+alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
+{
+	unsigned int n_slots;
+	void *slot_id;
+
+	if (h->use_local_cache) {
+		/* Try to get a free slot from the local cache */
+		if (cached_free_slots->len == 0) {
+			/* Need to get another burst of free slots from global ring */
+			n_slots = rte_ring_mc_dequeue_burst(h->free_slots,
+					cached_free_slots->objs,
+					LCORE_CACHE_SIZE, NULL);
+			if (n_slots == 0)
+				return EMPTY_SLOT;
+
+			cached_free_slots->len += n_slots;
+		}
+
+		/* Get a free slot from the local cache */
+		cached_free_slots->len--;
+		slot_id = cached_free_slots->objs[cached_free_slots->len];
+	} else {
+		if (rte_ring_sc_dequeue(h->free_slots, &slot_id) != 0)
+			return EMPTY_SLOT;
+	}
+
+	return (uint32_t)((uintptr_t)slot_id);
+}
+
+/*
+ * Refresh the aging timestamp of a bucket entry, when aging is enabled.
+ * The timestamp is only written when the epoch changed, so lookups do not
+ * dirty the bucket cache line on every hit.
+ */
+static inline void
+__hash_age_refresh(const struct rte_hash *h,
+		const struct rte_hash_bucket *bkt, unsigned int i)
+{
+	uint8_t *stamp;
+	uint8_t epoch;
+
+	if (!h->aging_support)
+		return;
+
+	stamp = (uint8_t *)(uintptr_t)&bkt->flag[i];
+	epoch = __atomic_load_n(&h->age_epoch, __ATOMIC_RELAXED);
+	if (__atomic_load_n(stamp, __ATOMIC_RELAXED) != epoch)
+		__atomic_store_n(stamp, epoch, __ATOMIC_RELAXED);
+}
+
 /* Search a key from bucket and update its data.
  * Writer holds the lock before calling this.
  */
@@ -643,12 +994,11 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 	struct rte_hash_bucket *bkt, uint16_t sig)
 {
 	int i;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == sig) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+			k = __hash_key_slot(h, bkt->key_idx[i]);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				/* The store to application data at *data
 				 * should not leak after the store to pdata
@@ -659,6 +1009,7 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 				__atomic_store_n(&k->pdata,
 					data,
 					__ATOMIC_RELEASE);
+				__hash_age_refresh(h, bkt, i);
 				/*
 				 * Return index where key is stored,
 				 * subtracting the first dummy index
@@ -714,6 +1065,7 @@ rte_hash_cuckoo_insert_mw(const struct rte_hash *h,
 		/* Check if slot is available */
 		if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
 			prim_bkt->sig_current[i] = sig;
+			prim_bkt->flag[i] = h->age_epoch;
 			/* Store to signature and key should not
 			 * leak after the store to key_idx. i.e.
 			 * key_idx is the guard variable for signature
@@ -823,6 +1175,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 		 */
 		curr_bkt->sig_current[curr_slot] =
 			prev_bkt->sig_current[prev_slot];
+		curr_bkt->flag[curr_slot] = prev_bkt->flag[prev_slot];
 		/* Release the updated bucket entry */
 		__atomic_store_n(&curr_bkt->key_idx[curr_slot],
 			prev_bkt->key_idx[prev_slot],
@@ -850,6 +1203,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	}
 
 	curr_bkt->sig_current[curr_slot] = sig;
+	curr_bkt->flag[curr_slot] = h->age_epoch;
 	/* Release the new bucket entry */
 	__atomic_store_n(&curr_bkt->key_idx[curr_slot],
 			 new_idx,
@@ -925,12 +1279,12 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
-	struct rte_hash_key *new_k, *keys = h->key_store;
+	struct rte_hash_key *new_k;
 	void *slot_id = NULL;
 	void *ext_bkt_id = NULL;
 	uint32_t new_idx, bkt_id;
 	int ret;
-	unsigned n_slots;
+	unsigned int freed;
 	unsigned lcore_id;
 	unsigned int i;
 	struct lcore_cache *cached_free_slots = NULL;
@@ -968,30 +1322,21 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	if (h->use_local_cache) {
 		lcore_id = rte_lcore_id();
 		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Try to get a free slot from the local cache */
-		if (cached_free_slots->len == 0) {
-			/* Need to get another burst of free slots from global ring */
-			n_slots = rte_ring_mc_dequeue_burst(h->free_slots,
-					cached_free_slots->objs,
-					LCORE_CACHE_SIZE, NULL);
-			if (n_slots == 0) {
-				return -ENOSPC;
-			}
-
-			cached_free_slots->len += n_slots;
-		}
-
-		/* Get a free slot from the local cache */
-		cached_free_slots->len--;
-		slot_id = cached_free_slots->objs[cached_free_slots->len];
-	} else {
-		if (rte_ring_sc_dequeue(h->free_slots, &slot_id) != 0) {
-			return -ENOSPC;
-		}
 	}
+	new_idx = alloc_slot(h, cached_free_slots);
+	if (new_idx == EMPTY_SLOT && h->dq != NULL) {
+		/* Try to reclaim the keys deleted by now. */
+		__hash_rw_writer_lock(h);
+		freed = __hash_rcu_qsbr_reclaim(h);
+		__hash_rw_writer_unlock(h);
+		if (freed != 0)
+			new_idx = alloc_slot(h, cached_free_slots);
+	}
+	if (new_idx == EMPTY_SLOT)
+		return -ENOSPC;
 
-	new_k = RTE_PTR_ADD(keys, (uintptr_t)slot_id * h->key_entry_size);
-	new_idx = (uint32_t)((uintptr_t) slot_id);
+	slot_id = (void *)((uintptr_t)new_idx);
+	new_k = __hash_key_slot(h, new_idx);
 	/* The store to application data (by the application) at *data should
 	 * not leak after the store of pdata in the key store. i.e. pdata is
 	 * the guard variable. Release the application data to the readers.
@@ -1064,6 +1409,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 			/* Check if slot is available */
 			if (likely(cur_bkt->key_idx[i] == EMPTY_SLOT)) {
 				cur_bkt->sig_current[i] = short_sig;
+				cur_bkt->flag[i] = h->age_epoch;
 				/* Store to signature and key should not
 				 * leak after the store to key_idx. i.e.
 				 * key_idx is the guard variable for signature
@@ -1081,14 +1427,19 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	/* Failed to get an empty entry from extendable buckets. Link a new
 	 * extendable bucket. We first get a free bucket from ring.
 	 */
-	if (rte_ring_sc_dequeue(h->free_ext_bkts, &ext_bkt_id) != 0) {
-		ret = -ENOSPC;
-		goto failure;
+	while (rte_ring_sc_dequeue(h->free_ext_bkts, &ext_bkt_id) != 0) {
+		/* Try to reclaim the buckets emptied by deletes by now. */
+		if (__hash_rcu_qsbr_reclaim(h) == 0) {
+			free_slot(h, new_idx);
+			ret = -ENOSPC;
+			goto failure;
+		}
 	}
 
 	bkt_id = (uint32_t)((uintptr_t)ext_bkt_id) - 1;
 	/* Use the first location of the new bucket */
 	(h->buckets_ext[bkt_id]).sig_current[0] = short_sig;
+	(h->buckets_ext[bkt_id]).flag[0] = h->age_epoch;
 	/* Store to signature and key should not leak after
 	 * the store to key_idx. i.e. key_idx is the guard variable
 	 * for signature and key.
@@ -1108,67 +1459,420 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 }
 
-int32_t
-rte_hash_add_key_with_hash(const struct rte_hash *h,
-			const void *key, hash_sig_t sig)
+/*
+ * Keep or free the bucket table a resize migrated from. The lock free
+ * readers may still access it: it is then freed through the RCU defer
+ * queue, or after a grace period once the resize lock is released, or
+ * when the table is freed if RCU is not configured. The other readers
+ * take the lock the table was switched under.
+ * Writer holds the resize lock before calling this.
+ */
+static void
+__hash_resize_retire(struct rte_hash *h, struct rte_hash_bucket *old)
 {
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, sig, 0);
+	struct __rte_hash_rcu_dq_entry dq_entry;
+	int ret = -1;
+
+	if (!h->readwrite_concur_lf_support) {
+		rte_free(old);
+	} else if (h->v == NULL) {
+		/* Resizes stop before the array is full */
+		RTE_ASSERT(h->nb_retired < RTE_HASH_MAX_RESIZES);
+		h->retired_buckets[h->nb_retired++] = old;
+	} else {
+		if (h->dq != NULL) {
+			dq_entry.key_idx = EMPTY_SLOT;
+			dq_entry.ext_bkt_idx = 0;
+			dq_entry.buckets = old;
+			__hash_rw_writer_lock(h);
+			ret = rte_rcu_qsbr_dq_enqueue(h->dq, &dq_entry);
+			__hash_rw_writer_unlock(h);
+		}
+		if (ret != 0)
+			h->sync_buckets = old;
+	}
 }
 
-int32_t
-rte_hash_add_key(const struct rte_hash *h, const void *key)
+/*
+ * Release the resize lock, then free the bucket table retired meanwhile
+ * once the lock free readers reported a quiescent state. The writers are
+ * not blocked during the grace period.
+ */
+static void
+__hash_resize_unlock_sync(struct rte_hash *h)
 {
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), 0);
+	struct rte_hash_bucket *old = h->sync_buckets;
+
+	h->sync_buckets = NULL;
+	rte_spinlock_unlock(&h->resize_lock);
+
+	if (old != NULL) {
+		rte_rcu_qsbr_synchronize(h->v, RTE_QSBR_THRID_INVALID);
+		rte_free(old);
+	}
 }
 
-int
-rte_hash_add_key_with_hash_data(const struct rte_hash *h,
-			const void *key, hash_sig_t sig, void *data)
+/*
+ * Add a key store segment holding as many keys as all the previous ones,
+ * and move the free slots to a ring big enough for all the key indexes.
+ * Writer holds the resize lock before calling this.
+ */
+static int
+__hash_key_store_grow(struct rte_hash *h)
 {
-	int ret;
+	const uint32_t seg = h->key_seg_num + 1;
+	struct rte_ring *r = NULL, *old_r;
+	char ring_name[RTE_RING_NAMESIZE];
+	uint32_t seg_start, num_slots, n, i;
+	void *objs[LCORE_CACHE_SIZE];
+	ssize_t ring_size;
+	char *k = NULL;
+
+	if (seg >= RTE_HASH_KEY_SEG_MAX || h->key_seg_shift + seg >= 32)
+		return -ENOSPC;
+
+	seg_start = 1U << (h->key_seg_shift + seg - 1);
+	if ((uint64_t)h->entries + seg_start > RTE_HASH_ENTRIES_MAX)
+		return -ENOSPC;
+
+	/* All the key indexes, but the dummy one, go in the new ring */
+	num_slots = h->key_slots_first - 1 +
+		(seg_start << 1) - (1U << h->key_seg_shift);
+	ring_size = rte_ring_get_memsize(rte_align32pow2(num_slots + 1));
+	if (ring_size < 0)
+		return -ENOSPC;
+
+	k = rte_zmalloc_socket(NULL, (size_t)h->key_entry_size * seg_start,
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	r = rte_zmalloc_socket(NULL, ring_size, RTE_CACHE_LINE_SIZE,
+			h->socket_id);
+	if (k == NULL || r == NULL) {
+		RTE_LOG(ERR, HASH, "key store memory allocation failed\n");
+		rte_free(k);
+		rte_free(r);
+		return -ENOMEM;
+	}
+
+	snprintf(ring_name, sizeof(ring_name), "HT_%s", h->name);
+	rte_ring_init(r, ring_name, rte_align32pow2(num_slots + 1), 0);
+
+	/* Publish the new segment before its key indexes can be used */
+	__atomic_store_n(&h->key_seg[seg], k, __ATOMIC_RELEASE);
+	h->key_seg_num = seg;
+	__atomic_store_n(&h->key_slots_end, seg_start << 1, __ATOMIC_RELAXED);
+
+	/* Move the free slots to the new ring, then add the new ones */
+	old_r = h->free_slots;
+	while ((n = rte_ring_sc_dequeue_burst(old_r, objs, RTE_DIM(objs),
+			NULL)) != 0)
+		rte_ring_sp_enqueue_bulk(r, objs, n, NULL);
+	for (i = seg_start; i < seg_start << 1; i++)
+		rte_ring_sp_enqueue(r, (void *)((uintptr_t)i));
+	h->free_slots = r;
+	__hash_ring_free(old_r);
+	h->entries += seg_start;
 
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	ret = __rte_hash_add_key_with_hash(h, key, sig, data);
-	if (ret >= 0)
-		return 0;
-	else
-		return ret;
+	return 0;
 }
 
-int
-rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
+/*
+ * Start a resize: switch to a bucket table twice as big. The entries of
+ * the old table are migrated afterwards, the lookups search both tables
+ * meanwhile.
+ * Writer holds the resize lock before calling this.
+ */
+static int
+__hash_resize_start(struct rte_hash *h)
 {
-	int ret;
+	const uint32_t num_buckets = h->num_buckets << 1;
+	struct rte_hash_bucket *buckets;
 
-	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	if ((uint64_t)num_buckets * RTE_HASH_BUCKET_ENTRIES >
+			RTE_HASH_ENTRIES_MAX)
+		return -ENOSPC;
 
-	ret = __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), data);
-	if (ret >= 0)
-		return 0;
-	else
-		return ret;
+	/* No room to keep the table for the lock free readers */
+	if (h->readwrite_concur_lf_support && h->v == NULL &&
+			h->nb_retired == RTE_HASH_MAX_RESIZES)
+		return -ENOSPC;
+
+	buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	if (buckets == NULL) {
+		RTE_LOG(ERR, HASH, "buckets memory allocation failed\n");
+		return -ENOMEM;
+	}
+
+	__hash_rw_writer_lock(h);
+	h->old_bucket_bitmask = h->bucket_bitmask;
+	__atomic_store_n(&h->old_buckets, h->buckets, __ATOMIC_RELEASE);
+	h->migrate_next = 0;
+	/* The readers which load the new bitmask load the new table.
+	 * Those which load the old bitmask stay in bounds of both tables.
+	 */
+	__atomic_store_n(&h->buckets, buckets, __ATOMIC_RELEASE);
+	__atomic_store_n(&h->bucket_bitmask, num_buckets - 1,
+			__ATOMIC_RELEASE);
+	h->num_buckets = num_buckets;
+	/* Lookups which started before the switch search again */
+	__atomic_store_n(&h->resize_gen, h->resize_gen + 1, __ATOMIC_RELEASE);
+	if (h->readwrite_concur_lf_support) {
+		__atomic_store_n(h->tbl_chng_cnt, *h->tbl_chng_cnt + 1,
+				__ATOMIC_RELEASE);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+	__hash_rw_writer_unlock(h);
+
+	return 0;
 }
 
-/* Search one bucket to find the match key - uses rw lock */
-static inline int32_t
-search_one_bucket_l(const struct rte_hash *h, const void *key,
-		uint16_t sig, void **data,
-		const struct rte_hash_bucket *bkt)
+/*
+ * Move the entries of an old bucket to the new table. Each entry keeps
+ * its key index, it is inserted in the new table before being removed
+ * from the old one, so that it is always found by the readers.
+ *
+ * An entry of old bucket b goes to the bucket of the new table it would
+ * be in with the same choice of primary or alternative bucket, which is
+ * b or b + old size. Only the entries of b go there until b is migrated:
+ * the adds do not move entries around while resizing, see
+ * __hash_resize_prepare_add(). So there is always room, and the
+ * migration cannot fail.
+ * Writer holds the resize lock before calling this.
+ */
+static void
+__hash_resize_migrate_bucket(struct rte_hash *h, uint32_t bkt_idx)
 {
-	int i;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_bucket *bkt = &h->old_buckets[bkt_idx];
+	struct rte_hash_bucket *new_bkt;
+	uint32_t new_bkt_idx, key_idx;
+	struct rte_hash_key *k;
+	uint16_t short_sig;
+	hash_sig_t sig;
+	unsigned int i, j;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		key_idx = bkt->key_idx[i];
+		if (key_idx == EMPTY_SLOT)
+			continue;
+
+		k = __hash_key_slot(h, key_idx);
+		sig = rte_hash_hash(h, k->key);
+		short_sig = get_short_sig(sig);
+		new_bkt_idx = get_prim_bucket_index(h, sig);
+		if ((sig & h->old_bucket_bitmask) != bkt_idx)
+			new_bkt_idx = get_alt_bucket_index(h, new_bkt_idx,
+							short_sig);
+		new_bkt = &h->buckets[new_bkt_idx];
+
+		for (j = 0; j < RTE_HASH_BUCKET_ENTRIES; j++)
+			if (new_bkt->key_idx[j] == EMPTY_SLOT)
+				break;
+		RTE_ASSERT(j != RTE_HASH_BUCKET_ENTRIES);
+
+		__hash_rw_writer_lock(h);
+		new_bkt->sig_current[j] = short_sig;
+		/* The entry is not used by the move, keep its age */
+		new_bkt->flag[j] = __atomic_load_n(&bkt->flag[i],
+						__ATOMIC_RELAXED);
+		/* Store to signature and key should not leak after
+		 * the store to key_idx. i.e. key_idx is the guard
+		 * variable for signature and key.
+		 */
+		__atomic_store_n(&new_bkt->key_idx[j], key_idx,
+				__ATOMIC_RELEASE);
+		if (h->readwrite_concur_lf_support) {
+			/* Inform the readers that the entry moved */
+			__atomic_store_n(h->tbl_chng_cnt,
+					 *h->tbl_chng_cnt + 1,
+					 __ATOMIC_RELEASE);
+			/* The store to sig_current should not
+			 * move above the store to tbl_chng_cnt.
+			 */
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+		}
+		bkt->sig_current[i] = NULL_SIGNATURE;
+		__atomic_store_n(&bkt->key_idx[i], EMPTY_SLOT,
+				__ATOMIC_RELEASE);
+		__hash_rw_writer_unlock(h);
+	}
+}
+
+/*
+ * Migrate up to num old buckets, and complete the resize once the old
+ * table is empty.
+ * Writer holds the resize lock before calling this.
+ */
+static void
+__hash_resize_migrate(struct rte_hash *h, uint32_t num)
+{
+	struct rte_hash_bucket *old;
+
+	if (h->old_buckets == NULL)
+		return;
+
+	for (; num != 0 && h->migrate_next <= h->old_bucket_bitmask; num--)
+		__hash_resize_migrate_bucket(h, h->migrate_next++);
+
+	if (h->migrate_next <= h->old_bucket_bitmask)
+		return;
+
+	__hash_rw_writer_lock(h);
+	old = h->old_buckets;
+	__atomic_store_n(&h->old_buckets, NULL, __ATOMIC_RELEASE);
+	__atomic_store_n(&h->resize_gen, h->resize_gen + 1, __ATOMIC_RELEASE);
+	__hash_rw_writer_unlock(h);
+
+	__hash_resize_retire(h, old);
+}
+
+/*
+ * Prepare the add of a key while resizing. The old buckets the key may
+ * be in are migrated, so that the key is only searched for in the new
+ * table by the writer, and the new buckets of the key only hold migrated
+ * entries. The cuckoo search could move entries to new buckets whose old
+ * ones are not migrated yet, so the resize is completed first if the
+ * key does not fit in its primary bucket.
+ * Writer holds the resize lock before calling this.
+ */
+static void
+__hash_resize_prepare_add(struct rte_hash *h, hash_sig_t sig)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *prim_bkt;
+	unsigned int i;
+
+	if (h->old_buckets == NULL)
+		return;
+
+	prim_bucket_idx = sig & h->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ get_short_sig(sig)) &
+				h->old_bucket_bitmask;
+	__hash_resize_migrate_bucket(h, prim_bucket_idx);
+	__hash_resize_migrate_bucket(h, sec_bucket_idx);
+	__hash_resize_migrate(h, RTE_HASH_RESIZE_MIGRATE_BUCKETS);
+	if (h->old_buckets == NULL)
+		return;
+
+	prim_bkt = &h->buckets[get_prim_bucket_index(h, sig)];
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++)
+		if (prim_bkt->key_idx[i] == EMPTY_SLOT)
+			return;
+	__hash_resize_migrate(h, UINT32_MAX);
+}
+
+static inline int32_t
+__rte_hash_add_key_with_hash_resize(struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	uint32_t capacity;
+	int32_t ret;
+
+	rte_spinlock_lock(&h->resize_lock);
+
+	/* Grow the key store before the free slots run out */
+	if (rte_ring_count(h->free_slots) < h->entries / 8)
+		__hash_key_store_grow(h);
+
+	/* Grow the bucket table before the cuckoo paths get too long. The
+	 * slots cached by the lcores are only counted once an add failed.
+	 */
+	capacity = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	if (h->old_buckets == NULL && !h->use_local_cache &&
+			__hash_count_keys(h) >= capacity - capacity / 8)
+		__hash_resize_start(h);
+
+	__hash_resize_prepare_add(h, sig);
+	ret = __rte_hash_add_key_with_hash(h, key, sig, data);
+
+	/* No room for this key in a table at least half full: complete
+	 * the current resize and start another one.
+	 */
+	capacity = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	if (ret == -ENOSPC && __hash_count_keys(h) >= capacity / 2) {
+		__hash_resize_migrate(h, UINT32_MAX);
+		if (__hash_resize_start(h) == 0) {
+			__hash_resize_prepare_add(h, sig);
+			ret = __rte_hash_add_key_with_hash(h, key, sig, data);
+		}
+	}
+
+	__hash_resize_unlock_sync(h);
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_add_key(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	if (h->resize_support)
+		return __rte_hash_add_key_with_hash_resize(
+				(struct rte_hash *)(uintptr_t)h, key, sig, data);
+	else
+		return __rte_hash_add_key_with_hash(h, key, sig, data);
+}
+
+int32_t
+rte_hash_add_key_with_hash(const struct rte_hash *h,
+			const void *key, hash_sig_t sig)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_add_key(h, key, sig, 0);
+}
+
+int32_t
+rte_hash_add_key(const struct rte_hash *h, const void *key)
+{
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	return __rte_hash_add_key(h, key, rte_hash_hash(h, key), 0);
+}
+
+int
+rte_hash_add_key_with_hash_data(const struct rte_hash *h,
+			const void *key, hash_sig_t sig, void *data)
+{
+	int ret;
+
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+	ret = __rte_hash_add_key(h, key, sig, data);
+	if (ret >= 0)
+		return 0;
+	else
+		return ret;
+}
+
+int
+rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
+{
+	int ret;
+
+	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
+
+	ret = __rte_hash_add_key(h, key, rte_hash_hash(h, key), data);
+	if (ret >= 0)
+		return 0;
+	else
+		return ret;
+}
+
+/* Search one bucket to find the match key - uses rw lock */
+static inline int32_t
+search_one_bucket_l(const struct rte_hash *h, const void *key,
+		uint16_t sig, void **data,
+		const struct rte_hash_bucket *bkt)
+{
+	int i;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == sig &&
 				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+			k = __hash_key_slot(h, bkt->key_idx[i]);
 
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				if (data != NULL)
 					*data = k->pdata;
+				__hash_age_refresh(h, bkt, i);
 				/*
 				 * Return index where key is stored,
 				 * subtracting the first dummy index
@@ -1187,7 +1891,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 {
 	int i;
 	uint32_t key_idx;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		/* Signature comparison is done before the acquire-load
@@ -1201,8 +1905,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 			key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 			if (key_idx != EMPTY_SLOT) {
-				k = (struct rte_hash_key *) ((char *)keys +
-						key_idx * h->key_entry_size);
+				k = __hash_key_slot(h, key_idx);
 
 				if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 					if (data != NULL) {
@@ -1210,6 +1913,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 							&k->pdata,
 							__ATOMIC_ACQUIRE);
 					}
+					__hash_age_refresh(h, bkt, i);
 					/*
 					 * Return index where key is stored,
 					 * subtracting the first dummy index
@@ -1324,11 +2028,99 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+/* Search the primary and secondary buckets of a key in one table */
+static inline int32_t
+search_bucket_pair(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		void **data, const struct rte_hash_bucket *buckets,
+		uint32_t bucket_bitmask)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = sig & bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) & bucket_bitmask;
+
+	if (h->readwrite_concur_lf_support) {
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+				&buckets[prim_bucket_idx]);
+		if (ret == -1)
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+					&buckets[sec_bucket_idx]);
+	} else {
+		ret = search_one_bucket_l(h, key, short_sig, data,
+				&buckets[prim_bucket_idx]);
+		if (ret == -1)
+			ret = search_one_bucket_l(h, key, short_sig, data,
+					&buckets[sec_bucket_idx]);
+	}
+	return ret;
+}
+
+/*
+ * Lookup in a resizable table, searching the old table first while
+ * resizing: an entry is inserted in the new table before being removed
+ * from the old one. The bitmasks are derived from the resize generation,
+ * the tables loaded afterwards are at least as big, so the bucket
+ * indexes stay in bounds even if the table is resized meanwhile, the
+ * search is then done again.
+ */
+static inline int32_t
+__rte_hash_lookup_with_hash_resize(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	const struct rte_hash_bucket *buckets, *old_buckets;
+	uint32_t cnt_b, cnt_a, gen, bucket_bitmask;
+	int32_t ret;
+
+	__hash_rw_reader_lock(h);
+	do {
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+		gen = __atomic_load_n(&h->resize_gen, __ATOMIC_ACQUIRE);
+		bucket_bitmask = ((h->init_bucket_bitmask + 1) <<
+					((gen + 1) >> 1)) - 1;
+
+		if (gen & 1) {
+			old_buckets = __atomic_load_n(&h->old_buckets,
+					__ATOMIC_ACQUIRE);
+			if (old_buckets != NULL) {
+				ret = search_bucket_pair(h, key, sig, data,
+						old_buckets,
+						bucket_bitmask >> 1);
+				if (ret != -1)
+					goto out;
+			}
+		}
+
+		buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+		ret = search_bucket_pair(h, key, sig, data, buckets,
+				bucket_bitmask);
+		if (ret != -1)
+			goto out;
+
+		/* The loads of sig_current in search_one_bucket
+		 * should not move below the loads of tbl_chng_cnt
+		 * and resize_gen.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a ||
+		gen != __atomic_load_n(&h->resize_gen, __ATOMIC_ACQUIRE));
+
+	ret = -ENOENT;
+out:
+	__hash_rw_reader_unlock(h);
+	return ret;
+}
+
 static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resize_support)
+		return __rte_hash_lookup_with_hash_resize(h, key, sig, data);
+	else if (h->readwrite_concur_lf_support)
 		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
 		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
@@ -1411,6 +2203,7 @@ __rte_hash_compact_ll(const struct rte_hash *h,
 	for (i = RTE_HASH_BUCKET_ENTRIES - 1; i >= 0; i--) {
 		if (last_bkt->key_idx[i] != EMPTY_SLOT) {
 			cur_bkt->sig_current[pos] = last_bkt->sig_current[i];
+			cur_bkt->flag[pos] = last_bkt->flag[i];
 			__atomic_store_n(&cur_bkt->key_idx[pos],
 					 last_bkt->key_idx[i],
 					 __ATOMIC_RELEASE);
@@ -1444,7 +2237,7 @@ static inline int32_t
 search_and_remove(const struct rte_hash *h, const void *key,
 			struct rte_hash_bucket *bkt, uint16_t sig, int *pos)
 {
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 	unsigned int i;
 	uint32_t key_idx;
 
@@ -1453,8 +2246,7 @@ search_and_remove(const struct rte_hash *h, const void *key,
 		key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 		if (bkt->sig_current[i] == sig && key_idx != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					key_idx * h->key_entry_size);
+			k = __hash_key_slot(h, key_idx);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				bkt->sig_current[i] = NULL_SIGNATURE;
 				/* Free the key store index if
@@ -1489,6 +2281,7 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	int pos;
 	int32_t ret, i;
 	uint16_t short_sig;
+	uint32_t index = 0;
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
@@ -1523,10 +2316,8 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 
 /* Search last bucket to see if empty to be recycled */
 return_bkt:
-	if (!last_bkt) {
-		__hash_rw_writer_unlock(h);
-		return ret;
-	}
+	if (!last_bkt)
+		goto return_key;
 	while (last_bkt->next) {
 		prev_bkt = last_bkt;
 		last_bkt = last_bkt->next;
@@ -1539,10 +2330,13 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	/* found empty bucket and recycle */
 	if (i == RTE_HASH_BUCKET_ENTRIES) {
 		prev_bkt->next = NULL;
-		uint32_t index = last_bkt - h->buckets_ext + 1;
+		index = last_bkt - h->buckets_ext + 1;
 		/* Recycle the empty bkt if
-		 * no_free_on_del is disabled.
+		 * no_free_on_del is disabled. With RCU configured, it is
+		 * recycled along with the key index below.
 		 */
+		if (h->v != NULL)
+			goto return_key;
 		if (h->no_free_on_del)
 			/* Store index of an empty ext bkt to be recycled
 			 * on calling rte_hash_del_xxx APIs.
@@ -1556,23 +2350,88 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		else
 			rte_ring_sp_enqueue(h->free_ext_bkts, (void *)(uintptr_t)index);
 	}
+
+return_key:
+	/* With RCU configured, free the key index once the readers are done
+	 * with it. Key index where key is stored, adding the first dummy index.
+	 */
+	if (h->v != NULL)
+		__hash_rcu_qsbr_free(h, ret + 1, index);
 	__hash_rw_writer_unlock(h);
 	return ret;
 }
 
+/*
+ * Delete a key from the old buckets it may be in, while resizing.
+ * Writer holds the resize lock before calling this.
+ */
+static inline int32_t
+__hash_resize_del_old_key(struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+	int pos;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = sig & h->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) & h->old_bucket_bitmask;
+
+	__hash_rw_writer_lock(h);
+	ret = search_and_remove(h, key, &h->old_buckets[prim_bucket_idx],
+				short_sig, &pos);
+	if (ret == -1)
+		ret = search_and_remove(h, key,
+				&h->old_buckets[sec_bucket_idx],
+				short_sig, &pos);
+	if (ret != -1 && h->v != NULL)
+		__hash_rcu_qsbr_free(h, ret + 1, 0);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_del_key_with_hash_resize(struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	int32_t ret = -1;
+
+	rte_spinlock_lock(&h->resize_lock);
+	if (h->old_buckets != NULL)
+		ret = __hash_resize_del_old_key(h, key, sig);
+	if (ret == -1)
+		ret = __rte_hash_del_key_with_hash(h, key, sig);
+	__hash_resize_migrate(h, RTE_HASH_RESIZE_MIGRATE_BUCKETS);
+	__hash_resize_unlock_sync(h);
+
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_del_key(const struct rte_hash *h, const void *key, hash_sig_t sig)
+{
+	if (h->resize_support)
+		return __rte_hash_del_key_with_hash_resize(
+				(struct rte_hash *)(uintptr_t)h, key, sig);
+	else
+		return __rte_hash_del_key_with_hash(h, key, sig);
+}
+
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_del_key_with_hash(h, key, sig);
+	return __rte_hash_del_key(h, key, sig);
 }
 
 int32_t
 rte_hash_del_key(const struct rte_hash *h, const void *key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
+	return __rte_hash_del_key(h, key, rte_hash_hash(h, key));
 }
 
 int
@@ -1581,9 +2440,12 @@ rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
-	struct rte_hash_key *k, *keys = h->key_store;
-	k = (struct rte_hash_key *) ((char *) keys + (position + 1) *
-				     h->key_entry_size);
+	struct rte_hash_key *k;
+
+	if (!__hash_key_idx_valid(h, position + 1))
+		return -EINVAL;
+
+	k = __hash_key_slot(h, position + 1);
 	*key = k->key;
 
 	if (position !=
@@ -1602,16 +2464,12 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 	/* Key index where key is stored, adding the first dummy index */
 	uint32_t key_idx = position + 1;
 
-	RETURN_IF_TRUE(((h == NULL) || (key_idx == EMPTY_SLOT)), -EINVAL);
+	int ret;
 
-	unsigned int lcore_id, n_slots;
-	struct lcore_cache *cached_free_slots;
-	const uint32_t total_entries = h->use_local_cache ?
-		h->entries + (RTE_MAX_LCORE - 1) * (LCORE_CACHE_SIZE - 1) + 1
-							: h->entries + 1;
+	RETURN_IF_TRUE(((h == NULL) || (key_idx == EMPTY_SLOT)), -EINVAL);
 
 	/* Out of bounds */
-	if (key_idx >= total_entries)
+	if (!__hash_key_idx_valid(h, key_idx))
 		return -EINVAL;
 	if (h->ext_table_support && h->readwrite_concur_lf_support) {
 		uint32_t index = h->ext_bkt_to_free[position];
@@ -1622,30 +2480,97 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 		}
 	}
 
-	if (h->use_local_cache) {
-		lcore_id = rte_lcore_id();
-		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Cache full, need to free it. */
-		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
-			/* Need to enqueue the free slots in global ring. */
-			n_slots = rte_ring_mp_enqueue_burst(h->free_slots,
-						cached_free_slots->objs,
-						LCORE_CACHE_SIZE, NULL);
-			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
-			cached_free_slots->len -= n_slots;
+	/* A resize may replace the ring of free slots */
+	__hash_resize_lock(h);
+	ret = free_slot(h, key_idx);
+	__hash_resize_unlock(h);
+
+	return ret;
+}
+
+/* Associate QSBR variable with a hash table.
+ */
+int
+rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg,
+	struct rte_rcu_qsbr_dq **dq)
+{
+	/* Leave room for the "RCU_" prefix added by the defer queue. */
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE - 4];
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+
+	if (h == NULL || cfg == NULL || cfg->v == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	/* Readers of the other modes are not expected to report
+	 * quiescent states, nor need to.
+	 */
+	if (!h->readwrite_concur_lf_support) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (h->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_HASH_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_HASH_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"HT_%s", h->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = h->entries;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_HASH_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(struct __rte_hash_rcu_dq_entry);
+		params.free_fn = __hash_rcu_qsbr_free_resource;
+		params.p = h;
+		params.v = cfg->v;
+		h->dq = rte_rcu_qsbr_dq_create(&params);
+		if (h->dq == NULL) {
+			RTE_LOG(ERR, HASH, "Hash defer queue creation failed\n");
+			return 1;
 		}
-		/* Put index of new free slot in cache. */
-		cached_free_slots->objs[cached_free_slots->len] =
-					(void *)((uintptr_t)key_idx);
-		cached_free_slots->len++;
+		if (dq != NULL)
+			*dq = h->dq;
 	} else {
-		rte_ring_sp_enqueue(h->free_slots,
-				(void *)((uintptr_t)key_idx));
+		rte_errno = EINVAL;
+		return 1;
 	}
+	h->rcu_mode = cfg->mode;
+	h->key_data_ptr = cfg->key_data_ptr;
+	h->free_key_data_func = cfg->free_key_data_func;
+	h->v = cfg->v;
 
 	return 0;
 }
 
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets)
+{
+	int ret;
+
+	if (h == NULL || !h->resize_support)
+		return -EINVAL;
+
+	rte_spinlock_lock(&h->resize_lock);
+	__hash_resize_migrate(h, num_buckets);
+	ret = 0;
+	if (h->old_buckets != NULL)
+		ret = h->old_bucket_bitmask + 1 - h->migrate_next;
+	__hash_resize_unlock_sync(h);
+
+	return ret;
+}
+
 static inline void
 compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 			const struct rte_hash_bucket *prim_bkt,
@@ -1657,7 +2582,20 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 
 	/* For match mask the first bit of every two bits indicates the match */
 	switch (sig_cmp_fn) {
+#if defined(CC_AVX2_SUPPORT)
+	/* single key lookups of an AVX512 table too */
+	case RTE_HASH_COMPARE_AVX512:
+	case RTE_HASH_COMPARE_AVX2:
+		rte_hash_compare_signatures_avx2(prim_hash_matches,
+			sec_hash_matches, (const void * const *)&prim_bkt,
+			(const void * const *)&sec_bkt, &sig, 1);
+		break;
+#endif
 #if defined(RTE_MACHINE_CPUFLAG_SSE2)
+#if !defined(CC_AVX2_SUPPORT)
+	/* single key lookups of an AVX512 table */
+	case RTE_HASH_COMPARE_AVX512:
+#endif
 	case RTE_HASH_COMPARE_SSE:
 		/* Compare all signatures in the bucket */
 		*prim_hash_matches = _mm_movemask_epi8(_mm_cmpeq_epi16(
@@ -1690,6 +2628,8 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 		break;
 #endif
 	default:
+		*prim_hash_matches = 0;
+		*sec_hash_matches = 0;
 		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 			*prim_hash_matches |=
 				((sig == prim_bkt->sig_current[i]) << (i << 1));
@@ -1700,23 +2640,29 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 }
 
 #define PREFETCH_OFFSET 4
-static inline void
-__rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
-			int32_t num_keys, int32_t *positions,
-			uint64_t *hit_mask, void *data[])
+
+/*
+ * First stage of a bulk lookup: compute the hash and the signature of
+ * each key, locate its primary and secondary buckets and prefetch them.
+ */
+static inline void
+__bulk_lookup_prefetching_loop(const struct rte_hash *h,
+			const void **keys, int32_t num_keys, uint16_t *sig,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt)
 {
-	uint64_t hits = 0;
+	const struct rte_hash_bucket *buckets;
+	uint32_t bucket_bitmask;
 	int32_t i;
-	int32_t ret;
-	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
-	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
-	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	struct rte_hash_bucket *cur_bkt, *next_bkt;
+	uint32_t prim_hash;
+	uint32_t prim_index;
+	uint32_t sec_index;
+
+	/* A resize stores the new table before the new bitmask, so the
+	 * bucket indexes are in bounds of the table loaded afterwards.
+	 */
+	bucket_bitmask = __atomic_load_n(&h->bucket_bitmask, __ATOMIC_ACQUIRE);
+	buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
 
 	/* Prefetch first keys */
 	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
@@ -1726,74 +2672,204 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 	 * Prefetch rest of the keys, calculate primary and
 	 * secondary bucket and prefetch them
 	 */
-	for (i = 0; i < (num_keys - PREFETCH_OFFSET); i++) {
-		rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+	for (i = 0; i < num_keys; i++) {
+		if (i + PREFETCH_OFFSET < num_keys)
+			rte_prefetch0(keys[i + PREFETCH_OFFSET]);
 
-		prim_hash[i] = rte_hash_hash(h, keys[i]);
+		prim_hash = rte_hash_hash(h, keys[i]);
 
-		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		sig[i] = get_short_sig(prim_hash);
+		prim_index = prim_hash & bucket_bitmask;
+		sec_index = (prim_index ^ sig[i]) & bucket_bitmask;
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &buckets[prim_index];
+		secondary_bkt[i] = &buckets[sec_index];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
 	}
+}
 
-	/* Calculate and prefetch rest of the buckets */
-	for (; i < num_keys; i++) {
-		prim_hash[i] = rte_hash_hash(h, keys[i]);
-
-		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
-
-		rte_prefetch0(primary_bkt[i]);
-		rte_prefetch0(secondary_bkt[i]);
-	}
+/*
+ * Second stage of a bulk lookup: compare the signatures of the keys
+ * with the ones stored in their buckets and prefetch the key slot of
+ * the first hit of each key.
+ */
+static inline void
+__bulk_compare_signatures(const struct rte_hash *h, int32_t num_keys,
+			const uint16_t *sig,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			uint32_t *prim_hitmask, uint32_t *sec_hitmask)
+{
+	int32_t i;
+	uint32_t first_hit;
+	uint32_t key_idx;
 
-	__hash_rw_reader_lock(h);
+	/* The signatures start the buckets */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_hash_bucket, sig_current) != 0);
 
-	/* Compare signatures and prefetch key slot of first hit */
-	for (i = 0; i < num_keys; i++) {
+	/* The arrays are only filled for a non-empty burst */
+#if defined(CC_AVX512_SUPPORT)
+	if (h->sig_cmp_fn == RTE_HASH_COMPARE_AVX512 && num_keys > 0)
+		rte_hash_compare_signatures_avx512(prim_hitmask, sec_hitmask,
+			(const void * const *)primary_bkt,
+			(const void * const *)secondary_bkt, sig, num_keys);
+	else
+#endif
+#if defined(CC_AVX2_SUPPORT)
+	if (h->sig_cmp_fn == RTE_HASH_COMPARE_AVX2 && num_keys > 0)
+		rte_hash_compare_signatures_avx2(prim_hitmask, sec_hitmask,
+			(const void * const *)primary_bkt,
+			(const void * const *)secondary_bkt, sig, num_keys);
+	else
+#endif
+	for (i = 0; i < num_keys; i++)
 		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
 			primary_bkt[i], secondary_bkt[i],
 			sig[i], h->sig_cmp_fn);
 
+	for (i = 0; i < num_keys; i++) {
 		if (prim_hitmask[i]) {
-			uint32_t first_hit =
+			first_hit = __builtin_ctzl(prim_hitmask[i]) >> 1;
+			key_idx = primary_bkt[i]->key_idx[first_hit];
+		} else if (sec_hitmask[i]) {
+			first_hit = __builtin_ctzl(sec_hitmask[i]) >> 1;
+			key_idx = secondary_bkt[i]->key_idx[first_hit];
+		} else
+			continue;
+
+		rte_prefetch0(__hash_key_slot(h, key_idx));
+	}
+}
+
+/*
+ * Last stage of a bulk lookup, for lock based tables: compare the keys,
+ * first hits in primary first, then walk the extendable buckets.
+ * Has to be called with the reader lock held since the signatures were
+ * compared. Returns the mask of the keys found.
+ */
+static inline uint64_t
+__bulk_compare_keys_l(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, const uint16_t *sig,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			uint32_t *prim_hitmask, uint32_t *sec_hitmask,
+			int32_t *positions, void *data[])
+{
+	uint64_t hits = 0;
+	int32_t i;
+	int32_t ret;
+	struct rte_hash_bucket *cur_bkt, *next_bkt;
+
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = -ENOENT;
+		while (prim_hitmask[i]) {
+			uint32_t hit_index =
 					__builtin_ctzl(prim_hitmask[i])
 					>> 1;
 			uint32_t key_idx =
-				primary_bkt[i]->key_idx[first_hit];
+				primary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
-			rte_prefetch0(key_slot);
-			continue;
+				__hash_key_slot(h, key_idx);
+
+			/*
+			 * If key index is 0, do not compare key,
+			 * as it is checking the dummy slot
+			 */
+			if (!!key_idx &
+				!rte_hash_cmp_eq(
+					key_slot->key, keys[i], h)) {
+				if (data != NULL)
+					data[i] = key_slot->pdata;
+				__hash_age_refresh(h, primary_bkt[i],
+						hit_index);
+
+				hits |= 1ULL << i;
+				positions[i] = key_idx - 1;
+				goto next_key;
+			}
+			prim_hitmask[i] &= ~(3ULL << (hit_index << 1));
 		}
 
-		if (sec_hitmask[i]) {
-			uint32_t first_hit =
+		while (sec_hitmask[i]) {
+			uint32_t hit_index =
 					__builtin_ctzl(sec_hitmask[i])
 					>> 1;
 			uint32_t key_idx =
-				secondary_bkt[i]->key_idx[first_hit];
+				secondary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
-			rte_prefetch0(key_slot);
+				__hash_key_slot(h, key_idx);
+
+			/*
+			 * If key index is 0, do not compare key,
+			 * as it is checking the dummy slot
+			 */
+
+			if (!!key_idx &
+				!rte_hash_cmp_eq(
+					key_slot->key, keys[i], h)) {
+				if (data != NULL)
+					data[i] = key_slot->pdata;
+				__hash_age_refresh(h, secondary_bkt[i],
+						hit_index);
+
+				hits |= 1ULL << i;
+				positions[i] = key_idx - 1;
+				goto next_key;
+			}
+			sec_hitmask[i] &= ~(3ULL << (hit_index << 1));
 		}
+next_key:
+		continue;
 	}
 
-	/* Compare keys, first hits in primary first */
+	/* all found, do not need to go through ext bkt */
+	if ((hits == ((1ULL << num_keys) - 1)) || !h->ext_table_support)
+		return hits;
+
+	/* need to check ext buckets for match */
+	for (i = 0; i < num_keys; i++) {
+		if ((hits & (1ULL << i)) != 0)
+			continue;
+		next_bkt = secondary_bkt[i]->next;
+		FOR_EACH_BUCKET(cur_bkt, next_bkt) {
+			if (data != NULL)
+				ret = search_one_bucket_l(h, keys[i],
+						sig[i], &data[i], cur_bkt);
+			else
+				ret = search_one_bucket_l(h, keys[i],
+						sig[i], NULL, cur_bkt);
+			if (ret != -1) {
+				positions[i] = ret;
+				hits |= 1ULL << i;
+				break;
+			}
+		}
+	}
+
+	return hits;
+}
+
+/*
+ * Last stage of a bulk lookup, for lock-free tables: compare the keys,
+ * first hits in primary first, then walk the extendable buckets.
+ * The caller has to validate the result against the table change
+ * counter. Returns the mask of the keys found.
+ */
+static inline uint64_t
+__bulk_compare_keys_lf(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, const uint16_t *sig,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			uint32_t *prim_hitmask, uint32_t *sec_hitmask,
+			int32_t *positions, void *data[])
+{
+	uint64_t hits = 0;
+	int32_t i;
+	int32_t ret;
+	struct rte_hash_bucket *cur_bkt, *next_bkt;
+
 	for (i = 0; i < num_keys; i++) {
 		positions[i] = -ENOENT;
 		while (prim_hitmask[i]) {
@@ -1801,11 +2877,11 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 					__builtin_ctzl(prim_hitmask[i])
 					>> 1;
 			uint32_t key_idx =
-				primary_bkt[i]->key_idx[hit_index];
+			__atomic_load_n(
+				&primary_bkt[i]->key_idx[hit_index],
+				__ATOMIC_ACQUIRE);
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				__hash_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -1815,7 +2891,11 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 				!rte_hash_cmp_eq(
 					key_slot->key, keys[i], h)) {
 				if (data != NULL)
-					data[i] = key_slot->pdata;
+					data[i] = __atomic_load_n(
+						&key_slot->pdata,
+						__ATOMIC_ACQUIRE);
+				__hash_age_refresh(h, primary_bkt[i],
+						hit_index);
 
 				hits |= 1ULL << i;
 				positions[i] = key_idx - 1;
@@ -1829,11 +2909,11 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 					__builtin_ctzl(sec_hitmask[i])
 					>> 1;
 			uint32_t key_idx =
-				secondary_bkt[i]->key_idx[hit_index];
+			__atomic_load_n(
+				&secondary_bkt[i]->key_idx[hit_index],
+				__ATOMIC_ACQUIRE);
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				__hash_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -1844,7 +2924,11 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 				!rte_hash_cmp_eq(
 					key_slot->key, keys[i], h)) {
 				if (data != NULL)
-					data[i] = key_slot->pdata;
+					data[i] = __atomic_load_n(
+						&key_slot->pdata,
+						__ATOMIC_ACQUIRE);
+				__hash_age_refresh(h, secondary_bkt[i],
+						hit_index);
 
 				hits |= 1ULL << i;
 				positions[i] = key_idx - 1;
@@ -1857,12 +2941,8 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 	}
 
 	/* all found, do not need to go through ext bkt */
-	if ((hits == ((1ULL << num_keys) - 1)) || !h->ext_table_support) {
-		if (hit_mask != NULL)
-			*hit_mask = hits;
-		__hash_rw_reader_unlock(h);
-		return;
-	}
+	if ((hits == ((1ULL << num_keys) - 1)) || !h->ext_table_support)
+		return hits;
 
 	/* need to check ext buckets for match */
 	for (i = 0; i < num_keys; i++) {
@@ -1871,10 +2951,10 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 		next_bkt = secondary_bkt[i]->next;
 		FOR_EACH_BUCKET(cur_bkt, next_bkt) {
 			if (data != NULL)
-				ret = search_one_bucket_l(h, keys[i],
+				ret = search_one_bucket_lf(h, keys[i],
 						sig[i], &data[i], cur_bkt);
 			else
-				ret = search_one_bucket_l(h, keys[i],
+				ret = search_one_bucket_lf(h, keys[i],
 						sig[i], NULL, cur_bkt);
 			if (ret != -1) {
 				positions[i] = ret;
@@ -1884,72 +2964,54 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 		}
 	}
 
-	__hash_rw_reader_unlock(h);
-
-	if (hit_mask != NULL)
-		*hit_mask = hits;
+	return hits;
 }
 
 static inline void
-__rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
+__rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	uint64_t hits = 0;
-	int32_t i;
-	int32_t ret;
-	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
+	uint64_t hits;
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	struct rte_hash_bucket *cur_bkt, *next_bkt;
-	uint32_t cnt_b, cnt_a;
-
-	/* Prefetch first keys */
-	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
-		rte_prefetch0(keys[i]);
-
-	/*
-	 * Prefetch rest of the keys, calculate primary and
-	 * secondary bucket and prefetch them
-	 */
-	for (i = 0; i < (num_keys - PREFETCH_OFFSET); i++) {
-		rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
 
-		prim_hash[i] = rte_hash_hash(h, keys[i]);
+	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
+			primary_bkt, secondary_bkt);
 
-		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+	__hash_rw_reader_lock(h);
 
-		rte_prefetch0(primary_bkt[i]);
-		rte_prefetch0(secondary_bkt[i]);
-	}
+	__bulk_compare_signatures(h, num_keys, sig, primary_bkt,
+			secondary_bkt, prim_hitmask, sec_hitmask);
 
-	/* Calculate and prefetch rest of the buckets */
-	for (; i < num_keys; i++) {
-		prim_hash[i] = rte_hash_hash(h, keys[i]);
+	hits = __bulk_compare_keys_l(h, keys, num_keys, sig, primary_bkt,
+			secondary_bkt, prim_hitmask, sec_hitmask,
+			positions, data);
 
-		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+	__hash_rw_reader_unlock(h);
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
 
-		rte_prefetch0(primary_bkt[i]);
-		rte_prefetch0(secondary_bkt[i]);
-	}
+static inline void
+__rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[])
+{
+	uint64_t hits;
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t cnt_b, cnt_a;
 
-	for (i = 0; i < num_keys; i++)
-		positions[i] = -ENOENT;
+	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
+			primary_bkt, secondary_bkt);
 
 	do {
 		/* Load the table change counter before the lookup
@@ -1959,139 +3021,13 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
 
-		/* Compare signatures and prefetch key slot of first hit */
-		for (i = 0; i < num_keys; i++) {
-			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				sig[i], h->sig_cmp_fn);
-
-			if (prim_hitmask[i]) {
-				uint32_t first_hit =
-						__builtin_ctzl(prim_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-					primary_bkt[i]->key_idx[first_hit];
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-				rte_prefetch0(key_slot);
-				continue;
-			}
+		__bulk_compare_signatures(h, num_keys, sig, primary_bkt,
+				secondary_bkt, prim_hitmask, sec_hitmask);
 
-			if (sec_hitmask[i]) {
-				uint32_t first_hit =
-						__builtin_ctzl(sec_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-					secondary_bkt[i]->key_idx[first_hit];
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-				rte_prefetch0(key_slot);
-			}
-		}
+		hits = __bulk_compare_keys_lf(h, keys, num_keys, sig,
+				primary_bkt, secondary_bkt, prim_hitmask,
+				sec_hitmask, positions, data);
 
-		/* Compare keys, first hits in primary first */
-		for (i = 0; i < num_keys; i++) {
-			while (prim_hitmask[i]) {
-				uint32_t hit_index =
-						__builtin_ctzl(prim_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-				__atomic_load_n(
-					&primary_bkt[i]->key_idx[hit_index],
-					__ATOMIC_ACQUIRE);
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-
-				/*
-				 * If key index is 0, do not compare key,
-				 * as it is checking the dummy slot
-				 */
-				if (!!key_idx &
-					!rte_hash_cmp_eq(
-						key_slot->key, keys[i], h)) {
-					if (data != NULL)
-						data[i] = __atomic_load_n(
-							&key_slot->pdata,
-							__ATOMIC_ACQUIRE);
-
-					hits |= 1ULL << i;
-					positions[i] = key_idx - 1;
-					goto next_key;
-				}
-				prim_hitmask[i] &= ~(3ULL << (hit_index << 1));
-			}
-
-			while (sec_hitmask[i]) {
-				uint32_t hit_index =
-						__builtin_ctzl(sec_hitmask[i])
-						>> 1;
-				uint32_t key_idx =
-				__atomic_load_n(
-					&secondary_bkt[i]->key_idx[hit_index],
-					__ATOMIC_ACQUIRE);
-				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
-
-				/*
-				 * If key index is 0, do not compare key,
-				 * as it is checking the dummy slot
-				 */
-
-				if (!!key_idx &
-					!rte_hash_cmp_eq(
-						key_slot->key, keys[i], h)) {
-					if (data != NULL)
-						data[i] = __atomic_load_n(
-							&key_slot->pdata,
-							__ATOMIC_ACQUIRE);
-
-					hits |= 1ULL << i;
-					positions[i] = key_idx - 1;
-					goto next_key;
-				}
-				sec_hitmask[i] &= ~(3ULL << (hit_index << 1));
-			}
-next_key:
-			continue;
-		}
-
-		/* all found, do not need to go through ext bkt */
-		if (hits == ((1ULL << num_keys) - 1)) {
-			if (hit_mask != NULL)
-				*hit_mask = hits;
-			return;
-		}
-		/* need to check ext buckets for match */
-		if (h->ext_table_support) {
-			for (i = 0; i < num_keys; i++) {
-				if ((hits & (1ULL << i)) != 0)
-					continue;
-				next_bkt = secondary_bkt[i]->next;
-				FOR_EACH_BUCKET(cur_bkt, next_bkt) {
-					if (data != NULL)
-						ret = search_one_bucket_lf(h,
-							keys[i], sig[i],
-							&data[i], cur_bkt);
-					else
-						ret = search_one_bucket_lf(h,
-								keys[i], sig[i],
-								NULL, cur_bkt);
-					if (ret != -1) {
-						positions[i] = ret;
-						hits |= 1ULL << i;
-						break;
-					}
-				}
-			}
-		}
 		/* The loads of sig_current in compare_signatures
 		 * should not move below the load from tbl_chng_cnt.
 		 */
@@ -2112,12 +3048,60 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		*hit_mask = hits;
 }
 
+/*
+ * Bulk lookup in a resizable table. The pipelined lookup only searches
+ * the current table, it is used when no resize started nor completed
+ * meanwhile. Otherwise the keys are searched for one by one in both
+ * tables.
+ */
+static inline void
+__rte_hash_lookup_bulk_resize(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[])
+{
+	uint64_t hits = 0;
+	uint32_t gen;
+	int32_t i;
+
+	gen = __atomic_load_n(&h->resize_gen, __ATOMIC_ACQUIRE);
+	if (likely(!(gen & 1))) {
+		if (h->readwrite_concur_lf_support)
+			__rte_hash_lookup_bulk_lf(h, keys, num_keys,
+					positions, &hits, data);
+		else
+			__rte_hash_lookup_bulk_l(h, keys, num_keys,
+					positions, &hits, data);
+		/* The loads of the buckets should not move below
+		 * the load of resize_gen.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (likely(gen == __atomic_load_n(&h->resize_gen,
+					__ATOMIC_ACQUIRE)))
+			goto out;
+	}
+
+	hits = 0;
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_lookup_with_hash_resize(h, keys[i],
+				rte_hash_hash(h, keys[i]),
+				data != NULL ? &data[i] : NULL);
+		if (positions[i] >= 0)
+			hits |= 1ULL << i;
+	}
+out:
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
 static inline void
 __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resize_support)
+		__rte_hash_lookup_bulk_resize(h, keys, num_keys, positions,
+					  hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2153,17 +3137,163 @@ rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/* Number of keys going through each stage of a pipelined burst lookup */
+#define LOOKUP_BURST_GROUP 16U
+/* Number of stages of a pipelined burst lookup */
+#define LOOKUP_BURST_STAGES 3
+
+/* State of a group of keys in a pipelined burst lookup */
+struct lookup_burst_group {
+	uint16_t sig[LOOKUP_BURST_GROUP];
+	const struct rte_hash_bucket *primary_bkt[LOOKUP_BURST_GROUP];
+	const struct rte_hash_bucket *secondary_bkt[LOOKUP_BURST_GROUP];
+	uint32_t prim_hitmask[LOOKUP_BURST_GROUP];
+	uint32_t sec_hitmask[LOOKUP_BURST_GROUP];
+	uint32_t cnt_b;
+};
+
+int
+rte_hash_lookup_burst(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions, void *data[])
+{
+	struct lookup_burst_group grp[LOOKUP_BURST_STAGES];
+	struct lookup_burst_group *g;
+	uint32_t num_groups, n, i, j, off;
+	uint64_t hits, hit_mask;
+	uint32_t cnt_a;
+	int ret = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(positions == NULL)), -EINVAL);
+
+	/* The pipeline does not search the old table of a resize */
+	if (h->resize_support) {
+		for (off = 0; off < num_keys; off += n) {
+			n = RTE_MIN(num_keys - off,
+					(uint32_t)RTE_HASH_LOOKUP_BULK_MAX);
+			__rte_hash_lookup_bulk_resize(h, &keys[off], n,
+					&positions[off], &hit_mask,
+					data != NULL ? &data[off] : NULL);
+			ret += __builtin_popcountl(hit_mask);
+		}
+		return ret;
+	}
+
+	num_groups = (num_keys + LOOKUP_BURST_GROUP - 1) / LOOKUP_BURST_GROUP;
+
+	if (!h->readwrite_concur_lf_support)
+		__hash_rw_reader_lock(h);
+
+	/*
+	 * Software pipeline over groups of keys: in each iteration, the
+	 * buckets of group i are located and prefetched, the signatures
+	 * of group i - 1 are compared, which prefetches its key slots,
+	 * and the keys of group i - 2 are compared. This way, the memory
+	 * accesses of each stage have a full iteration to complete.
+	 */
+	for (i = 0; i < num_groups + LOOKUP_BURST_STAGES - 1; i++) {
+		if (i < num_groups) {
+			off = i * LOOKUP_BURST_GROUP;
+			n = RTE_MIN(num_keys - off, LOOKUP_BURST_GROUP);
+			g = &grp[i % LOOKUP_BURST_STAGES];
+			__bulk_lookup_prefetching_loop(h, &keys[off], n,
+					g->sig, g->primary_bkt,
+					g->secondary_bkt);
+
+			/* Prefetch the keys of the next group */
+			for (j = off + n; j < num_keys &&
+					j < off + n + LOOKUP_BURST_GROUP; j++)
+				rte_prefetch0(keys[j]);
+		}
+
+		if (i >= 1 && i - 1 < num_groups) {
+			off = (i - 1) * LOOKUP_BURST_GROUP;
+			n = RTE_MIN(num_keys - off, LOOKUP_BURST_GROUP);
+			g = &grp[(i - 1) % LOOKUP_BURST_STAGES];
+			/* Acquire semantics will make sure that the loads
+			 * in compare_signatures are not hoisted.
+			 */
+			if (h->readwrite_concur_lf_support)
+				g->cnt_b = __atomic_load_n(h->tbl_chng_cnt,
+							__ATOMIC_ACQUIRE);
+			__bulk_compare_signatures(h, n, g->sig,
+					g->primary_bkt, g->secondary_bkt,
+					g->prim_hitmask, g->sec_hitmask);
+		}
+
+		if (i < LOOKUP_BURST_STAGES - 1)
+			continue;
+
+		off = (i - 2) * LOOKUP_BURST_GROUP;
+		n = RTE_MIN(num_keys - off, LOOKUP_BURST_GROUP);
+		g = &grp[(i - 2) % LOOKUP_BURST_STAGES];
+		if (!h->readwrite_concur_lf_support) {
+			hits = __bulk_compare_keys_l(h, &keys[off], n, g->sig,
+					g->primary_bkt, g->secondary_bkt,
+					g->prim_hitmask, g->sec_hitmask,
+					&positions[off],
+					data != NULL ? &data[off] : NULL);
+			ret += __builtin_popcountl(hits);
+			continue;
+		}
+
+		hits = __bulk_compare_keys_lf(h, &keys[off], n, g->sig,
+				g->primary_bkt, g->secondary_bkt,
+				g->prim_hitmask, g->sec_hitmask,
+				&positions[off],
+				data != NULL ? &data[off] : NULL);
+		/* The loads of sig_current in compare_signatures
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+		/* The table changed during the search of this group,
+		 * search it again out of the pipeline.
+		 */
+		if (unlikely(g->cnt_b != cnt_a)) {
+			__rte_hash_lookup_bulk_lf(h, &keys[off], n,
+					&positions[off], &hit_mask,
+					data != NULL ? &data[off] : NULL);
+			hits = hit_mask;
+		}
+		ret += __builtin_popcountl(hits);
+	}
+
+	if (!h->readwrite_concur_lf_support)
+		__hash_rw_reader_unlock(h);
+
+	return ret;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
+	const struct rte_hash_bucket *buckets, *buckets_ext;
+	uint32_t num_buckets, num_buckets_ext;
 	uint32_t bucket_idx, idx, position;
 	struct rte_hash_key *next_key;
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
-	const uint32_t total_entries_main = h->num_buckets *
+	/* A resizable table has no extendable buckets, the old table is
+	 * iterated instead while resizing. Its entries may be migrated,
+	 * and then returned twice or missed, between two calls.
+	 */
+	num_buckets = __atomic_load_n(&h->bucket_bitmask, __ATOMIC_ACQUIRE) + 1;
+	buckets = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+	if (h->resize_support) {
+		buckets_ext = __atomic_load_n(&h->old_buckets,
+					__ATOMIC_ACQUIRE);
+		num_buckets_ext = buckets_ext != NULL ? num_buckets >> 1 : 0;
+	} else {
+		buckets_ext = h->buckets_ext;
+		num_buckets_ext = h->ext_table_support ? num_buckets : 0;
+	}
+
+	const uint32_t total_entries_main = num_buckets *
 							RTE_HASH_BUCKET_ENTRIES;
-	const uint32_t total_entries = total_entries_main << 1;
+	const uint32_t total_entries = total_entries_main +
+			num_buckets_ext * RTE_HASH_BUCKET_ENTRIES;
 
 	/* Out of bounds of all buckets (both main table and ext table) */
 	if (*next >= total_entries_main)
@@ -2174,7 +3304,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	idx = *next % RTE_HASH_BUCKET_ENTRIES;
 
 	/* If current position is empty, go to the next one */
-	while ((position = __atomic_load_n(&h->buckets[bucket_idx].key_idx[idx],
+	while ((position = __atomic_load_n(&buckets[bucket_idx].key_idx[idx],
 					__ATOMIC_ACQUIRE)) == EMPTY_SLOT) {
 		(*next)++;
 		/* End of table */
@@ -2185,8 +3315,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	}
 
 	__hash_rw_reader_lock(h);
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	next_key = __hash_key_slot(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
@@ -2201,13 +3330,13 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 /* Begin to iterate extendable buckets */
 extend_table:
 	/* Out of total bound or if ext bucket feature is not enabled */
-	if (*next >= total_entries || !h->ext_table_support)
+	if (*next >= total_entries)
 		return -ENOENT;
 
 	bucket_idx = (*next - total_entries_main) / RTE_HASH_BUCKET_ENTRIES;
 	idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
 
-	while ((position = h->buckets_ext[bucket_idx].key_idx[idx]) == EMPTY_SLOT) {
+	while ((position = buckets_ext[bucket_idx].key_idx[idx]) == EMPTY_SLOT) {
 		(*next)++;
 		if (*next == total_entries)
 			return -ENOENT;
@@ -2216,8 +3345,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
 	}
 	__hash_rw_reader_lock(h);
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	next_key = __hash_key_slot(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
@@ -2228,3 +3356,84 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+void
+rte_hash_age_tick(struct rte_hash *h)
+{
+	if (h == NULL)
+		return;
+
+	__atomic_store_n(&h->age_epoch, (uint8_t)(h->age_epoch + 1),
+			__ATOMIC_RELAXED);
+}
+
+int32_t
+rte_hash_age(struct rte_hash *h, uint8_t timeout, uint32_t budget,
+	const void *keys[], void *data[], uint32_t max)
+{
+	const struct rte_hash_bucket *bkt;
+	struct rte_hash_key *k;
+	uint32_t next, scan, key_idx, bucket_idx, idx;
+	uint32_t num = 0;
+	uint8_t epoch;
+
+	if (h == NULL || keys == NULL || max == 0 || timeout == 0 ||
+			!h->aging_support)
+		return -EINVAL;
+
+	/* Only the new table of a resizable table is scanned while
+	 * resizing, the entries of the old one are aged once migrated.
+	 */
+	const uint32_t num_buckets = __atomic_load_n(&h->bucket_bitmask,
+					__ATOMIC_ACQUIRE) + 1;
+	const struct rte_hash_bucket *buckets = __atomic_load_n(&h->buckets,
+					__ATOMIC_ACQUIRE);
+	const uint32_t total_entries_main = num_buckets *
+							RTE_HASH_BUCKET_ENTRIES;
+	const uint32_t total_entries = h->ext_table_support ?
+			total_entries_main << 1 : total_entries_main;
+
+	/* Do not scan an entry twice in one call */
+	scan = RTE_MIN((uint64_t)budget * RTE_HASH_BUCKET_ENTRIES,
+			(uint64_t)total_entries);
+	next = h->age_next;
+	if (next >= total_entries)
+		next = 0;
+	epoch = __atomic_load_n(&h->age_epoch, __ATOMIC_RELAXED);
+
+	__hash_rw_reader_lock(h);
+	for (; scan != 0 && num < max; scan--) {
+		/* Main table first, then extendable buckets */
+		if (next < total_entries_main) {
+			bucket_idx = next / RTE_HASH_BUCKET_ENTRIES;
+			bkt = &buckets[bucket_idx];
+		} else {
+			bucket_idx = (next - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES;
+			bkt = &h->buckets_ext[bucket_idx];
+		}
+		idx = next % RTE_HASH_BUCKET_ENTRIES;
+		if (++next == total_entries)
+			next = 0;
+
+		key_idx = __atomic_load_n(&bkt->key_idx[idx],
+					__ATOMIC_ACQUIRE);
+		if (key_idx == EMPTY_SLOT)
+			continue;
+		if ((uint8_t)(epoch - __atomic_load_n(&bkt->flag[idx],
+				__ATOMIC_RELAXED)) < timeout)
+			continue;
+
+		k = __hash_key_slot(h, key_idx);
+		keys[num] = k->key;
+		if (data != NULL)
+			data[num] = __atomic_load_n(&k->pdata,
+					__ATOMIC_ACQUIRE);
+		num++;
+	}
+	__hash_rw_reader_unlock(h);
+
+	h->age_next = next;
+
+	return num;
+}
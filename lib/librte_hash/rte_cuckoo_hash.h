@@ -122,6 +122,17 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/* Maximum number of key store segments of a resizable table */
+#define RTE_HASH_KEY_SEG_MAX		32
+
+/* Maximum number of bucket tables a resizable table keeps for the lock
+ * free readers when no RCU QSBR variable is attached
+ */
+#define RTE_HASH_MAX_RESIZES		32
+
+/* Number of old buckets migrated by each add or delete while resizing */
+#define RTE_HASH_RESIZE_MIGRATE_BUCKETS	8
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	void *objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -142,6 +153,8 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SCALAR = 0,
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_NEON,
+	RTE_HASH_COMPARE_AVX2,
+	RTE_HASH_COMPARE_AVX512,
 	RTE_HASH_COMPARE_NUM
 };
 
@@ -152,6 +165,7 @@ struct rte_hash_bucket {
 	uint32_t key_idx[RTE_HASH_BUCKET_ENTRIES];
 
 	uint8_t flag[RTE_HASH_BUCKET_ENTRIES];
+	/**< Aging epoch of the last add or lookup of each entry */
 
 	void *next;
 } __rte_cache_aligned;
@@ -191,6 +205,12 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t aging_support;
+	/**< If lookups refresh the aging timestamp of the entries */
+	uint8_t age_epoch;
+	/**< Current aging epoch, stamped on the entries looked up */
+	uint8_t resize_support;
+	/**< If the table grows online when it fills up */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -220,8 +240,60 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+
+	/* RCU config. */
+	struct rte_rcu_qsbr *v;		/**< RCU QSBR variable. */
+	enum rte_hash_qsbr_mode rcu_mode;/**< Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq *dq;	/**< RCU QSBR defer queue. */
+	void *key_data_ptr;		/**< Passed to free_key_data_func. */
+	rte_hash_free_key_data free_key_data_func;
+	/**< Function to free the data of a reclaimed key. */
+	uint32_t age_next;
+	/**< Next entry to be scanned by rte_hash_age(). */
+
+	/* Online resize. */
+	rte_spinlock_t resize_lock;
+	/**< Serializes the writers of a resizable table. */
+	uint32_t resize_gen;
+	/**< Incremented when a resize starts and completes, odd while
+	 * the buckets are migrated to the new table.
+	 */
+	uint32_t init_bucket_bitmask;	/**< Bucket bitmask at creation. */
+	struct rte_hash_bucket *old_buckets;
+	/**< Table the buckets are migrated from, NULL if not resizing. */
+	uint32_t old_bucket_bitmask;	/**< Bucket bitmask of old_buckets. */
+	uint32_t migrate_next;		/**< Next old bucket to migrate. */
+	uint32_t key_seg_num;		/**< Number of segments added. */
+	uint32_t key_seg_shift;
+	/**< Log2 of the first key index of segment 1. Segment n covers
+	 * the key indexes [1 << (shift + n - 1), 1 << (shift + n)).
+	 */
+	uint32_t key_slots_first;	/**< Number of slots of segment 0. */
+	uint32_t key_slots_end;		/**< End of the last segment. */
+	char *key_seg[RTE_HASH_KEY_SEG_MAX];
+	/**< Key store segments, key_seg[0] is key_store. */
+	struct rte_hash_bucket *retired_buckets[RTE_HASH_MAX_RESIZES];
+	/**< Old tables which lock free readers may still access. */
+	uint32_t nb_retired;		/**< Number of retired_buckets. */
+	struct rte_hash_bucket *sync_buckets;
+	/**< Old table to free after a grace period, once the resize lock
+	 * is released.
+	 */
+	int socket_id;			/**< Socket to allocate memory on. */
 } __rte_cache_aligned;
 
+/* Entry of the RCU defer queue: a deleted key and its emptied ext bucket. */
+struct __rte_hash_rcu_dq_entry {
+	uint32_t key_idx;
+	/**< Key index in the key store, including the dummy entry */
+	uint32_t ext_bkt_idx;
+	/**< Extendable bucket index to recycle, 0 if none */
+	struct rte_hash_bucket *buckets;
+	/**< Bucket table retired by a resize, NULL if none. The key and
+	 * extendable bucket indexes are then unused.
+	 */
+};
+
 struct queue_node {
 	struct rte_hash_bucket *bkt; /* Current bucket on the bfs search */
 	uint32_t cur_bkt_idx;
@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_avx2.h"
+
+void
+rte_hash_compare_signatures_avx2(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const void * const *prim_sigs,
+			const void * const *sec_sigs,
+			const uint16_t *sig, int32_t num_keys)
+{
+	__m256i bkts;
+	uint32_t matches;
+	int32_t i;
+
+	/* Compare both buckets at once, one per 128-bit lane */
+	for (i = 0; i < num_keys; i++) {
+		bkts = _mm256_inserti128_si256(_mm256_castsi128_si256(
+				_mm_load_si128((__m128i const *)prim_sigs[i])),
+				_mm_load_si128((__m128i const *)sec_sigs[i]),
+				1);
+		matches = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(
+				bkts, _mm256_set1_epi16(sig[i])));
+
+		prim_hash_matches[i] = matches & 0xffff;
+		sec_hash_matches[i] = matches >> 16;
+	}
+}
@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#ifndef _RTE_CUCKOO_HASH_AVX2_H_
+#define _RTE_CUCKOO_HASH_AVX2_H_
+
+#include <stdint.h>
+
+/*
+ * Compare the signatures of num_keys keys against their primary and
+ * secondary buckets, both buckets of a key at once. The buckets are
+ * passed as pointers to their array of signatures, which starts struct
+ * rte_hash_bucket. Match masks are returned in the same format as
+ * compare_signatures().
+ *
+ * Built with AVX2 enabled, only to be called if the CPU supports it.
+ */
+void
+rte_hash_compare_signatures_avx2(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const void * const *prim_sigs,
+			const void * const *sec_sigs,
+			const uint16_t *sig, int32_t num_keys);
+
+#endif /* _RTE_CUCKOO_HASH_AVX2_H_ */
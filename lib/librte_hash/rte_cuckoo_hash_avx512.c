@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_avx512.h"
+
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const void * const *prim_sigs,
+			const void * const *sec_sigs,
+			const uint16_t *sig, int32_t num_keys)
+{
+	__m512i bkts, sigs;
+	__m256i bkts2;
+	uint64_t matches;
+	int32_t i;
+
+	/* Compare the buckets of two keys at once, one per 128-bit lane */
+	for (i = 0; i + 1 < num_keys; i += 2) {
+		bkts = _mm512_castsi128_si512(_mm_load_si128(
+				(__m128i const *)prim_sigs[i]));
+		bkts = _mm512_inserti32x4(bkts, _mm_load_si128(
+				(__m128i const *)sec_sigs[i]), 1);
+		bkts = _mm512_inserti32x4(bkts, _mm_load_si128(
+				(__m128i const *)prim_sigs[i + 1]), 2);
+		bkts = _mm512_inserti32x4(bkts, _mm_load_si128(
+				(__m128i const *)sec_sigs[i + 1]), 3);
+		sigs = _mm512_mask_set1_epi16(_mm512_set1_epi16(sig[i]),
+				0xffff0000, sig[i + 1]);
+
+		/* Widen the 16-bit element mask to two bits per entry */
+		matches = _mm512_movepi8_mask(_mm512_movm_epi16(
+				_mm512_cmpeq_epi16_mask(bkts, sigs)));
+
+		prim_hash_matches[i] = (uint32_t)matches & 0xffff;
+		sec_hash_matches[i] = (uint32_t)(matches >> 16) & 0xffff;
+		prim_hash_matches[i + 1] = (uint32_t)(matches >> 32) & 0xffff;
+		sec_hash_matches[i + 1] = (uint32_t)(matches >> 48);
+	}
+
+	/* Last key of an odd burst, both buckets in a 256-bit compare */
+	if (i < num_keys) {
+		bkts2 = _mm256_inserti128_si256(_mm256_castsi128_si256(
+				_mm_load_si128((__m128i const *)prim_sigs[i])),
+				_mm_load_si128((__m128i const *)sec_sigs[i]),
+				1);
+		matches = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(
+				bkts2, _mm256_set1_epi16(sig[i])));
+
+		prim_hash_matches[i] = (uint32_t)matches & 0xffff;
+		sec_hash_matches[i] = (uint32_t)(matches >> 16);
+	}
+}
@@ -15,6 +15,7 @@
 #include <stddef.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -56,6 +57,34 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to enable entry aging. Lookups refresh a per entry timestamp,
+ * and rte_hash_age() returns the entries which were not looked up for
+ * a given number of epochs.
+ */
+#define RTE_HASH_EXTRA_FLAGS_AGING 0x40
+
+/** Flag to make the table grow online when it fills up. The number of
+ * entries given at creation is the initial capacity. Once the free entries
+ * run low, the bucket table is doubled and the buckets are migrated to the
+ * new table a few at a time by the following adds and deletes, or by
+ * rte_hash_resize_step(). Lookups search both tables while migrating.
+ * All the writers of a resizable table are serialized.
+ * Currently, extendable bucket table feature is not supported with
+ * this feature.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZE 0x80
+
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_HASH_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_hash_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_HASH_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_HASH_QSBR_MODE_SYNC
+};
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -86,6 +115,38 @@ struct rte_hash_parameters {
 /** @internal A hash table structure. */
 struct rte_hash;
 
+/**
+ * Type of function called when a deleted key is reclaimed, to free the
+ * application data associated with it.
+ *
+ * @param p
+ *   Pointer provided in the RCU configuration (key_data_ptr).
+ * @param key_data
+ *   Data associated with the key when it was added.
+ */
+typedef void (*rte_hash_free_key_data)(void *p, void *key_data);
+
+/** HASH RCU QSBR configuration structure. */
+struct rte_hash_rcu_config {
+	struct rte_rcu_qsbr *v;	/**< RCU QSBR variable. */
+	/** Mode of RCU QSBR. RTE_HASH_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_hash_qsbr_mode mode;
+	uint32_t dq_size;	/**< RCU defer queue size.
+				 * default: total hash table entries.
+				 */
+	uint32_t reclaim_thd;	/**< Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/**< Max entries to reclaim in one go.
+				 * default: RTE_HASH_RCU_DQ_RECLAIM_MAX.
+				 */
+	void *key_data_ptr;	/**< Pointer passed to free_key_data_func. */
+	rte_hash_free_key_data free_key_data_func;
+	/**< Function called to free the data of a reclaimed key.
+	 * Can be NULL.
+	 */
+};
+
 /**
  * Create a new hash table.
  *
@@ -275,6 +336,10 @@ rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t
  * rte_hash_free_key_with_position API should be called after all
  * the readers have stopped referencing the entry corresponding to
  * this key. RCU mechanisms could be used to determine such a state.
+ * If a RCU QSBR variable is associated with the hash table using
+ * rte_hash_rcu_qsbr_add(), the key index is freed automatically once the
+ * readers have reported a quiescent state, and
+ * rte_hash_free_key_with_position API must not be called.
  *
  * @param h
  *   Hash table to remove the key from.
@@ -304,6 +369,10 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
  * rte_hash_free_key_with_position API should be called after all
  * the readers have stopped referencing the entry corresponding to
  * this key. RCU mechanisms could be used to determine such a state.
+ * If a RCU QSBR variable is associated with the hash table using
+ * rte_hash_rcu_qsbr_add(), the key index is freed automatically once the
+ * readers have reported a quiescent state, and
+ * rte_hash_free_key_with_position API must not be called.
  *
  * @param h
  *   Hash table to remove the key from.
@@ -524,6 +593,44 @@ int
 rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 		      uint32_t num_keys, int32_t *positions);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Find a burst of keys in the hash table, with no limit on the number
+ * of keys. The lookup is software pipelined over groups of keys, so
+ * that the hash computation, the bucket prefetch and the key prefetch
+ * of the next groups overlap with the key comparisons of the current
+ * one. Large bursts benefit from it the most on tables exceeding the
+ * cache size.
+ * This operation is multi-thread safe with regarding to other lookup threads.
+ * Read-write concurrency can be enabled by setting flag during
+ * table creation. For a table without lock-free read-write concurrency,
+ * the reader lock is held for the whole burst.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param keys
+ *   A pointer to a list of keys to look for.
+ * @param num_keys
+ *   How many keys are in the keys list.
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys that
+ *   can be used by the caller as an offset into an array of user data. These
+ *   values are unique for each key, and are the same values that were returned
+ *   when each key was added. If a key in the list was not found, then -ENOENT
+ *   will be the value.
+ * @param data
+ *   Output containing array of data returned from all the successful lookups,
+ *   can be NULL.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of successful lookups.
+ */
+__rte_experimental
+int
+rte_hash_lookup_burst(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions, void *data[]);
+
 /**
  * Iterate through the hash table, returning key-value pairs.
  *
@@ -545,6 +652,130 @@ rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
  */
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Advance the aging clock of a hash table by one epoch.
+ * Entries added or looked up from now on are stamped with the new epoch.
+ * The application typically calls it periodically, the idle timeout of
+ * the entries being expressed in number of epochs.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ */
+__rte_experimental
+void
+rte_hash_age_tick(struct rte_hash *h);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Incrementally scan a hash table for the entries which were neither added
+ * nor looked up for at least *timeout* epochs.
+ *
+ * Each call resumes the scan where the previous one stopped, and scans at
+ * most *budget* buckets, so the cost of aging can be amortized over many
+ * calls, e.g. from the idle loop of a data-plane thread. The scan stops
+ * early once *max* expired entries are found. The expired entries are not
+ * deleted, the application is expected to delete them after processing.
+ *
+ * The timestamps are 8-bit epochs, compared modulo 256: the whole table
+ * must be scanned within (256 - timeout) epochs for an idle entry not to
+ * be seen as fresh again. The scan has the same thread safety as lookups,
+ * but only one thread may call this function at a time. Concurrent key
+ * additions may move entries, which may then be missed or returned twice
+ * in one pass.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ * @param timeout
+ *   Number of epochs after which an entry expires, must not be zero.
+ * @param budget
+ *   Maximum number of buckets to scan.
+ * @param keys
+ *   Output array of the expired keys.
+ * @param data
+ *   Output array of the data associated with the expired keys, can be NULL.
+ * @param max
+ *   Size of the output arrays.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Number of expired entries returned in *keys*.
+ */
+__rte_experimental
+int32_t
+rte_hash_age(struct rte_hash *h, uint8_t timeout, uint32_t budget,
+	const void *keys[], void *data[], uint32_t max);
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a hash table.
+ *
+ * Once associated, the key indexes and the extendable buckets released by
+ * rte_hash_del_xxx APIs are only reused after all the reader threads
+ * registered on the QSBR variable have reported a quiescent state.
+ * The application does not need to call rte_hash_free_key_with_position
+ * anymore. This is only supported by hash tables created with
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, and should be called before
+ * any key is deleted.
+ *
+ * @param h
+ *   the hash table to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @param dq
+ *   handler of created RCU QSBR defer queue, can be NULL
+ * @return
+ *   On success - 0
+ *   On error - 1 with error code set in rte_errno.
+ *   Possible rte_errno codes are:
+ *   - EINVAL - invalid pointer or hash table not lock free
+ *   - EEXIST - already added QSBR
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg,
+	struct rte_rcu_qsbr_dq **dq);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Migrate buckets of a resizable hash table to its new bucket table.
+ *
+ * A resize is started by the add which finds the table almost full, then
+ * each add and delete migrates a few buckets. This function lets the
+ * application complete the migration from a control thread, so that the
+ * lookups only search one table again sooner.
+ * This operation is multi-thread safe with regarding to the other writers,
+ * and lock free with regarding to the readers if
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled.
+ *
+ * Once the migration completes, the old bucket table is freed after the
+ * readers have reported a quiescent state if a RCU QSBR variable is
+ * associated with the table, or immediately if read-write concurrency is
+ * not enabled. Otherwise it is only freed by rte_hash_reset() or
+ * rte_hash_free(). The RCU defer queue must not be reclaimed by the
+ * application concurrently with the writers of a resizable table.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_RESIZE.
+ * @param num_buckets
+ *   Maximum number of buckets to migrate, zero to only query the progress
+ *   of the resize.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Number of buckets still to migrate, zero if the table is not being
+ *     resized.
+ */
+__rte_experimental
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,6 +5,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <math.h>
 
 #include <rte_string_fns.h>
@@ -37,11 +38,40 @@ static uint64_t samp_intvl;
 static uint64_t timer_tsc;
 static uint64_t prev_tsc;
 
+/*
+ * Latency histograms are log-linear, as HDR histograms: the values below
+ * LAT_HIST_SUB_COUNT cycles have their own bucket, and each following
+ * power of two range is split in LAT_HIST_SUB_COUNT buckets, so that the
+ * relative error is at most 1 / LAT_HIST_SUB_COUNT. Latencies larger than
+ * 2^LAT_HIST_MAX_BITS cycles fall in the last bucket.
+ */
+#define LAT_HIST_SUB_BITS 4
+#define LAT_HIST_SUB_COUNT (1U << LAT_HIST_SUB_BITS)
+#define LAT_HIST_MAX_BITS 40
+#define LAT_HIST_NB_BUCKETS \
+	((LAT_HIST_MAX_BITS - LAT_HIST_SUB_BITS + 1) * LAT_HIST_SUB_COUNT)
+
+/** Latency histogram of a Tx queue, only written by the lcore using it */
+struct latency_hist {
+	uint64_t buckets[LAT_HIST_NB_BUCKETS];
+} __rte_cache_aligned;
+
+/** Percentiles exported with the stats */
+#define LAT_NUM_PERCENTILES 4
+static const double lat_percentiles[LAT_NUM_PERCENTILES] = {
+	50, 90, 99, 99.9
+};
+
 struct rte_latency_stats {
 	float min_latency; /**< Minimum latency in nano seconds */
 	float avg_latency; /**< Average latency in nano seconds */
 	float max_latency; /**< Maximum latency in nano seconds */
 	float jitter; /** Latency variation */
+	float percentiles[LAT_NUM_PERCENTILES]; /**< Latency percentiles */
+	uint32_t hist_first[RTE_MAX_ETHPORTS]; /**< First histogram of port */
+	uint16_t hist_nb_queues[RTE_MAX_ETHPORTS]; /**< Histograms of port */
+	uint32_t nb_hist; /**< Number of histograms */
+	struct latency_hist hist[]; /**< Histograms of all Tx queues */
 };
 
 static struct rte_latency_stats *glob_stats;
@@ -63,11 +93,139 @@ static const struct latency_stats_nameoff lat_stats_strings[] = {
 	{"avg_latency_ns", offsetof(struct rte_latency_stats, avg_latency)},
 	{"max_latency_ns", offsetof(struct rte_latency_stats, max_latency)},
 	{"jitter_ns", offsetof(struct rte_latency_stats, jitter)},
+	{"p50_latency_ns", offsetof(struct rte_latency_stats, percentiles[0])},
+	{"p90_latency_ns", offsetof(struct rte_latency_stats, percentiles[1])},
+	{"p99_latency_ns", offsetof(struct rte_latency_stats, percentiles[2])},
+	{"p99_9_latency_ns",
+		offsetof(struct rte_latency_stats, percentiles[3])},
 };
 
 #define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
 				sizeof(lat_stats_strings[0]))
 
+/* Index of the first percentile in lat_stats_strings */
+#define LAT_PERCENTILE_FIRST (NUM_LATENCY_STATS - LAT_NUM_PERCENTILES)
+
+static inline unsigned int
+lat_hist_index(uint64_t cycles)
+{
+	unsigned int shift;
+
+	if (cycles < LAT_HIST_SUB_COUNT)
+		return cycles;
+	if (cycles >> LAT_HIST_MAX_BITS)
+		cycles = (1ULL << LAT_HIST_MAX_BITS) - 1;
+
+	shift = 63 - __builtin_clzll(cycles) - LAT_HIST_SUB_BITS;
+	return (shift << LAT_HIST_SUB_BITS) + (cycles >> shift);
+}
+
+/* Highest latency in cycles counted in a bucket */
+static uint64_t
+lat_hist_value(unsigned int idx)
+{
+	unsigned int shift;
+	uint64_t top;
+
+	if (idx < LAT_HIST_SUB_COUNT)
+		return idx;
+
+	shift = (idx >> LAT_HIST_SUB_BITS) - 1;
+	top = idx - (shift << LAT_HIST_SUB_BITS);
+	return ((top + 1) << shift) - 1;
+}
+
+/* Sum the histograms of queues [first, first + nb) */
+static uint64_t
+lat_hist_merge(uint64_t *buckets, uint32_t first, uint32_t nb)
+{
+	uint64_t total = 0;
+	unsigned int i;
+	uint32_t q;
+
+	memset(buckets, 0, sizeof(uint64_t) * LAT_HIST_NB_BUCKETS);
+	for (q = first; q < first + nb; q++) {
+		const struct latency_hist *hist = &glob_stats->hist[q];
+
+		for (i = 0; i < LAT_HIST_NB_BUCKETS; i++) {
+			buckets[i] += hist->buckets[i];
+			total += hist->buckets[i];
+		}
+	}
+
+	return total;
+}
+
+/* Latency in cycles below which a percentile of the samples fall */
+static uint64_t
+lat_hist_percentile(const uint64_t *buckets, uint64_t total,
+		double percentile)
+{
+	uint64_t rank, sum = 0;
+	unsigned int i;
+
+	if (total == 0)
+		return 0;
+
+	rank = (uint64_t)ceil(total * percentile / 100);
+	if (rank == 0)
+		rank = 1;
+
+	for (i = 0; i < LAT_HIST_NB_BUCKETS; i++) {
+		sum += buckets[i];
+		if (sum >= rank)
+			break;
+	}
+
+	return lat_hist_value(RTE_MIN(i, LAT_HIST_NB_BUCKETS - 1));
+}
+
+/* Compute the percentiles of all ports, in cycles */
+static void
+latencystats_percentiles_calc(void)
+{
+	uint64_t buckets[LAT_HIST_NB_BUCKETS];
+	uint64_t total;
+	unsigned int i;
+
+	total = lat_hist_merge(buckets, 0, glob_stats->nb_hist);
+	for (i = 0; i < LAT_NUM_PERCENTILES; i++)
+		glob_stats->percentiles[i] = lat_hist_percentile(buckets,
+				total, lat_percentiles[i]);
+}
+
+/* Push the percentiles of each port to the metrics library */
+static int
+latencystats_port_percentiles_update(void)
+{
+	uint64_t buckets[LAT_HIST_NB_BUCKETS];
+	uint64_t values[LAT_NUM_PERCENTILES];
+	uint64_t total;
+	unsigned int i;
+	uint16_t pid;
+	int ret;
+
+	for (pid = 0; pid < RTE_MAX_ETHPORTS; pid++) {
+		if (glob_stats->hist_nb_queues[pid] == 0)
+			continue;
+
+		total = lat_hist_merge(buckets, glob_stats->hist_first[pid],
+				glob_stats->hist_nb_queues[pid]);
+		for (i = 0; i < LAT_NUM_PERCENTILES; i++)
+			values[i] = (uint64_t)floor((float)lat_hist_percentile(
+					buckets, total, lat_percentiles[i]) /
+					latencystat_cycles_per_ns());
+
+		ret = rte_metrics_update_values(pid,
+				latency_stats_index + LAT_PERCENTILE_FIRST,
+				values, LAT_NUM_PERCENTILES);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
 int32_t
 rte_latencystats_update(void)
 {
@@ -76,6 +234,8 @@ rte_latencystats_update(void)
 	uint64_t values[NUM_LATENCY_STATS] = {0};
 	int ret;
 
+	latencystats_percentiles_calc();
+
 	for (i = 0; i < NUM_LATENCY_STATS; i++) {
 		stats_ptr = RTE_PTR_ADD(glob_stats,
 				lat_stats_strings[i].offset);
@@ -86,6 +246,8 @@ rte_latencystats_update(void)
 	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
 					latency_stats_index,
 					values, NUM_LATENCY_STATS);
+	if (ret == 0)
+		ret = latencystats_port_percentiles_update();
 	if (ret < 0)
 		RTE_LOG(INFO, LATENCY_STATS, "Failed to push the stats\n");
 
@@ -98,6 +260,8 @@ rte_latencystats_fill_values(struct rte_metric_value *values)
 	unsigned int i;
 	float *stats_ptr = NULL;
 
+	latencystats_percentiles_calc();
+
 	for (i = 0; i < NUM_LATENCY_STATS; i++) {
 		stats_ptr = RTE_PTR_ADD(glob_stats,
 				lat_stats_strings[i].offset);
@@ -145,10 +309,11 @@ calc_latency(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
-		void *_ __rte_unused)
+		void *user_cb)
 {
+	struct latency_hist *hist = user_cb;
 	unsigned int i, cnt = 0;
-	uint64_t now;
+	uint64_t now, cycles;
 	float latency[nb_pkts];
 	static float prev_latency;
 	/*
@@ -160,8 +325,11 @@ calc_latency(uint16_t pid __rte_unused,
 
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		if (pkts[i]->ol_flags & PKT_RX_TIMESTAMP)
-			latency[cnt++] = now - pkts[i]->timestamp;
+		if (pkts[i]->ol_flags & PKT_RX_TIMESTAMP) {
+			cycles = now - pkts[i]->timestamp;
+			hist->buckets[lat_hist_index(cycles)]++;
+			latency[cnt++] = cycles;
+		}
 	}
 
 	for (i = 0; i < cnt; i++) {
@@ -208,12 +376,21 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
 	const struct rte_memzone *mz = NULL;
 	const unsigned int flags = 0;
+	uint32_t nb_hist = 0;
 
 	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
 		return -EEXIST;
 
+	/** One latency histogram per Tx queue */
+	RTE_ETH_FOREACH_DEV(pid) {
+		struct rte_eth_dev_info dev_info;
+		rte_eth_dev_info_get(pid, &dev_info);
+		nb_hist += dev_info.nb_tx_queues;
+	}
+
 	/** Allocate stats in shared memory fo multi process support */
-	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
+	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats) +
+					nb_hist * sizeof(struct latency_hist),
 					rte_socket_id(), flags);
 	if (mz == NULL) {
 		RTE_LOG(ERR, LATENCY_STATS, "Cannot reserve memory: %s:%d\n",
@@ -222,6 +399,7 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	}
 
 	glob_stats = mz->addr;
+	memset(glob_stats, 0, mz->len);
 	samp_intvl = app_samp_intvl * latencystat_cycles_per_ns();
 
 	/** Register latency stats with stats library */
@@ -249,10 +427,14 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 					"register Rx callback for pid=%d, "
 					"qid=%d\n", pid, qid);
 		}
+		glob_stats->hist_first[pid] = glob_stats->nb_hist;
+		glob_stats->hist_nb_queues[pid] = dev_info.nb_tx_queues;
+		glob_stats->nb_hist += dev_info.nb_tx_queues;
 		for (qid = 0; qid < dev_info.nb_tx_queues; qid++) {
 			cbs = &tx_cbs[pid][qid];
 			cbs->cb =  rte_eth_add_tx_callback(pid, qid,
-					calc_latency, user_cb);
+					calc_latency, &glob_stats->hist[
+					glob_stats->hist_first[pid] + qid]);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Tx callback for pid=%d, "
@@ -316,12 +498,9 @@ rte_latencystats_get_names(struct rte_metric_name *names, uint16_t size)
 	return NUM_LATENCY_STATS;
 }
 
-int
-rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
+static int
+latencystats_lookup(void)
 {
-	if (size < NUM_LATENCY_STATS || values == NULL)
-		return NUM_LATENCY_STATS;
-
 	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
 		const struct rte_memzone *mz;
 		mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
@@ -333,8 +512,53 @@ rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
 		glob_stats =  mz->addr;
 	}
 
+	if (glob_stats == NULL)
+		return -ENOMEM;
+
+	return 0;
+}
+
+int
+rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
+{
+	int ret;
+
+	if (size < NUM_LATENCY_STATS || values == NULL)
+		return NUM_LATENCY_STATS;
+
+	ret = latencystats_lookup();
+	if (ret < 0)
+		return ret;
+
 	/* Retrieve latency stats */
 	rte_latencystats_fill_values(values);
 
 	return NUM_LATENCY_STATS;
 }
+
+int
+rte_latencystats_percentile_get(uint16_t port_id, uint16_t queue_id,
+		double percentile, uint64_t *latency_ns)
+{
+	uint64_t buckets[LAT_HIST_NB_BUCKETS];
+	uint64_t total;
+	int ret;
+
+	if (latency_ns == NULL || !(percentile >= 0 && percentile <= 100) ||
+			port_id >= RTE_MAX_ETHPORTS)
+		return -EINVAL;
+
+	ret = latencystats_lookup();
+	if (ret < 0)
+		return ret;
+
+	if (queue_id >= glob_stats->hist_nb_queues[port_id])
+		return -ENODEV;
+
+	total = lat_hist_merge(buckets,
+			glob_stats->hist_first[port_id] + queue_id, 1);
+	*latency_ns = (uint64_t)floor((float)lat_hist_percentile(buckets,
+			total, percentile) / latencystat_cycles_per_ns());
+
+	return 0;
+}
@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <rte_compat.h>
 #include <rte_metrics.h>
 #include <rte_mbuf.h>
 
@@ -63,8 +64,9 @@ int rte_latencystats_init(uint64_t samp_intvl,
 			rte_latency_stats_flow_type_fn user_cb);
 
 /**
- * Calculates the latency and jitter values internally, exposing the updated
- * values via *rte_latencystats_get* or the rte_metrics API.
+ * Calculates the latency, jitter and percentile values internally, exposing
+ * the updated values via *rte_latencystats_get* or the rte_metrics API.
+ * The percentiles of each port are also updated in the rte_metrics API.
  * @return:
  *  0      : on Success
  *  < 0    : Error in updating values.
@@ -121,6 +123,37 @@ int rte_latencystats_get_names(struct rte_metric_name *names,
 int rte_latencystats_get(struct rte_metric_value *values,
 			uint16_t size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve a latency percentile of a Tx queue.
+ *
+ * The latencies measured on each Tx queue are counted in a log-linear
+ * histogram, with a relative error lower than 6.25%. The percentiles of all
+ * the queues are also reported by *rte_latencystats_get*, and the
+ * percentiles of each port are pushed to the rte_metrics library by
+ * *rte_latencystats_update*.
+ *
+ * @param port_id
+ *   The port identifier.
+ * @param queue_id
+ *   The Tx queue identifier.
+ * @param percentile
+ *   The percentile to compute, between 0 and 100, e.g. 99.9.
+ * @param latency_ns
+ *   Pointer to the latency in nano seconds below which *percentile* percent
+ *   of the measured latencies fall, or 0 if no latency was measured.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: Invalid parameters.
+ *   - -ENODEV: No latency stats for this port and queue.
+ *   - -ENOMEM: Latency stats are not initialized.
+ */
+__rte_experimental
+int rte_latencystats_percentile_get(uint16_t port_id, uint16_t queue_id,
+		double percentile, uint64_t *latency_ns);
+
 #ifdef __cplusplus
 }
 #endif
@@ -381,6 +381,8 @@ rte_lpm_free_v1604(struct rte_lpm *lpm)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (lpm->dq != NULL)
+		rte_rcu_qsbr_dq_delete(lpm->dq);
 	rte_free(lpm->tbl8);
 	rte_free(lpm->rules_tbl);
 	rte_free(lpm);
@@ -390,6 +392,72 @@ BIND_DEFAULT_SYMBOL(rte_lpm_free, _v1604, 16.04);
 MAP_STATIC_SYMBOL(void rte_lpm_free(struct rte_lpm *lpm),
 		rte_lpm_free_v1604);
 
+static void
+__lpm_rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct rte_lpm_tbl_entry *tbl8 = ((struct rte_lpm *)p)->tbl8;
+	uint32_t tbl8_group_start = *(uint32_t *)data;
+
+	RTE_SET_USED(n);
+	/* Set tbl8 group invalid */
+	tbl8[tbl8_group_start].valid_group = INVALID;
+}
+
+/* Associate QSBR variable with an LPM object.
+ */
+int
+rte_lpm_rcu_qsbr_add(struct rte_lpm *lpm, struct rte_lpm_rcu_config *cfg,
+	struct rte_rcu_qsbr_dq **dq)
+{
+	/* Leave room for the "RCU_" prefix added by the defer queue. */
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE - 4];
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+
+	if (lpm == NULL || cfg == NULL || cfg->v == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (lpm->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_LPM_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_LPM_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"LPM_%s", lpm->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = lpm->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_LPM_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 group index */
+		params.free_fn = __lpm_rcu_qsbr_free_resource;
+		params.p = lpm;
+		params.v = cfg->v;
+		lpm->dq = rte_rcu_qsbr_dq_create(&params);
+		if (lpm->dq == NULL) {
+			RTE_LOG(ERR, LPM, "LPM defer queue creation failed\n");
+			return 1;
+		}
+		if (dq != NULL)
+			*dq = lpm->dq;
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	lpm->rcu_mode = cfg->mode;
+	lpm->v = cfg->v;
+
+	return 0;
+}
+
 /*
  * Adds a rule to the rule table.
  *
@@ -671,7 +739,7 @@ tbl8_alloc_v20(struct rte_lpm_tbl_entry_v20 *tbl8)
 }
 
 static inline int32_t
-tbl8_alloc_v1604(struct rte_lpm_tbl_entry *tbl8, uint32_t number_tbl8s)
+_tbl8_alloc_v1604(struct rte_lpm_tbl_entry *tbl8, uint32_t number_tbl8s)
 {
 	uint32_t group_idx; /* tbl8 group index. */
 	struct rte_lpm_tbl_entry *tbl8_entry;
@@ -696,6 +764,32 @@ tbl8_alloc_v1604(struct rte_lpm_tbl_entry *tbl8, uint32_t number_tbl8s)
 	return -ENOSPC;
 }
 
+static inline int32_t
+tbl8_alloc_v1604(struct rte_lpm *lpm)
+{
+	int32_t group_idx; /* tbl8 group index. */
+
+	unsigned int freed, pending;
+
+	group_idx = _tbl8_alloc_v1604(lpm->tbl8, lpm->number_tbl8s);
+	if (group_idx == -ENOSPC && lpm->dq != NULL) {
+		/* If there are no tbl8 groups try to reclaim one. */
+		rte_rcu_qsbr_dq_reclaim(lpm->dq, 1, &freed, &pending, NULL);
+		if (freed == 0 && pending != 0) {
+			/* Wait for the readers rather than fail the add. */
+			rte_rcu_qsbr_synchronize(lpm->v,
+					RTE_QSBR_THRID_INVALID);
+			rte_rcu_qsbr_dq_reclaim(lpm->dq, 1, &freed, NULL,
+					NULL);
+		}
+		if (freed != 0)
+			group_idx = _tbl8_alloc_v1604(lpm->tbl8,
+					lpm->number_tbl8s);
+	}
+
+	return group_idx;
+}
+
 static inline void
 tbl8_free_v20(struct rte_lpm_tbl_entry_v20 *tbl8, uint32_t tbl8_group_start)
 {
@@ -704,12 +798,50 @@ tbl8_free_v20(struct rte_lpm_tbl_entry_v20 *tbl8, uint32_t tbl8_group_start)
 }
 
 static inline void
-tbl8_free_v1604(struct rte_lpm_tbl_entry *tbl8, uint32_t tbl8_group_start)
+_tbl8_free_v1604(struct rte_lpm_tbl_entry *tbl8, uint32_t tbl8_group_start)
 {
 	/* Set tbl8 group invalid*/
 	tbl8[tbl8_group_start].valid_group = INVALID;
 }
 
+/*
+ * Free a tbl8 group unlinked from tbl24. With RCU configured, the group is
+ * only returned to the free pool once the readers which may still walk it
+ * have reported a quiescent state.
+ */
+static inline void
+tbl8_free_v1604(struct rte_lpm *lpm, uint32_t tbl8_group_start)
+{
+	if (lpm->v == NULL) {
+		_tbl8_free_v1604(lpm->tbl8, tbl8_group_start);
+		return;
+	}
+
+	/* Push into QSBR defer queue, fall back to blocking mode if full. */
+	if (lpm->rcu_mode == RTE_LPM_QSBR_MODE_DQ &&
+			rte_rcu_qsbr_dq_enqueue(lpm->dq,
+				(void *)&tbl8_group_start) == 0)
+		return;
+
+	/* Wait for quiescent state change. */
+	rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+	_tbl8_free_v1604(lpm->tbl8, tbl8_group_start);
+}
+
+/*
+ * Wait for the readers and free all the tbl8 groups pending on the
+ * defer queue.
+ */
+static void
+tbl8_free_pending_v1604(struct rte_lpm *lpm)
+{
+	if (lpm->dq == NULL)
+		return;
+
+	rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+	rte_rcu_qsbr_dq_reclaim(lpm->dq, lpm->number_tbl8s, NULL, NULL, NULL);
+}
+
 static inline int32_t
 add_depth_small_v20(struct rte_lpm_v20 *lpm, uint32_t ip, uint8_t depth,
 		uint8_t next_hop)
@@ -986,7 +1118,7 @@ add_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked, uint8_t depth,
 
 	if (!lpm->tbl24[tbl24_index].valid) {
 		/* Search for a free tbl8 group. */
-		tbl8_group_index = tbl8_alloc_v1604(lpm->tbl8, lpm->number_tbl8s);
+		tbl8_group_index = tbl8_alloc_v1604(lpm);
 
 		/* Check tbl8 allocation was successful. */
 		if (tbl8_group_index < 0) {
@@ -1018,12 +1150,14 @@ add_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked, uint8_t depth,
 			.depth = 0,
 		};
 
-		lpm->tbl24[tbl24_index] = new_tbl24_entry;
+		/* The tbl8 group must be visible before it is linked. */
+		__atomic_store(&lpm->tbl24[tbl24_index], &new_tbl24_entry,
+				__ATOMIC_RELEASE);
 
 	} /* If valid entry but not extended calculate the index into Table8. */
 	else if (lpm->tbl24[tbl24_index].valid_group == 0) {
 		/* Search for free tbl8 group. */
-		tbl8_group_index = tbl8_alloc_v1604(lpm->tbl8, lpm->number_tbl8s);
+		tbl8_group_index = tbl8_alloc_v1604(lpm);
 
 		if (tbl8_group_index < 0) {
 			return tbl8_group_index;
@@ -1064,7 +1198,9 @@ add_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked, uint8_t depth,
 				.depth = 0,
 		};
 
-		lpm->tbl24[tbl24_index] = new_tbl24_entry;
+		/* The tbl8 group must be visible before it is linked. */
+		__atomic_store(&lpm->tbl24[tbl24_index], &new_tbl24_entry,
+				__ATOMIC_RELEASE);
 
 	} else { /*
 		* If it is valid, extended entry calculate the index into tbl8.
@@ -1716,7 +1852,7 @@ delete_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked,
 	if (tbl8_recycle_index == -EINVAL) {
 		/* Set tbl24 before freeing tbl8 to avoid race condition. */
 		lpm->tbl24[tbl24_index].valid = 0;
-		tbl8_free_v1604(lpm->tbl8, tbl8_group_start);
+		tbl8_free_v1604(lpm, tbl8_group_start);
 	} else if (tbl8_recycle_index > -1) {
 		/* Update tbl24 entry. */
 		struct rte_lpm_tbl_entry new_tbl24_entry = {
@@ -1728,7 +1864,7 @@ delete_depth_big_v1604(struct rte_lpm *lpm, uint32_t ip_masked,
 
 		/* Set tbl24 before freeing tbl8 to avoid race condition. */
 		lpm->tbl24[tbl24_index] = new_tbl24_entry;
-		tbl8_free_v1604(lpm->tbl8, tbl8_group_start);
+		tbl8_free_v1604(lpm, tbl8_group_start);
 	}
 #undef group_idx
 	return 0;
@@ -1870,6 +2006,11 @@ VERSION_SYMBOL(rte_lpm_delete_all, _v20, 2.0);
 void
 rte_lpm_delete_all_v1604(struct rte_lpm *lpm)
 {
+	/* tbl8 groups waiting for their grace period must not be released
+	 * once the tables are reset and the groups possibly reallocated.
+	 */
+	tbl8_free_pending_v1604(lpm);
+
 	/* Zero rule information. */
 	memset(lpm->rule_info, 0, sizeof(lpm->rule_info));
 
@@ -112,6 +112,11 @@ struct rte_lpm6 {
 
 	struct rte_lpm_tbl8_hdr *tbl8_hdrs; /* array of tbl8 headers */
 
+	/* RCU config. */
+	struct rte_rcu_qsbr *v;		/* RCU QSBR variable. */
+	enum rte_lpm6_qsbr_mode rcu_mode;/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq *dq;	/* RCU QSBR defer queue. */
+
 	struct rte_lpm6_tbl_entry tbl8[0]
 			__rte_cache_aligned; /**< LPM tbl8 table. */
 };
@@ -213,6 +218,71 @@ tbl8_available(struct rte_lpm6 *lpm)
 	return lpm->number_tbl8s - lpm->tbl8_pool_pos;
 }
 
+/*
+ * Put a tbl8 unlinked from the tree back to the pool. With RCU configured,
+ * this is done only once the readers which may still walk it have reported
+ * a quiescent state.
+ */
+static void
+tbl8_free(struct rte_lpm6 *lpm, uint32_t tbl8_ind)
+{
+	if (lpm->v == NULL) {
+		tbl8_put(lpm, tbl8_ind);
+		return;
+	}
+
+	/* Push into QSBR defer queue, fall back to blocking mode if full. */
+	if (lpm->rcu_mode == RTE_LPM6_QSBR_MODE_DQ &&
+			rte_rcu_qsbr_dq_enqueue(lpm->dq, (void *)&tbl8_ind) == 0)
+		return;
+
+	/* Wait for quiescent state change. */
+	rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+	tbl8_put(lpm, tbl8_ind);
+}
+
+/*
+ * Reclaim tbl8s from the defer queue until at least n are available,
+ * waiting for the readers if needed.
+ * Returns number of tbl8s available in the pool.
+ */
+static uint32_t
+tbl8_reclaim(struct rte_lpm6 *lpm, uint32_t n)
+{
+	uint32_t avail = tbl8_available(lpm);
+	unsigned int pending;
+
+	if (avail < n && lpm->dq != NULL) {
+		rte_rcu_qsbr_dq_reclaim(lpm->dq, lpm->number_tbl8s,
+				NULL, &pending, NULL);
+		avail = tbl8_available(lpm);
+		if (avail < n && pending != 0) {
+			/* Wait for the readers rather than fail the add. */
+			rte_rcu_qsbr_synchronize(lpm->v,
+					RTE_QSBR_THRID_INVALID);
+			rte_rcu_qsbr_dq_reclaim(lpm->dq, lpm->number_tbl8s,
+					NULL, NULL, NULL);
+			avail = tbl8_available(lpm);
+		}
+	}
+
+	return avail;
+}
+
+/*
+ * Wait for the readers and put all the tbl8s pending on the defer queue
+ * back to the pool.
+ */
+static void
+tbl8_free_pending(struct rte_lpm6 *lpm)
+{
+	if (lpm->dq == NULL)
+		return;
+
+	rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+	rte_rcu_qsbr_dq_reclaim(lpm->dq, lpm->number_tbl8s, NULL, NULL, NULL);
+}
+
 /*
  * Init a rule key.
  *	  note that ip must be already masked
@@ -434,6 +504,8 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (lpm->dq != NULL)
+		rte_rcu_qsbr_dq_delete(lpm->dq);
 	rte_free(lpm->tbl8_hdrs);
 	rte_free(lpm->tbl8_pool);
 	rte_hash_free(lpm->rules_tbl);
@@ -441,6 +513,68 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 	rte_free(te);
 }
 
+static void
+__lpm6_rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	RTE_SET_USED(n);
+	tbl8_put((struct rte_lpm6 *)p, *(uint32_t *)data);
+}
+
+/* Associate QSBR variable with an LPM6 object.
+ */
+int
+rte_lpm6_rcu_qsbr_add(struct rte_lpm6 *lpm, struct rte_lpm6_rcu_config *cfg,
+	struct rte_rcu_qsbr_dq **dq)
+{
+	/* Leave room for the "RCU_" prefix added by the defer queue. */
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE - 4];
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+
+	if (lpm == NULL || cfg == NULL || cfg->v == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (lpm->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_LPM6_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_LPM6_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"LPM6_%s", lpm->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = lpm->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_LPM6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 index */
+		params.free_fn = __lpm6_rcu_qsbr_free_resource;
+		params.p = lpm;
+		params.v = cfg->v;
+		lpm->dq = rte_rcu_qsbr_dq_create(&params);
+		if (lpm->dq == NULL) {
+			RTE_LOG(ERR, LPM, "LPM6 defer queue creation failed\n");
+			return 1;
+		}
+		if (dq != NULL)
+			*dq = lpm->dq;
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	lpm->rcu_mode = cfg->mode;
+	lpm->v = cfg->v;
+
+	return 0;
+}
+
 /* Find a rule */
 static inline int
 rule_find_with_key(struct rte_lpm6 *lpm,
@@ -742,7 +876,9 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 				.ext_entry = 1,
 			};
 
-			tbl[entry_ind] = new_tbl_entry;
+			/* The tbl8 must be visible before it is linked. */
+			__atomic_store(&tbl[entry_ind], &new_tbl_entry,
+					__ATOMIC_RELEASE);
 
 			/* update the current table's reference counter */
 			if (tbl_ind != TBL24_IND)
@@ -793,7 +929,9 @@ add_step(struct rte_lpm6 *lpm, struct rte_lpm6_tbl_entry *tbl,
 				.ext_entry = 1,
 			};
 
-			tbl[entry_ind] = new_tbl_entry;
+			/* The tbl8 must be visible before it is linked. */
+			__atomic_store(&tbl[entry_ind], &new_tbl_entry,
+					__ATOMIC_RELEASE);
 
 			/* update the current table's reference counter */
 			if (tbl_ind != TBL24_IND)
@@ -854,7 +992,7 @@ simulate_add(struct rte_lpm6 *lpm, const uint8_t *masked_ip, uint8_t depth)
 		total_need_tbl_nb += need_tbl_nb;
 	}
 
-	if (tbl8_available(lpm) < total_need_tbl_nb)
+	if (tbl8_reclaim(lpm, total_need_tbl_nb) < total_need_tbl_nb)
 		/* not enought tbl8 to add a rule */
 		return -ENOSPC;
 
@@ -1193,6 +1331,7 @@ rte_lpm6_delete_bulk_func(struct rte_lpm6 *lpm,
 	 * Set all the table entries to 0 (ie delete every rule
 	 * from the data structure.
 	 */
+	tbl8_free_pending(lpm);
 	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
 	memset(lpm->tbl8, 0, sizeof(lpm->tbl8[0])
 			* RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s);
@@ -1213,6 +1352,11 @@ rte_lpm6_delete_bulk_func(struct rte_lpm6 *lpm,
 void
 rte_lpm6_delete_all(struct rte_lpm6 *lpm)
 {
+	/* tbl8s waiting for their grace period must not be put back
+	 * once the pool is reset and the tbl8s possibly reallocated.
+	 */
+	tbl8_free_pending(lpm);
+
 	/* Zero used rules counter. */
 	lpm->used_rules = 0;
 
@@ -1387,7 +1531,7 @@ remove_tbl(struct rte_lpm6 *lpm, struct rte_lpm_tbl8_hdr *tbl_hdr,
 	}
 
 	/* return the table to the pool */
-	tbl8_put(lpm, tbl_ind);
+	tbl8_free(lpm, tbl_ind);
 }
 
 /*
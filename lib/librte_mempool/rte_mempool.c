@@ -31,6 +31,7 @@
 #include <rte_string_fns.h>
 #include <rte_spinlock.h>
 #include <rte_tailq.h>
+#include <rte_telemetry.h>
 
 #include "rte_mempool.h"
 
@@ -1324,3 +1325,84 @@ void rte_mempool_walk(void (*func)(struct rte_mempool *, void *),
 
 	rte_mcfg_mempool_read_unlock();
 }
+
+static void
+mempool_list_cb(struct rte_mempool *mp, void *arg)
+{
+	struct rte_tel_data *d = (struct rte_tel_data *)arg;
+
+	rte_tel_data_add_array_string(d, mp->name);
+}
+
+static int
+mempool_handle_list(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	rte_mempool_walk(mempool_list_cb, d);
+	return 0;
+}
+
+struct mempool_info_cb_arg {
+	const char *name;
+	struct rte_tel_data *d;
+	int found;
+};
+
+static void
+mempool_info_cb(struct rte_mempool *mp, void *arg)
+{
+	struct mempool_info_cb_arg *info = (struct mempool_info_cb_arg *)arg;
+	struct rte_tel_data *d = info->d;
+	const struct rte_mempool_ops *ops;
+
+	if (info->found || strncmp(mp->name, info->name,
+			RTE_MEMZONE_NAMESIZE) != 0)
+		return;
+	info->found = 1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", mp->name);
+	rte_tel_data_add_dict_int(d, "socket_id", mp->socket_id);
+	rte_tel_data_add_dict_u64(d, "flags", mp->flags);
+	rte_tel_data_add_dict_u64(d, "size", mp->size);
+	rte_tel_data_add_dict_u64(d, "cache_size", mp->cache_size);
+	rte_tel_data_add_dict_u64(d, "elt_size", mp->elt_size);
+	rte_tel_data_add_dict_u64(d, "header_size", mp->header_size);
+	rte_tel_data_add_dict_u64(d, "trailer_size", mp->trailer_size);
+	rte_tel_data_add_dict_u64(d, "private_data_size",
+		mp->private_data_size);
+	ops = rte_mempool_get_ops(mp->ops_index);
+	rte_tel_data_add_dict_string(d, "ops_name", ops->name);
+	rte_tel_data_add_dict_u64(d, "populated_size", mp->populated_size);
+	rte_tel_data_add_dict_u64(d, "nb_mem_chunks", mp->nb_mem_chunks);
+	rte_tel_data_add_dict_u64(d, "avail_count",
+		rte_mempool_avail_count(mp));
+	rte_tel_data_add_dict_u64(d, "in_use_count",
+		rte_mempool_in_use_count(mp));
+}
+
+static int
+mempool_handle_info(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct mempool_info_cb_arg info = {
+		.name = params,
+		.d = d,
+		.found = 0,
+	};
+
+	if (params == NULL)
+		return -EINVAL;
+
+	rte_mempool_walk(mempool_info_cb, &info);
+	return info.found ? 0 : -ENOENT;
+}
+
+RTE_INIT(mempool_init_telemetry)
+{
+	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
+		"Returns list of available mempools. Takes no parameters");
+	rte_telemetry_register_cmd("/mempool/info", mempool_handle_info,
+		"Returns mempool info. Parameters: pool_name");
+}
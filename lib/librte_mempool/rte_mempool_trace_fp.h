@@ -0,0 +1,44 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#ifndef _RTE_MEMPOOL_TRACE_FP_H_
+#define _RTE_MEMPOOL_TRACE_FP_H_
+
+/**
+ * @file
+ *
+ * Mempool fast path API for trace support
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_trace_point.h>
+
+RTE_TRACE_POINT(
+	rte_mempool_trace_generic_put,
+	RTE_TRACE_POINT_ARGS(void *mempool, void * const *obj_table,
+		uint32_t nb_objs, void *cache),
+	rte_trace_point_emit_ptr(mempool);
+	rte_trace_point_emit_ptr(obj_table);
+	rte_trace_point_emit_u32(nb_objs);
+	rte_trace_point_emit_ptr(cache);
+)
+
+RTE_TRACE_POINT(
+	rte_mempool_trace_generic_get,
+	RTE_TRACE_POINT_ARGS(void *mempool, void * const *obj_table,
+		uint32_t nb_objs, void *cache),
+	rte_trace_point_emit_ptr(mempool);
+	rte_trace_point_emit_ptr(obj_table);
+	rte_trace_point_emit_u32(nb_objs);
+	rte_trace_point_emit_ptr(cache);
+)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMPOOL_TRACE_FP_H_ */
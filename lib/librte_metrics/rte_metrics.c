@@ -2,19 +2,32 @@
  * Copyright(c) 2017 Intel Corporation
  */
 
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/queue.h>
 
+#include <rte_atomic.h>
+#include <rte_branch_prediction.h>
 #include <rte_common.h>
 #include <rte_string_fns.h>
 #include <rte_malloc.h>
 #include <rte_metrics.h>
 #include <rte_lcore.h>
 #include <rte_memzone.h>
+#include <rte_pause.h>
 #include <rte_spinlock.h>
+#include <rte_telemetry.h>
 
 #define RTE_METRICS_MAX_METRICS 256
 #define RTE_METRICS_MEMZONE_NAME "RTE_METRICS"
+#define RTE_METRICS_LCORE_MEMZONE_NAME "RTE_METRICS_LC_%u"
+
+/* Index of the global metrics in the per port arrays */
+#define RTE_METRICS_GLOBAL_IDX RTE_MAX_ETHPORTS
+#define RTE_METRICS_NB_PORTS (RTE_MAX_ETHPORTS + 1)
 
 /**
  * Internal stats metadata and value entry.
@@ -51,10 +64,146 @@ struct rte_metrics_data_s {
 	uint16_t cnt_stats;
 	/** Metric data memory block. */
 	struct rte_metrics_meta_s metadata[RTE_METRICS_MAX_METRICS];
-	/** Metric data access lock */
+	/** Metric data access lock, taken by writers */
 	rte_spinlock_t lock;
+	/** Sequence number of the values of each port, odd during updates */
+	volatile uint32_t seq[RTE_METRICS_NB_PORTS];
+	/** Non-zero for the lcores having set metrics values */
+	volatile uint8_t lcore_used[RTE_MAX_LCORE];
 };
 
+/**
+ * Internal per-lcore metric values.
+ *
+ * @internal
+ * Each lcore updates its own values, so that writers neither lock nor
+ * use atomic operations. Readers use the sequence number of a port to
+ * get a consistent snapshot of its values.
+ */
+struct rte_metrics_lcore_s {
+	/** Sequence number of the values of each port, odd during updates */
+	volatile uint32_t seq[RTE_METRICS_NB_PORTS];
+	/** Values set by the lcore */
+	uint64_t value[RTE_METRICS_NB_PORTS][RTE_METRICS_MAX_METRICS];
+} __rte_cache_aligned;
+
+/* Memzones are never freed, so their addresses are kept once found */
+static struct rte_metrics_data_s *metrics_data;
+static struct rte_metrics_lcore_s *metrics_lcore[RTE_MAX_LCORE];
+
+static struct rte_metrics_data_s *
+metrics_data_get(void)
+{
+	const struct rte_memzone *memzone;
+
+	if (likely(metrics_data != NULL))
+		return metrics_data;
+
+	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
+	if (memzone == NULL)
+		return NULL;
+	metrics_data = memzone->addr;
+	return metrics_data;
+}
+
+/* Values of an lcore, or NULL if it has not set any */
+static struct rte_metrics_lcore_s *
+metrics_lcore_lookup(struct rte_metrics_data_s *stats, unsigned int lcore_id)
+{
+	const struct rte_memzone *memzone;
+	char name[RTE_MEMZONE_NAMESIZE];
+
+	if (likely(metrics_lcore[lcore_id] != NULL))
+		return metrics_lcore[lcore_id];
+	if (!stats->lcore_used[lcore_id])
+		return NULL;
+
+	snprintf(name, sizeof(name), RTE_METRICS_LCORE_MEMZONE_NAME, lcore_id);
+	memzone = rte_memzone_lookup(name);
+	if (memzone == NULL)
+		return NULL;
+	metrics_lcore[lcore_id] = memzone->addr;
+	return metrics_lcore[lcore_id];
+}
+
+/* Values of the calling lcore, reserved on its first update */
+static struct rte_metrics_lcore_s *
+metrics_lcore_get(struct rte_metrics_data_s *stats, unsigned int lcore_id)
+{
+	struct rte_metrics_lcore_s *values;
+	const struct rte_memzone *memzone;
+	char name[RTE_MEMZONE_NAMESIZE];
+
+	values = metrics_lcore_lookup(stats, lcore_id);
+	if (likely(values != NULL))
+		return values;
+
+	snprintf(name, sizeof(name), RTE_METRICS_LCORE_MEMZONE_NAME, lcore_id);
+	memzone = rte_memzone_reserve(name, sizeof(*values),
+		rte_lcore_to_socket_id(lcore_id), 0);
+	if (memzone == NULL) {
+		/*
+		 * reserved by a process which exited: lcore ids cannot be
+		 * shared by running processes.
+		 */
+		memzone = rte_memzone_lookup(name);
+		if (memzone == NULL)
+			return NULL;
+	} else {
+		memset(memzone->addr, 0, sizeof(*values));
+	}
+	metrics_lcore[lcore_id] = memzone->addr;
+
+	rte_smp_wmb();
+	stats->lcore_used[lcore_id] = 1;
+	return metrics_lcore[lcore_id];
+}
+
+/*
+ * Check that key is a registered metric, and that updating count values
+ * from it does not cross a set border.
+ */
+static int
+metrics_set_check(struct rte_metrics_data_s *stats, uint16_t cnt_stats,
+	uint16_t key, uint32_t count)
+{
+	struct rte_metrics_meta_s *entry;
+	uint16_t idx_metric;
+	uint16_t cnt_setsize;
+
+	if (key >= cnt_stats)
+		return -EINVAL;
+	idx_metric = key;
+	cnt_setsize = 1;
+	while (idx_metric < cnt_stats) {
+		entry = &stats->metadata[idx_metric];
+		if (entry->idx_next_stat == 0)
+			break;
+		cnt_setsize++;
+		idx_metric++;
+	}
+	/* Check update does not cross set border */
+	if (count > cnt_setsize)
+		return -ERANGE;
+	return 0;
+}
+
+/* Number of metrics, whose names and sets are written before it */
+static inline uint16_t
+metrics_count(struct rte_metrics_data_s *stats)
+{
+	uint16_t cnt_stats = *(volatile uint16_t *)&stats->cnt_stats;
+
+	rte_smp_rmb();
+	return cnt_stats;
+}
+
+static inline int
+metrics_port_idx(int port_id)
+{
+	return port_id == RTE_METRICS_GLOBAL ? RTE_METRICS_GLOBAL_IDX : port_id;
+}
+
 void
 rte_metrics_init(int socket_id)
 {
@@ -74,6 +223,7 @@ rte_metrics_init(int socket_id)
 	stats = memzone->addr;
 	memset(stats, 0, sizeof(struct rte_metrics_data_s));
 	rte_spinlock_init(&stats->lock);
+	metrics_data = stats;
 }
 
 int
@@ -89,7 +239,6 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 {
 	struct rte_metrics_meta_s *entry = NULL;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
 	uint16_t idx_base;
 
@@ -100,10 +249,9 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 		if (names[idx_name] == NULL)
 			return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
 
 	if (stats->cnt_stats + cnt_names >= RTE_METRICS_MAX_METRICS)
 		return -ENOMEM;
@@ -123,6 +271,8 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 	}
 	entry->idx_next_stat = 0;
 	entry->idx_next_set = 0;
+	/* lockless readers only see the metrics once fully registered */
+	rte_smp_wmb();
 	stats->cnt_stats += cnt_names;
 
 	rte_spinlock_unlock(&stats->lock);
@@ -142,12 +292,12 @@ rte_metrics_update_values(int port_id,
 	const uint64_t *values,
 	uint32_t count)
 {
-	struct rte_metrics_meta_s *entry;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_metric;
 	uint16_t idx_value;
-	uint16_t cnt_setsize;
+	uint32_t seq;
+	int idx_port;
+	int ret;
 
 	if (port_id != RTE_METRICS_GLOBAL &&
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
@@ -156,32 +306,23 @@ rte_metrics_update_values(int port_id,
 	if (values == NULL)
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
 
 	rte_spinlock_lock(&stats->lock);
 
-	if (key >= stats->cnt_stats) {
+	ret = metrics_set_check(stats, stats->cnt_stats, key, count);
+	if (ret < 0) {
 		rte_spinlock_unlock(&stats->lock);
-		return -EINVAL;
-	}
-	idx_metric = key;
-	cnt_setsize = 1;
-	while (idx_metric < stats->cnt_stats) {
-		entry = &stats->metadata[idx_metric];
-		if (entry->idx_next_stat == 0)
-			break;
-		cnt_setsize++;
-		idx_metric++;
-	}
-	/* Check update does not cross set border */
-	if (count > cnt_setsize) {
-		rte_spinlock_unlock(&stats->lock);
-		return -ERANGE;
+		return ret;
 	}
 
+	idx_port = metrics_port_idx(port_id);
+	seq = stats->seq[idx_port];
+	stats->seq[idx_port] = seq + 1;
+	rte_smp_wmb();
+
 	if (port_id == RTE_METRICS_GLOBAL)
 		for (idx_value = 0; idx_value < count; idx_value++) {
 			idx_metric = key + idx_value;
@@ -194,39 +335,109 @@ rte_metrics_update_values(int port_id,
 			stats->metadata[idx_metric].value[port_id] =
 				values[idx_value];
 		}
+
+	rte_smp_wmb();
+	stats->seq[idx_port] = seq + 2;
 	rte_spinlock_unlock(&stats->lock);
 	return 0;
 }
 
+int
+rte_metrics_lcore_update_values(int port_id,
+	uint16_t key,
+	const uint64_t *values,
+	uint32_t count)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_metrics_lcore_s *lcore_values;
+	struct rte_metrics_data_s *stats;
+	uint32_t seq;
+	int idx_port;
+	int ret;
+
+	if (port_id != RTE_METRICS_GLOBAL &&
+			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
+		return -EINVAL;
+
+	if (values == NULL || lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	stats = metrics_data_get();
+	if (stats == NULL)
+		return -EIO;
+
+	ret = metrics_set_check(stats, metrics_count(stats), key, count);
+	if (ret < 0)
+		return ret;
+
+	lcore_values = metrics_lcore_get(stats, lcore_id);
+	if (lcore_values == NULL)
+		return -ENOMEM;
+
+	/* the lcore is the only writer of its values */
+	idx_port = metrics_port_idx(port_id);
+	seq = lcore_values->seq[idx_port];
+	lcore_values->seq[idx_port] = seq + 1;
+	rte_smp_wmb();
+
+	memcpy(&lcore_values->value[idx_port][key], values,
+		count * sizeof(*values));
+
+	rte_smp_wmb();
+	lcore_values->seq[idx_port] = seq + 2;
+	return 0;
+}
+
 int
 rte_metrics_get_names(struct rte_metric_name *names,
 	uint16_t capacity)
 {
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
-	int return_value;
+	uint16_t cnt_stats;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
-	rte_spinlock_lock(&stats->lock);
+	/* names are never modified once registered */
+	cnt_stats = metrics_count(stats);
 	if (names != NULL) {
-		if (capacity < stats->cnt_stats) {
-			return_value = stats->cnt_stats;
-			rte_spinlock_unlock(&stats->lock);
-			return return_value;
-		}
-		for (idx_name = 0; idx_name < stats->cnt_stats; idx_name++)
+		if (capacity < cnt_stats)
+			return cnt_stats;
+		for (idx_name = 0; idx_name < cnt_stats; idx_name++)
 			strlcpy(names[idx_name].name,
 				stats->metadata[idx_name].name,
 				RTE_METRICS_MAX_NAME_LEN);
 	}
-	return_value = stats->cnt_stats;
-	rte_spinlock_unlock(&stats->lock);
-	return return_value;
+	return cnt_stats;
+}
+
+/* Add the values set by an lcore for a port to a snapshot */
+static void
+metrics_lcore_values_add(struct rte_metrics_lcore_s *lcore_values,
+	int idx_port, uint16_t cnt_stats, struct rte_metric_value *values)
+{
+	uint64_t snapshot[RTE_METRICS_MAX_METRICS];
+	uint16_t idx_name;
+	uint32_t seq;
+
+	for (;;) {
+		seq = lcore_values->seq[idx_port];
+		if (seq & 1) {
+			rte_pause();
+			continue;
+		}
+		rte_smp_rmb();
+		memcpy(snapshot, lcore_values->value[idx_port],
+			cnt_stats * sizeof(snapshot[0]));
+		rte_smp_rmb();
+		if (seq == lcore_values->seq[idx_port])
+			break;
+	}
+
+	for (idx_name = 0; idx_name < cnt_stats; idx_name++)
+		values[idx_name].value += snapshot[idx_name];
 }
 
 int
@@ -234,47 +445,110 @@ rte_metrics_get_values(int port_id,
 	struct rte_metric_value *values,
 	uint16_t capacity)
 {
+	struct rte_metrics_lcore_s *lcore_values;
 	struct rte_metrics_meta_s *entry;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
+	unsigned int lcore_id;
 	uint16_t idx_name;
-	int return_value;
+	uint16_t cnt_stats;
+	uint32_t seq;
+	int idx_port;
 
 	if (port_id != RTE_METRICS_GLOBAL &&
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_data_get();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
-	rte_spinlock_lock(&stats->lock);
-
-	if (values != NULL) {
-		if (capacity < stats->cnt_stats) {
-			return_value = stats->cnt_stats;
-			rte_spinlock_unlock(&stats->lock);
-			return return_value;
+	cnt_stats = metrics_count(stats);
+	if (values == NULL || capacity < cnt_stats)
+		return cnt_stats;
+
+	/* retry if the values were updated while being read */
+	idx_port = metrics_port_idx(port_id);
+	for (;;) {
+		seq = stats->seq[idx_port];
+		if (seq & 1) {
+			rte_pause();
+			continue;
 		}
-		if (port_id == RTE_METRICS_GLOBAL)
-			for (idx_name = 0;
-					idx_name < stats->cnt_stats;
-					idx_name++) {
-				entry = &stats->metadata[idx_name];
-				values[idx_name].key = idx_name;
-				values[idx_name].value = entry->global_value;
-			}
-		else
-			for (idx_name = 0;
-					idx_name < stats->cnt_stats;
-					idx_name++) {
-				entry = &stats->metadata[idx_name];
-				values[idx_name].key = idx_name;
-				values[idx_name].value = entry->value[port_id];
-			}
+		rte_smp_rmb();
+		for (idx_name = 0; idx_name < cnt_stats; idx_name++) {
+			entry = &stats->metadata[idx_name];
+			values[idx_name].key = idx_name;
+			values[idx_name].value = port_id == RTE_METRICS_GLOBAL ?
+				entry->global_value : entry->value[port_id];
+		}
+		rte_smp_rmb();
+		if (seq == stats->seq[idx_port])
+			break;
 	}
-	return_value = stats->cnt_stats;
-	rte_spinlock_unlock(&stats->lock);
-	return return_value;
+
+	/* the values set per lcore are summed */
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		lcore_values = metrics_lcore_lookup(stats, lcore_id);
+		if (lcore_values != NULL)
+			metrics_lcore_values_add(lcore_values, idx_port,
+				cnt_stats, values);
+	}
+
+	return cnt_stats;
+}
+
+static int
+metrics_handle_values(const char *cmd __rte_unused, const char *params,
+	struct rte_tel_data *d)
+{
+	struct rte_metric_value *values;
+	struct rte_metric_name *names;
+	unsigned long port_id;
+	char *end;
+	int idx_name;
+	int nb_values;
+	int ret;
+
+	port_id = RTE_MAX_ETHPORTS;
+	if (params != NULL) {
+		if (!isdigit((unsigned char)*params))
+			return -EINVAL;
+		port_id = strtoul(params, &end, 0);
+		if (*end != '\0' || port_id >= RTE_MAX_ETHPORTS)
+			return -EINVAL;
+	}
+
+	/* sized for all metrics, so the counts cannot exceed capacity */
+	values = malloc((sizeof(*values) + sizeof(*names)) *
+		RTE_METRICS_MAX_METRICS);
+	if (values == NULL)
+		return -ENOMEM;
+	names = (void *)&values[RTE_METRICS_MAX_METRICS];
+
+	nb_values = rte_metrics_get_values(port_id == RTE_MAX_ETHPORTS ?
+		RTE_METRICS_GLOBAL : (int)port_id, values,
+		RTE_METRICS_MAX_METRICS);
+	/* the names are read last, so there are at least as many */
+	ret = nb_values;
+	if (ret >= 0)
+		ret = rte_metrics_get_names(names, RTE_METRICS_MAX_METRICS);
+	if (ret < 0) {
+		free(values);
+		return ret;
+	}
+
+	rte_tel_data_start_dict(d);
+	for (idx_name = 0; idx_name < nb_values; idx_name++)
+		rte_tel_data_add_dict_u64(d, names[values[idx_name].key].name,
+			values[idx_name].value);
+
+	free(values);
+	return 0;
+}
+
+RTE_INIT(metrics_init_telemetry)
+{
+	rte_telemetry_register_cmd("/metrics", metrics_handle_values,
+		"Returns the metrics of a port, or the global metrics if no "
+		"port is given. Parameters: int port_id (optional)");
 }
@@ -18,6 +18,11 @@
  * metric information by querying the central metric data, which is
  * held in shared memory. Currently only bulk querying of metrics
  * by consumers is supported.
+ *
+ * Consumers do not lock the metric data, so they do not block producers.
+ * Producers running on several lcores may also set their own value of a
+ * metric with rte_metrics_lcore_update_values(), without any lock, in
+ * which case consumers get the sum of these values.
  */
 
 #ifndef _RTE_METRICS_H_
@@ -25,6 +30,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -215,6 +222,47 @@ int rte_metrics_update_values(
 	const uint64_t *values,
 	uint32_t count);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Updates the values of a metric set for the calling lcore.
+ *
+ * Each lcore has its own copy of the metric values, which it updates
+ * without any lock or atomic operation. The value of a metric returned by
+ * rte_metrics_get_values() is the sum of the values set by every lcore,
+ * and of the value set with rte_metrics_update_values(). This is suited
+ * to counters, for example per queue counters updated by each datapath
+ * lcore. The values of a port set by an lcore are read as a consistent
+ * snapshot.
+ *
+ * The first call on an lcore reserves the memory of its values. This
+ * function must be called from an EAL thread, and lcore ids must not be
+ * shared by processes running at the same time.
+ *
+ * @param port_id
+ *   Port to update metrics for
+ * @param key
+ *   Base id of metrics set to update
+ * @param values
+ *   Set of new values
+ * @param count
+ *   Number of new values
+ *
+ * @return
+ *   - -EINVAL if the parameters are invalid or called from a non-EAL thread
+ *   - -ERANGE if count exceeds metric set size
+ *   - -EIO if unable to access shared metrics memory
+ *   - -ENOMEM if unable to reserve the values of the lcore
+ *   - Zero on success
+ */
+__rte_experimental
+int rte_metrics_lcore_update_values(
+	int port_id,
+	uint16_t key,
+	const uint64_t *values,
+	uint32_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,10 @@
 
 #include <rte_byteorder.h>
 #include <rte_mbuf.h>
+#if defined(RTE_ARCH_X86) || \
+	(defined(RTE_ARCH_ARM64) && defined(RTE_MACHINE_CPUFLAG_NEON))
+#include <rte_vect.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -103,10 +107,157 @@ struct rte_ipv4_hdr {
 #define RTE_IPV4_MIN_IHL    (0x5)
 #define RTE_IPV4_VHL_DEF    (IPVERSION | RTE_IPV4_MIN_IHL)
 
+#if defined(RTE_ARCH_X86) || \
+	(defined(RTE_ARCH_ARM64) && defined(RTE_MACHINE_CPUFLAG_NEON))
+
+/* Buffers are summed with vector instructions by blocks of this size. */
+#define __RTE_RAW_CKSUM_VEC_BLOCK 64
+
+/*
+ * Number of bytes summed in 32-bit lanes before they are folded into the
+ * 64-bit lanes: each 32-bit lane gets at most 8 words per block, so that
+ * it cannot overflow before 65536 words.
+ */
+#define __RTE_RAW_CKSUM_VEC_FOLD (__RTE_RAW_CKSUM_VEC_BLOCK * 8192)
+
+/**
+ * @internal Calculate a sum of all words in the buffer, using vector
+ * instructions. Helper routine for the __rte_raw_cksum().
+ *
+ * @param buf
+ *   Pointer to the buffer, which does not need to be aligned.
+ * @param len
+ *   Length of the buffer, a multiple of __RTE_RAW_CKSUM_VEC_BLOCK.
+ * @return
+ *   Sum of all words in the buffer.
+ */
+static inline uint64_t
+__rte_raw_cksum_vec(const void *buf, size_t len)
+{
+	const uint8_t *p = (const uint8_t *)buf;
+#if defined(RTE_MACHINE_CPUFLAG_AVX512F)
+	const __m512i mask16 = _mm512_set1_epi32(0xffff);
+	const __m512i mask32 = _mm512_set1_epi64(0xffffffff);
+	__m512i sum64 = _mm512_setzero_si512();
+
+	while (len > 0) {
+		size_t n = RTE_MIN(len, (size_t)__RTE_RAW_CKSUM_VEC_FOLD);
+		__m512i sum32 = _mm512_setzero_si512();
+
+		len -= n;
+		for (; n > 0; n -= 64, p += 64) {
+			__m512i v = _mm512_loadu_si512((const void *)p);
+
+			v = _mm512_add_epi32(_mm512_and_si512(v, mask16),
+				_mm512_srli_epi32(v, 16));
+			sum32 = _mm512_add_epi32(sum32, v);
+		}
+		sum64 = _mm512_add_epi64(sum64,
+			_mm512_and_si512(sum32, mask32));
+		sum64 = _mm512_add_epi64(sum64, _mm512_srli_epi64(sum32, 32));
+	}
+
+	return _mm512_reduce_add_epi64(sum64);
+#elif defined(RTE_MACHINE_CPUFLAG_AVX2)
+	const __m256i mask16 = _mm256_set1_epi32(0xffff);
+	const __m256i mask32 = _mm256_set1_epi64x(0xffffffff);
+	__m256i sum64 = _mm256_setzero_si256();
+	uint64_t res[4];
+
+	while (len > 0) {
+		size_t n = RTE_MIN(len, (size_t)__RTE_RAW_CKSUM_VEC_FOLD);
+		__m256i sum32 = _mm256_setzero_si256();
+
+		len -= n;
+		for (; n > 0; n -= 64, p += 64) {
+			__m256i v0 = _mm256_loadu_si256((const __m256i *)p);
+			__m256i v1 = _mm256_loadu_si256(
+				(const __m256i *)(p + 32));
+
+			v0 = _mm256_add_epi32(_mm256_and_si256(v0, mask16),
+				_mm256_srli_epi32(v0, 16));
+			v1 = _mm256_add_epi32(_mm256_and_si256(v1, mask16),
+				_mm256_srli_epi32(v1, 16));
+			sum32 = _mm256_add_epi32(sum32,
+				_mm256_add_epi32(v0, v1));
+		}
+		sum64 = _mm256_add_epi64(sum64,
+			_mm256_and_si256(sum32, mask32));
+		sum64 = _mm256_add_epi64(sum64, _mm256_srli_epi64(sum32, 32));
+	}
+
+	_mm256_storeu_si256((__m256i *)res, sum64);
+	return res[0] + res[1] + res[2] + res[3];
+#elif defined(RTE_ARCH_X86)
+	const __m128i mask16 = _mm_set1_epi32(0xffff);
+	const __m128i mask32 = _mm_set1_epi64x(0xffffffff);
+	__m128i sum64 = _mm_setzero_si128();
+	uint64_t res[2];
+
+	while (len > 0) {
+		size_t n = RTE_MIN(len, (size_t)__RTE_RAW_CKSUM_VEC_FOLD);
+		__m128i sum32 = _mm_setzero_si128();
+
+		len -= n;
+		for (; n > 0; n -= 64, p += 64) {
+			__m128i v0 = _mm_loadu_si128((const __m128i *)p);
+			__m128i v1 = _mm_loadu_si128((const __m128i *)(p + 16));
+			__m128i v2 = _mm_loadu_si128((const __m128i *)(p + 32));
+			__m128i v3 = _mm_loadu_si128((const __m128i *)(p + 48));
+
+			v0 = _mm_add_epi32(_mm_and_si128(v0, mask16),
+				_mm_srli_epi32(v0, 16));
+			v1 = _mm_add_epi32(_mm_and_si128(v1, mask16),
+				_mm_srli_epi32(v1, 16));
+			v2 = _mm_add_epi32(_mm_and_si128(v2, mask16),
+				_mm_srli_epi32(v2, 16));
+			v3 = _mm_add_epi32(_mm_and_si128(v3, mask16),
+				_mm_srli_epi32(v3, 16));
+			sum32 = _mm_add_epi32(sum32, _mm_add_epi32(
+				_mm_add_epi32(v0, v1), _mm_add_epi32(v2, v3)));
+		}
+		sum64 = _mm_add_epi64(sum64, _mm_and_si128(sum32, mask32));
+		sum64 = _mm_add_epi64(sum64, _mm_srli_epi64(sum32, 32));
+	}
+
+	_mm_storeu_si128((__m128i *)res, sum64);
+	return res[0] + res[1];
+#else /* NEON */
+	uint64x2_t sum64 = vdupq_n_u64(0);
+
+	while (len > 0) {
+		size_t n = RTE_MIN(len, (size_t)__RTE_RAW_CKSUM_VEC_FOLD);
+		uint32x4_t sum32 = vdupq_n_u32(0);
+
+		len -= n;
+		for (; n > 0; n -= 64, p += 64) {
+			sum32 = vpadalq_u16(sum32,
+				vreinterpretq_u16_u8(vld1q_u8(p)));
+			sum32 = vpadalq_u16(sum32,
+				vreinterpretq_u16_u8(vld1q_u8(p + 16)));
+			sum32 = vpadalq_u16(sum32,
+				vreinterpretq_u16_u8(vld1q_u8(p + 32)));
+			sum32 = vpadalq_u16(sum32,
+				vreinterpretq_u16_u8(vld1q_u8(p + 48)));
+		}
+		sum64 = vpadalq_u32(sum64, sum32);
+	}
+
+	return vaddvq_u64(sum64);
+#endif
+}
+
+#endif
+
 /**
  * @internal Calculate a sum of all words in the buffer.
  * Helper routine for the rte_raw_cksum().
  *
+ * Large buffers are summed with vector instructions when the target
+ * supports them (SSE, AVX2, AVX-512 or NEON). The returned sum may then
+ * differ from the plain sum of the words, but it always gives the same
+ * value once reduced by __rte_raw_cksum_reduce().
+ *
  * @param buf
  *   Pointer to the buffer.
  * @param len
@@ -122,8 +273,24 @@ __rte_raw_cksum(const void *buf, size_t len, uint32_t sum)
 	/* workaround gcc strict-aliasing warning */
 	uintptr_t ptr = (uintptr_t)buf;
 	typedef uint16_t __attribute__((__may_alias__)) u16_p;
-	const u16_p *u16_buf = (const u16_p *)ptr;
+	const u16_p *u16_buf;
+
+#ifdef __RTE_RAW_CKSUM_VEC_BLOCK
+	if (len >= __RTE_RAW_CKSUM_VEC_BLOCK) {
+		size_t vlen = len & ~((size_t)__RTE_RAW_CKSUM_VEC_BLOCK - 1);
+		uint64_t vsum;
+
+		vsum = __rte_raw_cksum_vec((const void *)ptr, vlen) + sum;
+		/* fold so that the remaining words cannot overflow the sum */
+		vsum = (vsum & 0xffffffff) + (vsum >> 32);
+		vsum = (vsum & 0xffffffff) + (vsum >> 32);
+		sum = (uint32_t)(vsum & 0xffff) + (uint32_t)(vsum >> 16);
+		ptr += vlen;
+		len -= vlen;
+	}
+#endif
 
+	u16_buf = (const u16_p *)ptr;
 	while (len >= (sizeof(*u16_buf) * 4)) {
 		sum += u16_buf[0];
 		sum += u16_buf[1];
@@ -235,6 +402,8 @@ rte_raw_cksum_mbuf(const struct rte_mbuf *m, uint32_t off, uint32_t len,
 	done = 0;
 	for (;;) {
 		tmp = __rte_raw_cksum(buf, seglen, 0);
+		/* reduce before swapping, not to lose the carries */
+		tmp = __rte_raw_cksum_reduce(tmp);
 		if (done & 1)
 			tmp = rte_bswap16((uint16_t)tmp);
 		sum += tmp;
@@ -252,6 +421,76 @@ rte_raw_cksum_mbuf(const struct rte_mbuf *m, uint32_t off, uint32_t len,
 	return 0;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Update a complemented checksum after a 16-bit word of the checksummed
+ * data has been modified, as described in RFC 1624. This is typically
+ * used to fix the IP and L4 checksums when rewriting a port in a NAT.
+ *
+ * The checksum and the words must be given in the same byte order, which
+ * is usually the network order in which they are stored in the packet.
+ * For UDP, a null result must be changed to 0xffff by the caller.
+ *
+ * @param cksum
+ *   The complemented checksum, as stored in the header.
+ * @param old_val
+ *   The previous value of the word.
+ * @param new_val
+ *   The new value of the word.
+ * @return
+ *   The updated complemented checksum.
+ */
+__rte_experimental
+static inline uint16_t
+rte_cksum_adjust16(uint16_t cksum, uint16_t old_val, uint16_t new_val)
+{
+	uint32_t sum;
+
+	/* HC' = ~(~HC + ~m + m') */
+	sum = (uint16_t)~cksum;
+	sum += (uint16_t)~old_val;
+	sum += new_val;
+	return (uint16_t)~__rte_raw_cksum_reduce(sum);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Update a complemented checksum after a 32-bit word of the checksummed
+ * data has been modified, as described in RFC 1624. This is typically
+ * used to fix the IP and L4 checksums when rewriting an IPv4 address in
+ * a NAT.
+ *
+ * The checksum and the words must be given in the same byte order, which
+ * is usually the network order in which they are stored in the packet.
+ * For UDP, a null result must be changed to 0xffff by the caller.
+ *
+ * @param cksum
+ *   The complemented checksum, as stored in the header.
+ * @param old_val
+ *   The previous value of the word.
+ * @param new_val
+ *   The new value of the word.
+ * @return
+ *   The updated complemented checksum.
+ */
+__rte_experimental
+static inline uint16_t
+rte_cksum_adjust32(uint16_t cksum, uint32_t old_val, uint32_t new_val)
+{
+	uint32_t sum;
+
+	sum = (uint16_t)~cksum;
+	sum += (uint16_t)~(old_val >> 16);
+	sum += (uint16_t)~old_val;
+	sum += new_val >> 16;
+	sum += new_val & 0xffff;
+	return (uint16_t)~__rte_raw_cksum_reduce(sum);
+}
+
 /**
  * Process the IPv4 checksum of an IPv4 header.
  *
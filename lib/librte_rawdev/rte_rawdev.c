@@ -29,6 +29,7 @@
 #include <rte_common.h>
 #include <rte_malloc.h>
 #include <rte_errno.h>
+#include <rte_telemetry.h>
 
 #include "rte_rawdev.h"
 #include "rte_rawdev_pmd.h"
@@ -544,6 +545,88 @@ rte_rawdev_pmd_release(struct rte_rawdev *rawdev)
 	return 0;
 }
 
+static int
+rawdev_handle_dev_list(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	int i;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	for (i = 0; i < RTE_RAWDEV_MAX_DEVS; i++)
+		if (rte_rawdev_pmd_is_valid_dev(i))
+			rte_tel_data_add_array_int(d, i);
+	return 0;
+}
+
+static int
+rawdev_handle_dev_xstats(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_rawdev_xstats_name *xstat_names;
+	unsigned long dev_id;
+	unsigned int *ids;
+	uint64_t *values;
+	char *end;
+	int num_xstats;
+	int i, ret;
+
+	if (params == NULL || !isdigit((unsigned char)*params))
+		return -EINVAL;
+
+	dev_id = strtoul(params, &end, 0);
+	if (*end != '\0' || dev_id >= RTE_RAWDEV_MAX_DEVS ||
+			!rte_rawdev_pmd_is_valid_dev(dev_id))
+		return -EINVAL;
+
+	num_xstats = xstats_get_count(dev_id);
+	if (num_xstats < 0)
+		return num_xstats;
+	if (num_xstats == 0) {
+		rte_tel_data_start_dict(d);
+		return 0;
+	}
+
+	/* one allocation for the values, the ids and the names */
+	values = malloc((sizeof(uint64_t) + sizeof(unsigned int) +
+			sizeof(struct rte_rawdev_xstats_name)) * num_xstats);
+	if (values == NULL)
+		return -ENOMEM;
+	ids = (void *)&values[num_xstats];
+	xstat_names = (void *)&ids[num_xstats];
+
+	ret = rte_rawdev_xstats_names_get(dev_id, xstat_names, num_xstats);
+	if (ret < 0 || ret > num_xstats) {
+		free(values);
+		return -1;
+	}
+
+	for (i = 0; i < ret; i++)
+		ids[i] = i;
+
+	ret = rte_rawdev_xstats_get(dev_id, ids, values, ret);
+	if (ret < 0 || ret > num_xstats) {
+		free(values);
+		return -1;
+	}
+
+	rte_tel_data_start_dict(d);
+	for (i = 0; i < ret; i++)
+		rte_tel_data_add_dict_u64(d, xstat_names[i].name, values[i]);
+
+	free(values);
+	return 0;
+}
+
+RTE_INIT(librawdev_init_telemetry)
+{
+	rte_telemetry_register_cmd("/rawdev/list", rawdev_handle_dev_list,
+		"Returns list of available rawdev ports. Takes no parameters");
+	rte_telemetry_register_cmd("/rawdev/xstats", rawdev_handle_dev_xstats,
+		"Returns the xstats for a rawdev port. Parameters: int port_id");
+}
+
 RTE_INIT(librawdev_init_log)
 {
 	librawdev_logtype = rte_log_register("lib.rawdev");
@@ -4,6 +4,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifndef _RTE_TELEMETRY_H_
 #define _RTE_TELEMETRY_H_
 
@@ -12,58 +14,366 @@
  * RTE Telemetry
  *
  * The telemetry library provides a method to retrieve statistics from
- * DPDK by sending a JSON encoded message over a socket. DPDK will send
- * a JSON encoded response containing telemetry data.
+ * DPDK by sending a command over a UNIX socket, e.g. "/ethdev/stats,0".
+ * DPDK will send a JSON encoded response containing the telemetry data.
+ *
+ * Libraries and applications register commands with a callback, which
+ * fills a data container with strings, integers, arrays and dictionaries
+ * when the command is received. The data is then serialized to JSON by
+ * the library.
  ***/
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum length of a string or name in an array or dictionary. */
+#define RTE_TEL_MAX_STRING_LEN 128
+/** Maximum length of a string given as the whole data. */
+#define RTE_TEL_MAX_SINGLE_STRING_LEN 8192
+/** Maximum number of entries in a dictionary. */
+#define RTE_TEL_MAX_DICT_ENTRIES 256
+/** Maximum number of entries in an array. */
+#define RTE_TEL_MAX_ARRAY_ENTRIES 512
+
+/** Maximum length of a command. */
+#define RTE_TEL_MAX_CMD_LEN 56
+/** Maximum length of the help text of a command. */
+#define RTE_TEL_MAX_HELP_LEN 128
+
+/**
+ * Data container filled by the telemetry commands.
+ *
+ * The container holds either a single string, an array of values of
+ * one type, or a dictionary of named values of any type.
+ */
+struct rte_tel_data;
+
+/**
+ * The types of the values in an array or a dictionary.
+ */
+enum rte_tel_value_type {
+	RTE_TEL_STRING_VAL, /**< a string value */
+	RTE_TEL_INT_VAL,    /**< a signed 32-bit integer value */
+	RTE_TEL_U64_VAL,    /**< an unsigned 64-bit integer value */
+	RTE_TEL_CONTAINER,  /**< a nested data container */
+};
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
  *
- * Initialize Telemetry
+ * Start an array of the given type for returning from a callback.
  *
+ * @param d
+ *   The data container passed to the callback.
+ * @param type
+ *   The type of the array values.
  * @return
- *  0 on successful initialisation.
+ *   0 on success, -EINVAL on invalid parameters.
+ */
+__rte_experimental
+int
+rte_tel_data_start_array(struct rte_tel_data *d, enum rte_tel_value_type type);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start a dictionary of named values for returning from a callback.
+ *
+ * @param d
+ *   The data container passed to the callback.
  * @return
- *  -ENOMEM on memory allocation error
+ *   0 on success, -EINVAL on invalid parameters.
+ */
+__rte_experimental
+int
+rte_tel_data_start_dict(struct rte_tel_data *d);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set a single string for returning from a callback.
+ *
+ * @param d
+ *   The data container passed to the callback.
+ * @param str
+ *   The string to return. It is truncated to
+ *   RTE_TEL_MAX_SINGLE_STRING_LEN - 1 characters.
+ * @return
+ *   0 on success, -EINVAL on invalid parameters, -E2BIG if truncated.
+ */
+__rte_experimental
+int
+rte_tel_data_string(struct rte_tel_data *d, const char *str);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a string to an array started with RTE_TEL_STRING_VAL.
+ *
+ * @param d
+ *   The data container holding the array.
+ * @param str
+ *   The string to add. It is truncated to RTE_TEL_MAX_STRING_LEN - 1
+ *   characters.
  * @return
- *  -EPERM on unknown error failure
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   array is full, -E2BIG if the string was truncated.
+ */
+__rte_experimental
+int
+rte_tel_data_add_array_string(struct rte_tel_data *d, const char *str);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add an integer to an array started with RTE_TEL_INT_VAL.
+ *
+ * @param d
+ *   The data container holding the array.
+ * @param x
+ *   The value to add.
  * @return
- *  -EALREADY if Telemetry is already initialised.
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   array is full.
  */
 __rte_experimental
-int32_t
-rte_telemetry_init(void);
+int
+rte_tel_data_add_array_int(struct rte_tel_data *d, int x);
 
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
  *
- * Clean up and free memory.
+ * Add an unsigned 64-bit integer to an array started with RTE_TEL_U64_VAL.
  *
+ * @param d
+ *   The data container holding the array.
+ * @param x
+ *   The value to add.
  * @return
- *  0 on success
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   array is full.
+ */
+__rte_experimental
+int
+rte_tel_data_add_array_u64(struct rte_tel_data *d, uint64_t x);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a container to an array started with RTE_TEL_CONTAINER.
+ *
+ * The container must have been allocated with rte_tel_data_alloc(). On
+ * success, it is owned by the array and freed with it.
+ *
+ * @param d
+ *   The data container holding the array.
+ * @param val
+ *   The container to add.
  * @return
- *  -EPERM on failure
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   array is full.
  */
 __rte_experimental
-int32_t
-rte_telemetry_cleanup(void);
+int
+rte_tel_data_add_array_container(struct rte_tel_data *d,
+		struct rte_tel_data *val);
 
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
  *
- * Runs various tests to ensure telemetry initialisation and register/unregister
- * functions are working correctly.
+ * Add a named string to a dictionary.
  *
+ * @param d
+ *   The data container holding the dictionary.
+ * @param name
+ *   The name of the value, truncated to RTE_TEL_MAX_STRING_LEN - 1
+ *   characters.
+ * @param val
+ *   The string value, truncated to RTE_TEL_MAX_STRING_LEN - 1 characters.
  * @return
- *  0 on success when all tests have passed
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   dictionary is full, -E2BIG if the name or value was truncated.
+ */
+__rte_experimental
+int
+rte_tel_data_add_dict_string(struct rte_tel_data *d, const char *name,
+		const char *val);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a named integer to a dictionary.
+ *
+ * @param d
+ *   The data container holding the dictionary.
+ * @param name
+ *   The name of the value, truncated to RTE_TEL_MAX_STRING_LEN - 1
+ *   characters.
+ * @param val
+ *   The value.
  * @return
- *  -1 on failure when the test has failed
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   dictionary is full, -E2BIG if the name was truncated.
  */
 __rte_experimental
-int32_t
-rte_telemetry_selftest(void);
+int
+rte_tel_data_add_dict_int(struct rte_tel_data *d, const char *name, int val);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a named unsigned 64-bit integer to a dictionary.
+ *
+ * @param d
+ *   The data container holding the dictionary.
+ * @param name
+ *   The name of the value, truncated to RTE_TEL_MAX_STRING_LEN - 1
+ *   characters.
+ * @param val
+ *   The value.
+ * @return
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   dictionary is full, -E2BIG if the name was truncated.
+ */
+__rte_experimental
+int
+rte_tel_data_add_dict_u64(struct rte_tel_data *d, const char *name,
+		uint64_t val);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a named container to a dictionary.
+ *
+ * The container must have been allocated with rte_tel_data_alloc(). On
+ * success, it is owned by the dictionary and freed with it.
+ *
+ * @param d
+ *   The data container holding the dictionary.
+ * @param name
+ *   The name of the value, truncated to RTE_TEL_MAX_STRING_LEN - 1
+ *   characters.
+ * @param val
+ *   The container to add.
+ * @return
+ *   0 on success, -EINVAL on invalid parameters or type, -ENOSPC if the
+ *   dictionary is full, -E2BIG if the name was truncated.
+ */
+__rte_experimental
+int
+rte_tel_data_add_dict_container(struct rte_tel_data *d, const char *name,
+		struct rte_tel_data *val);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate an empty data container, to be nested in the data returned by
+ * a callback.
+ *
+ * @return
+ *   The container, or NULL on allocation failure.
+ */
+__rte_experimental
+struct rte_tel_data *
+rte_tel_data_alloc(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a data container allocated with rte_tel_data_alloc(), and the
+ * containers nested in it. A container added to another one must not be
+ * freed.
+ *
+ * @param data
+ *   The container to free. NULL is ignored.
+ */
+__rte_experimental
+void
+rte_tel_data_free(struct rte_tel_data *data);
+
+/**
+ * Function called to handle a telemetry command.
+ *
+ * It is called from a control thread, and may run concurrently with the
+ * other threads of the application, including the callbacks of other
+ * commands.
+ *
+ * @param cmd
+ *   The command received, as registered.
+ * @param params
+ *   The parameters given after the command and a comma, or NULL.
+ * @param info
+ *   The data container to fill, which is initially empty.
+ * @return
+ *   0 on success, a negative value on error, in which case a null value
+ *   is returned to the client.
+ */
+typedef int (*rte_telemetry_cb)(const char *cmd, const char *params,
+		struct rte_tel_data *info);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Register a command and its callback. This can be called before the
+ * EAL initialization, typically from a constructor.
+ *
+ * @param cmd
+ *   The command, starting with a '/', e.g. "/ethdev/stats". It must be
+ *   shorter than RTE_TEL_MAX_CMD_LEN and must not contain a comma.
+ * @param fn
+ *   The callback handling the command.
+ * @param help
+ *   A short description of the command and its parameters, truncated to
+ *   RTE_TEL_MAX_HELP_LEN - 1 characters.
+ * @return
+ *   0 on success, -EINVAL on invalid parameters, -EEXIST if the command
+ *   is already registered, -ENOSPC if too many commands are registered.
+ */
+__rte_experimental
+int
+rte_telemetry_register_cmd(const char *cmd, rte_telemetry_cb fn,
+		const char *help);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Initialize Telemetry: create the UNIX socket in the runtime directory
+ * and the control thread accepting the clients.
+ *
+ * It is called at the end of the EAL initialization when the --telemetry
+ * EAL option is given.
+ *
+ * @return
+ *  0 on successful initialisation.
+ * @return
+ *  -EALREADY if Telemetry is already initialised.
+ * @return
+ *  -EADDRINUSE if the socket is used by another running process.
+ * @return
+ *  Another negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_telemetry_init(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
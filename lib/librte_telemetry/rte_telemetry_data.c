@@ -0,0 +1,402 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2019 Intel Corporation
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_string_fns.h>
+
+#include "rte_telemetry.h"
+#include "rte_telemetry_internal.h"
+
+void
+tel_data_reset(struct rte_tel_data *d)
+{
+	unsigned int i;
+
+	if (d->type == TEL_DICT) {
+		for (i = 0; i < d->data_len; i++)
+			if (d->data.dict[i].type == RTE_TEL_CONTAINER)
+				rte_tel_data_free(
+					d->data.dict[i].value.container);
+	} else if (d->type == TEL_ARRAY &&
+			d->array_type == RTE_TEL_CONTAINER) {
+		for (i = 0; i < d->data_len; i++)
+			rte_tel_data_free(d->data.array[i].container);
+	}
+
+	d->type = TEL_NULL;
+	d->data_len = 0;
+}
+
+struct rte_tel_data *
+rte_tel_data_alloc(void)
+{
+	struct rte_tel_data *d;
+
+	d = malloc(sizeof(*d));
+	if (d == NULL)
+		return NULL;
+
+	d->type = TEL_NULL;
+	d->data_len = 0;
+	return d;
+}
+
+void
+rte_tel_data_free(struct rte_tel_data *data)
+{
+	if (data == NULL)
+		return;
+
+	tel_data_reset(data);
+	free(data);
+}
+
+int
+rte_tel_data_start_array(struct rte_tel_data *d, enum rte_tel_value_type type)
+{
+	if (d == NULL || type > RTE_TEL_CONTAINER)
+		return -EINVAL;
+
+	tel_data_reset(d);
+	d->type = TEL_ARRAY;
+	d->array_type = type;
+	return 0;
+}
+
+int
+rte_tel_data_start_dict(struct rte_tel_data *d)
+{
+	if (d == NULL)
+		return -EINVAL;
+
+	tel_data_reset(d);
+	d->type = TEL_DICT;
+	return 0;
+}
+
+int
+rte_tel_data_string(struct rte_tel_data *d, const char *str)
+{
+	if (d == NULL || str == NULL)
+		return -EINVAL;
+
+	tel_data_reset(d);
+	d->type = TEL_STRING;
+	if (strlcpy(d->data.str, str, sizeof(d->data.str)) >=
+			sizeof(d->data.str))
+		return -E2BIG;
+	return 0;
+}
+
+/* Get the next free value of an array of the given type */
+static union tel_value *
+tel_array_next(struct rte_tel_data *d, enum rte_tel_value_type type, int *ret)
+{
+	if (d == NULL || d->type != TEL_ARRAY || d->array_type != type) {
+		*ret = -EINVAL;
+		return NULL;
+	}
+	if (d->data_len >= RTE_TEL_MAX_ARRAY_ENTRIES) {
+		*ret = -ENOSPC;
+		return NULL;
+	}
+
+	*ret = 0;
+	return &d->data.array[d->data_len++];
+}
+
+int
+rte_tel_data_add_array_string(struct rte_tel_data *d, const char *str)
+{
+	union tel_value *v;
+	int ret;
+
+	if (str == NULL)
+		return -EINVAL;
+
+	v = tel_array_next(d, RTE_TEL_STRING_VAL, &ret);
+	if (v == NULL)
+		return ret;
+
+	if (strlcpy(v->sval, str, sizeof(v->sval)) >= sizeof(v->sval))
+		return -E2BIG;
+	return 0;
+}
+
+int
+rte_tel_data_add_array_int(struct rte_tel_data *d, int x)
+{
+	union tel_value *v;
+	int ret;
+
+	v = tel_array_next(d, RTE_TEL_INT_VAL, &ret);
+	if (v == NULL)
+		return ret;
+
+	v->ival = x;
+	return 0;
+}
+
+int
+rte_tel_data_add_array_u64(struct rte_tel_data *d, uint64_t x)
+{
+	union tel_value *v;
+	int ret;
+
+	v = tel_array_next(d, RTE_TEL_U64_VAL, &ret);
+	if (v == NULL)
+		return ret;
+
+	v->u64val = x;
+	return 0;
+}
+
+int
+rte_tel_data_add_array_container(struct rte_tel_data *d,
+		struct rte_tel_data *val)
+{
+	union tel_value *v;
+	int ret;
+
+	if (val == NULL || val == d)
+		return -EINVAL;
+
+	v = tel_array_next(d, RTE_TEL_CONTAINER, &ret);
+	if (v == NULL)
+		return ret;
+
+	v->container = val;
+	return 0;
+}
+
+/* Get the next free entry of a dictionary and set its name and type */
+static struct tel_dict_entry *
+tel_dict_next(struct rte_tel_data *d, const char *name,
+		enum rte_tel_value_type type, int *ret)
+{
+	struct tel_dict_entry *e;
+
+	if (d == NULL || d->type != TEL_DICT || name == NULL) {
+		*ret = -EINVAL;
+		return NULL;
+	}
+	if (d->data_len >= RTE_TEL_MAX_DICT_ENTRIES) {
+		*ret = -ENOSPC;
+		return NULL;
+	}
+
+	e = &d->data.dict[d->data_len++];
+	e->type = type;
+	*ret = 0;
+	if (strlcpy(e->name, name, sizeof(e->name)) >= sizeof(e->name))
+		*ret = -E2BIG;
+	return e;
+}
+
+int
+rte_tel_data_add_dict_string(struct rte_tel_data *d, const char *name,
+		const char *val)
+{
+	struct tel_dict_entry *e;
+	int ret;
+
+	if (val == NULL)
+		return -EINVAL;
+
+	e = tel_dict_next(d, name, RTE_TEL_STRING_VAL, &ret);
+	if (e == NULL)
+		return ret;
+
+	if (strlcpy(e->value.sval, val, sizeof(e->value.sval)) >=
+			sizeof(e->value.sval))
+		return -E2BIG;
+	return ret;
+}
+
+int
+rte_tel_data_add_dict_int(struct rte_tel_data *d, const char *name, int val)
+{
+	struct tel_dict_entry *e;
+	int ret;
+
+	e = tel_dict_next(d, name, RTE_TEL_INT_VAL, &ret);
+	if (e == NULL)
+		return ret;
+
+	e->value.ival = val;
+	return ret;
+}
+
+int
+rte_tel_data_add_dict_u64(struct rte_tel_data *d, const char *name,
+		uint64_t val)
+{
+	struct tel_dict_entry *e;
+	int ret;
+
+	e = tel_dict_next(d, name, RTE_TEL_U64_VAL, &ret);
+	if (e == NULL)
+		return ret;
+
+	e->value.u64val = val;
+	return ret;
+}
+
+int
+rte_tel_data_add_dict_container(struct rte_tel_data *d, const char *name,
+		struct rte_tel_data *val)
+{
+	struct tel_dict_entry *e;
+	int ret;
+
+	if (val == NULL || val == d)
+		return -EINVAL;
+
+	e = tel_dict_next(d, name, RTE_TEL_CONTAINER, &ret);
+	if (e == NULL)
+		return ret;
+
+	e->value.container = val;
+	return ret;
+}
+
+/* JSON output buffer */
+struct tel_json {
+	char *buf;
+	size_t size;
+	size_t len;
+};
+
+static int __attribute__((format(printf, 2, 3)))
+tel_json_printf(struct tel_json *j, const char *fmt, ...)
+{
+	va_list ap;
+	int ret;
+
+	va_start(ap, fmt);
+	ret = vsnprintf(j->buf + j->len, j->size - j->len, fmt, ap);
+	va_end(ap);
+	if (ret < 0 || (size_t)ret >= j->size - j->len)
+		return -E2BIG;
+
+	j->len += ret;
+	return 0;
+}
+
+static int
+tel_json_string(struct tel_json *j, const char *s)
+{
+	if (tel_json_printf(j, "\"") < 0)
+		return -E2BIG;
+
+	for (; *s != '\0'; s++) {
+		int ret;
+
+		if (*s == '"' || *s == '\\')
+			ret = tel_json_printf(j, "\\%c", *s);
+		else if ((unsigned char)*s < 0x20)
+			ret = tel_json_printf(j, "\\u%04x", (unsigned char)*s);
+		else
+			ret = tel_json_printf(j, "%c", *s);
+		if (ret < 0)
+			return ret;
+	}
+
+	return tel_json_printf(j, "\"");
+}
+
+static int tel_json_data(struct tel_json *j, const struct rte_tel_data *d);
+
+static int
+tel_json_value(struct tel_json *j, enum rte_tel_value_type type,
+		const union tel_value *v)
+{
+	switch (type) {
+	case RTE_TEL_STRING_VAL:
+		return tel_json_string(j, v->sval);
+	case RTE_TEL_INT_VAL:
+		return tel_json_printf(j, "%d", v->ival);
+	case RTE_TEL_U64_VAL:
+		return tel_json_printf(j, "%" PRIu64, v->u64val);
+	case RTE_TEL_CONTAINER:
+		return tel_json_data(j, v->container);
+	}
+
+	return -EINVAL;
+}
+
+static int
+tel_json_data(struct tel_json *j, const struct rte_tel_data *d)
+{
+	unsigned int i;
+	int ret;
+
+	switch (d->type) {
+	case TEL_STRING:
+		return tel_json_string(j, d->data.str);
+	case TEL_ARRAY:
+		ret = tel_json_printf(j, "[");
+		for (i = 0; ret == 0 && i < d->data_len; i++) {
+			if (i > 0)
+				ret = tel_json_printf(j, ",");
+			if (ret == 0)
+				ret = tel_json_value(j, d->array_type,
+					&d->data.array[i]);
+		}
+		return ret == 0 ? tel_json_printf(j, "]") : ret;
+	case TEL_DICT:
+		ret = tel_json_printf(j, "{");
+		for (i = 0; ret == 0 && i < d->data_len; i++) {
+			if (i > 0)
+				ret = tel_json_printf(j, ",");
+			if (ret == 0)
+				ret = tel_json_string(j, d->data.dict[i].name);
+			if (ret == 0)
+				ret = tel_json_printf(j, ":");
+			if (ret == 0)
+				ret = tel_json_value(j, d->data.dict[i].type,
+					&d->data.dict[i].value);
+		}
+		return ret == 0 ? tel_json_printf(j, "}") : ret;
+	case TEL_NULL:
+		break;
+	}
+
+	return tel_json_printf(j, "null");
+}
+
+int
+tel_data_to_json(const char *name, const struct rte_tel_data *d, char *buf,
+		size_t size)
+{
+	struct tel_json j = { .buf = buf, .size = size, .len = 0 };
+	int ret = 0;
+
+	if (size == 0)
+		return -E2BIG;
+	buf[0] = '\0';
+
+	if (name != NULL) {
+		ret = tel_json_printf(&j, "{");
+		if (ret == 0)
+			ret = tel_json_string(&j, name);
+		if (ret == 0)
+			ret = tel_json_printf(&j, ":");
+	}
+	if (ret == 0)
+		ret = tel_json_data(&j, d);
+	if (ret == 0 && name != NULL)
+		ret = tel_json_printf(&j, "}");
+	if (ret < 0)
+		return ret;
+
+	return j.len;
+}
@@ -2,8 +2,12 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <rte_log.h>
-#include <rte_tailq.h>
+
+#include "rte_telemetry.h"
 
 #ifndef _RTE_TELEMETRY_INTERNAL_H_
 #define _RTE_TELEMETRY_INTERNAL_H_
@@ -24,89 +28,49 @@ extern int telemetry_log_level;
 #define TELEMETRY_LOG_INFO(fmt, args...) \
 	TELEMETRY_LOG(INFO, fmt, ## args)
 
-#define MAX_METRICS 256
-
-typedef struct telemetry_client {
-	char *file_path;
-	int fd;
-	TAILQ_ENTRY(telemetry_client) client_list;
-} telemetry_client;
-
-typedef struct telemetry_impl {
-	int accept_fd;
-	int server_fd;
-	pthread_t thread_id;
-	int thread_status;
-	uint32_t socket_id;
-	int reg_index[RTE_MAX_ETHPORTS];
-	int metrics_register_done;
-	TAILQ_HEAD(, telemetry_client) client_list_head;
-	struct telemetry_client *request_client;
-	int register_fail_count;
-} telemetry_impl;
-
-enum rte_telemetry_parser_actions {
-	ACTION_GET = 0,
-	ACTION_DELETE = 2
+/* Kind of data held by a container */
+enum tel_container_type {
+	TEL_NULL,   /* nothing was set, encoded as null */
+	TEL_STRING, /* a single string */
+	TEL_DICT,   /* named values of any type */
+	TEL_ARRAY,  /* values of the type given at start */
 };
 
-enum rte_telemetry_stats_type {
-	PORT_STATS = 0,
-	GLOBAL_STATS = 1
+union tel_value {
+	char sval[RTE_TEL_MAX_STRING_LEN];
+	int ival;
+	uint64_t u64val;
+	struct rte_tel_data *container;
 };
 
-/* @internal */
-struct telemetry_encode_param {
-	enum rte_telemetry_stats_type type;
-	union {
-		struct port_param {
-			int num_metric_ids;
-			uint32_t metric_ids[MAX_METRICS];
-			int num_port_ids;
-			uint32_t port_ids[RTE_MAX_ETHPORTS];
-		} pp;
-		struct global_param {
-			int num_metric_ids;
-			uint32_t metric_ids[MAX_METRICS];
-		} gp;
-	};
+struct tel_dict_entry {
+	char name[RTE_TEL_MAX_STRING_LEN];
+	enum rte_tel_value_type type;
+	union tel_value value;
 };
 
-int32_t
-rte_telemetry_parse_client_message(struct telemetry_impl *telemetry, char *buf);
-
-int32_t
-rte_telemetry_send_error_response(struct telemetry_impl *telemetry,
-	int error_type);
-
-int32_t
-rte_telemetry_register_client(struct telemetry_impl *telemetry,
-	const char *client_path);
+struct rte_tel_data {
+	enum tel_container_type type;
+	enum rte_tel_value_type array_type;
+	unsigned int data_len; /* number of array or dictionary entries */
+	union {
+		char str[RTE_TEL_MAX_SINGLE_STRING_LEN];
+		struct tel_dict_entry dict[RTE_TEL_MAX_DICT_ENTRIES];
+		union tel_value array[RTE_TEL_MAX_ARRAY_ENTRIES];
+	} data;
+};
 
-int32_t
-rte_telemetry_unregister_client(struct telemetry_impl *telemetry,
-	const char *client_path);
+/* Free the containers nested in d and make it null */
+void
+tel_data_reset(struct rte_tel_data *d);
 
-/**
- * This is a wrapper for the ethdev api rte_eth_find_next().
- * If rte_eth_find_next() returns the same port id that we passed it,
- * then we know that that port is active.
+/*
+ * Encode a container in JSON, as {"<name>":<data>} if name is not NULL,
+ * or as <data> otherwise. Returns the length of the string written in buf,
+ * or -E2BIG if it does not fit in size bytes.
  */
-int32_t
-rte_telemetry_is_port_active(int port_id);
-
-int32_t
-rte_telemetry_send_ports_stats_values(struct telemetry_encode_param *ep,
-	struct telemetry_impl *telemetry);
-
-int32_t
-rte_telemetry_socket_messaging_testing(int index, int socket);
-
-int32_t
-rte_telemetry_send_global_stats_values(struct telemetry_encode_param *ep,
-	struct telemetry_impl *telemetry);
-
-int32_t
-rte_telemetry_parser_test(struct telemetry_impl *telemetry);
+int
+tel_data_to_json(const char *name, const struct rte_tel_data *d, char *buf,
+		size_t size);
 
 #endif
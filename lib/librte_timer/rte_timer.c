@@ -30,6 +30,35 @@
 
 #include "rte_timer.h"
 
+#define TIMER_WHEEL_BITS	6
+#define TIMER_WHEEL_SLOTS	(1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS	8
+/* ticks beyond this range from the current tick go to the overflow list */
+#define TIMER_WHEEL_SPAN_BITS	(TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)
+
+/**
+ * Per-lcore hierarchical timing wheel.
+ *
+ * A timer is stored at the level of the highest bit differing between its
+ * expiry tick and the current tick, in the slot given by the bits of its
+ * expiry tick at this level. When the current tick reaches a slot of an
+ * upper level, its timers are cascaded down to the lower levels, so that
+ * only the timers of a level 0 slot are expired at each tick. The timers are
+ * linked on sl_next[0], sl_next[1] holding the address of the pointer to the
+ * timer, or NULL when the timer is not linked anymore.
+ */
+struct timer_wheel {
+	uint64_t now;         /**< next tick to process */
+	/** no timer expires before this time, in timer cycles */
+	uint64_t next_expire;
+	uint32_t tick_shift;  /**< log2 of the tick length in timer cycles */
+	uint32_t count;       /**< number of timers in the wheel */
+	uint64_t occupied[TIMER_WHEEL_LEVELS]; /**< bitmaps of non-empty slots */
+	struct rte_timer *overflow; /**< timers beyond the last level */
+	struct rte_timer *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} __rte_cache_aligned;
+
 /**
  * Per-lcore info for timers.
  */
@@ -49,6 +78,9 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timing wheel holding the pending timers, NULL for the skiplist */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -119,12 +151,64 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 	return -ENOSPC;
 }
 
+int
+rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution)
+{
+	struct rte_timer_data *data;
+	struct timer_wheel *wheels;
+	uint64_t cur_tick;
+	uint32_t tick_shift;
+	uint32_t id;
+	unsigned int lcore_id;
+	int ret;
+
+	/* default to a microsecond tick, or one cycle on slower timers */
+	if (resolution == 0)
+		resolution = RTE_MAX(rte_get_timer_hz() / 1000000,
+				UINT64_C(1));
+	/* the tick length is rounded up to a power of 2 below 2^63 */
+	if (resolution >= UINT64_C(1) << 63)
+		return -EINVAL;
+	tick_shift = rte_log2_u64(resolution);
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret < 0)
+		return ret;
+
+	wheels = rte_zmalloc("timer_wheels", sizeof(*wheels) * RTE_MAX_LCORE,
+			RTE_CACHE_LINE_SIZE);
+	if (wheels == NULL) {
+		rte_timer_data_dealloc(id);
+		return -ENOMEM;
+	}
+
+	cur_tick = rte_get_timer_cycles() >> tick_shift;
+	data = &rte_timer_data_arr[id];
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheels[lcore_id].now = cur_tick;
+		wheels[lcore_id].next_expire = UINT64_MAX;
+		wheels[lcore_id].tick_shift = tick_shift;
+		data->priv_timer[lcore_id].wheel = &wheels[lcore_id];
+	}
+
+	if (id_ptr)
+		*id_ptr = id;
+
+	return 0;
+}
+
 int
 rte_timer_data_dealloc(uint32_t id)
 {
 	struct rte_timer_data *timer_data;
+	unsigned int lcore_id;
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	/* the wheels of all lcores are allocated at once */
+	rte_free(timer_data->priv_timer[0].wheel);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		timer_data->priv_timer[lcore_id].wheel = NULL;
+
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -195,6 +279,7 @@ rte_timer_subsystem_init_v1905(void)
 					&data->priv_timer[lcore_id].list_lock);
 				data->priv_timer[lcore_id].prev_lcore =
 					lcore_id;
+				data->priv_timer[lcore_id].wheel = NULL;
 			}
 		}
 	}
@@ -395,6 +480,233 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+/* first tick at or after the given time */
+static inline uint64_t
+timer_wheel_tick(const struct timer_wheel *w, uint64_t time_val)
+{
+	uint64_t mask = (UINT64_C(1) << w->tick_shift) - 1;
+
+	return (time_val >> w->tick_shift) + ((time_val & mask) != 0);
+}
+
+static inline void
+timer_wheel_link(struct rte_timer **head, struct rte_timer *tim)
+{
+	tim->sl_next[0] = *head;
+	if (*head != NULL)
+		(*head)->sl_next[1] = (void *)&tim->sl_next[0];
+	tim->sl_next[1] = (void *)head;
+	*head = tim;
+}
+
+/* link a timer in the slot matching its expiry tick */
+static void
+timer_wheel_insert(struct timer_wheel *w, struct rte_timer *tim)
+{
+	uint64_t tick = RTE_MAX(timer_wheel_tick(w, tim->expire), w->now);
+	uint64_t diff = tick ^ w->now;
+	unsigned int lvl, slot;
+
+	lvl = diff == 0 ? 0 : (rte_fls_u64(diff) - 1) / TIMER_WHEEL_BITS;
+	if (lvl >= TIMER_WHEEL_LEVELS) {
+		timer_wheel_link(&w->overflow, tim);
+		return;
+	}
+
+	slot = (tick >> (lvl * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+	timer_wheel_link(&w->slots[lvl][slot], tim);
+	w->occupied[lvl] |= UINT64_C(1) << slot;
+}
+
+static void
+timer_wheel_add(struct timer_wheel *w, struct rte_timer *tim)
+{
+	uint64_t tick = timer_wheel_tick(w, tim->expire);
+
+	timer_wheel_insert(w, tim);
+	w->count++;
+
+	/* NOTE: this is not atomic on 32-bit */
+	if (tick < (w->next_expire >> w->tick_shift))
+		w->next_expire = RTE_MAX(tick, w->now) << w->tick_shift;
+}
+
+static void
+timer_wheel_del(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = (void *)tim->sl_next[1];
+	struct rte_timer *next = tim->sl_next[0];
+	struct rte_timer **first = &w->slots[0][0];
+	size_t idx;
+
+	/* already taken out of the wheel to be run */
+	if (pprev == NULL)
+		return;
+
+	*pprev = next;
+	if (next != NULL)
+		next->sl_next[1] = (void *)pprev;
+	else if (pprev >= first &&
+		 pprev < first + TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS) {
+		/* the slot is empty now */
+		idx = pprev - first;
+		w->occupied[idx / TIMER_WHEEL_SLOTS] &=
+			~(UINT64_C(1) << (idx % TIMER_WHEEL_SLOTS));
+	}
+	tim->sl_next[1] = NULL;
+	w->count--;
+}
+
+/*
+ * Get the first tick, starting from the current one, at which a slot has
+ * to be cascaded or expired, or UINT64_MAX if the wheel is empty.
+ */
+static uint64_t
+timer_wheel_next_tick(const struct timer_wheel *w)
+{
+	const uint64_t span_mask = (UINT64_C(1) << TIMER_WHEEL_SPAN_BITS) - 1;
+	uint64_t next = UINT64_MAX;
+	uint64_t tick, bits;
+	unsigned int lvl, shift, idx;
+
+	for (lvl = 0; lvl < TIMER_WHEEL_LEVELS; lvl++) {
+		shift = lvl * TIMER_WHEEL_BITS;
+		idx = (w->now >> shift) & TIMER_WHEEL_MASK;
+		/* the occupied slots are never behind the current one */
+		bits = w->occupied[lvl] & (UINT64_MAX << idx);
+		if (bits == 0)
+			continue;
+		tick = (w->now >> (shift + TIMER_WHEEL_BITS)) <<
+			(shift + TIMER_WHEEL_BITS);
+		tick |= (uint64_t)rte_bsf64(bits) << shift;
+		next = RTE_MIN(next, RTE_MAX(tick, w->now));
+	}
+
+	if (w->overflow != NULL) {
+		tick = (w->now & span_mask) == 0 ? w->now :
+			(w->now | span_mask) + 1;
+		next = RTE_MIN(next, tick);
+	}
+
+	return next;
+}
+
+/* put back the timers of a list in the wheel, relatively to its current tick */
+static void
+timer_wheel_cascade(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer *next_tim;
+
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+		timer_wheel_insert(w, tim);
+	}
+}
+
+/*
+ * Advance the wheel up to the given time, and return the list of expired
+ * timers, transitioned from PENDING to RUNNING and linked on sl_next[0].
+ * Must be called with the list lock held.
+ */
+static struct rte_timer *
+timer_wheel_expire(struct timer_wheel *w, uint64_t cur_time)
+{
+	const uint64_t span_mask = (UINT64_C(1) << TIMER_WHEEL_SPAN_BITS) - 1;
+	uint64_t cur_tick = cur_time >> w->tick_shift;
+	struct rte_timer *run_first_tim, **pprev;
+	struct rte_timer *tim, *next_tim;
+	unsigned int lvl, shift, slot;
+	uint64_t next;
+
+	run_first_tim = NULL;
+	pprev = &run_first_tim;
+
+	while (w->now <= cur_tick) {
+		/* skip the ticks without any slot to process */
+		next = timer_wheel_next_tick(w);
+		if (next > cur_tick) {
+			w->now = cur_tick + 1;
+			break;
+		}
+		w->now = next;
+
+		if ((w->now & span_mask) == 0 && w->overflow != NULL) {
+			tim = w->overflow;
+			w->overflow = NULL;
+			timer_wheel_cascade(w, tim);
+		}
+
+		/* cascade the upper levels slots starting at this tick */
+		for (lvl = TIMER_WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+			shift = lvl * TIMER_WHEEL_BITS;
+			if ((w->now & ((UINT64_C(1) << shift) - 1)) != 0)
+				continue;
+			slot = (w->now >> shift) & TIMER_WHEEL_MASK;
+			tim = w->slots[lvl][slot];
+			if (tim == NULL)
+				continue;
+			w->slots[lvl][slot] = NULL;
+			w->occupied[lvl] &= ~(UINT64_C(1) << slot);
+			timer_wheel_cascade(w, tim);
+		}
+
+		/* transition the expired slot from PENDING to RUNNING */
+		slot = w->now & TIMER_WHEEL_MASK;
+		tim = w->slots[0][slot];
+		w->slots[0][slot] = NULL;
+		w->occupied[0] &= ~(UINT64_C(1) << slot);
+
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[0];
+			tim->sl_next[1] = NULL;
+			w->count--;
+
+			/* if another core is trying to re-config this one,
+			 * it will find it out of the wheel
+			 */
+			if (likely(timer_set_running_state(tim) == 0)) {
+				*pprev = tim;
+				pprev = &tim->sl_next[0];
+			}
+		}
+
+		w->now++;
+	}
+	*pprev = NULL;
+
+	/* update the next to expire timer value */
+	next = timer_wheel_next_tick(w);
+	w->next_expire = next > (UINT64_MAX >> w->tick_shift) ? UINT64_MAX :
+		next << w->tick_shift;
+
+	return run_first_tim;
+}
+
+/* collect the expired timers of an lcore wheel */
+static struct rte_timer *
+timer_wheel_manage(struct priv_timer *privp)
+{
+	struct rte_timer *run_first_tim;
+	uint64_t cur_time;
+
+	/* optimize for the case where the wheel is empty */
+	if (privp->wheel->count == 0)
+		return NULL;
+	cur_time = rte_get_timer_cycles();
+
+#ifdef RTE_ARCH_64
+	/* as for the skiplist, check the next expiry time without the lock */
+	if (likely(privp->wheel->next_expire > cur_time))
+		return NULL;
+#endif
+
+	rte_spinlock_lock(&privp->list_lock);
+	run_first_tim = timer_wheel_expire(privp->wheel, cur_time);
+	rte_spinlock_unlock(&privp->list_lock);
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -407,6 +719,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		timer_wheel_add(priv_timer[tim_lcore].wheel, tim);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -432,26 +749,14 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 			pending_head.sl_next[0]->expire;
 }
 
-/*
- * del from list, lock if needed
- * timer must be in config state
- * timer must be in a list
- */
+/* call with lock held, del from the skiplist */
 static void
-timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
-	  int local_is_locked, struct priv_timer *priv_timer)
+timer_skiplist_del(struct rte_timer *tim, unsigned int prev_owner,
+		   struct priv_timer *priv_timer)
 {
-	unsigned lcore_id = rte_lcore_id();
-	unsigned prev_owner = prev_status.owner;
 	int i;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
-	/* if timer needs is pending another core, we need to lock the
-	 * list; if it is on local core, we need to lock if we are not
-	 * called from rte_timer_manage() */
-	if (prev_owner != lcore_id || !local_is_locked)
-		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
-
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -471,6 +776,30 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 			priv_timer[prev_owner].curr_skiplist_depth --;
 		else
 			break;
+}
+
+/*
+ * del from list, lock if needed
+ * timer must be in config state
+ * timer must be in a list
+ */
+static void
+timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
+	  int local_is_locked, struct priv_timer *priv_timer)
+{
+	unsigned lcore_id = rte_lcore_id();
+	unsigned prev_owner = prev_status.owner;
+
+	/* if timer needs is pending another core, we need to lock the
+	 * list; if it is on local core, we need to lock if we are not
+	 * called from rte_timer_manage() */
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	if (priv_timer[prev_owner].wheel != NULL)
+		timer_wheel_del(priv_timer[prev_owner].wheel, tim);
+	else
+		timer_skiplist_del(tim, prev_owner, priv_timer);
 
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
@@ -872,6 +1201,13 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		poll_lcore = poll_lcores[i];
 		privp = &data->priv_timer[poll_lcore];
 
+		if (privp->wheel != NULL) {
+			tim = timer_wheel_manage(privp);
+			if (tim != NULL)
+				run_first_tims[nb_runlists++] = tim;
+			continue;
+		}
+
 		/* optimize for the case where per-cpu list is empty */
 		if (privp->pending_head.sl_next[0] == NULL)
 			continue;
@@ -1009,6 +1345,24 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* Stop the timers of a pending list, with the list lock held */
+static void
+timer_list_stop_all(struct rte_timer *tim, struct rte_timer_data *timer_data,
+		    rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct rte_timer *next_tim;
+
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+
+		/* Call timer_stop with lock held */
+		__rte_timer_stop(tim, 1, timer_data);
+
+		if (f)
+			f(tim, f_arg);
+	}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -1016,9 +1370,11 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		   rte_timer_stop_all_cb_t f, void *f_arg)
 {
 	int i;
+	unsigned int lvl, slot;
+	uint64_t occupied;
 	struct priv_timer *priv_timer;
+	struct timer_wheel *w;
 	uint32_t walk_lcore;
-	struct rte_timer *tim, *next_tim;
 	struct rte_timer_data *timer_data;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
@@ -1026,20 +1382,27 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 	for (i = 0; i < nb_walk_lcores; i++) {
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
+		w = priv_timer->wheel;
 
 		rte_spinlock_lock(&priv_timer->list_lock);
 
-		for (tim = priv_timer->pending_head.sl_next[0];
-		     tim != NULL;
-		     tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			/* Call timer_stop with lock held */
-			__rte_timer_stop(tim, 1, timer_data);
+		if (w == NULL) {
+			timer_list_stop_all(priv_timer->pending_head.sl_next[0],
+					    timer_data, f, f_arg);
+			rte_spinlock_unlock(&priv_timer->list_lock);
+			continue;
+		}
 
-			if (f)
-				f(tim, f_arg);
+		for (lvl = 0; lvl < TIMER_WHEEL_LEVELS; lvl++) {
+			occupied = w->occupied[lvl];
+			while (occupied != 0) {
+				slot = rte_bsf64(occupied);
+				occupied &= occupied - 1;
+				timer_list_stop_all(w->slots[lvl][slot],
+						    timer_data, f, f_arg);
+			}
 		}
+		timer_list_stop_all(w->overflow, timer_data, f, f_arg);
 
 		rte_spinlock_unlock(&priv_timer->list_lock);
 	}
@@ -150,6 +150,36 @@ struct rte_timer
 __rte_experimental
 int rte_timer_data_alloc(uint32_t *id_ptr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance tracking its pending timers in per-lcore
+ * hierarchical timing wheels instead of skiplists.
+ *
+ * Starting and stopping a timer is done in constant time, and the expired
+ * timers are collected by batches of wheel ticks. The timers of such an
+ * instance do not expire before their expiry time, but may expire up to one
+ * tick after it, and timers expiring within the same tick may be run in any
+ * order. The instance is used with the rte_timer_alt_*() and
+ * rte_timer_stop_all() functions, like any other timer data instance.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param resolution
+ *   Length of a wheel tick in timer cycles, rounded up to a power of 2.
+ *   If 0, a tick of about one microsecond is used.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: resolution is 2^63 cycles or more
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ *   - -ENOMEM: unable to allocate memory for the timing wheels
+ */
+__rte_experimental
+int rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution);
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
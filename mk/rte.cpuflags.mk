@@ -80,6 +80,12 @@ endif
 endif
 endif
 
+ifneq ($(filter $(AUTO_CPUFLAGS),__AVX512BW__),)
+ifeq ($(CONFIG_RTE_ENABLE_AVX512),y)
+CPUFLAGS += AVX512BW
+endif
+endif
+
 # IBM Power CPU flags
 ifneq ($(filter $(AUTO_CPUFLAGS),__PPC64__),)
 CPUFLAGS += PPC64
@@ -0,0 +1,90 @@
+#! /usr/bin/env python
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright(c) 2019 Intel Corporation
+
+"""
+Script to be used with telemetry.
+Allows the user to input commands and read the JSON responses.
+"""
+
+from __future__ import print_function
+
+import json
+import os
+import readline
+import socket
+import sys
+
+DEFAULT_PREFIX = 'rte'
+RUNTIME_DIRS = ['/var/run/dpdk', os.path.join(os.environ.get(
+    'XDG_RUNTIME_DIR', '/tmp'), 'dpdk')]
+SOCKET_NAME = 'dpdk_telemetry.v2'
+
+try:
+    raw_input  # Python 2
+except NameError:
+    raw_input = input  # Python 3
+
+
+def read_socket(sock, buf_len, echo=True):
+    """ Read data from socket and return it in JSON format """
+    reply = sock.recv(buf_len).decode()
+    try:
+        ret = json.loads(reply)
+    except ValueError:
+        print("Error in reply: ", reply)
+        sock.close()
+        raise
+    if echo:
+        print(json.dumps(ret))
+    return ret
+
+
+def find_socket(prefix):
+    """ Return the path of the telemetry socket of a DPDK process """
+    for runtime_dir in RUNTIME_DIRS:
+        path = os.path.join(runtime_dir, prefix, SOCKET_NAME)
+        if os.path.exists(path):
+            return path
+    return os.path.join(RUNTIME_DIRS[0], prefix, SOCKET_NAME)
+
+
+def handle_socket(path):
+    """ Connect to socket and handle user input """
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+    print("Connecting to " + path)
+    try:
+        sock.connect(path)
+    except (socket.error, OSError):
+        print("Error connecting to " + path)
+        sock.close()
+        return
+    info = read_socket(sock, 1024)
+    output_buf_len = info["/info"]["max_output_len"]
+    sock.send("/".encode())
+    cmds = read_socket(sock, output_buf_len, False)["/"]
+
+    # interactive prompt with completion of the commands
+    readline.set_completer(lambda text, state:
+                           [c for c in cmds if c.startswith(text)][state])
+    readline.set_completer_delims(',')
+    readline.parse_and_bind('tab: complete')
+    try:
+        text = raw_input('--> ').strip()
+        while text != "quit":
+            if text.startswith('/'):
+                sock.send(text.encode())
+                read_socket(sock, output_buf_len)
+            text = raw_input('--> ').strip()
+    except EOFError:
+        pass
+    finally:
+        sock.close()
+
+
+if len(sys.argv) > 2:
+    print("Usage: %s [file_prefix]" % sys.argv[0])
+    sys.exit(1)
+
+handle_socket(find_socket(sys.argv[1] if len(sys.argv) == 2 else
+                          DEFAULT_PREFIX))